@@ -0,0 +1,353 @@
+#include "gerador.h"
+#include "ingestaoManutencao.h"
+#include "leitorSegmento.h"
+#include "repository.h"
+#include "repositorioCompactado.h"
+#include "sistemaInventario.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sched.h>
+#endif
+
+// gcc bench/benchmark.c $(ls src/*.c | grep -v main.c) -o benchmark -I include -lpthread -lm
+// ./benchmark [--semente S] [--repeticoes R] [--max-quadratico N] [--saida arquivo.json] [tamanhos...]
+
+#ifdef _WIN32
+#define DISPOSITIVO_NULO "NUL"
+#else
+#define DISPOSITIVO_NULO "/dev/null"
+#endif
+
+#define MAX_OPERACOES 64
+#define MAX_TAMANHOS 16
+#define PRODUTORES_INGESTAO 4
+#define EVENTOS_INGESTAO 200000
+
+typedef struct {
+    const char* nome;
+    int repeticoes;
+    double minimoMs;
+    double maximoMs;
+    double somaMs;
+} ResultadoOperacao;
+
+typedef struct {
+    int tamanho;
+    ResultadoOperacao operacoes[MAX_OPERACOES];
+    int numOperacoes;
+    long long bytesCsv;
+    long long bytesCompactado;
+    double eventosPorSegundo;       // melhor repetição da ingestão de manutenções
+} ResultadoTamanho;
+
+typedef struct {
+    unsigned long long semente;
+    int repeticoes;
+    int maxQuadratico;
+    const char* saida;
+    int tamanhos[MAX_TAMANHOS];
+    int numTamanhos;
+} Configuracao;
+
+static void registrar(ResultadoTamanho* resultado, const char* nome, double ms) {
+    ResultadoOperacao* op = NULL;
+    for (int i = 0; i < resultado->numOperacoes; i++) {
+        if (strcmp(resultado->operacoes[i].nome, nome) == 0) {
+            op = &resultado->operacoes[i];
+            break;
+        }
+    }
+    if (op == NULL) {
+        if (resultado->numOperacoes == MAX_OPERACOES) return;
+        op = &resultado->operacoes[resultado->numOperacoes++];
+        op->nome = nome;
+        op->repeticoes = 0;
+        op->somaMs = 0;
+    }
+
+    if (op->repeticoes == 0 || ms < op->minimoMs) op->minimoMs = ms;
+    if (op->repeticoes == 0 || ms > op->maximoMs) op->maximoMs = ms;
+    op->somaMs += ms;
+    op->repeticoes++;
+}
+
+static long long tamanho_arquivo(const char* nome) {
+    struct stat info;
+    return stat(nome, &info) == 0 ? (long long)info.st_size : -1;
+}
+
+static double ms_desde(long long inicioNs) {
+    return (tempo_monotonico_ns() - inicioNs) / 1000000.0;
+}
+
+#define MEDIR(resultado, nome, comando) do {          \
+        long long inicio_ = tempo_monotonico_ns();      \
+        comando;                                        \
+        fflush(stdout);                                 \
+        registrar((resultado), (nome), ms_desde(inicio_)); \
+    } while (0)
+
+typedef struct {
+    IngestaoManutencao* ingestao;
+    int tamanho;
+    int produtor;
+    int ano;
+} ProdutorIngestao;
+
+static void* produzir_manutencoes(void* arg) {
+    ProdutorIngestao* produtor = (ProdutorIngestao*)arg;
+    for (int i = 0; i < EVENTOS_INGESTAO / PRODUTORES_INGESTAO; i++) {
+        int sequencia = i * PRODUTORES_INGESTAO + produtor->produtor;
+        Data data = {1 + sequencia % 28, 1 + (sequencia / 28) % 12, produtor->ano};
+        int id = 1 + (int)((sequencia * 7919LL) % produtor->tamanho);
+        while (!ingestao_enviar(produtor->ingestao, id, &data)) {
+#ifdef _WIN32
+            Sleep(0);
+#else
+            sched_yield();
+#endif
+        }
+    }
+    return NULL;
+}
+
+// Produtores concorrentes enviam eventos; o tempo vai do primeiro envio até o último lote gravado
+static double medir_ingestao(SistemaInventario* sistema, int tamanho, int ano) {
+    IngestaoManutencao ingestao;
+    if (!ingestao_iniciar(&ingestao, sistema, 65536, 4096)) return 0;
+
+    long long inicio = tempo_monotonico_ns();
+    pthread_t threads[PRODUTORES_INGESTAO];
+    ProdutorIngestao produtores[PRODUTORES_INGESTAO];
+    int iniciados = 0;
+    for (int p = 0; p < PRODUTORES_INGESTAO; p++) {
+        produtores[p] = (ProdutorIngestao){&ingestao, tamanho, p, ano};
+        if (pthread_create(&threads[p], NULL, produzir_manutencoes, &produtores[p]) == 0) iniciados++;
+    }
+    for (int p = 0; p < iniciados; p++) pthread_join(threads[p], NULL);
+    ingestao_encerrar(&ingestao);
+    double segundos = ms_desde(inicio) / 1000.0;
+
+    if (ingestao.falhasGravacao > 0) fprintf(stderr, "[BENCH] Ingestão: %lld lotes sem gravação\n", ingestao.falhasGravacao);
+    return segundos > 0 ? ingestao.eventosAplicados / segundos : 0;
+}
+
+// Remove o arquivo de dados e os que os repositórios criam ao lado dele: índice de ids e CRCs do
+// CSV, temporário de uma gravação interrompida e a cópia guardada de um arquivo corrompido
+static void remover_com_auxiliares(const char* arquivo) {
+    static const char* SUFIXOS[] = {"", ".ids", ".crc", ".tmp", ".corrompido"};
+    char caminho[96];
+    for (size_t i = 0; i < sizeof(SUFIXOS) / sizeof(SUFIXOS[0]); i++) {
+        snprintf(caminho, sizeof(caminho), "%s%s", arquivo, SUFIXOS[i]);
+        remove(caminho);
+    }
+}
+
+static void executar_tamanho(const Configuracao* config, int tamanho, ResultadoTamanho* resultado) {
+    char arquivo[64];
+    snprintf(arquivo, sizeof(arquivo), "bench_inventario_%d.csv", tamanho);
+    Data hoje = {1, 7, 2026};
+
+    resultado->tamanho = tamanho;
+    resultado->numOperacoes = 0;
+
+    LinkedList gerado;
+    linkedlist_init(&gerado);
+    MEDIR(resultado, "gerador_inventario", gerador_inventario(&gerado, tamanho, config->semente));
+
+    Repository* repo = criar_repositorio_csv(arquivo);
+    if (!repo) {
+        linkedlist_clear(&gerado);
+        return;
+    }
+    const RepositoryInterface* api = repo->interface;
+
+    for (int r = 0; r < config->repeticoes; r++) {
+        MEDIR(resultado, "csv_salvar", api->salvar(repo->implementacao, &gerado));
+
+        LinkedList carregado;
+        linkedlist_init(&carregado);
+        MEDIR(resultado, "csv_carregar", api->carregar(repo->implementacao, &carregado));
+        linkedlist_clear(&carregado);
+    }
+    resultado->bytesCsv = tamanho_arquivo(arquivo);
+
+    // Mesmo inventário no formato compactado: tamanho em disco e tempo de carga contra o CSV
+    char arquivoCompactado[64];
+    snprintf(arquivoCompactado, sizeof(arquivoCompactado), "bench_inventario_%d.invz", tamanho);
+    Repository* compactado = criar_repositorio_compactado(arquivoCompactado);
+    if (compactado) {
+        for (int r = 0; r < config->repeticoes; r++) {
+            MEDIR(resultado, "compactado_salvar", compactado->interface->salvar(compactado->implementacao, &gerado));
+
+            LinkedList carregado;
+            linkedlist_init(&carregado);
+            MEDIR(resultado, "compactado_carregar", compactado->interface->carregar(compactado->implementacao, &carregado));
+            linkedlist_clear(&carregado);
+        }
+        resultado->bytesCompactado = tamanho_arquivo(arquivoCompactado);
+        destruir_repositorio(compactado);
+        remover_com_auxiliares(arquivoCompactado);
+    }
+    linkedlist_clear(&gerado);
+
+    // Operações unitárias do repositório; cada adição é desfeita pela remoção correspondente
+    GeradorAleatorio aleatorio;
+    gerador_init(&aleatorio, config->semente + 1);
+    for (int r = 0; r < config->repeticoes; r++) {
+        Hardware novo;
+        gerador_hardware(&aleatorio, tamanho + 1 + r, &novo);
+        int alvo = tamanho > 0 ? gerador_intervalo(&aleatorio, 1, tamanho) : 1;
+
+        MEDIR(resultado, "csv_adicionar", api->adicionar(repo->implementacao, &novo));
+
+        Hardware* encontrado = NULL;
+        MEDIR(resultado, "csv_buscar_por_id", encontrado = api->buscar_por_id(repo->implementacao, alvo));
+        if (encontrado) {
+            encontrado->ultimaManutencao = hoje;
+            MEDIR(resultado, "csv_atualizar", api->atualizar(repo->implementacao, encontrado));
+            free(encontrado);
+        }
+
+        MEDIR(resultado, "csv_remover", api->remover(repo->implementacao, novo.id));
+    }
+
+    SistemaInventario sistema;
+    MEDIR(resultado, "sistema_init", sistema_init(&sistema, repo));
+
+    for (int r = 0; r < config->repeticoes; r++) {
+        MEDIR(resultado, "sistema_listar_equipamentos", sistema_listar_equipamentos(&sistema));
+        MEDIR(resultado, "sistema_listar_por_tipo", sistema_listar_por_tipo(&sistema, SERVIDOR));
+        if (tamanho <= config->maxQuadratico) {
+            MEDIR(resultado, "sistema_listar_por_data_compra", sistema_listar_por_data_compra(&sistema));
+            MEDIR(resultado, "sistema_listar_por_data_manutencao", sistema_listar_por_data_manutencao(&sistema));
+        }
+        MEDIR(resultado, "sistema_mostrar_analise_depreciacao", sistema_mostrar_analise_depreciacao(&sistema, &hoje));
+        MEDIR(resultado, "sistema_mostrar_analise_depreciacao_paralela", sistema_mostrar_analise_depreciacao_paralela(&sistema, &hoje));
+        MEDIR(resultado, "sistema_atualizar_status_obsoleto", sistema_atualizar_status_obsoleto(&sistema, &hoje));
+        MEDIR(resultado, "sistema_identificar_obsoletos", sistema_identificar_obsoletos(&sistema, &hoje));
+        MEDIR(resultado, "sistema_identificar_obsoletos_paralelo", sistema_identificar_obsoletos_paralelo(&sistema, &hoje));
+        MEDIR(resultado, "sistema_relatorio_manutencao_pendente", sistema_relatorio_manutencao_pendente(&sistema, &hoje, 12));
+        MEDIR(resultado, "sistema_relatorio_manutencao_pendente_paralelo", sistema_relatorio_manutencao_pendente_paralelo(&sistema, &hoje, 12));
+        MEDIR(resultado, "sistema_relatorio_manutencao_pendente_agenda", sistema_relatorio_manutencao_pendente_agenda(&sistema, &hoje, 12));
+        MEDIR(resultado, "sistema_relatorio_proximas_manutencoes", sistema_relatorio_proximas_manutencoes(&sistema, &hoje, 12, 100));
+        MEDIR(resultado, "sistema_relatorio_agregado", sistema_relatorio_agregado(&sistema, AGRUPAR_TIPO | AGRUPAR_FABRICANTE, &hoje, 12));
+        MEDIR(resultado, "sistema_mostrar_projecao_valor", sistema_mostrar_projecao_valor(&sistema, &hoje, 5));
+        MEDIR(resultado, "sistema_mostrar_valor_em_data", sistema_mostrar_valor_em_data(&sistema, &hoje));
+        MEDIR(resultado, "sistema_previsao_substituicao", sistema_previsao_substituicao(&sistema, &hoje, 5));
+    }
+
+    // Leitores em outro processo consultam o segmento compartilhado sem chamadas ao sistema por leitura
+    char nomeSegmento[64];
+    snprintf(nomeSegmento, sizeof(nomeSegmento), "/bench_inventario_%d", tamanho);
+    bool publicado = false;
+    MEDIR(resultado, "segmento_publicar", publicado = sistema_publicar_segmento(&sistema, nomeSegmento));
+    LeitorSegmento leitor;
+    if (publicado && tamanho > 0 && leitor_segmento_abrir(&leitor, nomeSegmento)) {
+        for (int r = 0; r < config->repeticoes; r++) {
+            Hardware hw;
+            MEDIR(resultado, "segmento_buscar_1000",
+                  for (int i = 0; i < 1000; i++) leitor_segmento_buscar(&leitor, 1 + (i * 7919) % tamanho, &hw));
+            MEDIR(resultado, "segmento_contar_obsoletos", leitor_segmento_contar_obsoletos(&leitor, &hoje));
+            MEDIR(resultado, "segmento_contar_pendentes", leitor_segmento_contar_pendentes(&leitor, &hoje, 12));
+        }
+        leitor_segmento_fechar(&leitor);
+    }
+
+    // Um evento por chamada grava o registro a cada vez; a ingestão grava uma vez por lote
+    if (tamanho > 0) {
+        resultado->eventosPorSegundo = 0;
+        for (int r = 0; r < config->repeticoes; r++) {
+            Data manutencao = {1, 1, 2027};
+            MEDIR(resultado, "sistema_registrar_manutencao", sistema_registrar_manutencao(&sistema, 1 + r % tamanho, &manutencao));
+
+            double eventosPorSegundo = 0;
+            // Cada repetição usa um ano posterior, senão os eventos não alterariam nenhum registro
+            MEDIR(resultado, "ingestao_manutencoes", eventosPorSegundo = medir_ingestao(&sistema, tamanho, 2028 + r));
+            if (eventosPorSegundo > resultado->eventosPorSegundo) resultado->eventosPorSegundo = eventosPorSegundo;
+        }
+        fprintf(stderr, "[BENCH] Ingestão: %.0f eventos/s (%d produtores)\n", resultado->eventosPorSegundo, PRODUTORES_INGESTAO);
+    }
+
+    MEDIR(resultado, "sistema_destroy", sistema_destroy(&sistema));
+    destruir_repositorio(repo);
+    remover_com_auxiliares(arquivo);
+}
+
+static void escrever_json(const Configuracao* config, const ResultadoTamanho* resultados, int numResultados) {
+    FILE* arquivo = fopen(config->saida, "w");
+    if (!arquivo) {
+        fprintf(stderr, "Falha ao gravar %s\n", config->saida);
+        return;
+    }
+
+    fprintf(arquivo, "{\n  \"semente\": %llu,\n  \"repeticoes\": %d,\n  \"max_quadratico\": %d,\n  \"resultados\": [",
+            config->semente, config->repeticoes, config->maxQuadratico);
+    for (int t = 0; t < numResultados; t++) {
+        const ResultadoTamanho* resultado = &resultados[t];
+        fprintf(arquivo, "%s\n    {\"tamanho\": %d, \"bytes_csv\": %lld, \"bytes_compactado\": %lld, "
+                "\"eventos_manutencao_por_segundo\": %.0f, \"operacoes\": [",
+                t > 0 ? "," : "", resultado->tamanho, resultado->bytesCsv, resultado->bytesCompactado,
+                resultado->eventosPorSegundo);
+        for (int i = 0; i < resultado->numOperacoes; i++) {
+            const ResultadoOperacao* op = &resultado->operacoes[i];
+            fprintf(arquivo, "%s\n      {\"nome\": \"%s\", \"repeticoes\": %d, \"min_ms\": %.4f, \"media_ms\": %.4f, \"max_ms\": %.4f}",
+                    i > 0 ? "," : "", op->nome, op->repeticoes, op->minimoMs, op->somaMs / op->repeticoes, op->maximoMs);
+        }
+        fprintf(arquivo, "\n    ]}");
+    }
+    fprintf(arquivo, "\n  ]\n}\n");
+    fclose(arquivo);
+}
+
+int main(int argc, char** argv) {
+    Configuracao config = {20240601ULL, 3, 20000, "benchmark.json", {0}, 0};
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--semente") == 0 && i + 1 < argc) {
+            config.semente = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--repeticoes") == 0 && i + 1 < argc) {
+            config.repeticoes = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--max-quadratico") == 0 && i + 1 < argc) {
+            config.maxQuadratico = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--saida") == 0 && i + 1 < argc) {
+            config.saida = argv[++i];
+        } else if (config.numTamanhos < MAX_TAMANHOS && atoi(argv[i]) > 0) {
+            config.tamanhos[config.numTamanhos++] = atoi(argv[i]);
+        } else {
+            fprintf(stderr, "Argumento inválido: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (config.repeticoes < 1) config.repeticoes = 1;
+    if (config.numTamanhos == 0) {
+        int padrao[] = {1000, 10000, 100000};
+        for (int i = 0; i < 3; i++) config.tamanhos[config.numTamanhos++] = padrao[i];
+    }
+
+    // Relatórios escrevem em stdout; a saída é descartada para medir só o processamento
+    cronometro_definir_console(false);
+    if (!freopen(DISPOSITIVO_NULO, "w", stdout)) {
+        fprintf(stderr, "Falha ao redirecionar a saída padrão\n");
+        return 1;
+    }
+
+    ResultadoTamanho* resultados = calloc(config.numTamanhos, sizeof(ResultadoTamanho));
+    if (!resultados) return 1;
+
+    for (int t = 0; t < config.numTamanhos; t++) {
+        fprintf(stderr, "[BENCH] %d itens...\n", config.tamanhos[t]);
+        executar_tamanho(&config, config.tamanhos[t], &resultados[t]);
+    }
+
+    escrever_json(&config, resultados, config.numTamanhos);
+    fprintf(stderr, "[BENCH] Resultados gravados em %s\n", config.saida);
+    free(resultados);
+    return 0;
+}
@@ -0,0 +1,249 @@
+#include "gerador.h"
+#include "sistemaInventario.h"
+#include "utils.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// gcc bench/estresseVersoes.c $(ls src/*.c | grep -v main.c) -o estresseVersoes -I include -lpthread -lm
+// ./estresseVersoes [--leitores L] [--segundos S] [--semente S] [tamanho]
+//
+// Leitores conferem versões publicadas enquanto escritores alteram o inventário pelas mesmas funções
+// do menu. Cada versão obtida é percorrida duas vezes e precisa repetir contagem e TOTAL; os escritores
+// só acrescentam registros de valor VALOR_ACRESCIMO, então o TOTAL de uma versão é função da contagem.
+// Entre versões sucessivas, contagem e manutenções marcadas nunca diminuem. Sai com 1 se houver
+// inconsistência.
+
+#ifdef _WIN32
+#define DISPOSITIVO_NULO "NUL"
+#else
+#define DISPOSITIVO_NULO "/dev/null"
+#endif
+
+#define MAX_LEITORES 16
+#define VALOR_ACRESCIMO 100.0
+// Manutenções dos escritores usam anos a partir deste; registros com ele ficam marcados
+#define ANO_MARCADO 2100
+#define EVENTOS_POR_LOTE 64
+
+typedef struct {
+    SistemaInventario* sistema;
+    atomic_bool* parar;
+    int registrosIniciais;
+    long long totalInicialCentavos;
+    long long versoes;
+    long long inconsistencias;
+} Leitor;
+
+typedef struct {
+    SistemaInventario* sistema;
+    atomic_bool* parar;
+    unsigned long long semente;
+    long long alteracoes;
+} Escritor;
+
+static long long centavos(double valor) {
+    return llround(valor * 100.0);
+}
+
+typedef struct {
+    int registros;
+    long long totalCentavos;
+    int marcados;
+    bool idsCrescentes;
+} Resumo;
+
+static Resumo resumir(const VersaoInventario* versao) {
+    Resumo resumo = {0, 0, 0, true};
+    int idAnterior = 0;
+    for (int p = 0; p < versao->numPaginas; p++) {
+        const PaginaInventario* pagina = versao->paginas[p];
+        for (int i = 0; i < pagina->quantidade; i++) {
+            const Hardware* hw = &pagina->registros[i];
+            resumo.registros++;
+            resumo.totalCentavos += centavos(hw->valorCompra);
+            if (hw->ultimaManutencao.ano >= ANO_MARCADO) resumo.marcados++;
+            // Registros novos entram no fim com id maior; a posição dos demais não muda
+            if (hw->id <= idAnterior) resumo.idsCrescentes = false;
+            idAnterior = hw->id;
+        }
+    }
+    return resumo;
+}
+
+static void* ler_versoes(void* arg) {
+    Leitor* leitor = (Leitor*)arg;
+    Resumo anterior = {0, 0, 0, true};
+    while (!atomic_load(leitor->parar)) {
+        const VersaoInventario* versao = sistema_obter_versao(leitor->sistema);
+        Resumo primeira = resumir(versao);
+        Resumo segunda = resumir(versao);
+        int registros = versao->numRegistros;
+        versao_liberar(versao);
+
+        long long esperado = leitor->totalInicialCentavos +
+                             (long long)(primeira.registros - leitor->registrosIniciais) * centavos(VALOR_ACRESCIMO);
+        const char* erro = NULL;
+        if (primeira.registros != segunda.registros || primeira.totalCentavos != segunda.totalCentavos ||
+            primeira.marcados != segunda.marcados) {
+            erro = "versão mudou durante a leitura";
+        } else if (primeira.registros != registros) {
+            erro = "contagem das páginas difere de numRegistros";
+        } else if (primeira.totalCentavos != esperado) {
+            erro = "TOTAL não corresponde à contagem";
+        } else if (!primeira.idsCrescentes) {
+            erro = "ids fora de ordem";
+        } else if (primeira.registros < anterior.registros || primeira.marcados < anterior.marcados) {
+            erro = "versão mais antiga que a anterior";
+        }
+        if (erro) {
+            if (leitor->inconsistencias++ < 10) {
+                fprintf(stderr, "[ESTRESSE] %s: %d registros, TOTAL %.2f (esperado %.2f), %d marcados\n", erro,
+                        primeira.registros, primeira.totalCentavos / 100.0, esperado / 100.0, primeira.marcados);
+            }
+        }
+        anterior = primeira;
+        leitor->versoes++;
+    }
+    return NULL;
+}
+
+// Acrescenta registros: publicação de um registro anexado
+static void* escrever_cadastros(void* arg) {
+    Escritor* escritor = (Escritor*)arg;
+    GeradorAleatorio aleatorio;
+    gerador_init(&aleatorio, escritor->semente);
+    while (!atomic_load(escritor->parar)) {
+        Hardware hw;
+        gerador_hardware(&aleatorio, 0, &hw);
+        sistema_cadastrar_hardware(escritor->sistema, hw.nome, hw.fabricante, hw.tipo, &hw.dataCompra,
+                                   VALOR_ACRESCIMO, hw.vidaUtilAnos);
+        escritor->alteracoes++;
+    }
+    return NULL;
+}
+
+// Alterna manutenção avulsa (um registro substituído) e lotes (versão sincronizada inteira), com
+// uma atualização de obsoletos de vez em quando
+static void* escrever_manutencoes(void* arg) {
+    Escritor* escritor = (Escritor*)arg;
+    GeradorAleatorio aleatorio;
+    gerador_init(&aleatorio, escritor->semente);
+    EventoManutencao lote[EVENTOS_POR_LOTE];
+    Data hoje = {1, 7, 2026};
+    for (long long rodada = 0; !atomic_load(escritor->parar); rodada++) {
+        const VersaoInventario* versao = sistema_obter_versao(escritor->sistema);
+        int maiorId = versao->numRegistros;
+        versao_liberar(versao);
+
+        Data data = {gerador_intervalo(&aleatorio, 1, 28), gerador_intervalo(&aleatorio, 1, 12),
+                     ANO_MARCADO + (int)(rodada / 100)};
+        if (rodada % 2 == 0) {
+            sistema_registrar_manutencao(escritor->sistema, gerador_intervalo(&aleatorio, 1, maiorId), &data);
+        } else {
+            for (int i = 0; i < EVENTOS_POR_LOTE; i++) {
+                lote[i].id = gerador_intervalo(&aleatorio, 1, maiorId);
+                lote[i].data = data;
+            }
+            sistema_aplicar_manutencoes(escritor->sistema, lote, EVENTOS_POR_LOTE);
+        }
+        if (rodada % 50 == 0) sistema_atualizar_status_obsoleto(escritor->sistema, &hoje);
+        escritor->alteracoes++;
+    }
+    return NULL;
+}
+
+int main(int argc, char** argv) {
+    int numLeitores = 4;
+    int segundos = 5;
+    int tamanho = 20000;
+    unsigned long long semente = 20240601ULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--leitores") == 0 && i + 1 < argc) {
+            numLeitores = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--segundos") == 0 && i + 1 < argc) {
+            segundos = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--semente") == 0 && i + 1 < argc) {
+            semente = strtoull(argv[++i], NULL, 10);
+        } else if (atoi(argv[i]) > 0) {
+            tamanho = atoi(argv[i]);
+        } else {
+            fprintf(stderr, "Argumento inválido: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (numLeitores < 1) numLeitores = 1;
+    if (numLeitores > MAX_LEITORES) numLeitores = MAX_LEITORES;
+    if (segundos < 1) segundos = 1;
+
+    // Cadastros e relatórios escrevem em stdout; só o resultado da verificação interessa
+    cronometro_definir_console(false);
+    if (!freopen(DISPOSITIVO_NULO, "w", stdout)) {
+        fprintf(stderr, "Falha ao redirecionar a saída padrão\n");
+        return 1;
+    }
+
+    // Sem repositório: as alterações ficam em memória e o teste mede só publicação e leitura
+    SistemaInventario sistema;
+    sistema_init(&sistema, NULL);
+    GeradorAleatorio aleatorio;
+    gerador_init(&aleatorio, semente);
+    long long totalInicialCentavos = 0;
+    for (int i = 0; i < tamanho; i++) {
+        Hardware hw;
+        gerador_hardware(&aleatorio, i + 1, &hw);
+        sistema_cadastrar_hardware(&sistema, hw.nome, hw.fabricante, hw.tipo, &hw.dataCompra,
+                                   hw.valorCompra, hw.vidaUtilAnos);
+        totalInicialCentavos += centavos(hw.valorCompra);
+    }
+
+    atomic_bool parar;
+    atomic_init(&parar, false);
+    Leitor leitores[MAX_LEITORES];
+    pthread_t threadsLeitores[MAX_LEITORES];
+    Escritor escritores[2] = {{&sistema, &parar, semente + 1, 0}, {&sistema, &parar, semente + 2, 0}};
+    pthread_t threadsEscritores[2];
+
+    fprintf(stderr, "[ESTRESSE] %d registros, %d leitores, 2 escritores, %d s\n", tamanho, numLeitores, segundos);
+    for (int l = 0; l < numLeitores; l++) {
+        leitores[l] = (Leitor){&sistema, &parar, tamanho, totalInicialCentavos, 0, 0};
+        pthread_create(&threadsLeitores[l], NULL, ler_versoes, &leitores[l]);
+    }
+    pthread_create(&threadsEscritores[0], NULL, escrever_cadastros, &escritores[0]);
+    pthread_create(&threadsEscritores[1], NULL, escrever_manutencoes, &escritores[1]);
+
+    long long inicio = tempo_monotonico_ns();
+    while (tempo_monotonico_ns() - inicio < (long long)segundos * 1000000000LL) {
+        // Relatórios reais sobre a versão publicada, concorrendo com os escritores
+        Data hoje = {1, 7, 2026};
+        sistema_identificar_obsoletos(&sistema, &hoje);
+        sistema_relatorio_manutencao_pendente(&sistema, &hoje, 12);
+    }
+    atomic_store(&parar, true);
+
+    for (int e = 0; e < 2; e++) pthread_join(threadsEscritores[e], NULL);
+    long long versoes = 0;
+    long long inconsistencias = 0;
+    for (int l = 0; l < numLeitores; l++) {
+        pthread_join(threadsLeitores[l], NULL);
+        versoes += leitores[l].versoes;
+        inconsistencias += leitores[l].inconsistencias;
+    }
+
+    // Depois de parar, a versão final tem que bater com a lista do escritor
+    const VersaoInventario* final = sistema_obter_versao(&sistema);
+    Resumo resumo = resumir(final);
+    if (resumo.registros != sistema.inventario.size) {
+        fprintf(stderr, "[ESTRESSE] versão final com %d registros; a lista tem %d\n", resumo.registros, sistema.inventario.size);
+        inconsistencias++;
+    }
+    versao_liberar(final);
+
+    fprintf(stderr, "[ESTRESSE] %lld versões verificadas; %lld cadastros e %lld rodadas de manutenção; %lld inconsistências\n",
+            versoes, escritores[0].alteracoes, escritores[1].alteracoes, inconsistencias);
+    sistema_destroy(&sistema);
+    return inconsistencias == 0 ? 0 : 1;
+}
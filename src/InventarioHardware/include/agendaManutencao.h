@@ -0,0 +1,37 @@
+#ifndef AGENDA_MANUTENCAO_H
+#define AGENDA_MANUTENCAO_H
+
+#include "data.h"
+#include "linkedList.h"
+#include "mapaInt.h"
+#include <stdbool.h>
+
+typedef struct {
+    Data ultimaManutencao;
+    Node* no;
+    int sequencia;      // posição do equipamento na lista, para devolver resultados na ordem original
+} EntradaManutencao;
+
+// Min-heap indexado por data da última manutenção, com mapa id -> posição no heap
+typedef struct {
+    EntradaManutencao* heap;
+    int tamanho;
+    int capacidade;
+    int proximaSequencia;
+    MapaInt posicoes;
+} AgendaManutencao;
+
+int meses_desde(const Data* inicio, const Data* hoje);
+Data data_vencimento_manutencao(const Data* ultimaManutencao, int mesesLimite);
+void agenda_manutencao_init(AgendaManutencao* agenda);
+void agenda_manutencao_destruir(AgendaManutencao* agenda);
+bool agenda_manutencao_construir(AgendaManutencao* agenda, LinkedList* list);
+bool agenda_manutencao_restaurar(AgendaManutencao* agenda, const EntradaManutencao* entradas, int tamanho, int proximaSequencia);
+bool agenda_manutencao_registrar(AgendaManutencao* agenda, Node* no);
+Node* agenda_manutencao_buscar(const AgendaManutencao* agenda, int id);
+void agenda_manutencao_atualizar(AgendaManutencao* agenda, int id);
+// O vetor em *resultado é liberado pelo chamador com mem_liberar
+int agenda_manutencao_vencidos(const AgendaManutencao* agenda, const Data* hoje, int mesesLimite, Node*** resultado);
+int agenda_manutencao_proximos(const AgendaManutencao* agenda, const Data* hoje, int mesesLimite, int quantidade, Node*** resultado);
+
+#endif
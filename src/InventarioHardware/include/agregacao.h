@@ -0,0 +1,61 @@
+#ifndef AGREGACAO_H
+#define AGREGACAO_H
+
+#include "data.h"
+#include "hardware.h"
+#include "threadPool.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// Campos de agrupamento, combináveis com '|'
+typedef enum {
+    AGRUPAR_TIPO = 1 << 0,
+    AGRUPAR_FABRICANTE = 1 << 1,
+    AGRUPAR_ANO_COMPRA = 1 << 2,
+    AGRUPAR_MES_COMPRA = 1 << 3,
+    AGRUPAR_OBSOLETO = 1 << 4
+} CampoAgrupamento;
+
+typedef struct {
+    double soma;
+    double minimo;
+    double maximo;
+} Estatistica;
+
+typedef struct {
+    // Chave do grupo; só os campos selecionados são significativos
+    TipoHardware tipo;
+    char fabricante[100];
+    int anoCompra;
+    int mesCompra;
+    bool obsoleto;
+
+    long quantidade;
+    long manutencaoPendente;
+    Estatistica valor;
+    Estatistica depreciacao;
+    Estatistica idadeAnos;
+} GrupoAgregado;
+
+typedef struct {
+    int campos;
+    Data hoje;
+    int mesesLimite;        // limite para contar manutenção pendente; 0 desliga a contagem
+
+    GrupoAgregado* grupos;
+    int numGrupos;
+    int capacidadeGrupos;
+    int* tabela;            // índice do grupo + 1, 0 = vazio
+    size_t capacidadeTabela;
+} Agregacao;
+
+void agregacao_init(Agregacao* agregacao, int campos, const Data* hoje, int mesesLimite);
+void agregacao_liberar(Agregacao* agregacao);
+bool agregacao_adicionar(Agregacao* agregacao, const Hardware* hw);
+bool agregacao_mesclar(Agregacao* destino, const Agregacao* origem);
+bool agregacao_executar(Agregacao* agregacao, const Hardware* const* itens, int numItens, ThreadPool* pool);
+void agregacao_ordenar(Agregacao* agregacao);
+double estatistica_media(const Estatistica* estatistica, long quantidade);
+void agregacao_imprimir(const Agregacao* agregacao);
+
+#endif
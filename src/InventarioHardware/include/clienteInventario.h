@@ -0,0 +1,32 @@
+#ifndef CLIENTE_INVENTARIO_H
+#define CLIENTE_INVENTARIO_H
+
+#include "pedidoInventario.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Cliente do servidor do inventário (servidorInventario.h). Os pedidos enfileirados só vão
+// para o socket quando uma resposta é esperada, então vários pedidos seguidos saem num único
+// envio e o servidor responde todos sem esperar ida e volta entre eles.
+typedef struct {
+    int fd;
+    uint32_t proximaSequencia;
+    uint32_t sequenciaEsperada;     // sequência da próxima resposta
+    TextoBuffer envio;              // pedidos enfileirados ainda não enviados
+    TextoBuffer recebido;
+} ClienteInventario;
+
+bool cliente_conectar(ClienteInventario* cliente, const char* caminhoSocket);
+void cliente_desconectar(ClienteInventario* cliente);
+
+// Pipelining: enfileirar não espera; cada cliente_receber devolve a resposta do pedido
+// enfileirado mais antigo que ainda não foi respondido
+bool cliente_enfileirar(ClienteInventario* cliente, const PedidoInventario* pedido);
+bool cliente_receber(ClienteInventario* cliente, RespostaInventario* resposta);
+
+bool cliente_executar(ClienteInventario* cliente, const PedidoInventario* pedido, RespostaInventario* resposta);
+// Lote: um envio com todos os pedidos; respostas[i] corresponde a pedidos[i]
+bool cliente_executar_lote(ClienteInventario* cliente, const PedidoInventario* pedidos, int quantidade,
+                           RespostaInventario* respostas);
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef COMPRESSAO_LZ_H
+#define COMPRESSAO_LZ_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Compressor LZ77 no formato de sequências do LZ4 (token com comprimentos de literal e de cópia,
+// literais, deslocamento de 16 bits). Rápido para descomprimir; não precisa de biblioteca externa.
+
+// Tamanho de saída que lz_comprimir exige para uma entrada de tamanho bytes
+size_t lz_limite_comprimido(size_t tamanho);
+
+// Devolve o tamanho comprimido, ou 0 se capacidade for menor que lz_limite_comprimido(tamanho)
+size_t lz_comprimir(const unsigned char* entrada, size_t tamanho, unsigned char* saida, size_t capacidade);
+
+// false se os dados estiverem corrompidos ou não produzirem exatamente tamanhoSaida bytes
+bool lz_descomprimir(const unsigned char* entrada, size_t tamanho, unsigned char* saida, size_t tamanhoSaida);
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef CONTADORES_HW_H
+#define CONTADORES_HW_H
+
+#include <stdbool.h>
+
+// Contadores de desempenho do processador (Linux perf_event_open), abertos como um grupo que o kernel
+// agenda junto. Contam a thread que chamou contadores_hw_iniciar e as threads que ela criar depois
+// (como as do pool); se o kernel recusar a herança, só a thread chamadora, e contadores_hw_escopo diz
+// qual dos dois. Em outros sistemas, ou sem permissão, ficam desligados.
+typedef enum {
+    CONTADOR_CICLOS,
+    CONTADOR_INSTRUCOES,
+    CONTADOR_CACHE_MISSES,
+    CONTADOR_BRANCH_MISSES,
+    CONTADOR_PAGE_FAULTS,
+    NUM_CONTADORES_HW
+} ContadorHw;
+
+// Valores acumulados; -1 indica contador indisponível. Os tempos do grupo habilitado e efetivamente
+// contando permitem corrigir a variação quando o kernel reveza os contadores com outros eventos.
+typedef struct {
+    long long valores[NUM_CONTADORES_HW];
+    long long habilitadoNs;
+    long long contandoNs;
+} LeituraHw;
+
+bool contadores_hw_iniciar();
+void contadores_hw_encerrar();
+bool contadores_hw_ativos();
+void contadores_hw_ler(LeituraHw* leitura);
+// Variação entre duas leituras, escalada por habilitado/contando; -1 onde não há medição
+void contadores_hw_variacao(const LeituraHw* inicio, const LeituraHw* fim, long long* variacoes);
+// "processo" ou "thread chamadora"
+const char* contadores_hw_escopo();
+const char* contador_hw_nome(ContadorHw contador);
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// CRC32C (polinômio de Castagnoli), o mesmo da instrução crc32 do SSE4.2. Usa a instrução quando a
+// CPU tem suporte e, caso contrário, uma tabela slicing-by-8.
+
+// Incremental: comece com crc = 0 e passe o resultado de uma chamada para a seguinte
+uint32_t crc32c_atualizar(uint32_t crc, const void* dados, size_t tamanho);
+
+// true se o cálculo está usando a instrução da CPU
+bool crc32c_acelerado(void);
+
+#endif
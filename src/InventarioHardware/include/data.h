@@ -8,6 +8,7 @@ typedef struct {
 } Data;
 
 Data obter_data_atual();
+// Retorna string alocada com mem_alocar; liberar com mem_liberar
 char* data_to_string(const Data* data);
 bool data_from_string(const char* str, Data* data);
 bool data_menor_que(const Data* a, const Data* b);
@@ -0,0 +1,12 @@
+#ifndef DEPRECIACAO_H
+#define DEPRECIACAO_H
+
+#include "data.h"
+#include "hardware.h"
+
+// Depreciação linear por anos completos desde a compra: (valor / vida) * anos, e o valor todo
+// ao fim da vida útil (ou no primeiro aniversário, se a vida útil não for positiva)
+double depreciacao_acumulada(double valorCompra, int vidaUtilAnos, const Data* dataCompra, const Data* hoje);
+double calcular_depreciacao(const Hardware* hw, const Data* hoje);
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef GERADOR_H
+#define GERADOR_H
+
+#include "linkedList.h"
+#include <stdint.h>
+
+// Gerador pseudoaleatório determinístico (xorshift64*), independente da libc
+typedef struct {
+    uint64_t estado;
+} GeradorAleatorio;
+
+void gerador_init(GeradorAleatorio* gerador, uint64_t semente);
+uint64_t gerador_proximo(GeradorAleatorio* gerador);
+int gerador_intervalo(GeradorAleatorio* gerador, int minimo, int maximo);
+double gerador_uniforme(GeradorAleatorio* gerador);
+void gerador_hardware(GeradorAleatorio* gerador, int id, Hardware* hw);
+void gerador_inventario(LinkedList* list, int quantidade, uint64_t semente);
+
+#endif
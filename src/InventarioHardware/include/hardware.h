@@ -13,6 +13,8 @@ typedef enum {
     OUTRO
 } TipoHardware;
 
+#define NUM_TIPOS_HARDWARE (OUTRO + 1)
+
 typedef struct {
     int id;
     char nome[100];
@@ -27,6 +29,7 @@ typedef struct {
 
 char* tipo_to_string(TipoHardware tipo);
 TipoHardware string_to_tipo(const char* str);
+// hardware_to_csv e hardware_to_string alocam com mem_alocar; liberar com mem_liberar
 char* hardware_to_csv(const Hardware* hw);
 bool hardware_from_csv(const char* linha, Hardware* hw);
 char* hardware_to_string(const Hardware* hw);
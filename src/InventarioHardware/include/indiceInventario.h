@@ -0,0 +1,42 @@
+#ifndef INDICE_INVENTARIO_H
+#define INDICE_INVENTARIO_H
+
+#include "hardware.h"
+#include "mapaInt.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+// Campos com que a listagem por tipo e os relatórios de depreciação, obsoletos e manutenção pendente
+// filtram e somam, e posição da linha no CSV; nome e fabricante ficam no arquivo
+typedef struct {
+    long long deslocamento;
+    int id;
+    TipoHardware tipo;
+    Data dataCompra;
+    Data ultimaManutencao;
+    double valorCompra;
+    int vidaUtilAnos;
+} EntradaIndice;
+
+// Índice residente do CSV para carregamento sob demanda: a abertura só lê os campos acima,
+// e o registro completo de cada linha é lido do arquivo no primeiro acesso e guardado em cache
+typedef struct {
+    FILE* arquivo;
+    long long posicaoArquivo;   // início da próxima leitura sequencial; nela o fseek é dispensado
+    EntradaIndice* entradas;
+    int tamanho;
+    int capacidade;
+    int maiorId;
+    MapaInt porId;          // id -> posição em entradas
+    MapaInt cache;          // posição -> Hardware* já lido
+} IndiceInventario;
+
+void indice_inventario_init(IndiceInventario* indice);
+bool indice_inventario_construir(IndiceInventario* indice, const char* arquivo);
+void indice_inventario_liberar(IndiceInventario* indice);
+const Hardware* indice_inventario_obter(IndiceInventario* indice, int posicao);
+// Lê o registro da linha em destino sem guardá-lo em cache, para relatórios que passam por todas as linhas
+bool indice_inventario_ler(IndiceInventario* indice, int posicao, Hardware* destino);
+const Hardware* indice_inventario_buscar(IndiceInventario* indice, int id);
+
+#endif
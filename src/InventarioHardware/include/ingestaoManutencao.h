@@ -0,0 +1,65 @@
+#ifndef INGESTAO_MANUTENCAO_H
+#define INGESTAO_MANUTENCAO_H
+
+#include "data.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// sistemaInventario.h inclui este cabeçalho para embutir a ingestão no sistema
+typedef struct SistemaInventario SistemaInventario;
+
+typedef struct {
+    int id;
+    Data data;
+} EventoManutencao;
+
+// Fila circular limitada, sem travas, com vários produtores e um consumidor. Cada célula guarda um
+// número de sequência: igual à posição quando está livre para o produtor daquela volta, posição + 1
+// quando o evento já foi escrito. Produtores disputam a cauda com compare-and-swap; o consumidor é
+// único e avança a cabeça sem operações atômicas de leitura-modificação-escrita.
+typedef struct {
+    _Atomic size_t sequencia;
+    EventoManutencao evento;
+} CelulaFila;
+
+typedef struct {
+    CelulaFila* celulas;
+    size_t mascara;
+    _Alignas(64) _Atomic size_t cauda;     // separadas em linhas de cache diferentes
+    _Alignas(64) size_t cabeca;
+} FilaManutencao;
+
+// capacidade é arredondada para potência de 2
+bool fila_manutencao_init(FilaManutencao* fila, size_t capacidade);
+void fila_manutencao_destruir(FilaManutencao* fila);
+// false com a fila cheia
+bool fila_manutencao_publicar(FilaManutencao* fila, const EventoManutencao* evento);
+// Só o consumidor; copia até maximo eventos para lote e devolve quantos
+int fila_manutencao_consumir(FilaManutencao* fila, EventoManutencao* lote, int maximo);
+
+// Ingestão de eventos de manutenção: qualquer thread envia, e uma thread aplicadora esvazia a fila em
+// lotes de até loteMaximo com sistema_aplicar_manutencoes (uma gravação por lote).
+typedef struct {
+    SistemaInventario* sistema;
+    FilaManutencao fila;
+    EventoManutencao* lote;
+    int loteMaximo;
+    pthread_t aplicador;
+    atomic_bool encerrar;
+    atomic_llong recusados;         // envios com a fila cheia
+    // Escritos só pelo aplicador; leia depois de ingestao_encerrar
+    long long eventosAplicados;
+    long long registrosAlterados;
+    long long lotes;
+    long long falhasGravacao;
+} IngestaoManutencao;
+
+bool ingestao_iniciar(IngestaoManutencao* ingestao, SistemaInventario* sistema, size_t capacidadeFila, int loteMaximo);
+// Não bloqueia; false com a fila cheia, e o produtor decide se tenta de novo
+bool ingestao_enviar(IngestaoManutencao* ingestao, int id, const Data* data);
+// Chamar depois que os produtores pararam: aplica o que resta na fila e encerra o aplicador
+void ingestao_encerrar(IngestaoManutencao* ingestao);
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef LEITOR_SEGMENTO_H
+#define LEITOR_SEGMENTO_H
+
+#include "data.h"
+#include "hardware.h"
+#include "segmentoInventario.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// Leitura do segmento compartilhado por outros processos. Depois de aberto, cada consulta só lê a
+// memória mapeada, sem chamadas ao sistema; a exceção é remapear quando o escritor aumenta o
+// segmento. Toda consulta é repetida até obter uma cópia consistente (seqlock) e devolve false
+// se o escritor não terminar a escrita em tempo razoável.
+typedef struct {
+    const unsigned char* base;
+    size_t tamanho;
+    int descritor;          // mantido aberto para remapear quando o segmento cresce
+} LeitorSegmento;
+
+bool leitor_segmento_abrir(LeitorSegmento* leitor, const char* nome);
+void leitor_segmento_fechar(LeitorSegmento* leitor);
+// false depois que o escritor encerrou; os dados continuam sendo os da última versão
+bool leitor_segmento_ativo(LeitorSegmento* leitor);
+
+int leitor_segmento_total(LeitorSegmento* leitor);
+bool leitor_segmento_buscar(LeitorSegmento* leitor, int id, Hardware* destino);
+// Copia até capacidade registros de uma mesma versão; devolve o total de registros ou -1
+int leitor_segmento_copiar(LeitorSegmento* leitor, Hardware* destino, int capacidade);
+
+// Mesmas regras dos relatórios: obsoleto a partir da compra + vida útil; manutenção pendente com
+// pelo menos mesesLimite meses desde a última. As verificações por id devolvem false se o id não existe.
+bool leitor_segmento_obsoleto(LeitorSegmento* leitor, int id, const Data* hoje, bool* obsoleto);
+bool leitor_segmento_manutencao_pendente(LeitorSegmento* leitor, int id, const Data* hoje, int mesesLimite,
+                                         bool* pendente);
+int leitor_segmento_contar_obsoletos(LeitorSegmento* leitor, const Data* hoje);
+int leitor_segmento_contar_pendentes(LeitorSegmento* leitor, const Data* hoje, int mesesLimite);
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef MAPA_INT_H
+#define MAPA_INT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Tabela hash com endereçamento aberto (sondagem linear) de chave int para valor inteiro/ponteiro
+typedef struct {
+    int* chaves;
+    intptr_t* valores;
+    unsigned char* ocupado;
+    size_t capacidade;
+    size_t tamanho;
+} MapaInt;
+
+void mapa_int_init(MapaInt* mapa);
+void mapa_int_destruir(MapaInt* mapa);
+void mapa_int_limpar(MapaInt* mapa);
+bool mapa_int_reservar(MapaInt* mapa, size_t quantidade);
+bool mapa_int_inserir(MapaInt* mapa, int chave, intptr_t valor);
+bool mapa_int_buscar(const MapaInt* mapa, int chave, intptr_t* valor);
+bool mapa_int_remover(MapaInt* mapa, int chave);
+
+#endif
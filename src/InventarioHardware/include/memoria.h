@@ -0,0 +1,47 @@
+#ifndef MEMORIA_H
+#define MEMORIA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Contabilização de alocações por subsistema. Cada bloco leva um cabeçalho com tamanho e
+// subsistema; blocos obtidos com mem_* devem ser liberados com mem_liberar.
+// Compilar com -DINVENTARIO_SEM_CONTAGEM_MEMORIA usa malloc/free diretamente.
+typedef enum {
+    MEMORIA_REGISTROS,      // nós da lista de inventário
+    MEMORIA_TEXTO,          // strings formatadas (datas, CSV, descrições)
+    MEMORIA_INDICES,        // estruturas auxiliares persistentes (heaps, mapas, projeção)
+    MEMORIA_TEMPORARIA,     // buffers de relatórios e vetores de trabalho
+    MEMORIA_OUTROS,
+    NUM_SUBSISTEMAS_MEMORIA
+} SubsistemaMemoria;
+
+typedef struct {
+    long long alocacoes;
+    long long liberacoes;
+    long long bytesAlocados;
+    long long bytesVivos;
+    long long picoBytes;
+} EstatisticaMemoria;
+
+const char* subsistema_memoria_nome(SubsistemaMemoria subsistema);
+void memoria_obter_estatisticas(SubsistemaMemoria subsistema, EstatisticaMemoria* estatistica);
+
+#ifdef INVENTARIO_SEM_CONTAGEM_MEMORIA
+
+#include <stdlib.h>
+#define mem_alocar(subsistema, tamanho) malloc(tamanho)
+#define mem_alocar_zerado(subsistema, quantidade, tamanho) calloc((quantidade), (tamanho))
+#define mem_realocar(subsistema, ponteiro, tamanho) realloc((ponteiro), (tamanho))
+#define mem_liberar(ponteiro) free(ponteiro)
+
+#else
+
+void* mem_alocar(SubsistemaMemoria subsistema, size_t tamanho);
+void* mem_alocar_zerado(SubsistemaMemoria subsistema, size_t quantidade, size_t tamanho);
+void* mem_realocar(SubsistemaMemoria subsistema, void* ponteiro, size_t tamanho);
+void mem_liberar(void* ponteiro);
+
+#endif
+
+#endif
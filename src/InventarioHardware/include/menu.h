@@ -5,5 +5,13 @@
 
 void menu_principal();
 void menu_principal(Repository* repo);
+void menu_definir_snapshot(const char* imagem, const char* origem);
+void menu_definir_carregamento_lazy(const char* origem);
+// Com um servidor definido, o menu envia os pedidos pelo socket em vez de carregar o inventário
+void menu_definir_servidor(const char* caminhoSocket);
+// Publica o inventário no segmento de memória compartilhada nome para leitores locais (leitorSegmento.h)
+void menu_definir_segmento(const char* nome);
+// Carrega o inventário e o atende pelo socket até SIGINT/SIGTERM (servidorInventario.h)
+void menu_servir(Repository* repo, const char* caminhoSocket);
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,27 @@
+#ifndef METRICAS_H
+#define METRICAS_H
+
+#include "contadoresHw.h"
+#include <stdbool.h>
+
+// Registro de latências por operação em histogramas log-lineares (32 sub-baldes por
+// potência de 2, erro relativo < 3%). Compilar com -DINVENTARIO_SEM_METRICAS remove tudo.
+#ifdef INVENTARIO_SEM_METRICAS
+
+#define metricas_registrar(operacao, microssegundos) ((void)0)
+#define metricas_registrar_contadores(operacao, variacoes, registros) ((void)0)
+#define metricas_imprimir() ((void)0)
+#define metricas_exportar_json(caminho) (true)
+#define metricas_limpar() ((void)0)
+
+#else
+
+void metricas_registrar(const char* operacao, double microssegundos);
+void metricas_registrar_contadores(const char* operacao, const long long* variacoes, long registros);
+void metricas_imprimir();
+bool metricas_exportar_json(const char* caminho);
+void metricas_limpar();
+
+#endif
+
+#endif
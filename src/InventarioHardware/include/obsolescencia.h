@@ -0,0 +1,35 @@
+#ifndef OBSOLESCENCIA_H
+#define OBSOLESCENCIA_H
+
+#include "data.h"
+#include "linkedList.h"
+#include <stdbool.h>
+
+// Equipamento ainda ativo e a data em que ele passa a ser obsoleto
+typedef struct {
+    Data dataObsolescencia;
+    Node* no;
+} EventoObsolescencia;
+
+// Min-heap das próximas datas de obsolescência. Avançar a data de referência
+// só visita os equipamentos cuja data já passou.
+typedef struct {
+    EventoObsolescencia* heap;
+    int tamanho;
+    int capacidade;
+    Data referencia;
+    bool inicializado;
+    int totalObsoletos;
+} MonitorObsolescencia;
+
+Data data_obsolescencia(const Hardware* hw);
+// Mesma regra sobre os campos soltos, para quem não tem um Hardware (colunas, índice)
+Data data_obsolescencia_campos(const Data* dataCompra, int vidaUtilAnos);
+void monitor_obsolescencia_init(MonitorObsolescencia* monitor);
+void monitor_obsolescencia_destruir(MonitorObsolescencia* monitor);
+void monitor_obsolescencia_invalidar(MonitorObsolescencia* monitor);
+void monitor_obsolescencia_registrar(MonitorObsolescencia* monitor, Node* no);
+int monitor_obsolescencia_avancar(MonitorObsolescencia* monitor, LinkedList* list, const Data* hoje);
+int monitor_obsolescencia_total(const MonitorObsolescencia* monitor);
+
+#endif
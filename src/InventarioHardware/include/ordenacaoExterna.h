@@ -0,0 +1,30 @@
+#ifndef ORDENACAO_EXTERNA_H
+#define ORDENACAO_EXTERNA_H
+
+#include "hardware.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef enum {
+    ORDENAR_DATA_COMPRA,
+    ORDENAR_DATA_MANUTENCAO
+} ChaveOrdenacao;
+
+// Fonte devolve o próximo registro em *hw, ou false quando acabar; consumidor recebe os registros já em ordem
+typedef bool (*FonteRegistros)(void* contexto, Hardware* hw);
+typedef void (*ConsumidorRegistros)(void* contexto, const Hardware* hw);
+
+typedef struct {
+    long registros;
+    int runs;               // runs gravadas em disco (0 quando tudo coube no orçamento)
+    int passadas;           // passadas de intercalação, contando a final
+} EstatisticaOrdenacaoExterna;
+
+#define ORCAMENTO_ORDENACAO_PADRAO ((size_t)64 * 1024 * 1024)
+
+// Ordenação externa estável: runs do tamanho do orçamento são ordenadas em memória, gravadas
+// em arquivos temporários num formato binário compacto e intercaladas (k vias) direto para o consumidor
+bool ordenacao_externa(FonteRegistros fonte, void* contextoFonte, ChaveOrdenacao chave, size_t orcamentoBytes,
+                       ConsumidorRegistros consumidor, void* contextoConsumidor, EstatisticaOrdenacaoExterna* estatistica);
+
+#endif
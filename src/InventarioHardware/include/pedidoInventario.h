@@ -0,0 +1,98 @@
+#ifndef PEDIDO_INVENTARIO_H
+#define PEDIDO_INVENTARIO_H
+
+#include "hardware.h"
+#include "ordenacaoExterna.h"
+#include "sistemaInventario.h"
+#include "utils.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Operações do inventário como pedidos: o menu executa um pedido no sistema local ou o envia
+// ao servidor, que executa o mesmo pedido no sistema dele e devolve a saída produzida.
+typedef enum {
+    PEDIDO_CADASTRAR = 1,
+    PEDIDO_REGISTRAR_MANUTENCAO,
+    PEDIDO_CONSULTAR,
+    PEDIDO_BUSCAR,                  // devolve o registro em vez de imprimi-lo
+    PEDIDO_LISTAR,
+    PEDIDO_LISTAR_POR_TIPO,
+    PEDIDO_LISTAR_POR_DATA_COMPRA,
+    PEDIDO_LISTAR_POR_DATA_MANUTENCAO,
+    PEDIDO_LISTAR_ORDENADO_EXTERNO,
+    PEDIDO_DEPRECIACAO,
+    PEDIDO_OBSOLETOS,
+    PEDIDO_MANUTENCAO_PENDENTE,
+    PEDIDO_PROXIMAS_MANUTENCOES,
+    PEDIDO_AGREGADO,
+    PEDIDO_PROJECAO_VALOR,
+    PEDIDO_VALOR_EM_DATA,
+    PEDIDO_PREVISAO_SUBSTITUICAO,
+    PEDIDO_USO_MEMORIA,
+    PEDIDO_EXPORTAR_COLUNAR,
+    PEDIDO_ENFILEIRAR_MANUTENCAO,   // volta antes da gravação; aplicada em lote pela ingestão
+    NUM_OPERACOES_PEDIDO
+} OperacaoPedido;
+
+// Só os campos que a operação usa são considerados; os demais ficam zerados
+typedef struct {
+    OperacaoPedido operacao;
+    Data hoje;                      // data base dos relatórios
+    Data data;                      // compra no cadastro, manutenção ou data da avaliação
+    int id;
+    TipoHardware tipo;
+    int meses;
+    int quantidade;
+    int anos;
+    int campos;                     // AGRUPAR_* do relatório agregado
+    int vidaUtilAnos;
+    double valorCompra;
+    ChaveOrdenacao chave;
+    long long orcamentoBytes;
+    char nome[100];
+    char fabricante[100];
+    char arquivo[256];
+} PedidoInventario;
+
+typedef struct {
+    bool sucesso;
+    TextoBuffer saida;              // o que a operação imprimiu em stdout
+    TextoBuffer erros;              // e em stderr
+    bool temRegistro;
+    Hardware registro;              // PEDIDO_BUSCAR
+} RespostaInventario;
+
+void pedido_init(PedidoInventario* pedido, OperacaoPedido operacao, const Data* hoje);
+const char* pedido_nome(OperacaoPedido operacao);
+
+// Executa no sistema; a saída vai para stdout/stderr como nas chamadas diretas.
+// registro (pode ser NULL) recebe o resultado de PEDIDO_BUSCAR.
+bool pedido_executar(SistemaInventario* sistema, const PedidoInventario* pedido, Hardware* registro);
+
+void resposta_init(RespostaInventario* resposta);
+void resposta_liberar(RespostaInventario* resposta);
+
+// Formato no fio (socket Unix local, então na ordem de bytes da máquina): cabeçalho de
+// QUADRO_CABECALHO bytes com tamanho do corpo (uint32), sequência (uint32) e operação ou status
+// (uint32), seguido do corpo. Vários quadros podem seguir no mesmo envio (pipelining); as
+// respostas voltam na ordem dos pedidos, com a sequência do pedido correspondente.
+#define QUADRO_CABECALHO 12
+#define QUADRO_PEDIDO_MAXIMO 4096
+#define QUADRO_RESPOSTA_MAXIMO ((uint32_t)1 << 30)
+
+typedef struct {
+    uint32_t tamanho;
+    uint32_t sequencia;
+    uint32_t codigo;                // operação no pedido, 1/0 (sucesso) na resposta
+} CabecalhoQuadro;
+
+bool pedido_codificar(TextoBuffer* destino, const PedidoInventario* pedido, uint32_t sequencia);
+bool resposta_codificar(TextoBuffer* destino, const RespostaInventario* resposta, uint32_t sequencia);
+
+// Lê o cabeçalho de um quadro; false se ainda não há QUADRO_CABECALHO bytes
+bool quadro_cabecalho(const char* dados, size_t disponivel, CabecalhoQuadro* cabecalho);
+bool pedido_decodificar(const CabecalhoQuadro* cabecalho, const char* corpo, PedidoInventario* pedido);
+bool resposta_decodificar(const CabecalhoQuadro* cabecalho, const char* corpo, RespostaInventario* resposta);
+
+#endif
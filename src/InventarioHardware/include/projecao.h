@@ -0,0 +1,43 @@
+#ifndef PROJECAO_H
+#define PROJECAO_H
+
+#include "data.h"
+#include "hardware.h"
+#include "linkedList.h"
+#include "threadPool.h"
+#include <stdbool.h>
+
+// Valor contábil da frota como função da data. Cada equipamento entra com o valor de compra
+// na data de compra e perde uma parcela da depreciação linear a cada aniversário da compra.
+// As variações ficam numa árvore de Fenwick indexada por dia (31 chaves por mês, 372 por ano),
+// o que preserva a comparação lexicográfica usada por data_menor_que e calcular_depreciacao.
+typedef struct {
+    int anoBase;
+    int numChaves;
+    double* variacoes;      // variação do valor em cada chave
+    double* fenwick;
+    bool construida;
+} ProjecaoValor;
+
+// Previsão de substituição: valor de compra de cada equipamento agrupado pelo mês
+// em que ele atinge o fim da vida útil e pelo tipo
+typedef struct {
+    int mesInicial;
+    int anoInicial;
+    int numMeses;
+    double* valores;                // numMeses x NUM_TIPOS_HARDWARE
+    long* quantidades;              // numMeses x NUM_TIPOS_HARDWARE
+    double atrasadoValor[NUM_TIPOS_HARDWARE];   // vida útil já encerrada na data base
+    long atrasadoQuantidade[NUM_TIPOS_HARDWARE];
+} PrevisaoSubstituicao;
+
+void projecao_init(ProjecaoValor* projecao);
+void projecao_liberar(ProjecaoValor* projecao);
+bool projecao_construir(ProjecaoValor* projecao, const LinkedList* list);
+double projecao_valor_em(const ProjecaoValor* projecao, const Data* data);
+bool projecao_curva_mensal(const ProjecaoValor* projecao, int mesInicial, int anoInicial, int numMeses, double* valores);
+bool previsao_substituicao_calcular(PrevisaoSubstituicao* previsao, const Hardware* const* itens, int numItens,
+                                    const Data* hoje, int numMeses, ThreadPool* pool);
+void previsao_substituicao_liberar(PrevisaoSubstituicao* previsao);
+
+#endif
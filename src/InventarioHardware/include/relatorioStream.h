@@ -0,0 +1,16 @@
+#ifndef RELATORIO_STREAM_H
+#define RELATORIO_STREAM_H
+
+#include "data.h"
+#include "repository.h"
+#include <stdbool.h>
+
+#define TAMANHO_LOTE_STREAM 256
+
+// Relatórios lidos em lotes pelo cursor do repositório, com memória constante: servem para
+// inventários arquivados que nunca são carregados. Saída no mesmo formato das versões do sistema.
+bool relatorio_stream_depreciacao(Repository* repo, const Data* hoje);
+bool relatorio_stream_obsoletos(Repository* repo, const Data* hoje);
+bool relatorio_stream_manutencao_pendente(Repository* repo, const Data* hoje, int mesesLimite);
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef REPOSITORIO_CACHE_H
+#define REPOSITORIO_CACHE_H
+
+#include "repository.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct {
+    long long acertos;
+    long long falhas;
+    long long invalidacoes;
+    size_t ocupacao;
+    size_t capacidade;
+} EstatisticaCache;
+
+// Decorador de leitura com LRU sobre qualquer repositório. Mantém os últimos registros lidos por
+// buscar_por_id; adicionar/atualizar atualizam a entrada e remover/salvar a invalidam.
+// O repositório interno passa a pertencer ao decorador e é destruído junto com ele.
+Repository* criar_repositorio_cache(Repository* interno, size_t capacidade);
+
+// Retorna false se repo não for um repositório com cache
+bool repositorio_cache_estatisticas(const Repository* repo, EstatisticaCache* estatistica);
+
+#endif
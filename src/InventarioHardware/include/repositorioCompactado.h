@@ -0,0 +1,15 @@
+#ifndef REPOSITORIO_COMPACTADO_H
+#define REPOSITORIO_COMPACTADO_H
+
+#include "repository.h"
+
+// Repositório em arquivo binário compactado, em blocos de até REGISTROS_POR_BLOCO registros.
+// Cada bloco guarda as colunas separadas: ids e datas em delta, tipo em um byte, fabricante por
+// dicionário do bloco, e o conjunto passa pelo compressor LZ embutido. O cabeçalho de cada bloco
+// traz a faixa de ids, então buscar_por_id só descomprime os blocos que podem conter o id, e um
+// CRC32C: bloco que não confere é relatado com as faixas de registros e de ids e pulado.
+#define REGISTROS_POR_BLOCO 4096
+
+Repository* criar_repositorio_compactado(const char* filename);
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef REPOSITORIO_PARTICIONADO_H
+#define REPOSITORIO_PARTICIONADO_H
+
+#include "repository.h"
+#include <stdbool.h>
+
+// Repositório com um CSV por TipoHardware ("<prefixo>_<TIPO>.csv"). carregar lê as partições em
+// paralelo e as intercala por id; adicionar/atualizar/remover reescrevem só a partição do registro;
+// salvar pula partições cujo conteúdo não mudou desde a última leitura ou gravação.
+Repository* criar_repositorio_particionado(const char* prefixo);
+
+// true se ao menos uma partição existe em disco
+bool repositorio_particionado_existe(const Repository* repo);
+
+// Grava nas partições o conteúdo de outro repositório (ex.: o CSV único) já carregado em list
+bool repositorio_particionado_importar(Repository* repo, const LinkedList* list);
+
+#endif
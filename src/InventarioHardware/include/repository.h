@@ -13,6 +13,14 @@ typedef struct RepositoryInterface {
     bool (*atualizar)(void* self, const Hardware* hw);
     bool (*remover)(void* self, int id);
     Hardware* (*buscar_por_id)(void* self, int id);
+    // Opcional: acrescenta à lista só os registros do tipo. NULL faz repositorio_carregar_tipo
+    // carregar tudo e filtrar.
+    bool (*carregar_tipo)(void* self, TipoHardware tipo, LinkedList* list);
+    // Leitura em lotes direto do armazenamento: cursor_proximo preenche até capacidade registros e
+    // devolve quantos leu (0 no fim, -1 em erro). Backends sem cursor deixam os três ponteiros NULL.
+    void* (*cursor_abrir)(void* self);
+    int (*cursor_proximo)(void* self, void* cursor, Hardware* lote, int capacidade);
+    void (*cursor_fechar)(void* self, void* cursor);
     void (*destruir)(void* self);
 } RepositoryInterface;
 
@@ -22,7 +30,16 @@ typedef struct {
     const RepositoryInterface* interface;
 } Repository;
 
+typedef struct {
+    Repository* repositorio;
+    void* estado;
+} CursorRepositorio;
+
 Repository* criar_repositorio_csv(const char* filename);
 void destruir_repositorio(Repository* repo);
+bool repositorio_carregar_tipo(Repository* repo, TipoHardware tipo, LinkedList* list);
+bool repositorio_cursor_abrir(Repository* repo, CursorRepositorio* cursor);
+int repositorio_cursor_proximo(CursorRepositorio* cursor, Hardware* lote, int capacidade);
+void repositorio_cursor_fechar(CursorRepositorio* cursor);
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,59 @@
+#ifndef SEGMENTO_INVENTARIO_H
+#define SEGMENTO_INVENTARIO_H
+
+#include "hardware.h"
+#include "versaoInventario.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Segmento de memória compartilhada POSIX com os registros do inventário, para processos locais
+// que só leem (leitorSegmento.h). Layout: cabeçalho, tabela de espalhamento id -> posição + 1
+// (0 = vazio, sondagem linear) e os registros na ordem da versão publicada, alinhados a 64 bytes.
+// Um único escritor altera o segmento dentro de um seqlock: sequencia fica ímpar durante a escrita,
+// e o leitor repete a leitura se a viu ímpar ou se ela mudou enquanto copiava.
+#define SEGMENTO_MAGICO 0x47455349u      // "ISEG"
+#define SEGMENTO_VERSAO_FORMATO 1
+
+typedef struct {
+    uint32_t magico;
+    uint32_t versaoFormato;
+    _Atomic uint64_t sequencia;
+    uint64_t tamanho;                   // bytes em uso; cresce quando a capacidade acaba
+    uint64_t deslocamentoTabela;
+    uint64_t deslocamentoRegistros;
+    int32_t capacidadeTabela;           // potência de 2
+    int32_t capacidade;                 // registros que cabem
+    int32_t numRegistros;
+    int32_t ativo;                      // 0 depois que o escritor encerra
+} CabecalhoSegmento;
+
+// Campos de tamanho fixo, independentes do layout de Hardware
+typedef struct {
+    int32_t id;
+    int32_t tipo;
+    Data dataCompra;
+    Data ultimaManutencao;
+    int32_t vidaUtilAnos;
+    int32_t obsoleto;
+    double valorCompra;
+    char nome[100];
+    char fabricante[100];
+} RegistroSegmento;
+
+uint32_t segmento_espalhar(int id, int32_t capacidadeTabela);
+
+// Lado escritor: só o processo dono do inventário (menu local ou servidor)
+typedef struct SegmentoInventario SegmentoInventario;
+
+// Cria (ou recria) o segmento nome (ex.: "/inventario"); NULL em falha ou fora de sistemas POSIX
+SegmentoInventario* segmento_criar(const char* nome, int capacidadeInicial);
+// Marca o segmento inativo e remove o nome; leitores já abertos mantêm a última versão
+void segmento_destruir(SegmentoInventario* segmento);
+// Regrava todos os registros da versão
+bool segmento_sincronizar(SegmentoInventario* segmento, const VersaoInventario* versao);
+// Grava um registro na posição da versão; posicao == número de registros acrescenta no fim
+bool segmento_gravar_registro(SegmentoInventario* segmento, int posicao, const Hardware* hw);
+size_t segmento_tamanho(const SegmentoInventario* segmento);
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef SERVIDOR_INVENTARIO_H
+#define SERVIDOR_INVENTARIO_H
+
+#include "sistemaInventario.h"
+#include <stdbool.h>
+
+// Modo servidor: um único processo mantém o inventário carregado e atende pedidos
+// (pedidoInventario.h) de clientes locais por um socket Unix. Um laço epoll faz a E/S de
+// todas as conexões; os pedidos completos de uma conexão formam um lote executado num worker
+// do pool do sistema, um lote por vez, e as respostas do lote saem num único envio. Enquanto
+// um relatório longo executa, o laço continua aceitando, lendo e enviando. Sem workers (um
+// núcleo), o laço executa o lote. Só no Linux; SIGINT ou SIGTERM encerram o laço depois do
+// lote em andamento e ficam bloqueados na volta, enquanto o chamador grava o inventário com
+// sistema_destroy.
+bool servidor_executar(SistemaInventario* sistema, const char* caminhoSocket);
+
+#endif
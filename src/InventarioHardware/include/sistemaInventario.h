@@ -1,30 +1,109 @@
 #ifndef SISTEMA_INVENTARIO_H
 #define SISTEMA_INVENTARIO_H
 
+#include "agendaManutencao.h"
+#include "agregacao.h"
+#include "indiceInventario.h"
+#include "ingestaoManutencao.h"
 #include "linkedList.h"
+#include "mapaInt.h"
+#include "obsolescencia.h"
+#include "ordenacaoExterna.h"
+#include "projecao.h"
 #include "repository.h"
+#include "segmentoInventario.h"
+#include "tabelaColunar.h"
+#include "threadPool.h"
+#include "versaoInventario.h"
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 
-typedef struct {
+// Concorrência: um escritor por vez (trava escrita) altera a lista e as estruturas derivadas com
+// estruturas em modo de escrita e publica uma versão imutável nova. Os relatórios sobre registros
+// leem a versão publicada e nunca esperam o escritor; consultas às estruturas derivadas (agenda,
+// monitor, projeção) usam estruturas em modo de leitura.
+
+typedef struct SistemaInventario {
     LinkedList inventario;
     Repository* repositorio; 
     int proximoId;
+    ThreadPool* pool;
+    MonitorObsolescencia obsolescencia;
+    AgendaManutencao agendaManutencao;
+    ProjecaoValor projecao;
+    const char* arquivoSnapshot;    // imagem gravada no encerramento; NULL desliga o modo snapshot
+    const char* arquivoOrigem;      // CSV contra o qual a imagem é validada
+    atomic_bool inventarioCarregado; // false no modo sob demanda enquanto só o índice está residente
+    IndiceInventario indice;
+    pthread_mutex_t leituraIndice;  // arquivo do índice entre relatórios que o leem com estruturas em modo de leitura
+    pthread_mutex_t escrita;        // serializa alterações, gravação no repositório e carga sob demanda
+    pthread_rwlock_t estruturas;    // lista, agenda, monitor, projeção e índice
+    PublicacaoVersao versoes;       // versão imutável lida pelos relatórios
+    MapaInt posicoes;               // id -> posição na versão publicada; só o escritor usa
+    SegmentoInventario* segmento;   // cópia da versão para leitores em outros processos; NULL desliga
+    IngestaoManutencao ingestao;    // fila de sistema_enfileirar_manutencao
+    atomic_bool ingestaoAtiva;      // o aplicador só sobe no primeiro envio
 } SistemaInventario;
 
 void sistema_init(SistemaInventario* sistema, Repository* repo); 
+void sistema_init_com_snapshot(SistemaInventario* sistema, Repository* repo, const char* arquivoSnapshot, const char* arquivoOrigem);
+// Com arquivoOrigem NULL e um repositório com carregar_tipo, nada fica residente até a primeira operação completa
+void sistema_init_lazy(SistemaInventario* sistema, Repository* repo, const char* arquivoOrigem);
 void sistema_destroy(SistemaInventario* sistema);
 bool sistema_cadastrar_hardware(SistemaInventario* sistema, const char* nome, const char* fabricante, 
                                TipoHardware tipo, const Data* dataCompra, double valorCompra, 
                                int vidaUtilAnos);
 bool sistema_registrar_manutencao(SistemaInventario* sistema, int id, const Data* dataManutencao);
+// Põe a manutenção na fila de ingestão e volta sem esperar a gravação: o aplicador junta os eventos em
+// lotes de sistema_aplicar_manutencoes, e ids inexistentes são descartados por ele. false com a fila
+// cheia; sistema_destroy aplica o que restar antes de gravar.
+bool sistema_enfileirar_manutencao(SistemaInventario* sistema, int id, const Data* dataManutencao);
+
+// Aplica um lote de eventos (ingestaoManutencao.h) com uma única gravação no repositório. Por id vale a
+// data mais recente, contando a já registrada: um evento atrasado não faz a data voltar. Devolve quantos
+// eventos alteraram registros, ou -1 se a gravação falhou; nesse caso o lote é desfeito na memória.
+int sistema_aplicar_manutencoes(SistemaInventario* sistema, const EventoManutencao* eventos, int quantidade);
+bool sistema_consultar_hardware(SistemaInventario* sistema, int id);
+// Copia o registro em destino sem imprimir; false se o id não existe
+bool sistema_buscar_hardware(SistemaInventario* sistema, int id, Hardware* destino);
+// Publica os registros no segmento compartilhado nome (leitorSegmento.h) e o atualiza a cada alteração;
+// no modo sob demanda, carrega o inventário inteiro
+bool sistema_publicar_segmento(SistemaInventario* sistema, const char* nome);
 void sistema_listar_equipamentos(SistemaInventario* sistema);
 void sistema_listar_por_tipo(SistemaInventario* sistema, TipoHardware tipo);
 void sistema_listar_por_data_compra(SistemaInventario* sistema);
 void sistema_listar_por_data_manutencao(SistemaInventario* sistema);
-double calcular_depreciacao(const Hardware* hw, const Data* hoje);
+void sistema_listar_ordenado_externo(SistemaInventario* sistema, ChaveOrdenacao chave, size_t orcamentoBytes);
 void sistema_mostrar_analise_depreciacao(SistemaInventario* sistema, const Data* hoje);
 void sistema_atualizar_status_obsoleto(SistemaInventario* sistema, const Data* hoje);
 void sistema_identificar_obsoletos(SistemaInventario* sistema, const Data* hoje);
+int sistema_total_obsoletos(SistemaInventario* sistema);
 void sistema_relatorio_manutencao_pendente(SistemaInventario* sistema, const Data* hoje, int mesesLimite);
+void sistema_relatorio_manutencao_pendente_agenda(SistemaInventario* sistema, const Data* hoje, int mesesLimite);
+void sistema_relatorio_proximas_manutencoes(SistemaInventario* sistema, const Data* hoje, int mesesLimite, int quantidade);
+
+double sistema_valor_contabil_em(SistemaInventario* sistema, const Data* data);
+void sistema_mostrar_projecao_valor(SistemaInventario* sistema, const Data* hoje, int anos);
+void sistema_mostrar_valor_em_data(SistemaInventario* sistema, const Data* data);
+void sistema_previsao_substituicao(SistemaInventario* sistema, const Data* hoje, int anos);
+bool sistema_agregar(SistemaInventario* sistema, int campos, const Data* hoje, int mesesLimite,
+                     bool paralelo, Agregacao* resultado);
+void sistema_relatorio_agregado(SistemaInventario* sistema, int campos, const Data* hoje, int mesesLimite);
+void sistema_relatorio_memoria(SistemaInventario* sistema);
+
+// Referência à versão publicada, para leitura em outra thread; soltar com versao_liberar
+const VersaoInventario* sistema_obter_versao(SistemaInventario* sistema);
+
+// Versões paralelas dos relatórios: mesma saída das versões seriais, calculada no pool do sistema
+void sistema_mostrar_analise_depreciacao_paralela(SistemaInventario* sistema, const Data* hoje);
+void sistema_identificar_obsoletos_paralelo(SistemaInventario* sistema, const Data* hoje);
+void sistema_relatorio_manutencao_pendente_paralelo(SistemaInventario* sistema, const Data* hoje, int mesesLimite);
+
+// Exportação colunar e os mesmos relatórios lidos direto das colunas de um arquivo exportado
+bool sistema_exportar_colunar(SistemaInventario* sistema, const char* arquivo);
+void sistema_mostrar_analise_depreciacao_colunar(const TabelaColunar* tabela, const Data* hoje);
+void sistema_identificar_obsoletos_colunar(const TabelaColunar* tabela, const Data* hoje);
+void sistema_relatorio_manutencao_pendente_colunar(const TabelaColunar* tabela, const Data* hoje, int mesesLimite);
 
 #endif 
\ No newline at end of file
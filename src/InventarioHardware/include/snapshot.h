@@ -0,0 +1,16 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "sistemaInventario.h"
+#include <stdbool.h>
+
+// Imagem binária do inventário já montado: itens com textos internados, proximoId e o heap da
+// agenda de manutenção. Só é aceita se tamanho e data de modificação do arquivo de origem (o CSV)
+// forem os registrados quando a imagem foi gravada; com a data diferente, vale o checksum do conteúdo.
+bool snapshot_gravar(const char* arquivoImagem, const char* arquivoOrigem, const SistemaInventario* sistema);
+
+// Preenche inventário, proximoId e agenda de um sistema recém-inicializado (lista vazia).
+// Retorna false, sem alterar o sistema, se a imagem estiver ausente, corrompida ou desatualizada.
+bool snapshot_carregar(const char* arquivoImagem, const char* arquivoOrigem, SistemaInventario* sistema);
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef TABELA_COLUNAR_H
+#define TABELA_COLUNAR_H
+
+#include "data.h"
+#include "linkedList.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Formato colunar para análise externa, no espírito do Arrow IPC: cabeçalho, descritores de coluna
+// (nome, tipo, deslocamento e tamanho dos buffers) e um buffer contíguo por coluna, alinhado a
+// 64 bytes. Colunas fixas são vetores little-endian; textos são offsets int32 (n + 1) mais os bytes;
+// a categoria guarda códigos uint8 e, na área de textos, os nomes das categorias separados por '\0'.
+typedef enum {
+    COLUNA_INT32 = 1,
+    COLUNA_FLOAT64 = 2,
+    COLUNA_BOOL = 3,        // uint8, 0 ou 1
+    COLUNA_DATA = 4,        // int32 AAAAMMDD
+    COLUNA_TEXTO = 5,
+    COLUNA_CATEGORIA = 6
+} TipoColuna;
+
+// Visão somente leitura de um arquivo exportado. Os ponteiros apontam direto para o arquivo
+// mapeado; nada é copiado nem convertido ao abrir.
+typedef struct {
+    int64_t numLinhas;
+    const int32_t* id;
+    const int32_t* nomeOffsets;
+    const char* nomeDados;
+    const int32_t* fabricanteOffsets;
+    const char* fabricanteDados;
+    const uint8_t* tipo;
+    TipoHardware tipoPorCodigo[256];
+    const int32_t* dataCompra;
+    const double* valorCompra;
+    const int32_t* vidaUtilAnos;
+    const int32_t* ultimaManutencao;
+    const uint8_t* obsoleto;
+
+    const unsigned char* base;
+    size_t tamanho;
+} TabelaColunar;
+
+// Grava a lista coluna por coluna, com um buffer fixo de escrita e sem alocação por registro
+bool colunar_exportar(const LinkedList* list, const char* arquivo);
+
+bool colunar_abrir(TabelaColunar* tabela, const char* arquivo);
+void colunar_fechar(TabelaColunar* tabela);
+
+Data colunar_data(int32_t aaaammdd);
+// Texto da linha (sem terminador); tamanho recebe o número de bytes
+const char* colunar_texto(const int32_t* offsets, const char* dados, int64_t linha, int* tamanho);
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <stdbool.h>
+
+// Tarefa executada pelo pool: recebe o contexto compartilhado e o índice da tarefa
+typedef void (*TarefaPool)(void* contexto, int indice);
+
+typedef struct ThreadPool ThreadPool;
+
+int obter_numero_nucleos();
+ThreadPool* threadpool_criar(int numThreads);
+void threadpool_destruir(ThreadPool* pool);
+int threadpool_num_threads(const ThreadPool* pool);
+void threadpool_executar(ThreadPool* pool, int numTarefas, TarefaPool tarefa, void* contexto);
+// Executa tarefa(contexto, 0) num worker sem esperar; false se não há worker para recebê-la
+bool threadpool_enviar(ThreadPool* pool, TarefaPool tarefa, void* contexto);
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Rastreamento de intervalos no formato Chrome Trace Event (aberto no Perfetto ou chrome://tracing).
+// Eventos vão para um buffer circular em memória e só são gravados em trace_finalizar.
+// Compilar com -DINVENTARIO_SEM_TRACE remove tudo; os argumentos continuam avaliados (sem efeito),
+// para que variáveis usadas só no trace não fiquem sem uso.
+#ifdef INVENTARIO_SEM_TRACE
+
+#define trace_iniciar(caminho, capacidade) ((void)(caminho), (void)(capacidade), false)
+#define trace_ativo() (false)
+#define trace_inicio(nome) ((void)(nome))
+#define trace_fim(nome) ((void)(nome))
+#define trace_completo(nome, inicioNs, fimNs) ((void)(nome), (void)(inicioNs), (void)(fimNs))
+#define trace_finalizar() (true)
+
+#else
+
+bool trace_iniciar(const char* caminho, size_t capacidadeEventos);
+bool trace_ativo();
+void trace_inicio(const char* nome);
+void trace_fim(const char* nome);
+// Intervalo já medido, com início e fim no relógio de tempo_monotonico_ns
+void trace_completo(const char* nome, long long inicioNs, long long fimNs);
+bool trace_finalizar();
+
+#endif
+
+#endif
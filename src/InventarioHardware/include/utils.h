@@ -1,23 +1,53 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include "contadoresHw.h"
 #include "data.h"
 #include "hardware.h"
 #include <stdbool.h>
+#include <stddef.h>
 #include <time.h>
 
+// Mede tempo de parede com relógio monotônico (nanossegundos) e, se ativos, os contadores de hardware
 typedef struct {
-    clock_t inicio;
-    clock_t fim;
+    long long inicio;
+    long long fim;
+    LeituraHw hwInicio;
+    long long hwVariacao[NUM_CONTADORES_HW];
+    bool hwMedido;
 } Cronometro;
 
+// Buffer de texto crescente, usado para montar saídas de relatórios em partes
+typedef struct {
+    char* dados;
+    size_t tamanho;
+    size_t capacidade;
+} TextoBuffer;
+
 bool compare_data_compra(const Hardware* a, const Hardware* b);
 bool compare_data_manutencao(const Hardware* a, const Hardware* b);
 TipoHardware selecionar_tipo();
 bool ler_data(const char* mensagem, Data* data);
 void limpar_buffer_entrada();
+long long tempo_monotonico_ns();
 void cronometro_iniciar(Cronometro* cronometro);
 double cronometro_parar(Cronometro* cronometro);
-void cronometro_imprimir(const char* operacao, double tempo);
+void cronometro_imprimir(const char* operacao, const Cronometro* cronometro);
+void cronometro_definir_console(bool ativo);
+// Para quem completa a linha [TEMPO] com um prefixo próprio
+bool cronometro_console_ativo(void);
+void cronometro_definir_registros(long registros);
+// O servidor redireciona stdout e stderr do processo inteiro para capturar a saída de um pedido.
+// Threads que imprimem por conta própria (o aplicador da ingestão) seguram esta trava enquanto
+// imprimem, e o servidor a segura durante a captura.
+void saida_travar(void);
+void saida_destravar(void);
+void texto_buffer_init(TextoBuffer* buffer);
+bool texto_buffer_anexar(TextoBuffer* buffer, const char* formato, ...);
+// Anexa bytes sem formatação (também serve para dados binários)
+bool texto_buffer_anexar_bytes(TextoBuffer* buffer, const void* dados, size_t tamanho);
+void texto_buffer_liberar(TextoBuffer* buffer);
+// Cópia byte a byte; em falha o destino parcial é removido
+bool copiar_arquivo(const char* origem, const char* destino);
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,55 @@
+#ifndef VERSAO_INVENTARIO_H
+#define VERSAO_INVENTARIO_H
+
+#include "hardware.h"
+#include "linkedList.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+
+// Versões imutáveis do inventário para leitura concorrente. Os registros ficam em páginas de
+// REGISTROS_POR_PAGINA, na ordem da lista; uma versão nova copia só a tabela de páginas e as
+// páginas alteradas, e compartilha as demais com a anterior (cópia na escrita). Páginas e versões
+// têm contagem de referências e são liberadas quando o último leitor solta a última versão que as usa.
+#define REGISTROS_POR_PAGINA 256
+
+typedef struct {
+    atomic_int referencias;
+    int quantidade;
+    Hardware registros[REGISTROS_POR_PAGINA];
+} PaginaInventario;
+
+typedef struct {
+    atomic_int referencias;
+    int numRegistros;
+    int numPaginas;
+    PaginaInventario** paginas;
+} VersaoInventario;
+
+// Versão com o conteúdo da lista, reaproveitando as páginas de base (pode ser NULL) que não mudaram
+VersaoInventario* versao_sincronizar(const VersaoInventario* base, const LinkedList* lista);
+// Cópias de base com um registro trocado na posição dada, ou acrescentado no fim
+VersaoInventario* versao_substituir(const VersaoInventario* base, int posicao, const Hardware* hw);
+VersaoInventario* versao_anexar(const VersaoInventario* base, const Hardware* hw);
+void versao_liberar(const VersaoInventario* versao);
+
+const Hardware* versao_registro(const VersaoInventario* versao, int posicao);
+// Vetor de ponteiros para os registros, na ordem da versão; liberar com mem_liberar
+const Hardware** versao_coletar_itens(const VersaoInventario* versao);
+
+// Ponto de publicação da versão atual. A trava só cobre a troca do ponteiro e o incremento da
+// referência: o leitor nunca espera o escritor montar a versão nova, e o escritor nunca espera
+// um relatório terminar.
+typedef struct {
+    VersaoInventario* atual;
+    pthread_mutex_t trava;
+} PublicacaoVersao;
+
+void publicacao_init(PublicacaoVersao* publicacao);
+void publicacao_destruir(PublicacaoVersao* publicacao);
+// Publica nova (assume a referência recebida) e solta a referência da versão anterior
+void publicacao_trocar(PublicacaoVersao* publicacao, VersaoInventario* nova);
+// Referência à versão atual (nunca NULL depois da primeira troca); soltar com versao_liberar
+const VersaoInventario* publicacao_obter(PublicacaoVersao* publicacao);
+
+#endif
@@ -0,0 +1,289 @@
+#include "agendaManutencao.h"
+#include "memoria.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Meses completos entre duas datas, com a mesma regra do relatório de manutenção pendente
+int meses_desde(const Data* inicio, const Data* hoje) {
+    int meses = (hoje->ano - inicio->ano) * 12 + (hoje->mes - inicio->mes);
+    if (hoje->dia < inicio->dia) {
+        meses--;
+    }
+    return meses;
+}
+
+// Primeira data em que meses_desde(ultimaManutencao, data) >= mesesLimite
+Data data_vencimento_manutencao(const Data* ultimaManutencao, int mesesLimite) {
+    static const int diasNoMes[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+    Data vencimento = *ultimaManutencao;
+    int totalMeses = vencimento.ano * 12 + (vencimento.mes - 1) + mesesLimite;
+    vencimento.ano = totalMeses / 12;
+    vencimento.mes = totalMeses % 12 + 1;
+
+    int ultimoDia = diasNoMes[vencimento.mes - 1];
+    bool bissexto = (vencimento.ano % 4 == 0 && vencimento.ano % 100 != 0) || vencimento.ano % 400 == 0;
+    if (vencimento.mes == 2 && bissexto) ultimoDia = 29;
+
+    if (vencimento.dia > ultimoDia) {
+        vencimento.dia = 1;
+        if (++vencimento.mes > 12) {
+            vencimento.mes = 1;
+            vencimento.ano++;
+        }
+    }
+    return vencimento;
+}
+
+void agenda_manutencao_init(AgendaManutencao* agenda) {
+    agenda->heap = NULL;
+    agenda->tamanho = 0;
+    agenda->capacidade = 0;
+    agenda->proximaSequencia = 0;
+    mapa_int_init(&agenda->posicoes);
+}
+
+void agenda_manutencao_destruir(AgendaManutencao* agenda) {
+    mem_liberar(agenda->heap);
+    mapa_int_destruir(&agenda->posicoes);
+    agenda_manutencao_init(agenda);
+}
+
+static bool entrada_menor(const EntradaManutencao* a, const EntradaManutencao* b) {
+    if (data_menor_que(&a->ultimaManutencao, &b->ultimaManutencao)) return true;
+    if (data_menor_que(&b->ultimaManutencao, &a->ultimaManutencao)) return false;
+    return a->sequencia < b->sequencia;
+}
+
+static void agenda_posicionar(AgendaManutencao* agenda, int i, EntradaManutencao item) {
+    agenda->heap[i] = item;
+    mapa_int_inserir(&agenda->posicoes, item.no->data.id, i);
+}
+
+static void heap_subir(AgendaManutencao* agenda, int i) {
+    EntradaManutencao item = agenda->heap[i];
+    while (i > 0) {
+        int pai = (i - 1) / 2;
+        if (!entrada_menor(&item, &agenda->heap[pai])) break;
+        agenda_posicionar(agenda, i, agenda->heap[pai]);
+        i = pai;
+    }
+    agenda_posicionar(agenda, i, item);
+}
+
+static void heap_descer(AgendaManutencao* agenda, int i) {
+    EntradaManutencao item = agenda->heap[i];
+    while (true) {
+        int filho = 2 * i + 1;
+        if (filho >= agenda->tamanho) break;
+        if (filho + 1 < agenda->tamanho && entrada_menor(&agenda->heap[filho + 1], &agenda->heap[filho])) {
+            filho++;
+        }
+        if (!entrada_menor(&agenda->heap[filho], &item)) break;
+        agenda_posicionar(agenda, i, agenda->heap[filho]);
+        i = filho;
+    }
+    agenda_posicionar(agenda, i, item);
+}
+
+static bool agenda_garantir_capacidade(AgendaManutencao* agenda, int minimo) {
+    if (minimo <= agenda->capacidade) return true;
+
+    int novaCapacidade = agenda->capacidade ? agenda->capacidade * 2 : 64;
+    while (novaCapacidade < minimo) novaCapacidade *= 2;
+
+    EntradaManutencao* novo = mem_realocar(MEMORIA_INDICES, agenda->heap, sizeof(EntradaManutencao) * novaCapacidade);
+    if (!novo) return false;
+    agenda->heap = novo;
+    agenda->capacidade = novaCapacidade;
+    return true;
+}
+
+// Monta a agenda a partir da lista em O(n)
+bool agenda_manutencao_construir(AgendaManutencao* agenda, LinkedList* list) {
+    agenda->tamanho = 0;
+    agenda->proximaSequencia = 0;
+    mapa_int_limpar(&agenda->posicoes);
+
+    if (!agenda_garantir_capacidade(agenda, list->size) ||
+        !mapa_int_reservar(&agenda->posicoes, list->size)) {
+        return false;
+    }
+
+    for (Node* current = list->head; current != NULL; current = current->next) {
+        EntradaManutencao* entrada = &agenda->heap[agenda->tamanho++];
+        entrada->ultimaManutencao = current->data.ultimaManutencao;
+        entrada->no = current;
+        entrada->sequencia = agenda->proximaSequencia++;
+    }
+    for (int i = agenda->tamanho / 2 - 1; i >= 0; i--) {
+        heap_descer(agenda, i);
+    }
+    for (int i = 0; i < agenda->tamanho; i++) {
+        mapa_int_inserir(&agenda->posicoes, agenda->heap[i].no->data.id, i);
+    }
+    return true;
+}
+
+// Reaproveita um heap já ordenado (por exemplo, lido de um snapshot); só o mapa de posições é refeito
+bool agenda_manutencao_restaurar(AgendaManutencao* agenda, const EntradaManutencao* entradas, int tamanho, int proximaSequencia) {
+    agenda->tamanho = 0;
+    agenda->proximaSequencia = 0;
+    mapa_int_limpar(&agenda->posicoes);
+
+    if (!agenda_garantir_capacidade(agenda, tamanho) ||
+        !mapa_int_reservar(&agenda->posicoes, tamanho)) {
+        return false;
+    }
+
+    if (tamanho > 0) memcpy(agenda->heap, entradas, sizeof(EntradaManutencao) * tamanho);
+    agenda->tamanho = tamanho;
+    agenda->proximaSequencia = proximaSequencia;
+    for (int i = 0; i < tamanho; i++) {
+        mapa_int_inserir(&agenda->posicoes, agenda->heap[i].no->data.id, i);
+    }
+    return true;
+}
+
+bool agenda_manutencao_registrar(AgendaManutencao* agenda, Node* no) {
+    if (!agenda_garantir_capacidade(agenda, agenda->tamanho + 1)) return false;
+
+    EntradaManutencao* entrada = &agenda->heap[agenda->tamanho++];
+    entrada->ultimaManutencao = no->data.ultimaManutencao;
+    entrada->no = no;
+    entrada->sequencia = agenda->proximaSequencia++;
+    heap_subir(agenda, agenda->tamanho - 1);
+    return true;
+}
+
+Node* agenda_manutencao_buscar(const AgendaManutencao* agenda, int id) {
+    intptr_t posicao;
+    if (!mapa_int_buscar(&agenda->posicoes, id, &posicao)) return NULL;
+    return agenda->heap[posicao].no;
+}
+
+// Reposiciona o equipamento depois que sua data de manutenção mudou, em O(log n)
+void agenda_manutencao_atualizar(AgendaManutencao* agenda, int id) {
+    intptr_t posicao;
+    if (!mapa_int_buscar(&agenda->posicoes, id, &posicao)) return;
+
+    EntradaManutencao* entrada = &agenda->heap[posicao];
+    entrada->ultimaManutencao = entrada->no->data.ultimaManutencao;
+    heap_subir(agenda, (int)posicao);
+
+    mapa_int_buscar(&agenda->posicoes, id, &posicao);
+    heap_descer(agenda, (int)posicao);
+}
+
+static int comparar_sequencia(const void* a, const void* b) {
+    const EntradaManutencao* ea = *(const EntradaManutencao* const*)a;
+    const EntradaManutencao* eb = *(const EntradaManutencao* const*)b;
+    return (ea->sequencia > eb->sequencia) - (ea->sequencia < eb->sequencia);
+}
+
+// Todos os equipamentos com pelo menos mesesLimite meses sem manutenção, na ordem da lista.
+// Como meses_desde é decrescente na data, o conjunto vencido é o topo do heap: a busca
+// para em cada ramo no primeiro equipamento em dia, custando O(k log k) para k vencidos.
+int agenda_manutencao_vencidos(const AgendaManutencao* agenda, const Data* hoje, int mesesLimite, Node*** resultado) {
+    *resultado = NULL;
+    if (agenda->tamanho == 0) return 0;
+
+    const EntradaManutencao** encontrados = NULL;
+    int* pilha = mem_alocar(MEMORIA_TEMPORARIA, sizeof(int) * agenda->tamanho);
+    int capacidade = 0, quantidade = 0, topo = 0;
+    if (!pilha) return -1;
+
+    pilha[topo++] = 0;
+    while (topo > 0) {
+        int i = pilha[--topo];
+        const EntradaManutencao* entrada = &agenda->heap[i];
+        if (meses_desde(&entrada->ultimaManutencao, hoje) < mesesLimite) continue;
+
+        if (quantidade == capacidade) {
+            capacidade = capacidade ? capacidade * 2 : 64;
+            const EntradaManutencao** novo = mem_realocar(MEMORIA_TEMPORARIA, encontrados, sizeof(*encontrados) * capacidade);
+            if (!novo) {
+                mem_liberar(encontrados);
+                mem_liberar(pilha);
+                return -1;
+            }
+            encontrados = novo;
+        }
+        encontrados[quantidade++] = entrada;
+
+        if (2 * i + 1 < agenda->tamanho) pilha[topo++] = 2 * i + 1;
+        if (2 * i + 2 < agenda->tamanho) pilha[topo++] = 2 * i + 2;
+    }
+    mem_liberar(pilha);
+
+    qsort(encontrados, quantidade, sizeof(*encontrados), comparar_sequencia);
+
+    Node** nos = mem_alocar(MEMORIA_TEMPORARIA, sizeof(Node*) * (quantidade > 0 ? quantidade : 1));
+    if (!nos) {
+        mem_liberar(encontrados);
+        return -1;
+    }
+    for (int i = 0; i < quantidade; i++) {
+        nos[i] = encontrados[i]->no;
+    }
+    mem_liberar(encontrados);
+
+    *resultado = nos;
+    return quantidade;
+}
+
+// Os próximos 'quantidade' equipamentos a vencer (ainda em dia), do mais próximo ao mais distante.
+// Busca em largura ordenada sobre o heap usando um heap auxiliar de índices.
+int agenda_manutencao_proximos(const AgendaManutencao* agenda, const Data* hoje, int mesesLimite, int quantidade, Node*** resultado) {
+    *resultado = NULL;
+    if (agenda->tamanho == 0 || quantidade <= 0) return 0;
+
+    Node** nos = mem_alocar(MEMORIA_TEMPORARIA, sizeof(Node*) * quantidade);
+    int* fronteira = mem_alocar(MEMORIA_TEMPORARIA, sizeof(int) * agenda->tamanho);
+    if (!nos || !fronteira) {
+        mem_liberar(nos);
+        mem_liberar(fronteira);
+        return -1;
+    }
+
+    int encontrados = 0, tamanhoFronteira = 0;
+    fronteira[tamanhoFronteira++] = 0;
+
+    while (tamanhoFronteira > 0 && encontrados < quantidade) {
+        int i = fronteira[0];
+
+        // Remove o menor da fronteira
+        int ultimo = fronteira[--tamanhoFronteira];
+        int pos = 0;
+        while (tamanhoFronteira > 0) {
+            int filho = 2 * pos + 1;
+            if (filho >= tamanhoFronteira) break;
+            if (filho + 1 < tamanhoFronteira &&
+                entrada_menor(&agenda->heap[fronteira[filho + 1]], &agenda->heap[fronteira[filho]])) {
+                filho++;
+            }
+            if (!entrada_menor(&agenda->heap[fronteira[filho]], &agenda->heap[ultimo])) break;
+            fronteira[pos] = fronteira[filho];
+            pos = filho;
+        }
+        if (tamanhoFronteira > 0) fronteira[pos] = ultimo;
+
+        const EntradaManutencao* entrada = &agenda->heap[i];
+        if (meses_desde(&entrada->ultimaManutencao, hoje) < mesesLimite) {
+            nos[encontrados++] = entrada->no;
+        }
+
+        for (int filho = 2 * i + 1; filho <= 2 * i + 2 && filho < agenda->tamanho; filho++) {
+            int p = tamanhoFronteira++;
+            while (p > 0 && entrada_menor(&agenda->heap[filho], &agenda->heap[fronteira[(p - 1) / 2]])) {
+                fronteira[p] = fronteira[(p - 1) / 2];
+                p = (p - 1) / 2;
+            }
+            fronteira[p] = filho;
+        }
+    }
+    mem_liberar(fronteira);
+
+    *resultado = nos;
+    return encontrados;
+}
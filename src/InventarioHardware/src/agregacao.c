@@ -0,0 +1,306 @@
+#include "agregacao.h"
+#include "agendaManutencao.h"
+#include "depreciacao.h"
+#include "memoria.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ITENS_MINIMOS_POR_PARTE 4096
+
+void agregacao_init(Agregacao* agregacao, int campos, const Data* hoje, int mesesLimite) {
+    memset(agregacao, 0, sizeof(*agregacao));
+    agregacao->campos = campos;
+    agregacao->hoje = *hoje;
+    agregacao->mesesLimite = mesesLimite;
+}
+
+void agregacao_liberar(Agregacao* agregacao) {
+    mem_liberar(agregacao->grupos);
+    mem_liberar(agregacao->tabela);
+    agregacao->grupos = NULL;
+    agregacao->tabela = NULL;
+    agregacao->numGrupos = 0;
+    agregacao->capacidadeGrupos = 0;
+    agregacao->capacidadeTabela = 0;
+}
+
+static size_t agregacao_hash(const Agregacao* agregacao, const GrupoAgregado* chave) {
+    // FNV-1a sobre os campos selecionados
+    size_t h = (size_t)2166136261u;
+    int campos = agregacao->campos;
+
+    if (campos & AGRUPAR_TIPO) h = (h ^ (size_t)chave->tipo) * 16777619u;
+    if (campos & AGRUPAR_FABRICANTE) {
+        for (const unsigned char* c = (const unsigned char*)chave->fabricante; *c; c++) {
+            h = (h ^ *c) * 16777619u;
+        }
+    }
+    if (campos & AGRUPAR_ANO_COMPRA) h = (h ^ (size_t)chave->anoCompra) * 16777619u;
+    if (campos & AGRUPAR_MES_COMPRA) h = (h ^ (size_t)chave->mesCompra) * 16777619u;
+    if (campos & AGRUPAR_OBSOLETO) h = (h ^ (size_t)chave->obsoleto) * 16777619u;
+    return h;
+}
+
+static int agregacao_comparar_chave(int campos, const GrupoAgregado* a, const GrupoAgregado* b) {
+    if ((campos & AGRUPAR_TIPO) && a->tipo != b->tipo) return a->tipo < b->tipo ? -1 : 1;
+    if (campos & AGRUPAR_FABRICANTE) {
+        int cmp = strcmp(a->fabricante, b->fabricante);
+        if (cmp != 0) return cmp;
+    }
+    if ((campos & AGRUPAR_ANO_COMPRA) && a->anoCompra != b->anoCompra) return a->anoCompra < b->anoCompra ? -1 : 1;
+    if ((campos & AGRUPAR_MES_COMPRA) && a->mesCompra != b->mesCompra) return a->mesCompra < b->mesCompra ? -1 : 1;
+    if ((campos & AGRUPAR_OBSOLETO) && a->obsoleto != b->obsoleto) return a->obsoleto ? 1 : -1;
+    return 0;
+}
+
+static bool agregacao_redimensionar_tabela(Agregacao* agregacao) {
+    size_t novaCapacidade = agregacao->capacidadeTabela ? agregacao->capacidadeTabela * 2 : 64;
+    int* tabela = mem_alocar_zerado(MEMORIA_TEMPORARIA, novaCapacidade, sizeof(int));
+    if (!tabela) return false;
+
+    for (int g = 0; g < agregacao->numGrupos; g++) {
+        size_t pos = agregacao_hash(agregacao, &agregacao->grupos[g]) & (novaCapacidade - 1);
+        while (tabela[pos] != 0) {
+            pos = (pos + 1) & (novaCapacidade - 1);
+        }
+        tabela[pos] = g + 1;
+    }
+
+    mem_liberar(agregacao->tabela);
+    agregacao->tabela = tabela;
+    agregacao->capacidadeTabela = novaCapacidade;
+    return true;
+}
+
+// Devolve o grupo com a chave informada, criando-o vazio se ainda não existir
+static GrupoAgregado* agregacao_obter_grupo(Agregacao* agregacao, const GrupoAgregado* chave) {
+    if ((size_t)(agregacao->numGrupos + 1) * 10 > agregacao->capacidadeTabela * 7) {
+        if (!agregacao_redimensionar_tabela(agregacao)) return NULL;
+    }
+
+    size_t mascara = agregacao->capacidadeTabela - 1;
+    size_t pos = agregacao_hash(agregacao, chave) & mascara;
+    while (agregacao->tabela[pos] != 0) {
+        GrupoAgregado* grupo = &agregacao->grupos[agregacao->tabela[pos] - 1];
+        if (agregacao_comparar_chave(agregacao->campos, grupo, chave) == 0) return grupo;
+        pos = (pos + 1) & mascara;
+    }
+
+    if (agregacao->numGrupos == agregacao->capacidadeGrupos) {
+        int novaCapacidade = agregacao->capacidadeGrupos ? agregacao->capacidadeGrupos * 2 : 16;
+        GrupoAgregado* novo = mem_realocar(MEMORIA_TEMPORARIA, agregacao->grupos, sizeof(GrupoAgregado) * novaCapacidade);
+        if (!novo) return NULL;
+        agregacao->grupos = novo;
+        agregacao->capacidadeGrupos = novaCapacidade;
+    }
+
+    GrupoAgregado* grupo = &agregacao->grupos[agregacao->numGrupos];
+    memset(grupo, 0, sizeof(*grupo));
+    grupo->tipo = chave->tipo;
+    strcpy(grupo->fabricante, chave->fabricante);
+    grupo->anoCompra = chave->anoCompra;
+    grupo->mesCompra = chave->mesCompra;
+    grupo->obsoleto = chave->obsoleto;
+
+    agregacao->tabela[pos] = ++agregacao->numGrupos;
+    return grupo;
+}
+
+static void estatistica_acumular(Estatistica* estatistica, long quantidadeAnterior, double valor) {
+    if (quantidadeAnterior == 0 || valor < estatistica->minimo) estatistica->minimo = valor;
+    if (quantidadeAnterior == 0 || valor > estatistica->maximo) estatistica->maximo = valor;
+    estatistica->soma += valor;
+}
+
+static void estatistica_combinar(Estatistica* destino, long quantidadeDestino, const Estatistica* origem) {
+    if (quantidadeDestino == 0 || origem->minimo < destino->minimo) destino->minimo = origem->minimo;
+    if (quantidadeDestino == 0 || origem->maximo > destino->maximo) destino->maximo = origem->maximo;
+    destino->soma += origem->soma;
+}
+
+double estatistica_media(const Estatistica* estatistica, long quantidade) {
+    return quantidade > 0 ? estatistica->soma / quantidade : 0.0;
+}
+
+bool agregacao_adicionar(Agregacao* agregacao, const Hardware* hw) {
+    GrupoAgregado chave;
+    int campos = agregacao->campos;
+    chave.tipo = (campos & AGRUPAR_TIPO) ? hw->tipo : OUTRO;
+    if (campos & AGRUPAR_FABRICANTE) {
+        strcpy(chave.fabricante, hw->fabricante);
+    } else {
+        chave.fabricante[0] = '\0';
+    }
+    chave.anoCompra = (campos & AGRUPAR_ANO_COMPRA) ? hw->dataCompra.ano : 0;
+    chave.mesCompra = (campos & AGRUPAR_MES_COMPRA) ? hw->dataCompra.mes : 0;
+    chave.obsoleto = (campos & AGRUPAR_OBSOLETO) ? hw->obsoleto : false;
+
+    GrupoAgregado* grupo = agregacao_obter_grupo(agregacao, &chave);
+    if (!grupo) return false;
+
+    double idade = meses_desde(&hw->dataCompra, &agregacao->hoje) / 12.0;
+    if (idade < 0) idade = 0;
+    estatistica_acumular(&grupo->valor, grupo->quantidade, hw->valorCompra);
+    estatistica_acumular(&grupo->depreciacao, grupo->quantidade, calcular_depreciacao(hw, &agregacao->hoje));
+    estatistica_acumular(&grupo->idadeAnos, grupo->quantidade, idade);
+
+    if (agregacao->mesesLimite > 0 &&
+        meses_desde(&hw->ultimaManutencao, &agregacao->hoje) >= agregacao->mesesLimite) {
+        grupo->manutencaoPendente++;
+    }
+    grupo->quantidade++;
+    return true;
+}
+
+bool agregacao_mesclar(Agregacao* destino, const Agregacao* origem) {
+    for (int g = 0; g < origem->numGrupos; g++) {
+        const GrupoAgregado* parcial = &origem->grupos[g];
+        GrupoAgregado* grupo = agregacao_obter_grupo(destino, parcial);
+        if (!grupo) return false;
+
+        estatistica_combinar(&grupo->valor, grupo->quantidade, &parcial->valor);
+        estatistica_combinar(&grupo->depreciacao, grupo->quantidade, &parcial->depreciacao);
+        estatistica_combinar(&grupo->idadeAnos, grupo->quantidade, &parcial->idadeAnos);
+        grupo->quantidade += parcial->quantidade;
+        grupo->manutencaoPendente += parcial->manutencaoPendente;
+    }
+    return true;
+}
+
+typedef struct {
+    const Hardware* const* itens;
+    int numItens;
+    int numPartes;
+    Agregacao* parciais;
+    bool* ok;
+} AgregacaoParalela;
+
+static void tarefa_agregacao(void* contexto, int parte) {
+    AgregacaoParalela* ctx = (AgregacaoParalela*)contexto;
+    int inicio = (int)((long long)ctx->numItens * parte / ctx->numPartes);
+    int fim = (int)((long long)ctx->numItens * (parte + 1) / ctx->numPartes);
+
+    ctx->ok[parte] = true;
+    for (int i = inicio; i < fim && ctx->ok[parte]; i++) {
+        ctx->ok[parte] = agregacao_adicionar(&ctx->parciais[parte], ctx->itens[i]);
+    }
+}
+
+// Agrupa os itens. Com pool, cada parte agrega numa tabela própria e as parciais
+// são mescladas em ordem de parte; o resultado final é ordenado pela chave.
+bool agregacao_executar(Agregacao* agregacao, const Hardware* const* itens, int numItens, ThreadPool* pool) {
+    int numPartes = numItens / ITENS_MINIMOS_POR_PARTE;
+    int maxPartes = threadpool_num_threads(pool);
+    if (numPartes > maxPartes) numPartes = maxPartes;
+
+    if (pool == NULL || numPartes <= 1) {
+        for (int i = 0; i < numItens; i++) {
+            if (!agregacao_adicionar(agregacao, itens[i])) return false;
+        }
+        agregacao_ordenar(agregacao);
+        return true;
+    }
+
+    AgregacaoParalela ctx;
+    ctx.itens = itens;
+    ctx.numItens = numItens;
+    ctx.numPartes = numPartes;
+    ctx.parciais = mem_alocar(MEMORIA_TEMPORARIA, sizeof(Agregacao) * numPartes);
+    ctx.ok = mem_alocar(MEMORIA_TEMPORARIA, sizeof(bool) * numPartes);
+    if (!ctx.parciais || !ctx.ok) {
+        mem_liberar(ctx.parciais);
+        mem_liberar(ctx.ok);
+        return false;
+    }
+    for (int p = 0; p < numPartes; p++) {
+        agregacao_init(&ctx.parciais[p], agregacao->campos, &agregacao->hoje, agregacao->mesesLimite);
+    }
+
+    threadpool_executar(pool, numPartes, tarefa_agregacao, &ctx);
+
+    bool resultado = true;
+    for (int p = 0; p < numPartes; p++) {
+        if (resultado) {
+            resultado = ctx.ok[p] && agregacao_mesclar(agregacao, &ctx.parciais[p]);
+        }
+        agregacao_liberar(&ctx.parciais[p]);
+    }
+    mem_liberar(ctx.parciais);
+    mem_liberar(ctx.ok);
+
+    if (resultado) agregacao_ordenar(agregacao);
+    return resultado;
+}
+
+// Campos não selecionados ficam zerados na chave, então comparar todos os campos
+// equivale a comparar só os selecionados
+#define TODOS_OS_CAMPOS (AGRUPAR_TIPO | AGRUPAR_FABRICANTE | AGRUPAR_ANO_COMPRA | AGRUPAR_MES_COMPRA | AGRUPAR_OBSOLETO)
+
+static int comparar_grupos(const void* a, const void* b) {
+    return agregacao_comparar_chave(TODOS_OS_CAMPOS, (const GrupoAgregado*)a, (const GrupoAgregado*)b);
+}
+
+// Ordena os grupos pela chave para que a saída não dependa da ordem de inserção.
+// A tabela hash é reconstruída porque os índices mudam.
+void agregacao_ordenar(Agregacao* agregacao) {
+    if (agregacao->numGrupos < 2) return;
+
+    qsort(agregacao->grupos, agregacao->numGrupos, sizeof(GrupoAgregado), comparar_grupos);
+
+    size_t capacidade = agregacao->capacidadeTabela;
+    mem_liberar(agregacao->tabela);
+    agregacao->tabela = NULL;
+    agregacao->capacidadeTabela = capacidade / 2;
+    if (!agregacao_redimensionar_tabela(agregacao)) {
+        agregacao->capacidadeTabela = 0;
+    }
+}
+
+void agregacao_imprimir(const Agregacao* agregacao) {
+    int campos = agregacao->campos;
+
+    for (int g = 0; g < agregacao->numGrupos; g++) {
+        const GrupoAgregado* grupo = &agregacao->grupos[g];
+
+        printf("[");
+        bool primeiro = true;
+        if (campos & AGRUPAR_TIPO) {
+            printf("Tipo: %s", tipo_to_string(grupo->tipo));
+            primeiro = false;
+        }
+        if (campos & AGRUPAR_FABRICANTE) {
+            printf("%sFabricante: %s", primeiro ? "" : " | ", grupo->fabricante);
+            primeiro = false;
+        }
+        if (campos & AGRUPAR_ANO_COMPRA) {
+            printf("%sAno: %d", primeiro ? "" : " | ", grupo->anoCompra);
+            primeiro = false;
+        }
+        if (campos & AGRUPAR_MES_COMPRA) {
+            printf("%sMês: %02d", primeiro ? "" : " | ", grupo->mesCompra);
+            primeiro = false;
+        }
+        if (campos & AGRUPAR_OBSOLETO) {
+            printf("%s%s", primeiro ? "" : " | ", grupo->obsoleto ? "OBSOLETO" : "Ativo");
+            primeiro = false;
+        }
+        if (primeiro) printf("Todos");
+        printf("] Quantidade: %ld", grupo->quantidade);
+        if (agregacao->mesesLimite > 0) {
+            printf(" | Manutenção pendente: %ld", grupo->manutencaoPendente);
+        }
+        printf("\n");
+
+        printf("    Valor: total R$%.2f | mín R$%.2f | máx R$%.2f | média R$%.2f\n",
+               grupo->valor.soma, grupo->valor.minimo, grupo->valor.maximo,
+               estatistica_media(&grupo->valor, grupo->quantidade));
+        printf("    Depreciação: total R$%.2f | mín R$%.2f | máx R$%.2f | média R$%.2f\n",
+               grupo->depreciacao.soma, grupo->depreciacao.minimo, grupo->depreciacao.maximo,
+               estatistica_media(&grupo->depreciacao, grupo->quantidade));
+        printf("    Idade (anos): mín %.1f | máx %.1f | média %.1f\n",
+               grupo->idadeAnos.minimo, grupo->idadeAnos.maximo,
+               estatistica_media(&grupo->idadeAnos, grupo->quantidade));
+    }
+    printf("Total de grupos: %d\n", agregacao->numGrupos);
+}
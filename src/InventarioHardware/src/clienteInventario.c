@@ -0,0 +1,135 @@
+#include "clienteInventario.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define TRECHO_LEITURA (64 * 1024)
+
+bool cliente_conectar(ClienteInventario* cliente, const char* caminhoSocket) {
+    memset(cliente, 0, sizeof(*cliente));
+    cliente->fd = -1;
+    texto_buffer_init(&cliente->envio);
+    texto_buffer_init(&cliente->recebido);
+
+    struct sockaddr_un endereco;
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    if (caminhoSocket == NULL || strlen(caminhoSocket) >= sizeof(endereco.sun_path)) return false;
+    strcpy(endereco.sun_path, caminhoSocket);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+    if (connect(fd, (struct sockaddr*)&endereco, sizeof(endereco)) != 0) {
+        close(fd);
+        return false;
+    }
+    cliente->fd = fd;
+    return true;
+}
+
+void cliente_desconectar(ClienteInventario* cliente) {
+    if (cliente->fd >= 0) close(cliente->fd);
+    cliente->fd = -1;
+    texto_buffer_liberar(&cliente->envio);
+    texto_buffer_liberar(&cliente->recebido);
+}
+
+bool cliente_enfileirar(ClienteInventario* cliente, const PedidoInventario* pedido) {
+    if (cliente->fd < 0) return false;
+    return pedido_codificar(&cliente->envio, pedido, cliente->proximaSequencia++);
+}
+
+static bool cliente_descarregar(ClienteInventario* cliente) {
+    size_t enviado = 0;
+    while (enviado < cliente->envio.tamanho) {
+        ssize_t n = send(cliente->fd, cliente->envio.dados + enviado, cliente->envio.tamanho - enviado, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        enviado += (size_t)n;
+    }
+    cliente->envio.tamanho = 0;
+    return true;
+}
+
+bool cliente_receber(ClienteInventario* cliente, RespostaInventario* resposta) {
+    if (cliente->fd < 0 || cliente->sequenciaEsperada == cliente->proximaSequencia) return false;
+    if (cliente->envio.tamanho > 0 && !cliente_descarregar(cliente)) return false;
+
+    CabecalhoQuadro cabecalho;
+    char trecho[TRECHO_LEITURA];
+    while (true) {
+        if (quadro_cabecalho(cliente->recebido.dados, cliente->recebido.tamanho, &cabecalho)) {
+            if (cabecalho.tamanho > QUADRO_RESPOSTA_MAXIMO || cabecalho.sequencia != cliente->sequenciaEsperada) {
+                fprintf(stderr, "Resposta fora do protocolo (sequência %u, esperada %u).\n",
+                        cabecalho.sequencia, cliente->sequenciaEsperada);
+                return false;
+            }
+            if (cliente->recebido.tamanho >= QUADRO_CABECALHO + (size_t)cabecalho.tamanho) break;
+        }
+        ssize_t lidos = read(cliente->fd, trecho, sizeof(trecho));
+        if (lidos < 0 && errno == EINTR) continue;
+        if (lidos <= 0 || !texto_buffer_anexar_bytes(&cliente->recebido, trecho, (size_t)lidos)) return false;
+    }
+
+    bool ok = resposta_decodificar(&cabecalho, cliente->recebido.dados + QUADRO_CABECALHO, resposta);
+    size_t consumido = QUADRO_CABECALHO + cabecalho.tamanho;
+    memmove(cliente->recebido.dados, cliente->recebido.dados + consumido, cliente->recebido.tamanho - consumido);
+    cliente->recebido.tamanho -= consumido;
+    cliente->sequenciaEsperada++;
+    return ok;
+}
+
+#else
+
+bool cliente_conectar(ClienteInventario* cliente, const char* caminhoSocket) {
+    (void)caminhoSocket;
+    memset(cliente, 0, sizeof(*cliente));
+    cliente->fd = -1;
+    fprintf(stderr, "O cliente do servidor está disponível apenas no Linux.\n");
+    return false;
+}
+
+void cliente_desconectar(ClienteInventario* cliente) {
+    texto_buffer_liberar(&cliente->envio);
+    texto_buffer_liberar(&cliente->recebido);
+}
+
+bool cliente_enfileirar(ClienteInventario* cliente, const PedidoInventario* pedido) {
+    (void)cliente;
+    (void)pedido;
+    return false;
+}
+
+bool cliente_receber(ClienteInventario* cliente, RespostaInventario* resposta) {
+    (void)cliente;
+    (void)resposta;
+    return false;
+}
+
+#endif
+
+bool cliente_executar(ClienteInventario* cliente, const PedidoInventario* pedido, RespostaInventario* resposta) {
+    return cliente_enfileirar(cliente, pedido) && cliente_receber(cliente, resposta);
+}
+
+bool cliente_executar_lote(ClienteInventario* cliente, const PedidoInventario* pedidos, int quantidade,
+                           RespostaInventario* respostas) {
+    for (int i = 0; i < quantidade; i++) {
+        if (!cliente_enfileirar(cliente, &pedidos[i])) return false;
+    }
+    for (int i = 0; i < quantidade; i++) {
+        if (!cliente_receber(cliente, &respostas[i])) {
+            while (--i >= 0) resposta_liberar(&respostas[i]);
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,144 @@
+#include "compressaoLz.h"
+#include <stdint.h>
+#include <string.h>
+
+#define LZ_COPIA_MINIMA 4
+#define LZ_JANELA 65535
+#define LZ_BITS_HASH 14
+// Os últimos bytes vão sempre como literais; assim a busca nunca lê além do fim da entrada
+#define LZ_MARGEM_FINAL 12
+#define LZ_LITERAIS_FINAIS 5
+
+static uint32_t lz_ler32(const unsigned char* p) {
+    uint32_t valor;
+    memcpy(&valor, p, sizeof(valor));
+    return valor;
+}
+
+static uint32_t lz_hash(uint32_t valor) {
+    return (valor * 2654435761u) >> (32 - LZ_BITS_HASH);
+}
+
+// Comprimentos a partir de 15 continuam em bytes de 255 terminados por um byte menor
+static unsigned char* lz_escrever_comprimento(unsigned char* saida, size_t resto) {
+    while (resto >= 255) {
+        *saida++ = 255;
+        resto -= 255;
+    }
+    *saida++ = (unsigned char)resto;
+    return saida;
+}
+
+static bool lz_ler_comprimento(const unsigned char** entrada, const unsigned char* fim, size_t* comprimento) {
+    unsigned char byte;
+    do {
+        if (*entrada >= fim) return false;
+        byte = *(*entrada)++;
+        *comprimento += byte;
+    } while (byte == 255);
+    return true;
+}
+
+static unsigned char* lz_escrever_literais(unsigned char* saida, unsigned char* token, const unsigned char* literais, size_t quantidade) {
+    *token = (unsigned char)((quantidade >= 15 ? 15 : quantidade) << 4);
+    if (quantidade >= 15) saida = lz_escrever_comprimento(saida, quantidade - 15);
+    memcpy(saida, literais, quantidade);
+    return saida + quantidade;
+}
+
+size_t lz_limite_comprimido(size_t tamanho) {
+    return tamanho + tamanho / 255 + 16;
+}
+
+size_t lz_comprimir(const unsigned char* entrada, size_t tamanho, unsigned char* saida, size_t capacidade) {
+    if (capacidade < lz_limite_comprimido(tamanho)) return 0;
+
+    // Posição + 1 da última ocorrência de cada hash de 4 bytes; 0 marca posição vazia
+    uint32_t tabela[1 << LZ_BITS_HASH];
+    memset(tabela, 0, sizeof(tabela));
+
+    const unsigned char* ip = entrada;
+    const unsigned char* ancora = entrada;
+    const unsigned char* fim = entrada + tamanho;
+    const unsigned char* limiteBusca = tamanho > LZ_MARGEM_FINAL ? fim - LZ_MARGEM_FINAL : entrada;
+    const unsigned char* limiteCopia = tamanho > LZ_LITERAIS_FINAIS ? fim - LZ_LITERAIS_FINAIS : entrada;
+    unsigned char* op = saida;
+    unsigned falhas = 0;
+
+    while (ip < limiteBusca) {
+        uint32_t valor = lz_ler32(ip);
+        uint32_t h = lz_hash(valor);
+        uint32_t candidato = tabela[h];
+        tabela[h] = (uint32_t)(ip - entrada) + 1;
+
+        const unsigned char* ref = candidato > 0 ? entrada + candidato - 1 : NULL;
+        if (ref == NULL || ip - ref > LZ_JANELA || lz_ler32(ref) != valor) {
+            // Em trechos sem repetição o passo cresce, para não gastar tempo em dados incompressíveis
+            size_t passo = 1 + (falhas++ >> 6);
+            if ((size_t)(limiteBusca - ip) <= passo) break;
+            ip += passo;
+            continue;
+        }
+        falhas = 0;
+
+        size_t comprimento = LZ_COPIA_MINIMA;
+        while (ip + comprimento < limiteCopia && ref[comprimento] == ip[comprimento]) comprimento++;
+
+        unsigned char* token = op++;
+        op = lz_escrever_literais(op, token, ancora, (size_t)(ip - ancora));
+        size_t deslocamento = (size_t)(ip - ref);
+        *op++ = (unsigned char)(deslocamento & 0xFF);
+        *op++ = (unsigned char)(deslocamento >> 8);
+
+        size_t resto = comprimento - LZ_COPIA_MINIMA;
+        *token |= (unsigned char)(resto >= 15 ? 15 : resto);
+        if (resto >= 15) op = lz_escrever_comprimento(op, resto - 15);
+
+        ip += comprimento;
+        ancora = ip;
+    }
+
+    // Última sequência: só literais, sem deslocamento
+    unsigned char* token = op++;
+    op = lz_escrever_literais(op, token, ancora, (size_t)(fim - ancora));
+    return (size_t)(op - saida);
+}
+
+bool lz_descomprimir(const unsigned char* entrada, size_t tamanho, unsigned char* saida, size_t tamanhoSaida) {
+    const unsigned char* ip = entrada;
+    const unsigned char* fim = entrada + tamanho;
+    unsigned char* op = saida;
+    unsigned char* fimSaida = saida + tamanhoSaida;
+
+    while (ip < fim) {
+        unsigned token = *ip++;
+
+        size_t literais = token >> 4;
+        if (literais == 15 && !lz_ler_comprimento(&ip, fim, &literais)) return false;
+        if ((size_t)(fim - ip) < literais || (size_t)(fimSaida - op) < literais) return false;
+        memcpy(op, ip, literais);
+        op += literais;
+        ip += literais;
+        if (ip == fim) break;
+
+        if (fim - ip < 2) return false;
+        size_t deslocamento = (size_t)ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        if (deslocamento == 0 || deslocamento > (size_t)(op - saida)) return false;
+
+        size_t comprimento = token & 15;
+        if (comprimento == 15 && !lz_ler_comprimento(&ip, fim, &comprimento)) return false;
+        comprimento += LZ_COPIA_MINIMA;
+        if ((size_t)(fimSaida - op) < comprimento) return false;
+
+        const unsigned char* ref = op - deslocamento;
+        if (deslocamento >= comprimento) {
+            memcpy(op, ref, comprimento);
+        } else {
+            // Cópia sobreposta (repetição de um padrão curto): byte a byte
+            for (size_t i = 0; i < comprimento; i++) op[i] = ref[i];
+        }
+        op += comprimento;
+    }
+    return op == fimSaida;
+}
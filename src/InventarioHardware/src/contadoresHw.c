@@ -0,0 +1,171 @@
+#include "contadoresHw.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char* NOMES_CONTADORES[NUM_CONTADORES_HW] = {
+    "ciclos", "instrucoes", "cache_misses", "branch_misses", "page_faults"
+};
+
+const char* contador_hw_nome(ContadorHw contador) {
+    return (contador >= 0 && contador < NUM_CONTADORES_HW) ? NOMES_CONTADORES[contador] : "?";
+}
+
+#ifdef __linux__
+
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+static const struct {
+    unsigned int tipo;
+    unsigned long long config;
+} EVENTOS[NUM_CONTADORES_HW] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+};
+
+static int descritores[NUM_CONTADORES_HW] = {-1, -1, -1, -1, -1};
+static int posicaoNoGrupo[NUM_CONTADORES_HW] = {-1, -1, -1, -1, -1};
+static int lider = -1;
+static int membros = 0;
+static bool herdado = false;
+static bool ativos = false;
+
+// Só o líder nasce desligado: habilitá-lo liga o grupo inteiro de uma vez
+static int abrir_contador(unsigned int tipo, unsigned long long config, int grupo, bool herdar) {
+    struct perf_event_attr atributos;
+    memset(&atributos, 0, sizeof(atributos));
+    atributos.size = sizeof(atributos);
+    atributos.type = tipo;
+    atributos.config = config;
+    atributos.disabled = grupo < 0;
+    atributos.inherit = herdar;
+    atributos.exclude_kernel = 1;
+    atributos.exclude_hv = 1;
+    atributos.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return (int)syscall(SYS_perf_event_open, &atributos, 0, -1, grupo, 0);
+}
+
+static void fechar_grupo() {
+    for (int i = 0; i < NUM_CONTADORES_HW; i++) {
+        if (descritores[i] >= 0) close(descritores[i]);
+        descritores[i] = -1;
+        posicaoNoGrupo[i] = -1;
+    }
+    lider = -1;
+    membros = 0;
+}
+
+// O primeiro evento aceito vira líder; a leitura do grupo devolve os valores na ordem de abertura
+static int abrir_grupo(bool herdar) {
+    for (int i = 0; i < NUM_CONTADORES_HW; i++) {
+        descritores[i] = abrir_contador(EVENTOS[i].tipo, EVENTOS[i].config, lider, herdar);
+        if (descritores[i] < 0) continue;
+        if (lider < 0) lider = descritores[i];
+        posicaoNoGrupo[i] = membros++;
+    }
+    return membros;
+}
+
+// Abre o grupo na thread atual, herdado pelas threads criadas depois. Cada contador que o kernel
+// recusar fica indisponível; se nenhum abrir (por exemplo com perf_event_paranoid restritivo) o modo
+// continua desligado.
+bool contadores_hw_iniciar() {
+    if (ativos) return true;
+
+    herdado = abrir_grupo(true) > 0;
+    if (!herdado) {
+        fechar_grupo();
+        abrir_grupo(false);
+    }
+
+    if (membros == 0) {
+        fprintf(stderr, "Contadores de hardware indisponíveis (verifique /proc/sys/kernel/perf_event_paranoid)\n");
+        return false;
+    }
+    if (membros < NUM_CONTADORES_HW) {
+        fprintf(stderr, "Alguns contadores de hardware não são suportados e serão reportados como n/d\n");
+    }
+    if (!herdado) {
+        fprintf(stderr, "Contadores de hardware medem só a thread principal; o trabalho do pool fica de fora\n");
+    }
+    ioctl(lider, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(lider, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    ativos = true;
+    return true;
+}
+
+void contadores_hw_encerrar() {
+    fechar_grupo();
+    ativos = false;
+}
+
+bool contadores_hw_ativos() {
+    return ativos;
+}
+
+const char* contadores_hw_escopo() {
+    return herdado ? "processo" : "thread chamadora";
+}
+
+void contadores_hw_ler(LeituraHw* leitura) {
+    // Formato de PERF_FORMAT_GROUP: quantidade, tempo habilitado, tempo contando, um valor por membro
+    unsigned long long dados[3 + NUM_CONTADORES_HW];
+    ssize_t lidos = lider >= 0 ? read(lider, dados, sizeof(dados)) : -1;
+    bool valida = lidos >= (ssize_t)(3 * sizeof(dados[0])) && dados[0] == (unsigned long long)membros;
+
+    leitura->habilitadoNs = valida ? (long long)dados[1] : -1;
+    leitura->contandoNs = valida ? (long long)dados[2] : -1;
+    for (int i = 0; i < NUM_CONTADORES_HW; i++) {
+        leitura->valores[i] = (valida && posicaoNoGrupo[i] >= 0) ? (long long)dados[3 + posicaoNoGrupo[i]] : -1;
+    }
+}
+
+#else
+
+bool contadores_hw_iniciar() {
+    fprintf(stderr, "Contadores de hardware só são suportados no Linux\n");
+    return false;
+}
+
+void contadores_hw_encerrar() {
+}
+
+bool contadores_hw_ativos() {
+    return false;
+}
+
+const char* contadores_hw_escopo() {
+    return "thread chamadora";
+}
+
+void contadores_hw_ler(LeituraHw* leitura) {
+    for (int i = 0; i < NUM_CONTADORES_HW; i++) {
+        leitura->valores[i] = -1;
+    }
+    leitura->habilitadoNs = -1;
+    leitura->contandoNs = -1;
+}
+
+#endif
+
+// O grupo só conta enquanto está no processador; fora dele o tempo habilitado avança e o contando não,
+// e a variação é estendida ao intervalo inteiro na mesma proporção
+void contadores_hw_variacao(const LeituraHw* inicio, const LeituraHw* fim, long long* variacoes) {
+    long long habilitado = fim->habilitadoNs - inicio->habilitadoNs;
+    long long contando = fim->contandoNs - inicio->contandoNs;
+    bool tempos = inicio->contandoNs >= 0 && fim->contandoNs >= 0 && contando > 0;
+    for (int i = 0; i < NUM_CONTADORES_HW; i++) {
+        if (!tempos || inicio->valores[i] < 0 || fim->valores[i] < 0) {
+            variacoes[i] = -1;
+            continue;
+        }
+        long long variacao = fim->valores[i] - inicio->valores[i];
+        variacoes[i] = contando < habilitado ? (long long)((double)variacao * habilitado / contando) : variacao;
+    }
+}
@@ -0,0 +1,157 @@
+#include "crc32c.h"
+#include <pthread.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define CRC32C_SSE42 1
+#include <nmmintrin.h>
+#endif
+
+#define CRC32C_POLINOMIO_REFLETIDO 0x82F63B78u
+
+// Com a instrução, três faixas de FAIXA_CRC bytes são calculadas intercaladas (a instrução tem
+// latência 3 e vazão 1) e depois combinadas deslocando os CRCs parciais sobre FAIXA_CRC zeros
+#define FAIXA_CRC 4096
+
+// tabela[k][b]: CRC de b seguido de k bytes zero; permite consumir 8 bytes por iteração
+static uint32_t tabela[8][256];
+// zeros[f][k][b]: efeito de (f + 1) * FAIXA_CRC bytes zero sobre o byte k do registrador valendo b
+static uint32_t zeros[2][4][256];
+static pthread_once_t tabelaPronta = PTHREAD_ONCE_INIT;
+
+static uint32_t registrador_avancar_zeros(uint32_t crc, size_t quantidade) {
+    while (quantidade-- > 0) crc = (crc >> 8) ^ tabela[0][crc & 0xFF];
+    return crc;
+}
+
+static void tabela_montar(void) {
+    for (uint32_t b = 0; b < 256; b++) {
+        uint32_t crc = b;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (CRC32C_POLINOMIO_REFLETIDO & (0u - (crc & 1)));
+        }
+        tabela[0][b] = crc;
+    }
+    for (uint32_t b = 0; b < 256; b++) {
+        for (int k = 1; k < 8; k++) {
+            tabela[k][b] = (tabela[k - 1][b] >> 8) ^ tabela[0][tabela[k - 1][b] & 0xFF];
+        }
+    }
+    // Avançar sobre zeros é linear: basta o efeito de cada bit, combinado por byte
+    for (int f = 0; f < 2; f++) {
+        uint32_t bases[32];
+        for (int bit = 0; bit < 32; bit++) {
+            bases[bit] = registrador_avancar_zeros(1u << bit, (size_t)(f + 1) * FAIXA_CRC);
+        }
+        for (int k = 0; k < 4; k++) {
+            for (uint32_t b = 0; b < 256; b++) {
+                uint32_t valor = 0;
+                for (int bit = 0; bit < 8; bit++) {
+                    if (b & (1u << bit)) valor ^= bases[k * 8 + bit];
+                }
+                zeros[f][k][b] = valor;
+            }
+        }
+    }
+}
+
+#if defined(CRC32C_SSE42) && defined(__x86_64__)
+static uint32_t deslocar_faixas(uint32_t crc, int faixas) {
+    const uint32_t (*z)[256] = zeros[faixas - 1];
+    return z[0][crc & 0xFF] ^ z[1][(crc >> 8) & 0xFF] ^ z[2][(crc >> 16) & 0xFF] ^ z[3][crc >> 24];
+}
+#endif
+
+static uint32_t crc32c_software(uint32_t crc, const unsigned char* p, size_t tamanho) {
+    pthread_once(&tabelaPronta, tabela_montar);
+    while (tamanho > 0 && ((uintptr_t)p & 7) != 0) {
+        crc = (crc >> 8) ^ tabela[0][(crc ^ *p++) & 0xFF];
+        tamanho--;
+    }
+    while (tamanho >= 8) {
+        uint32_t baixo, alto;
+        memcpy(&baixo, p, 4);
+        memcpy(&alto, p + 4, 4);
+        // Tabela montada para leitura little-endian, como em todas as plataformas suportadas
+        baixo ^= crc;
+        crc = tabela[7][baixo & 0xFF] ^ tabela[6][(baixo >> 8) & 0xFF] ^
+              tabela[5][(baixo >> 16) & 0xFF] ^ tabela[4][baixo >> 24] ^
+              tabela[3][alto & 0xFF] ^ tabela[2][(alto >> 8) & 0xFF] ^
+              tabela[1][(alto >> 16) & 0xFF] ^ tabela[0][alto >> 24];
+        p += 8;
+        tamanho -= 8;
+    }
+    while (tamanho-- > 0) {
+        crc = (crc >> 8) ^ tabela[0][(crc ^ *p++) & 0xFF];
+    }
+    return crc;
+}
+
+#ifdef CRC32C_SSE42
+
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_sse42(uint32_t crc, const unsigned char* p, size_t tamanho) {
+    pthread_once(&tabelaPronta, tabela_montar);
+    while (tamanho > 0 && ((uintptr_t)p & 7) != 0) {
+        crc = _mm_crc32_u8(crc, *p++);
+        tamanho--;
+    }
+#ifdef __x86_64__
+    while (tamanho >= 3 * FAIXA_CRC) {
+        uint64_t a = crc, b = 0, c = 0;
+        for (size_t i = 0; i < FAIXA_CRC; i += 8) {
+            uint64_t va, vb, vc;
+            memcpy(&va, p + i, 8);
+            memcpy(&vb, p + FAIXA_CRC + i, 8);
+            memcpy(&vc, p + 2 * FAIXA_CRC + i, 8);
+            a = _mm_crc32_u64(a, va);
+            b = _mm_crc32_u64(b, vb);
+            c = _mm_crc32_u64(c, vc);
+        }
+        crc = deslocar_faixas((uint32_t)a, 2) ^ deslocar_faixas((uint32_t)b, 1) ^ (uint32_t)c;
+        p += 3 * FAIXA_CRC;
+        tamanho -= 3 * FAIXA_CRC;
+    }
+    uint64_t crc64 = crc;
+    while (tamanho >= 8) {
+        uint64_t valor;
+        memcpy(&valor, p, 8);
+        crc64 = _mm_crc32_u64(crc64, valor);
+        p += 8;
+        tamanho -= 8;
+    }
+    crc = (uint32_t)crc64;
+#endif
+    while (tamanho >= 4) {
+        uint32_t valor;
+        memcpy(&valor, p, 4);
+        crc = _mm_crc32_u32(crc, valor);
+        p += 4;
+        tamanho -= 4;
+    }
+    while (tamanho-- > 0) {
+        crc = _mm_crc32_u8(crc, *p++);
+    }
+    return crc;
+}
+
+bool crc32c_acelerado(void) {
+    return __builtin_cpu_supports("sse4.2");
+}
+
+#else
+
+bool crc32c_acelerado(void) {
+    return false;
+}
+
+#endif
+
+uint32_t crc32c_atualizar(uint32_t crc, const void* dados, size_t tamanho) {
+    const unsigned char* p = (const unsigned char*)dados;
+    crc = ~crc;
+#ifdef CRC32C_SSE42
+    if (crc32c_acelerado()) return ~crc32c_sse42(crc, p, tamanho);
+#endif
+    return ~crc32c_software(crc, p, tamanho);
+}
@@ -1,4 +1,5 @@
 #include "data.h"
+#include "memoria.h"
 #include <time.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -16,7 +17,7 @@ Data obter_data_atual() {
 }
 
 char* data_to_string(const Data* data) {
-    char* str = malloc(11); 
+    char* str = mem_alocar(MEMORIA_TEXTO, 11); 
     if (str) {
         sprintf(str, "%02d/%02d/%04d", data->dia, data->mes, data->ano);
     }
@@ -0,0 +1,20 @@
+#include "depreciacao.h"
+#include <stddef.h>
+
+// Regra sobre os campos soltos, para servir tanto à lista quanto às colunas e ao índice
+double depreciacao_acumulada(double valorCompra, int vidaUtilAnos, const Data* dataCompra, const Data* hoje) {
+    int anos = hoje->ano - dataCompra->ano;
+    if (hoje->mes < dataCompra->mes || (hoje->mes == dataCompra->mes && hoje->dia < dataCompra->dia)) {
+        anos--;
+    }
+    
+    if (anos <= 0) return 0.0;
+    if (anos >= vidaUtilAnos) return valorCompra;
+    
+    return (valorCompra / vidaUtilAnos) * anos;
+}
+
+double calcular_depreciacao(const Hardware* hw, const Data* hoje) {
+    if (hw == NULL || hoje == NULL) return 0.0;
+    return depreciacao_acumulada(hw->valorCompra, hw->vidaUtilAnos, &hw->dataCompra, hoje);
+}
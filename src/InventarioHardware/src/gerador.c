@@ -0,0 +1,88 @@
+#include "gerador.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+static const char* FABRICANTES[] = {
+    "Dell", "HP", "Lenovo", "Cisco", "Apple", "Epson", "Brother", "Juniper",
+    "Samsung", "Asus", "Acer", "Positivo", "Huawei", "TP-Link", "Ubiquiti", "Supermicro",
+    "Canon", "Xerox", "Aruba", "Fortinet", "Intelbras", "Mikrotik", "Ricoh", "Lexmark",
+    "MSI", "Gigabyte", "Netgear", "D-Link", "Kyocera", "IBM", "Oracle", "Fujitsu"
+};
+#define NUM_FABRICANTES ((int)(sizeof(FABRICANTES) / sizeof(FABRICANTES[0])))
+
+// Distribuição de tipos típica de um parque corporativo (percentuais acumulados)
+static const int PERCENTUAL_TIPO[NUM_TIPOS_HARDWARE] = {55, 70, 77, 85, 95, 100};
+static const int VIDA_UTIL_MIN[NUM_TIPOS_HARDWARE] = {3, 4, 5, 5, 6, 2};
+static const int VIDA_UTIL_MAX[NUM_TIPOS_HARDWARE] = {5, 7, 8, 8, 10, 6};
+static const double VALOR_BASE[NUM_TIPOS_HARDWARE] = {4500.0, 2200.0, 28000.0, 3500.0, 9000.0, 800.0};
+static const char* PREFIXO_NOME[NUM_TIPOS_HARDWARE] = {"Estacao", "Impressora", "Servidor", "Roteador", "Switch", "Periferico"};
+
+void gerador_init(GeradorAleatorio* gerador, uint64_t semente) {
+    gerador->estado = semente ? semente : 0x9E3779B97F4A7C15ULL;
+}
+
+uint64_t gerador_proximo(GeradorAleatorio* gerador) {
+    uint64_t x = gerador->estado;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    gerador->estado = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+int gerador_intervalo(GeradorAleatorio* gerador, int minimo, int maximo) {
+    return minimo + (int)(gerador_proximo(gerador) % (uint64_t)(maximo - minimo + 1));
+}
+
+double gerador_uniforme(GeradorAleatorio* gerador) {
+    return (gerador_proximo(gerador) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Fabricante com distribuição aproximadamente Zipf: poucos fornecedores concentram o parque
+static int gerador_fabricante(GeradorAleatorio* gerador) {
+    double u = gerador_uniforme(gerador);
+    int indice = (int)(pow(NUM_FABRICANTES + 1.0, u)) - 1;
+    return indice < NUM_FABRICANTES ? indice : NUM_FABRICANTES - 1;
+}
+
+static Data gerador_data(GeradorAleatorio* gerador, int anoMin, int anoMax) {
+    Data data;
+    data.ano = gerador_intervalo(gerador, anoMin, anoMax);
+    data.mes = gerador_intervalo(gerador, 1, 12);
+    data.dia = gerador_intervalo(gerador, 1, 28);
+    return data;
+}
+
+void gerador_hardware(GeradorAleatorio* gerador, int id, Hardware* hw) {
+    int sorteio = gerador_intervalo(gerador, 1, 100);
+    int tipo = 0;
+    while (tipo < NUM_TIPOS_HARDWARE - 1 && sorteio > PERCENTUAL_TIPO[tipo]) tipo++;
+
+    hw->id = id;
+    hw->tipo = (TipoHardware)tipo;
+    snprintf(hw->nome, sizeof(hw->nome), "%s %06d", PREFIXO_NOME[tipo], id);
+    strcpy(hw->fabricante, FABRICANTES[gerador_fabricante(gerador)]);
+
+    hw->dataCompra = gerador_data(gerador, 2005, 2025);
+    hw->vidaUtilAnos = gerador_intervalo(gerador, VIDA_UTIL_MIN[tipo], VIDA_UTIL_MAX[tipo]);
+    hw->valorCompra = floor(VALOR_BASE[tipo] * (0.5 + 1.5 * gerador_uniforme(gerador)) * 100.0) / 100.0;
+
+    // Última manutenção entre a compra e 2026
+    hw->ultimaManutencao = gerador_data(gerador, hw->dataCompra.ano, 2026);
+    if (data_menor_que(&hw->ultimaManutencao, &hw->dataCompra)) {
+        hw->ultimaManutencao = hw->dataCompra;
+    }
+    hw->obsoleto = false;
+}
+
+void gerador_inventario(LinkedList* list, int quantidade, uint64_t semente) {
+    GeradorAleatorio gerador;
+    gerador_init(&gerador, semente);
+
+    for (int i = 1; i <= quantidade; i++) {
+        Hardware hw;
+        gerador_hardware(&gerador, i, &hw);
+        linkedlist_push_back(list, &hw);
+    }
+}
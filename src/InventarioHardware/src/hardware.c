@@ -1,5 +1,6 @@
 #include "hardware.h"
 #include "data.h"
+#include "memoria.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -33,7 +34,7 @@ char* hardware_to_csv(const Hardware* hw) {
                         dataCompraStr, hw->valorCompra, hw->vidaUtilAnos,
                         ultimaManutencaoStr, hw->obsoleto ? 1 : 0);
     
-    char* csv = malloc(size + 1);
+    char* csv = mem_alocar(MEMORIA_TEXTO, size + 1);
     if (csv) {
         sprintf(csv, "%d;%s;%s;%s;%s;%.2f;%d;%s;%d",
                 hw->id, hw->nome, hw->fabricante, tipo_to_string(hw->tipo),
@@ -41,8 +42,8 @@ char* hardware_to_csv(const Hardware* hw) {
                 ultimaManutencaoStr, hw->obsoleto ? 1 : 0);
     }
     
-    free(dataCompraStr);
-    free(ultimaManutencaoStr);
+    mem_liberar(dataCompraStr);
+    mem_liberar(ultimaManutencaoStr);
     return csv;
 }
 
@@ -107,7 +108,7 @@ char* hardware_to_string(const Hardware* hw) {
                         dataCompraStr, ultimaManutencaoStr, hw->valorCompra,
                         hw->vidaUtilAnos, hw->obsoleto ? "OBSOLETO" : "Ativo");
     
-    char* str = malloc(size + 1);
+    char* str = mem_alocar(MEMORIA_TEXTO, size + 1);
     if (str) {
         sprintf(str, "ID: %d | %s (%s) | Tipo: %s | Compra: %s | Última manutenção: %s | Valor: R$%.2f | Vida útil: %d anos | %s",
                 hw->id, hw->nome, hw->fabricante, tipo_to_string(hw->tipo),
@@ -115,7 +116,7 @@ char* hardware_to_string(const Hardware* hw) {
                 hw->vidaUtilAnos, hw->obsoleto ? "OBSOLETO" : "Ativo");
     }
     
-    free(dataCompraStr);
-    free(ultimaManutencaoStr);
+    mem_liberar(dataCompraStr);
+    mem_liberar(ultimaManutencaoStr);
     return str;
 }
\ No newline at end of file
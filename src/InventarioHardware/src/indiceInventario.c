@@ -0,0 +1,170 @@
+#include "indiceInventario.h"
+#include "memoria.h"
+#include "trace.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+
+void indice_inventario_init(IndiceInventario* indice) {
+    indice->arquivo = NULL;
+    indice->posicaoArquivo = -1;
+    indice->entradas = NULL;
+    indice->tamanho = 0;
+    indice->capacidade = 0;
+    indice->maiorId = 0;
+    mapa_int_init(&indice->porId);
+    mapa_int_init(&indice->cache);
+}
+
+void indice_inventario_liberar(IndiceInventario* indice) {
+    for (size_t i = 0; i < indice->cache.capacidade; i++) {
+        if (indice->cache.ocupado[i]) mem_liberar((void*)indice->cache.valores[i]);
+    }
+    mapa_int_destruir(&indice->cache);
+    mapa_int_destruir(&indice->porId);
+    mem_liberar(indice->entradas);
+    if (indice->arquivo) fclose(indice->arquivo);
+    indice_inventario_init(indice);
+}
+
+// Mesmas regras de hardware_from_csv (9 campos, datas válidas), sem copiar nome e fabricante
+static bool ler_campos_indice(char* linha, EntradaIndice* entrada) {
+    char* campos[9];
+    int i = 0;
+    char* inicio = linha;
+    for (char* atual = linha; *atual != '\0' && i < 9; atual++) {
+        if (*atual == ';') {
+            *atual = '\0';
+            campos[i++] = inicio;
+            inicio = atual + 1;
+        }
+    }
+    if (i < 9) campos[i++] = inicio;
+    if (i != 9) return false;
+
+    entrada->id = atoi(campos[0]);
+    entrada->tipo = string_to_tipo(campos[3]);
+    if (!data_from_string(campos[4], &entrada->dataCompra)) return false;
+    entrada->valorCompra = atof(campos[5]);
+    entrada->vidaUtilAnos = atoi(campos[6]);
+    return data_from_string(campos[7], &entrada->ultimaManutencao);
+}
+
+static bool indice_garantir_capacidade(IndiceInventario* indice) {
+    if (indice->tamanho < indice->capacidade) return true;
+
+    int novaCapacidade = indice->capacidade ? indice->capacidade * 2 : 1024;
+    EntradaIndice* novo = mem_realocar(MEMORIA_INDICES, indice->entradas, sizeof(EntradaIndice) * novaCapacidade);
+    if (!novo) return false;
+    indice->entradas = novo;
+    indice->capacidade = novaCapacidade;
+    return true;
+}
+
+// Percorre o CSV uma vez guardando o deslocamento de cada linha válida, como csv_carregar faria
+bool indice_inventario_construir(IndiceInventario* indice, const char* arquivo) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    indice_inventario_liberar(indice);
+    indice->arquivo = fopen(arquivo, "r");
+    if (!indice->arquivo) {
+        cronometro_parar(&crono);
+        cronometro_imprimir("Índice - Construir (falha)", &crono);
+        return false;
+    }
+
+    char linha[1024];
+    if (fgets(linha, sizeof(linha), indice->arquivo) == NULL) {
+        indice_inventario_liberar(indice);
+        cronometro_parar(&crono);
+        cronometro_imprimir("Índice - Construir (vazio)", &crono);
+        return false;
+    }
+
+    bool ok = true;
+    trace_inicio("Índice: leitura dos campos");
+    long long deslocamento = ftell(indice->arquivo);
+    while (ok && fgets(linha, sizeof(linha), indice->arquivo) != NULL) {
+        long long proximo = ftell(indice->arquivo);
+        linha[strcspn(linha, "\n")] = '\0';
+
+        EntradaIndice entrada;
+        if (linha[0] != '\0' && ler_campos_indice(linha, &entrada)) {
+            entrada.deslocamento = deslocamento;
+            ok = indice_garantir_capacidade(indice);
+            if (ok) {
+                intptr_t existente;
+                if (!mapa_int_buscar(&indice->porId, entrada.id, &existente)) {
+                    ok = mapa_int_inserir(&indice->porId, entrada.id, indice->tamanho);
+                }
+                if (entrada.id > indice->maiorId) indice->maiorId = entrada.id;
+                indice->entradas[indice->tamanho++] = entrada;
+            }
+        }
+        deslocamento = proximo;
+    }
+    trace_fim("Índice: leitura dos campos");
+
+    if (!ok) {
+        indice_inventario_liberar(indice);
+        cronometro_parar(&crono);
+        cronometro_imprimir("Índice - Construir (memória insuficiente)", &crono);
+        return false;
+    }
+
+    cronometro_parar(&crono);
+    if (cronometro_console_ativo()) printf("[ÍNDICE] Indexados %d itens - ", indice->tamanho);
+    cronometro_definir_registros(indice->tamanho);
+    cronometro_imprimir("Construir índice", &crono);
+    return true;
+}
+
+// fseek descarta o buffer do arquivo; linhas lidas em sequência seguem do ponto onde a anterior terminou
+static bool indice_ler_linha(IndiceInventario* indice, int posicao, Hardware* destino) {
+    char linha[1024];
+    long long deslocamento = indice->entradas[posicao].deslocamento;
+    if (deslocamento != indice->posicaoArquivo && fseek(indice->arquivo, (long)deslocamento, SEEK_SET) != 0) {
+        indice->posicaoArquivo = -1;
+        return false;
+    }
+    if (fgets(linha, sizeof(linha), indice->arquivo) == NULL) {
+        indice->posicaoArquivo = -1;
+        return false;
+    }
+    indice->posicaoArquivo = deslocamento + (long long)strlen(linha);
+    linha[strcspn(linha, "\n")] = '\0';
+    return hardware_from_csv(linha, destino);
+}
+
+const Hardware* indice_inventario_obter(IndiceInventario* indice, int posicao) {
+    if (posicao < 0 || posicao >= indice->tamanho || indice->arquivo == NULL) return NULL;
+
+    intptr_t existente;
+    if (mapa_int_buscar(&indice->cache, posicao, &existente)) return (const Hardware*)existente;
+
+    Hardware* hw = mem_alocar(MEMORIA_REGISTROS, sizeof(Hardware));
+    if (!hw) return NULL;
+    if (!indice_ler_linha(indice, posicao, hw) || !mapa_int_inserir(&indice->cache, posicao, (intptr_t)hw)) {
+        mem_liberar(hw);
+        return NULL;
+    }
+    return hw;
+}
+
+bool indice_inventario_ler(IndiceInventario* indice, int posicao, Hardware* destino) {
+    if (posicao < 0 || posicao >= indice->tamanho || indice->arquivo == NULL) return false;
+
+    intptr_t existente;
+    if (mapa_int_buscar(&indice->cache, posicao, &existente)) {
+        *destino = *(const Hardware*)existente;
+        return true;
+    }
+    return indice_ler_linha(indice, posicao, destino);
+}
+
+const Hardware* indice_inventario_buscar(IndiceInventario* indice, int id) {
+    intptr_t posicao;
+    if (!mapa_int_buscar(&indice->porId, id, &posicao)) return NULL;
+    return indice_inventario_obter(indice, (int)posicao);
+}
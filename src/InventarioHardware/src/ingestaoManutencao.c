@@ -0,0 +1,150 @@
+#include "ingestaoManutencao.h"
+#include "memoria.h"
+#include "sistemaInventario.h"
+#include "trace.h"
+#include "utils.h"
+#include <stdint.h>
+#include <stdio.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+bool fila_manutencao_init(FilaManutencao* fila, size_t capacidade) {
+    size_t tamanho = 2;
+    while (tamanho < capacidade) tamanho *= 2;
+
+    fila->celulas = mem_alocar(MEMORIA_OUTROS, tamanho * sizeof(CelulaFila));
+    if (!fila->celulas) return false;
+    for (size_t i = 0; i < tamanho; i++) {
+        atomic_init(&fila->celulas[i].sequencia, i);
+    }
+    fila->mascara = tamanho - 1;
+    atomic_init(&fila->cauda, 0);
+    fila->cabeca = 0;
+    return true;
+}
+
+void fila_manutencao_destruir(FilaManutencao* fila) {
+    mem_liberar(fila->celulas);
+    fila->celulas = NULL;
+}
+
+bool fila_manutencao_publicar(FilaManutencao* fila, const EventoManutencao* evento) {
+    size_t posicao = atomic_load_explicit(&fila->cauda, memory_order_relaxed);
+    CelulaFila* celula;
+    while (true) {
+        celula = &fila->celulas[posicao & fila->mascara];
+        size_t sequencia = atomic_load_explicit(&celula->sequencia, memory_order_acquire);
+        intptr_t diferenca = (intptr_t)sequencia - (intptr_t)posicao;
+        if (diferenca == 0) {
+            // A célula está livre nesta volta; quem vencer a disputa pela cauda fica com ela
+            if (atomic_compare_exchange_weak_explicit(&fila->cauda, &posicao, posicao + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diferenca < 0) {
+            // O consumidor ainda não liberou a célula da volta anterior: fila cheia
+            return false;
+        } else {
+            posicao = atomic_load_explicit(&fila->cauda, memory_order_relaxed);
+        }
+    }
+    celula->evento = *evento;
+    atomic_store_explicit(&celula->sequencia, posicao + 1, memory_order_release);
+    return true;
+}
+
+int fila_manutencao_consumir(FilaManutencao* fila, EventoManutencao* lote, int maximo) {
+    int quantidade = 0;
+    while (quantidade < maximo) {
+        CelulaFila* celula = &fila->celulas[fila->cabeca & fila->mascara];
+        // Célula reservada mas ainda não escrita encerra o lote; o evento entra no próximo
+        if (atomic_load_explicit(&celula->sequencia, memory_order_acquire) != fila->cabeca + 1) break;
+        lote[quantidade++] = celula->evento;
+        atomic_store_explicit(&celula->sequencia, fila->cabeca + fila->mascara + 1, memory_order_release);
+        fila->cabeca++;
+    }
+    return quantidade;
+}
+
+// Espera curta do aplicador com a fila vazia; os produtores nunca esperam por ele
+static void ingestao_aguardar(void) {
+#ifdef _WIN32
+    Sleep(1);
+#else
+    struct timespec espera = {0, 200 * 1000};
+    nanosleep(&espera, NULL);
+#endif
+}
+
+static void* ingestao_aplicador(void* arg) {
+    IngestaoManutencao* ingestao = (IngestaoManutencao*)arg;
+    while (true) {
+        // encerrar é lido antes de consumir: visto o pedido, a fila já tem todos os envios anteriores
+        bool encerrando = atomic_load_explicit(&ingestao->encerrar, memory_order_acquire);
+        int quantidade = fila_manutencao_consumir(&ingestao->fila, ingestao->lote, ingestao->loteMaximo);
+        if (quantidade == 0) {
+            if (encerrando) break;
+            ingestao_aguardar();
+            continue;
+        }
+
+        // Mensagens do lote não podem cair na saída capturada de um pedido do servidor
+        saida_travar();
+        trace_inicio("Ingestão: lote de manutenções");
+        int alterados = sistema_aplicar_manutencoes(ingestao->sistema, ingestao->lote, quantidade);
+        trace_fim("Ingestão: lote de manutenções");
+        saida_destravar();
+        if (alterados < 0) {
+            ingestao->falhasGravacao++;
+        } else {
+            ingestao->registrosAlterados += alterados;
+        }
+        ingestao->eventosAplicados += quantidade;
+        ingestao->lotes++;
+    }
+    return NULL;
+}
+
+bool ingestao_iniciar(IngestaoManutencao* ingestao, SistemaInventario* sistema, size_t capacidadeFila, int loteMaximo) {
+    if (ingestao == NULL || sistema == NULL || loteMaximo <= 0) return false;
+
+    ingestao->sistema = sistema;
+    ingestao->loteMaximo = loteMaximo;
+    atomic_init(&ingestao->encerrar, false);
+    atomic_init(&ingestao->recusados, 0);
+    ingestao->eventosAplicados = 0;
+    ingestao->registrosAlterados = 0;
+    ingestao->lotes = 0;
+    ingestao->falhasGravacao = 0;
+
+    if (!fila_manutencao_init(&ingestao->fila, capacidadeFila)) return false;
+    ingestao->lote = mem_alocar(MEMORIA_TEMPORARIA, (size_t)loteMaximo * sizeof(EventoManutencao));
+    if (!ingestao->lote || pthread_create(&ingestao->aplicador, NULL, ingestao_aplicador, ingestao) != 0) {
+        fprintf(stderr, "Falha ao iniciar o aplicador de manutenções\n");
+        mem_liberar(ingestao->lote);
+        fila_manutencao_destruir(&ingestao->fila);
+        return false;
+    }
+    return true;
+}
+
+bool ingestao_enviar(IngestaoManutencao* ingestao, int id, const Data* data) {
+    EventoManutencao evento;
+    evento.id = id;
+    evento.data = *data;
+    if (fila_manutencao_publicar(&ingestao->fila, &evento)) return true;
+    atomic_fetch_add_explicit(&ingestao->recusados, 1, memory_order_relaxed);
+    return false;
+}
+
+void ingestao_encerrar(IngestaoManutencao* ingestao) {
+    if (ingestao == NULL) return;
+    atomic_store_explicit(&ingestao->encerrar, true, memory_order_release);
+    pthread_join(ingestao->aplicador, NULL);
+    mem_liberar(ingestao->lote);
+    ingestao->lote = NULL;
+    fila_manutencao_destruir(&ingestao->fila);
+}
@@ -0,0 +1,294 @@
+#include "leitorSegmento.h"
+#include "agendaManutencao.h"
+#include "obsolescencia.h"
+#include <stdio.h>
+#include <string.h>
+
+// Layout lido no início de uma tentativa, já conferido contra o tamanho mapeado
+typedef struct {
+    uint64_t sequencia;
+    int32_t ativo;
+    int32_t capacidadeTabela;
+    int32_t numRegistros;
+    const int32_t* tabela;
+    const RegistroSegmento* registros;
+} VisaoSegmento;
+
+typedef void (*OperacaoLeitura)(const VisaoSegmento* visao, void* contexto);
+
+#ifndef _WIN32
+
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Uma escrita de registro leva nanossegundos; só uma sincronização completa faz o leitor ceder a CPU
+#define LEITURA_TENTATIVAS 1000000
+#define TENTATIVAS_SEM_CEDER 64
+
+static CabecalhoSegmento* leitor_cabecalho(const LeitorSegmento* leitor) {
+    return (CabecalhoSegmento*)leitor->base;
+}
+
+static bool leitor_remapear(LeitorSegmento* leitor, uint64_t tamanho) {
+    void* base = mmap(NULL, tamanho, PROT_READ, MAP_SHARED, leitor->descritor, 0);
+    if (base == MAP_FAILED) return false;
+    munmap((void*)leitor->base, leitor->tamanho);
+    leitor->base = base;
+    leitor->tamanho = tamanho;
+    return true;
+}
+
+// false com o escritor no meio de uma escrita; valores incoerentes também só podem vir de uma
+// escrita em andamento, e a tentativa é descartada antes de usar qualquer deslocamento
+static bool leitura_iniciar(LeitorSegmento* leitor, VisaoSegmento* visao) {
+    CabecalhoSegmento* cabecalho = leitor_cabecalho(leitor);
+    visao->sequencia = atomic_load_explicit(&cabecalho->sequencia, memory_order_acquire);
+    if (visao->sequencia & 1) return false;
+
+    uint64_t tamanho = cabecalho->tamanho;
+    if (tamanho > leitor->tamanho) {
+        leitor_remapear(leitor, tamanho);
+        return false;
+    }
+
+    uint64_t deslocamentoTabela = cabecalho->deslocamentoTabela;
+    uint64_t deslocamentoRegistros = cabecalho->deslocamentoRegistros;
+    int32_t capacidadeTabela = cabecalho->capacidadeTabela;
+    int32_t capacidade = cabecalho->capacidade;
+    int32_t numRegistros = cabecalho->numRegistros;
+    if (capacidadeTabela <= 0 || (capacidadeTabela & (capacidadeTabela - 1)) != 0 ||
+        numRegistros < 0 || capacidade < numRegistros ||
+        deslocamentoTabela > leitor->tamanho ||
+        (uint64_t)capacidadeTabela * sizeof(int32_t) > leitor->tamanho - deslocamentoTabela ||
+        deslocamentoRegistros > leitor->tamanho ||
+        (uint64_t)capacidade * sizeof(RegistroSegmento) > leitor->tamanho - deslocamentoRegistros) {
+        return false;
+    }
+
+    visao->ativo = cabecalho->ativo;
+    visao->capacidadeTabela = capacidadeTabela;
+    visao->numRegistros = numRegistros;
+    visao->tabela = (const int32_t*)(leitor->base + deslocamentoTabela);
+    visao->registros = (const RegistroSegmento*)(leitor->base + deslocamentoRegistros);
+    return true;
+}
+
+static bool leitura_confirmar(const LeitorSegmento* leitor, const VisaoSegmento* visao) {
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&leitor_cabecalho(leitor)->sequencia, memory_order_relaxed) == visao->sequencia;
+}
+
+// Repete a operação até ela ler uma versão inteira sem escrita no meio
+static bool leitura_executar(LeitorSegmento* leitor, OperacaoLeitura operacao, void* contexto) {
+    if (leitor == NULL || leitor->base == NULL) return false;
+
+    VisaoSegmento visao;
+    for (int tentativa = 0; tentativa < LEITURA_TENTATIVAS; tentativa++) {
+        if (leitura_iniciar(leitor, &visao)) {
+            operacao(&visao, contexto);
+            if (leitura_confirmar(leitor, &visao)) return true;
+        }
+        if (tentativa >= TENTATIVAS_SEM_CEDER) sched_yield();
+    }
+    return false;
+}
+
+bool leitor_segmento_abrir(LeitorSegmento* leitor, const char* nome) {
+    memset(leitor, 0, sizeof(*leitor));
+    leitor->descritor = shm_open(nome, O_RDONLY, 0);
+    if (leitor->descritor < 0) return false;
+
+    struct stat info;
+    void* base = MAP_FAILED;
+    if (fstat(leitor->descritor, &info) == 0 && (size_t)info.st_size >= sizeof(CabecalhoSegmento)) {
+        base = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, leitor->descritor, 0);
+    }
+    const CabecalhoSegmento* cabecalho = base == MAP_FAILED ? NULL : base;
+    if (cabecalho == NULL || cabecalho->magico != SEGMENTO_MAGICO || cabecalho->versaoFormato != SEGMENTO_VERSAO_FORMATO) {
+        if (cabecalho) munmap(base, (size_t)info.st_size);
+        close(leitor->descritor);
+        leitor->descritor = -1;
+        return false;
+    }
+    leitor->base = base;
+    leitor->tamanho = (size_t)info.st_size;
+    return true;
+}
+
+void leitor_segmento_fechar(LeitorSegmento* leitor) {
+    if (leitor->base) munmap((void*)leitor->base, leitor->tamanho);
+    if (leitor->descritor >= 0) close(leitor->descritor);
+    leitor->base = NULL;
+    leitor->tamanho = 0;
+    leitor->descritor = -1;
+}
+
+#else
+
+static bool leitura_executar(LeitorSegmento* leitor, OperacaoLeitura operacao, void* contexto) {
+    (void)leitor;
+    (void)operacao;
+    (void)contexto;
+    return false;
+}
+
+bool leitor_segmento_abrir(LeitorSegmento* leitor, const char* nome) {
+    (void)nome;
+    memset(leitor, 0, sizeof(*leitor));
+    leitor->descritor = -1;
+    fprintf(stderr, "O segmento compartilhado está disponível apenas em sistemas POSIX.\n");
+    return false;
+}
+
+void leitor_segmento_fechar(LeitorSegmento* leitor) {
+    leitor->base = NULL;
+}
+
+#endif
+
+// ---------- Consultas ----------
+
+static bool registro_obsoleto(const RegistroSegmento* registro, const Data* hoje) {
+    Data fim = data_obsolescencia_campos(&registro->dataCompra, registro->vidaUtilAnos);
+    return !data_menor_que(hoje, &fim);
+}
+
+static bool registro_pendente(const RegistroSegmento* registro, const Data* hoje, int mesesLimite) {
+    return meses_desde(&registro->ultimaManutencao, hoje) >= mesesLimite;
+}
+
+static void hardware_de_registro(Hardware* destino, const RegistroSegmento* registro) {
+    destino->id = registro->id;
+    memcpy(destino->nome, registro->nome, sizeof(destino->nome));
+    destino->nome[sizeof(destino->nome) - 1] = '\0';
+    memcpy(destino->fabricante, registro->fabricante, sizeof(destino->fabricante));
+    destino->fabricante[sizeof(destino->fabricante) - 1] = '\0';
+    destino->tipo = (TipoHardware)registro->tipo;
+    destino->dataCompra = registro->dataCompra;
+    destino->valorCompra = registro->valorCompra;
+    destino->vidaUtilAnos = registro->vidaUtilAnos;
+    destino->ultimaManutencao = registro->ultimaManutencao;
+    destino->obsoleto = registro->obsoleto != 0;
+}
+
+static void operacao_estado(const VisaoSegmento* visao, void* contexto) {
+    VisaoSegmento* destino = contexto;
+    *destino = *visao;
+}
+
+bool leitor_segmento_ativo(LeitorSegmento* leitor) {
+    VisaoSegmento visao;
+    return leitura_executar(leitor, operacao_estado, &visao) && visao.ativo != 0;
+}
+
+int leitor_segmento_total(LeitorSegmento* leitor) {
+    VisaoSegmento visao;
+    return leitura_executar(leitor, operacao_estado, &visao) ? visao.numRegistros : -1;
+}
+
+typedef struct {
+    int id;
+    bool encontrado;
+    RegistroSegmento registro;
+} ContextoBusca;
+
+static void operacao_buscar(const VisaoSegmento* visao, void* contexto) {
+    ContextoBusca* busca = contexto;
+    busca->encontrado = false;
+
+    // Numa versão consistente toda entrada aponta para um registro existente; fora disso a
+    // tentativa vai ser descartada e basta não sair dos limites
+    uint32_t mascara = (uint32_t)visao->capacidadeTabela - 1;
+    uint32_t i = segmento_espalhar(busca->id, visao->capacidadeTabela);
+    for (int32_t passo = 0; passo < visao->capacidadeTabela; passo++, i = (i + 1) & mascara) {
+        int32_t posicao = visao->tabela[i];
+        if (posicao <= 0 || posicao > visao->numRegistros) return;
+        if (visao->registros[posicao - 1].id == busca->id) {
+            busca->registro = visao->registros[posicao - 1];
+            busca->encontrado = true;
+            return;
+        }
+    }
+}
+
+static bool leitor_buscar_registro(LeitorSegmento* leitor, int id, RegistroSegmento* registro) {
+    ContextoBusca busca;
+    busca.id = id;
+    if (!leitura_executar(leitor, operacao_buscar, &busca) || !busca.encontrado) return false;
+    *registro = busca.registro;
+    return true;
+}
+
+bool leitor_segmento_buscar(LeitorSegmento* leitor, int id, Hardware* destino) {
+    RegistroSegmento registro;
+    if (destino == NULL || !leitor_buscar_registro(leitor, id, &registro)) return false;
+    hardware_de_registro(destino, &registro);
+    return true;
+}
+
+bool leitor_segmento_obsoleto(LeitorSegmento* leitor, int id, const Data* hoje, bool* obsoleto) {
+    RegistroSegmento registro;
+    if (hoje == NULL || obsoleto == NULL || !leitor_buscar_registro(leitor, id, &registro)) return false;
+    *obsoleto = registro_obsoleto(&registro, hoje);
+    return true;
+}
+
+bool leitor_segmento_manutencao_pendente(LeitorSegmento* leitor, int id, const Data* hoje, int mesesLimite,
+                                         bool* pendente) {
+    RegistroSegmento registro;
+    if (hoje == NULL || pendente == NULL || !leitor_buscar_registro(leitor, id, &registro)) return false;
+    *pendente = registro_pendente(&registro, hoje, mesesLimite);
+    return true;
+}
+
+typedef struct {
+    Hardware* destino;
+    int capacidade;
+    int total;
+} ContextoCopia;
+
+static void operacao_copiar(const VisaoSegmento* visao, void* contexto) {
+    ContextoCopia* copia = contexto;
+    int quantidade = visao->numRegistros < copia->capacidade ? visao->numRegistros : copia->capacidade;
+    for (int i = 0; i < quantidade; i++) {
+        hardware_de_registro(&copia->destino[i], &visao->registros[i]);
+    }
+    copia->total = visao->numRegistros;
+}
+
+int leitor_segmento_copiar(LeitorSegmento* leitor, Hardware* destino, int capacidade) {
+    ContextoCopia copia = {destino, destino ? capacidade : 0, 0};
+    return leitura_executar(leitor, operacao_copiar, &copia) ? copia.total : -1;
+}
+
+typedef struct {
+    const Data* hoje;
+    int mesesLimite;        // 0 conta obsoletos
+    int total;
+} ContextoContagem;
+
+static void operacao_contar(const VisaoSegmento* visao, void* contexto) {
+    ContextoContagem* contagem = contexto;
+    contagem->total = 0;
+    for (int i = 0; i < visao->numRegistros; i++) {
+        const RegistroSegmento* registro = &visao->registros[i];
+        bool conta = contagem->mesesLimite > 0 ? registro_pendente(registro, contagem->hoje, contagem->mesesLimite)
+                                               : registro_obsoleto(registro, contagem->hoje);
+        if (conta) contagem->total++;
+    }
+}
+
+int leitor_segmento_contar_obsoletos(LeitorSegmento* leitor, const Data* hoje) {
+    if (hoje == NULL) return -1;
+    ContextoContagem contagem = {hoje, 0, 0};
+    return leitura_executar(leitor, operacao_contar, &contagem) ? contagem.total : -1;
+}
+
+int leitor_segmento_contar_pendentes(LeitorSegmento* leitor, const Data* hoje, int mesesLimite) {
+    if (hoje == NULL || mesesLimite <= 0) return -1;
+    ContextoContagem contagem = {hoje, mesesLimite, 0};
+    return leitura_executar(leitor, operacao_contar, &contagem) ? contagem.total : -1;
+}
@@ -1,4 +1,5 @@
 #include "linkedList.h"
+#include "memoria.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -13,7 +14,7 @@ void linkedlist_clear(LinkedList* list) {
     Node* current = list->head;
     while (current != NULL) {
         Node* next = current->next;
-        free(current);
+        mem_liberar(current);
         current = next;
     }
     list->head = NULL;
@@ -22,7 +23,7 @@ void linkedlist_clear(LinkedList* list) {
 }
 
 void linkedlist_push_back(LinkedList* list, const Hardware* hw) {
-    Node* newNode = malloc(sizeof(Node));
+    Node* newNode = mem_alocar(MEMORIA_REGISTROS, sizeof(Node));
     if (!newNode) return;
     
     newNode->data.id = hw->id;
@@ -1,26 +1,159 @@
 #include "menu.h"
 #include "repository.h"
+#include "repositorioCache.h"
+#include "repositorioParticionado.h"
+#include "repositorioCompactado.h"
+#include "utils.h"
+#include "contadoresHw.h"
+#include "metricas.h"
+#include "trace.h"
 #include <stdio.h> 
+#include <stdlib.h>
+#include <string.h>
 #include <windows.h>
 
 
-// gcc src/*.c -o inventario -I include
+// gcc src/*.c -o inventario -I include -lpthread
 // ./inventario
 int main() {
     SetConsoleOutputCP(CP_UTF8);
     SetConsoleCP(CP_UTF8);
 
+    // INVENTARIO_TEMPO_CONSOLE=1 imprime as linhas [TEMPO], que por padrão só alimentam o histograma (opção 15);
+    // INVENTARIO_METRICAS=<arquivo> grava as métricas ao sair;
+    // INVENTARIO_TRACE=<arquivo> grava um trace Chrome/Perfetto da sessão;
+    // INVENTARIO_CONTADORES_HW=1 soma contadores de hardware (Linux) às métricas de cada operação;
+    // INVENTARIO_SNAPSHOT=<arquivo> inicia a partir da imagem binária quando ela corresponde ao CSV;
+    // INVENTARIO_LAZY=1 mantém só um índice do CSV e lê cada registro no primeiro acesso;
+    // INVENTARIO_CACHE=<n> envolve o repositório num cache LRU de n registros;
+    // INVENTARIO_PARTICIONADO=1 guarda um CSV por tipo (output/inventario_<TIPO>.csv), importando o CSV único na primeira vez;
+    // INVENTARIO_COMPACTADO=1 usa o arquivo binário compactado output/inventario.invz, também importado do CSV
+    // INVENTARIO_SERVIR=<socket> mantém o inventário carregado e atende clientes pelo socket Unix, sem menu;
+    // INVENTARIO_SERVIDOR=<socket> faz o menu enviar as operações a esse servidor
+    // INVENTARIO_SEGMENTO=/<nome> publica os registros num segmento de memória compartilhada POSIX para leitores locais
+    const char* tempoConsole = getenv("INVENTARIO_TEMPO_CONSOLE");
+    if (tempoConsole && strcmp(tempoConsole, "1") == 0) {
+        cronometro_definir_console(true);
+    }
+    const char* contadoresHw = getenv("INVENTARIO_CONTADORES_HW");
+    if (contadoresHw && strcmp(contadoresHw, "1") == 0) {
+        contadores_hw_iniciar();
+    }
+    const char* arquivoTrace = getenv("INVENTARIO_TRACE");
+    if (arquivoTrace && !trace_iniciar(arquivoTrace, 1 << 18)) {
+        fprintf(stderr, "Falha ao iniciar trace em %s\n", arquivoTrace);
+    }
+
     // Cria o repositório CSV
-    Repository* repo = criar_repositorio_csv("output/inventario.csv");
+    const char* arquivoCsv = "output/inventario.csv";
+    Repository* repo = criar_repositorio_csv(arquivoCsv);
     if (!repo) {
         fprintf(stderr, "Falha ao criar repositório\n");
         return 1;
     }
 
-    // Inicializa e executa o menu
-    menu_principal(repo);
+    const char* compactado = getenv("INVENTARIO_COMPACTADO");
+    bool usarCompactado = compactado && strcmp(compactado, "1") == 0;
+    if (usarCompactado) {
+        const char* arquivoCompactado = "output/inventario.invz";
+        Repository* binario = criar_repositorio_compactado(arquivoCompactado);
+        FILE* existente = fopen(arquivoCompactado, "rb");
+        if (existente) {
+            fclose(existente);
+        } else if (binario) {
+            LinkedList existentes;
+            linkedlist_init(&existentes);
+            if (repo->interface->carregar(repo->implementacao, &existentes) &&
+                !binario->interface->salvar(binario->implementacao, &existentes)) {
+                fprintf(stderr, "Falha ao importar %s para %s\n", arquivoCsv, arquivoCompactado);
+            }
+            linkedlist_clear(&existentes);
+        }
+        if (binario) {
+            destruir_repositorio(repo);
+            repo = binario;
+        } else {
+            fprintf(stderr, "Falha ao criar repositório compactado; seguindo com o CSV\n");
+            usarCompactado = false;
+        }
+    }
+
+    const char* particionado = getenv("INVENTARIO_PARTICIONADO");
+    bool usarParticoes = !usarCompactado && particionado && strcmp(particionado, "1") == 0;
+    if (usarParticoes) {
+        Repository* particoes = criar_repositorio_particionado("output/inventario");
+        if (particoes && !repositorio_particionado_existe(particoes)) {
+            LinkedList existentes;
+            linkedlist_init(&existentes);
+            if (repo->interface->carregar(repo->implementacao, &existentes) &&
+                !repositorio_particionado_importar(particoes, &existentes)) {
+                fprintf(stderr, "Falha ao importar %s para as partições\n", arquivoCsv);
+            }
+            linkedlist_clear(&existentes);
+        }
+        if (particoes) {
+            destruir_repositorio(repo);
+            repo = particoes;
+        } else {
+            fprintf(stderr, "Falha ao criar repositório particionado; seguindo com o CSV único\n");
+            usarParticoes = false;
+        }
+    }
+
+    const char* capacidadeCache = getenv("INVENTARIO_CACHE");
+    if (capacidadeCache && atol(capacidadeCache) > 0) {
+        Repository* cache = criar_repositorio_cache(repo, (size_t)atol(capacidadeCache));
+        if (cache) {
+            repo = cache;
+        } else {
+            fprintf(stderr, "Falha ao criar cache do repositório; seguindo sem cache\n");
+        }
+    }
+
+    // Snapshot e índice sob demanda são validados contra o CSV único; com partições, o modo sob demanda lê por tipo
+    const char* arquivoSnapshot = getenv("INVENTARIO_SNAPSHOT");
+    if (arquivoSnapshot && arquivoSnapshot[0] != '\0' && !usarParticoes && !usarCompactado) {
+        menu_definir_snapshot(arquivoSnapshot, arquivoCsv);
+    }
+
+    const char* lazy = getenv("INVENTARIO_LAZY");
+    if (lazy && strcmp(lazy, "1") == 0) {
+        if (usarCompactado) {
+            fprintf(stderr, "Modo sob demanda indexa o CSV; ignorado com o formato compactado\n");
+        } else {
+            menu_definir_carregamento_lazy(usarParticoes ? NULL : arquivoCsv);
+        }
+    }
+
+    const char* segmento = getenv("INVENTARIO_SEGMENTO");
+    if (segmento && segmento[0] != '\0') {
+        menu_definir_segmento(segmento);
+    }
+
+    const char* servidor = getenv("INVENTARIO_SERVIDOR");
+    if (servidor && servidor[0] != '\0') {
+        menu_definir_servidor(servidor);
+    }
+
+    // Inicializa e executa o menu, ou atende clientes no modo servidor
+    const char* servir = getenv("INVENTARIO_SERVIR");
+    if (servir && servir[0] != '\0') {
+        menu_servir(repo, servir);
+    } else {
+        menu_principal(repo);
+    }
 
     // Limpeza
     destruir_repositorio(repo);
+
+    const char* arquivoMetricas = getenv("INVENTARIO_METRICAS");
+    if (arquivoMetricas && !metricas_exportar_json(arquivoMetricas)) {
+        fprintf(stderr, "Falha ao gravar métricas em %s\n", arquivoMetricas);
+    }
+    contadores_hw_encerrar();
+    metricas_limpar();
+    if (arquivoTrace && !trace_finalizar()) {
+        fprintf(stderr, "Falha ao gravar trace em %s\n", arquivoTrace);
+    }
     return 0;
 }
\ No newline at end of file
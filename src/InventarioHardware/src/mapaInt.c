@@ -0,0 +1,134 @@
+#include "mapaInt.h"
+#include "memoria.h"
+#include <stdlib.h>
+#include <string.h>
+
+static size_t mapa_hash(int chave, size_t capacidade) {
+    // Hash de Fibonacci; capacidade é sempre potência de 2
+    uint32_t h = (uint32_t)chave * 2654435769u;
+    return (size_t)h & (capacidade - 1);
+}
+
+void mapa_int_init(MapaInt* mapa) {
+    mapa->chaves = NULL;
+    mapa->valores = NULL;
+    mapa->ocupado = NULL;
+    mapa->capacidade = 0;
+    mapa->tamanho = 0;
+}
+
+void mapa_int_destruir(MapaInt* mapa) {
+    mem_liberar(mapa->chaves);
+    mem_liberar(mapa->valores);
+    mem_liberar(mapa->ocupado);
+    mapa_int_init(mapa);
+}
+
+void mapa_int_limpar(MapaInt* mapa) {
+    if (mapa->ocupado) {
+        memset(mapa->ocupado, 0, mapa->capacidade);
+    }
+    mapa->tamanho = 0;
+}
+
+static bool mapa_redimensionar(MapaInt* mapa, size_t novaCapacidade) {
+    int* chaves = mem_alocar(MEMORIA_INDICES, sizeof(int) * novaCapacidade);
+    intptr_t* valores = mem_alocar(MEMORIA_INDICES, sizeof(intptr_t) * novaCapacidade);
+    unsigned char* ocupado = mem_alocar_zerado(MEMORIA_INDICES, novaCapacidade, 1);
+    if (!chaves || !valores || !ocupado) {
+        mem_liberar(chaves);
+        mem_liberar(valores);
+        mem_liberar(ocupado);
+        return false;
+    }
+
+    for (size_t i = 0; i < mapa->capacidade; i++) {
+        if (!mapa->ocupado[i]) continue;
+        size_t pos = mapa_hash(mapa->chaves[i], novaCapacidade);
+        while (ocupado[pos]) {
+            pos = (pos + 1) & (novaCapacidade - 1);
+        }
+        chaves[pos] = mapa->chaves[i];
+        valores[pos] = mapa->valores[i];
+        ocupado[pos] = 1;
+    }
+
+    mem_liberar(mapa->chaves);
+    mem_liberar(mapa->valores);
+    mem_liberar(mapa->ocupado);
+    mapa->chaves = chaves;
+    mapa->valores = valores;
+    mapa->ocupado = ocupado;
+    mapa->capacidade = novaCapacidade;
+    return true;
+}
+
+// Garante espaço para 'quantidade' chaves mantendo a ocupação abaixo de 70%
+bool mapa_int_reservar(MapaInt* mapa, size_t quantidade) {
+    size_t necessario = 16;
+    while (necessario * 7 / 10 < quantidade) necessario *= 2;
+    if (necessario <= mapa->capacidade) return true;
+    return mapa_redimensionar(mapa, necessario);
+}
+
+bool mapa_int_inserir(MapaInt* mapa, int chave, intptr_t valor) {
+    if (!mapa_int_reservar(mapa, mapa->tamanho + 1)) return false;
+
+    size_t pos = mapa_hash(chave, mapa->capacidade);
+    while (mapa->ocupado[pos]) {
+        if (mapa->chaves[pos] == chave) {
+            mapa->valores[pos] = valor;
+            return true;
+        }
+        pos = (pos + 1) & (mapa->capacidade - 1);
+    }
+
+    mapa->chaves[pos] = chave;
+    mapa->valores[pos] = valor;
+    mapa->ocupado[pos] = 1;
+    mapa->tamanho++;
+    return true;
+}
+
+bool mapa_int_buscar(const MapaInt* mapa, int chave, intptr_t* valor) {
+    if (mapa->capacidade == 0) return false;
+
+    size_t pos = mapa_hash(chave, mapa->capacidade);
+    while (mapa->ocupado[pos]) {
+        if (mapa->chaves[pos] == chave) {
+            if (valor) *valor = mapa->valores[pos];
+            return true;
+        }
+        pos = (pos + 1) & (mapa->capacidade - 1);
+    }
+    return false;
+}
+
+bool mapa_int_remover(MapaInt* mapa, int chave) {
+    if (mapa->capacidade == 0) return false;
+
+    size_t mascara = mapa->capacidade - 1;
+    size_t pos = mapa_hash(chave, mapa->capacidade);
+    while (mapa->ocupado[pos] && mapa->chaves[pos] != chave) {
+        pos = (pos + 1) & mascara;
+    }
+    if (!mapa->ocupado[pos]) return false;
+
+    // Remoção por deslocamento para trás, sem lápides
+    size_t vazio = pos;
+    size_t atual = (pos + 1) & mascara;
+    while (mapa->ocupado[atual]) {
+        size_t ideal = mapa_hash(mapa->chaves[atual], mapa->capacidade);
+        bool mover = (vazio <= atual) ? (ideal <= vazio || ideal > atual)
+                                      : (ideal <= vazio && ideal > atual);
+        if (mover) {
+            mapa->chaves[vazio] = mapa->chaves[atual];
+            mapa->valores[vazio] = mapa->valores[atual];
+            vazio = atual;
+        }
+        atual = (atual + 1) & mascara;
+    }
+    mapa->ocupado[vazio] = 0;
+    mapa->tamanho--;
+    return true;
+}
@@ -0,0 +1,109 @@
+#include "memoria.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+static const char* NOMES_SUBSISTEMAS[NUM_SUBSISTEMAS_MEMORIA] = {
+    "Registros", "Texto", "Índices", "Temporária", "Outros"
+};
+
+typedef struct {
+    atomic_llong alocacoes;
+    atomic_llong liberacoes;
+    atomic_llong bytesAlocados;
+    atomic_llong bytesVivos;
+    atomic_llong picoBytes;
+} ContadoresMemoria;
+
+static ContadoresMemoria contadores[NUM_SUBSISTEMAS_MEMORIA];
+
+const char* subsistema_memoria_nome(SubsistemaMemoria subsistema) {
+    return (subsistema >= 0 && subsistema < NUM_SUBSISTEMAS_MEMORIA) ? NOMES_SUBSISTEMAS[subsistema] : "?";
+}
+
+void memoria_obter_estatisticas(SubsistemaMemoria subsistema, EstatisticaMemoria* estatistica) {
+    memset(estatistica, 0, sizeof(*estatistica));
+    if (subsistema < 0 || subsistema >= NUM_SUBSISTEMAS_MEMORIA) return;
+
+    ContadoresMemoria* c = &contadores[subsistema];
+    estatistica->alocacoes = atomic_load(&c->alocacoes);
+    estatistica->liberacoes = atomic_load(&c->liberacoes);
+    estatistica->bytesAlocados = atomic_load(&c->bytesAlocados);
+    estatistica->bytesVivos = atomic_load(&c->bytesVivos);
+    estatistica->picoBytes = atomic_load(&c->picoBytes);
+}
+
+#ifndef INVENTARIO_SEM_CONTAGEM_MEMORIA
+
+// Cabeçalho com 16 bytes para manter o alinhamento que malloc garante
+typedef union {
+    struct {
+        size_t tamanho;
+        int subsistema;
+    } info;
+    long double alinhamento;
+} CabecalhoMemoria;
+
+static void contabilizar_alocacao(int subsistema, size_t tamanho) {
+    ContadoresMemoria* c = &contadores[subsistema];
+    atomic_fetch_add_explicit(&c->alocacoes, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&c->bytesAlocados, (long long)tamanho, memory_order_relaxed);
+    long long vivos = atomic_fetch_add_explicit(&c->bytesVivos, (long long)tamanho, memory_order_relaxed) + (long long)tamanho;
+
+    long long pico = atomic_load_explicit(&c->picoBytes, memory_order_relaxed);
+    while (vivos > pico &&
+           !atomic_compare_exchange_weak_explicit(&c->picoBytes, &pico, vivos, memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+static void contabilizar_liberacao(int subsistema, size_t tamanho) {
+    ContadoresMemoria* c = &contadores[subsistema];
+    atomic_fetch_add_explicit(&c->liberacoes, 1, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&c->bytesVivos, (long long)tamanho, memory_order_relaxed);
+}
+
+void* mem_alocar(SubsistemaMemoria subsistema, size_t tamanho) {
+    if (subsistema < 0 || subsistema >= NUM_SUBSISTEMAS_MEMORIA) subsistema = MEMORIA_OUTROS;
+
+    CabecalhoMemoria* cabecalho = malloc(sizeof(CabecalhoMemoria) + tamanho);
+    if (!cabecalho) return NULL;
+
+    cabecalho->info.tamanho = tamanho;
+    cabecalho->info.subsistema = subsistema;
+    contabilizar_alocacao(subsistema, tamanho);
+    return cabecalho + 1;
+}
+
+void* mem_alocar_zerado(SubsistemaMemoria subsistema, size_t quantidade, size_t tamanho) {
+    if (tamanho != 0 && quantidade > ((size_t)-1 - sizeof(CabecalhoMemoria)) / tamanho) return NULL;
+
+    void* ponteiro = mem_alocar(subsistema, quantidade * tamanho);
+    if (ponteiro) memset(ponteiro, 0, quantidade * tamanho);
+    return ponteiro;
+}
+
+void* mem_realocar(SubsistemaMemoria subsistema, void* ponteiro, size_t tamanho) {
+    if (ponteiro == NULL) return mem_alocar(subsistema, tamanho);
+
+    CabecalhoMemoria* antigo = (CabecalhoMemoria*)ponteiro - 1;
+    size_t tamanhoAntigo = antigo->info.tamanho;
+    int subsistemaAntigo = antigo->info.subsistema;
+
+    CabecalhoMemoria* novo = realloc(antigo, sizeof(CabecalhoMemoria) + tamanho);
+    if (!novo) return NULL;
+
+    contabilizar_liberacao(subsistemaAntigo, tamanhoAntigo);
+    novo->info.tamanho = tamanho;
+    contabilizar_alocacao(subsistemaAntigo, tamanho);
+    return novo + 1;
+}
+
+void mem_liberar(void* ponteiro) {
+    if (ponteiro == NULL) return;
+
+    CabecalhoMemoria* cabecalho = (CabecalhoMemoria*)ponteiro - 1;
+    contabilizar_liberacao(cabecalho->info.subsistema, cabecalho->info.tamanho);
+    free(cabecalho);
+}
+
+#endif
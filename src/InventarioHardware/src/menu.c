@@ -1,25 +1,116 @@
 #include "menu.h"
 #include "sistemaInventario.h"
+#include "pedidoInventario.h"
+#include "clienteInventario.h"
+#include "servidorInventario.h"
+#include "relatorioStream.h"
 #include "utils.h"
 #include "data.h"
+#include "metricas.h"
+#include "trace.h"
+#include "memoria.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <limits.h>
+
+static const char* NOMES_OPCOES[] = {
+    "Menu: sair", "Menu: cadastrar hardware", "Menu: registrar manutenção", "Menu: listar equipamentos",
+    "Menu: listar por tipo", "Menu: listar por data de compra", "Menu: listar por data de manutenção",
+    "Menu: análise de depreciação", "Menu: obsoletos", "Menu: manutenção pendente",
+    "Menu: próximas manutenções", "Menu: relatório agregado", "Menu: projeção do valor",
+    "Menu: valor em data", "Menu: previsão de substituição", "Menu: métricas", "Menu: uso de memória",
+    "Menu: consultar por ID", "Menu: ordenação externa",
+    "Menu: relatórios em streaming", "Menu: formato colunar", "Menu: manutenções em lote"
+};
+#define NUM_OPCOES ((int)(sizeof(NOMES_OPCOES) / sizeof(NOMES_OPCOES[0])))
+
+static const char* arquivoSnapshot = NULL;
+static const char* arquivoOrigem = NULL;
+static bool carregamentoLazy = false;
+static const char* socketServidor = NULL;
+static const char* segmentoCompartilhado = NULL;
+
+void menu_definir_snapshot(const char* imagem, const char* origem) {
+    arquivoSnapshot = imagem;
+    arquivoOrigem = origem;
+}
+
+void menu_definir_carregamento_lazy(const char* origem) {
+    carregamentoLazy = true;
+    arquivoOrigem = origem;
+}
+
+void menu_definir_servidor(const char* caminhoSocket) {
+    socketServidor = caminhoSocket;
+}
+
+void menu_definir_segmento(const char* nome) {
+    segmentoCompartilhado = nome;
+}
+
+static void menu_iniciar_sistema(SistemaInventario* sistema, Repository* repo) {
+    if (carregamentoLazy) {
+        sistema_init_lazy(sistema, repo, arquivoOrigem);
+    } else {
+        sistema_init_com_snapshot(sistema, repo, arquivoSnapshot, arquivoOrigem);
+    }
+    if (segmentoCompartilhado && !sistema_publicar_segmento(sistema, segmentoCompartilhado)) {
+        fprintf(stderr, "Falha ao publicar o segmento compartilhado %s\n", segmentoCompartilhado);
+    }
+}
+
+// Executa o pedido no sistema local ou, conectado a um servidor, envia e reproduz a saída dele
+static bool menu_executar(SistemaInventario* sistema, ClienteInventario* cliente, const PedidoInventario* pedido) {
+    if (cliente == NULL) return pedido_executar(sistema, pedido, NULL);
+
+    RespostaInventario resposta;
+    resposta_init(&resposta);
+    if (!cliente_executar(cliente, pedido, &resposta)) {
+        fprintf(stderr, "Falha na comunicação com o servidor.\n");
+        return false;
+    }
+    fwrite(resposta.saida.dados, 1, resposta.saida.tamanho, stdout);
+    fflush(stdout);
+    fwrite(resposta.erros.dados, 1, resposta.erros.tamanho, stderr);
+    bool sucesso = resposta.sucesso;
+    resposta_liberar(&resposta);
+    return sucesso;
+}
+
+void menu_servir(Repository* repo, const char* caminhoSocket) {
+    SistemaInventario sistema;
+    menu_iniciar_sistema(&sistema, repo);
+    servidor_executar(&sistema, caminhoSocket);
+    sistema_destroy(&sistema);
+}
 
 void menu_principal(Repository* repo) {
     Cronometro crono_total;
     cronometro_iniciar(&crono_total);
     
+    // Conectado a um servidor, o inventário fica com ele e os pedidos vão pelo socket
     SistemaInventario sistema;
-    sistema_init(&sistema, repo); 
+    ClienteInventario conexao;
+    ClienteInventario* remoto = NULL;
+    if (socketServidor) {
+        if (!cliente_conectar(&conexao, socketServidor)) {
+            fprintf(stderr, "Não foi possível conectar ao servidor em %s\n", socketServidor);
+            cliente_desconectar(&conexao);
+            return;
+        }
+        remoto = &conexao;
+    } else {
+        menu_iniciar_sistema(&sistema, repo);
+    }
     
     Data hoje = obter_data_atual();
     char* hojeStr = data_to_string(&hoje);
     
     printf("\n=== SISTEMA DE INVENTÁRIO DE HARDWARE ===\n");
     printf("Data atual do sistema: %s\n", hojeStr ? hojeStr : "ERRO");
-    if (hojeStr) free(hojeStr);
+    if (hojeStr) mem_liberar(hojeStr);
 
     int opcao;
     bool sair = false;
@@ -35,18 +126,33 @@ void menu_principal(Repository* repo) {
         printf("7 - Mostrar análise de depreciação\n");
         printf("8 - Identificar equipamentos obsoletos\n");
         printf("9 - Relatório de manutenção pendente\n");
+        printf("10 - Próximas manutenções a vencer\n");
+        printf("11 - Relatório agregado (agrupar por campos)\n");
+        printf("12 - Projeção mensal do valor contábil\n");
+        printf("13 - Valor contábil em uma data\n");
+        printf("14 - Previsão de substituição por mês e tipo\n");
+        printf("15 - Métricas de desempenho\n");
+        printf("16 - Uso de memória\n");
+        printf("17 - Consultar equipamento por ID\n");
+        printf("18 - Listagem por data com ordenação externa\n");
+        printf("19 - Relatórios em streaming (direto do repositório)\n");
+        printf("20 - Formato colunar (exportar ou relatórios sobre o arquivo)\n");
+        printf("21 - Registrar manutenções em lote (gravadas em segundo plano)\n");
         printf("0 - Sair\n");
         printf("Opção: ");
 
         if (scanf("%d", &opcao) != 1) {
             limpar_buffer_entrada();
-            printf("Entrada inválida! Digite um número entre 0 e 9.\n");
+            printf("Entrada inválida! Digite um número entre 0 e 21.\n");
             continue;
         }
         limpar_buffer_entrada();
 
         Cronometro crono_op;
         cronometro_iniciar(&crono_op);
+        PedidoInventario pedido;
+        const char* nomeOpcao = (opcao >= 0 && opcao < NUM_OPCOES) ? NOMES_OPCOES[opcao] : "Menu: opção inválida";
+        trace_inicio(nomeOpcao);
         
         switch(opcao) {
             case 1: {
@@ -102,7 +208,14 @@ void menu_principal(Repository* repo) {
                     break;
                 } while (true);
                 
-                if (!sistema_cadastrar_hardware(&sistema, nome, fabricante, tipo, &dataCompra, valor, vidaUtil)) {
+                pedido_init(&pedido, PEDIDO_CADASTRAR, &hoje);
+                strcpy(pedido.nome, nome);
+                strcpy(pedido.fabricante, fabricante);
+                pedido.tipo = tipo;
+                pedido.data = dataCompra;
+                pedido.valorCompra = valor;
+                pedido.vidaUtilAnos = vidaUtil;
+                if (!menu_executar(&sistema, remoto, &pedido)) {
                     printf("Erro ao cadastrar hardware!\n");
                 }
                 break;
@@ -128,8 +241,11 @@ void menu_principal(Repository* repo) {
                     printf("Data inválida! Tente novamente.\n");
                 }
                 
-                if (!sistema_registrar_manutencao(&sistema, id, &dataManutencao)) {
-                    printf("Equipamento não encontrado!\n");
+                pedido_init(&pedido, PEDIDO_REGISTRAR_MANUTENCAO, &hoje);
+                pedido.id = id;
+                pedido.data = dataManutencao;
+                if (!menu_executar(&sistema, remoto, &pedido)) {
+                    printf("Manutenção não registrada!\n");
                 } else {
                     printf("Manutenção registrada com sucesso!\n");
                 }
@@ -137,29 +253,36 @@ void menu_principal(Repository* repo) {
             }
             
             case 3:
-                sistema_listar_equipamentos(&sistema);
+                pedido_init(&pedido, PEDIDO_LISTAR, &hoje);
+                menu_executar(&sistema, remoto, &pedido);
                 break;
                 
             case 4: {
                 TipoHardware tipo = selecionar_tipo();
-                sistema_listar_por_tipo(&sistema, tipo);
+                pedido_init(&pedido, PEDIDO_LISTAR_POR_TIPO, &hoje);
+                pedido.tipo = tipo;
+                menu_executar(&sistema, remoto, &pedido);
                 break;
             }
             
             case 5:
-                sistema_listar_por_data_compra(&sistema);
+                pedido_init(&pedido, PEDIDO_LISTAR_POR_DATA_COMPRA, &hoje);
+                menu_executar(&sistema, remoto, &pedido);
                 break;
                 
             case 6:
-                sistema_listar_por_data_manutencao(&sistema);
+                pedido_init(&pedido, PEDIDO_LISTAR_POR_DATA_MANUTENCAO, &hoje);
+                menu_executar(&sistema, remoto, &pedido);
                 break;
                 
             case 7:
-                sistema_mostrar_analise_depreciacao(&sistema, &hoje);
+                pedido_init(&pedido, PEDIDO_DEPRECIACAO, &hoje);
+                menu_executar(&sistema, remoto, &pedido);
                 break;
                 
             case 8:
-                sistema_identificar_obsoletos(&sistema, &hoje);
+                pedido_init(&pedido, PEDIDO_OBSOLETOS, &hoje);
+                menu_executar(&sistema, remoto, &pedido);
                 break;
                 
             case 9: {
@@ -177,26 +300,342 @@ void menu_principal(Repository* repo) {
                     break;
                 } while (true);
                 
-                sistema_relatorio_manutencao_pendente(&sistema, &hoje, meses);
+                pedido_init(&pedido, PEDIDO_MANUTENCAO_PENDENTE, &hoje);
+                pedido.meses = meses;
+                menu_executar(&sistema, remoto, &pedido);
+                break;
+            }
+            
+            case 10: {
+                printf("\n--- PRÓXIMAS MANUTENÇÕES A VENCER ---\n");
+                int meses = 0, quantidade = 0;
+                
+                do {
+                    printf("Informe o limite de meses sem manutenção: ");
+                    if (scanf("%d", &meses) != 1 || meses <= 0) {
+                        limpar_buffer_entrada();
+                        printf("Valor inválido! Digite um número positivo.\n");
+                        continue;
+                    }
+                    limpar_buffer_entrada();
+                    break;
+                } while (true);
+                
+                do {
+                    printf("Quantidade de equipamentos: ");
+                    if (scanf("%d", &quantidade) != 1 || quantidade <= 0) {
+                        limpar_buffer_entrada();
+                        printf("Valor inválido! Digite um número positivo.\n");
+                        continue;
+                    }
+                    limpar_buffer_entrada();
+                    break;
+                } while (true);
+                
+                pedido_init(&pedido, PEDIDO_PROXIMAS_MANUTENCOES, &hoje);
+                pedido.meses = meses;
+                pedido.quantidade = quantidade;
+                menu_executar(&sistema, remoto, &pedido);
+                break;
+            }
+            
+            case 11: {
+                printf("\n--- RELATÓRIO AGREGADO ---\n");
+                printf("Campos: 1 - Tipo | 2 - Fabricante | 3 - Ano de compra | 4 - Mês de compra | 5 - Obsoleto\n");
+                printf("Informe os campos desejados (ex: 13 para tipo e ano, vazio para total geral): ");
+                
+                char selecao[32];
+                int campos = 0;
+                if (fgets(selecao, sizeof(selecao), stdin) != NULL) {
+                    for (char* c = selecao; *c != '\0'; c++) {
+                        switch (*c) {
+                            case '1': campos |= AGRUPAR_TIPO; break;
+                            case '2': campos |= AGRUPAR_FABRICANTE; break;
+                            case '3': campos |= AGRUPAR_ANO_COMPRA; break;
+                            case '4': campos |= AGRUPAR_MES_COMPRA; break;
+                            case '5': campos |= AGRUPAR_OBSOLETO; break;
+                            default: break;
+                        }
+                    }
+                }
+                
+                int meses = 0;
+                do {
+                    printf("Limite de meses para manutenção pendente (0 para ignorar): ");
+                    if (scanf("%d", &meses) != 1 || meses < 0) {
+                        limpar_buffer_entrada();
+                        printf("Valor inválido! Digite um número não negativo.\n");
+                        continue;
+                    }
+                    limpar_buffer_entrada();
+                    break;
+                } while (true);
+                
+                pedido_init(&pedido, PEDIDO_AGREGADO, &hoje);
+                pedido.campos = campos;
+                pedido.meses = meses;
+                menu_executar(&sistema, remoto, &pedido);
+                break;
+            }
+            
+            case 12: {
+                int anos = 0;
+                do {
+                    printf("Horizonte da projeção em anos: ");
+                    if (scanf("%d", &anos) != 1 || anos <= 0) {
+                        limpar_buffer_entrada();
+                        printf("Valor inválido! Digite um número positivo.\n");
+                        continue;
+                    }
+                    limpar_buffer_entrada();
+                    break;
+                } while (true);
+                
+                pedido_init(&pedido, PEDIDO_PROJECAO_VALOR, &hoje);
+                pedido.anos = anos;
+                menu_executar(&sistema, remoto, &pedido);
+                break;
+            }
+            
+            case 13: {
+                Data data;
+                while (!ler_data("Data da avaliação (DD/MM/AAAA)", &data)) {
+                    printf("Data inválida! Tente novamente.\n");
+                }
+                pedido_init(&pedido, PEDIDO_VALOR_EM_DATA, &hoje);
+                pedido.data = data;
+                menu_executar(&sistema, remoto, &pedido);
+                break;
+            }
+            
+            case 14: {
+                int anos = 0;
+                do {
+                    printf("Horizonte da previsão em anos: ");
+                    if (scanf("%d", &anos) != 1 || anos <= 0) {
+                        limpar_buffer_entrada();
+                        printf("Valor inválido! Digite um número positivo.\n");
+                        continue;
+                    }
+                    limpar_buffer_entrada();
+                    break;
+                } while (true);
+                
+                pedido_init(&pedido, PEDIDO_PREVISAO_SUBSTITUICAO, &hoje);
+                pedido.anos = anos;
+                menu_executar(&sistema, remoto, &pedido);
                 break;
             }
             
+            case 15:
+                metricas_imprimir();
+                if (metricas_exportar_json("output/metricas.json")) {
+                    printf("Métricas gravadas em output/metricas.json\n");
+                } else {
+                    printf("Falha ao gravar output/metricas.json\n");
+                }
+                break;
+
+            case 16:
+                pedido_init(&pedido, PEDIDO_USO_MEMORIA, &hoje);
+                menu_executar(&sistema, remoto, &pedido);
+                break;
+
+            case 17: {
+                int id = 0;
+                printf("ID do equipamento: ");
+                if (scanf("%d", &id) != 1 || id <= 0) {
+                    limpar_buffer_entrada();
+                    printf("ID inválido! Digite um número positivo.\n");
+                    break;
+                }
+                limpar_buffer_entrada();
+                pedido_init(&pedido, PEDIDO_CONSULTAR, &hoje);
+                pedido.id = id;
+                menu_executar(&sistema, remoto, &pedido);
+                break;
+            }
+
+            case 18: {
+                int criterio = 0;
+                long orcamentoKb = -1;
+                printf("Ordenar por (1 - Data de compra, 2 - Data de manutenção): ");
+                if (scanf("%d", &criterio) != 1 || (criterio != 1 && criterio != 2)) {
+                    limpar_buffer_entrada();
+                    printf("Critério inválido!\n");
+                    break;
+                }
+                limpar_buffer_entrada();
+                printf("Orçamento de memória em KB (0 = padrão de 64 MB): ");
+                if (scanf("%ld", &orcamentoKb) != 1 || orcamentoKb < 0) {
+                    limpar_buffer_entrada();
+                    printf("Orçamento inválido!\n");
+                    break;
+                }
+                limpar_buffer_entrada();
+                pedido_init(&pedido, PEDIDO_LISTAR_ORDENADO_EXTERNO, &hoje);
+                pedido.chave = criterio == 1 ? ORDENAR_DATA_COMPRA : ORDENAR_DATA_MANUTENCAO;
+                pedido.orcamentoBytes = (long long)orcamentoKb * 1024;
+                menu_executar(&sistema, remoto, &pedido);
+                break;
+            }
+
+            case 19: {
+                char arquivo[256];
+                printf("Arquivo CSV (vazio = inventário atual): ");
+                if (fgets(arquivo, sizeof(arquivo), stdin) == NULL) break;
+                arquivo[strcspn(arquivo, "\n")] = '\0';
+
+                int relatorio = 0;
+                printf("Relatório (1 - Depreciação, 2 - Obsoletos, 3 - Manutenção pendente): ");
+                if (scanf("%d", &relatorio) != 1 || relatorio < 1 || relatorio > 3) {
+                    limpar_buffer_entrada();
+                    printf("Relatório inválido!\n");
+                    break;
+                }
+                limpar_buffer_entrada();
+
+                int meses = 0;
+                if (relatorio == 3) {
+                    printf("Informe o limite de meses sem manutenção: ");
+                    if (scanf("%d", &meses) != 1 || meses <= 0) {
+                        limpar_buffer_entrada();
+                        printf("Valor inválido! Digite um número positivo.\n");
+                        break;
+                    }
+                    limpar_buffer_entrada();
+                }
+
+                // Um arquivo arquivado ganha um repositório próprio, só para leitura pelo cursor
+                Repository* origem = arquivo[0] != '\0' ? criar_repositorio_csv(arquivo) : repo;
+                if (relatorio == 1) {
+                    relatorio_stream_depreciacao(origem, &hoje);
+                } else if (relatorio == 2) {
+                    relatorio_stream_obsoletos(origem, &hoje);
+                } else {
+                    relatorio_stream_manutencao_pendente(origem, &hoje, meses);
+                }
+                if (origem != repo) destruir_repositorio(origem);
+                break;
+            }
+            
+            case 20: {
+                int acao = 0;
+                printf("1 - Exportar inventário, 2 - Relatório sobre arquivo exportado: ");
+                if (scanf("%d", &acao) != 1 || acao < 1 || acao > 2) {
+                    limpar_buffer_entrada();
+                    printf("Opção inválida!\n");
+                    break;
+                }
+                limpar_buffer_entrada();
+
+                char arquivo[256];
+                printf("Arquivo colunar (vazio = output/inventario.col): ");
+                if (fgets(arquivo, sizeof(arquivo), stdin) == NULL) break;
+                arquivo[strcspn(arquivo, "\n")] = '\0';
+                if (arquivo[0] == '\0') strcpy(arquivo, "output/inventario.col");
+
+                if (acao == 1) {
+                    pedido_init(&pedido, PEDIDO_EXPORTAR_COLUNAR, &hoje);
+                    strcpy(pedido.arquivo, arquivo);
+                    menu_executar(&sistema, remoto, &pedido);
+                    break;
+                }
+
+                int relatorio = 0;
+                printf("Relatório (1 - Depreciação, 2 - Obsoletos, 3 - Manutenção pendente): ");
+                if (scanf("%d", &relatorio) != 1 || relatorio < 1 || relatorio > 3) {
+                    limpar_buffer_entrada();
+                    printf("Relatório inválido!\n");
+                    break;
+                }
+                limpar_buffer_entrada();
+
+                int meses = 0;
+                if (relatorio == 3) {
+                    printf("Informe o limite de meses sem manutenção: ");
+                    if (scanf("%d", &meses) != 1 || meses <= 0) {
+                        limpar_buffer_entrada();
+                        printf("Valor inválido! Digite um número positivo.\n");
+                        break;
+                    }
+                    limpar_buffer_entrada();
+                }
+
+                TabelaColunar tabela;
+                if (!colunar_abrir(&tabela, arquivo)) {
+                    printf("Não foi possível abrir %s.\n", arquivo);
+                    break;
+                }
+                if (relatorio == 1) {
+                    sistema_mostrar_analise_depreciacao_colunar(&tabela, &hoje);
+                } else if (relatorio == 2) {
+                    sistema_identificar_obsoletos_colunar(&tabela, &hoje);
+                } else {
+                    sistema_relatorio_manutencao_pendente_colunar(&tabela, &hoje, meses);
+                }
+                colunar_fechar(&tabela);
+                break;
+            }
+            
+            case 21: {
+                printf("\n--- REGISTRAR MANUTENÇÕES EM LOTE ---\n");
+                Data dataManutencao;
+                while (!ler_data("Data da manutenção (DD/MM/AAAA)", &dataManutencao)) {
+                    printf("Data inválida! Tente novamente.\n");
+                }
+
+                char linha[1024];
+                printf("IDs dos equipamentos (separados por espaço): ");
+                if (fgets(linha, sizeof(linha), stdin) == NULL) break;
+
+                // Cada id vira um pedido que só entra na fila; a gravação sai em lotes pela ingestão
+                int enfileiradas = 0, recusadas = 0;
+                char* fim = linha;
+                while (true) {
+                    char* inicio = fim;
+                    long id = strtol(inicio, &fim, 10);
+                    if (fim == inicio) break;
+                    if (id <= 0 || id > INT_MAX) {
+                        printf("ID inválido ignorado: %ld\n", id);
+                        continue;
+                    }
+                    pedido_init(&pedido, PEDIDO_ENFILEIRAR_MANUTENCAO, &hoje);
+                    pedido.id = (int)id;
+                    pedido.data = dataManutencao;
+                    if (menu_executar(&sistema, remoto, &pedido)) {
+                        enfileiradas++;
+                    } else {
+                        recusadas++;
+                    }
+                }
+                printf("%d manutenções enfileiradas", enfileiradas);
+                if (recusadas > 0) printf(", %d recusadas", recusadas);
+                printf(". IDs inexistentes são ignorados na gravação.\n");
+                break;
+            }
+
             case 0:
                 printf("\nSalvando dados e saindo...\n");
                 sair = true;
                 break;
                 
             default:
-                printf("Opção inválida! Digite um número entre 0 e 9.\n");
+                printf("Opção inválida! Digite um número entre 0 e 21.\n");
                 break;
         }
         
-        double tempo_op = cronometro_parar(&crono_op);
-        cronometro_imprimir("Operação do menu", tempo_op);
+        trace_fim(nomeOpcao);
+        cronometro_parar(&crono_op);
+        cronometro_imprimir("Operação do menu", &crono_op);
     }
     
-    sistema_destroy(&sistema);
+    if (remoto) {
+        cliente_desconectar(remoto);
+    } else {
+        sistema_destroy(&sistema);
+    }
     
-    double tempo_total = cronometro_parar(&crono_total);
-    cronometro_imprimir("Tempo total no menu", tempo_total);
+    cronometro_parar(&crono_total);
+    cronometro_imprimir("Tempo total no menu", &crono_total);
 }
\ No newline at end of file
@@ -0,0 +1,333 @@
+#include "metricas.h"
+
+#ifndef INVENTARIO_SEM_METRICAS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#define METRICAS_MAX_OPERACOES 256
+#define METRICAS_CAPACIDADE_TABELA 512    // potência de 2, folga para as sondagens pararem num vazio
+#define METRICAS_TAMANHO_NOME 96
+#define SUB_BALDES_BITS 5
+#define SUB_BALDES (1 << SUB_BALDES_BITS)
+#define NUM_BALDES (SUB_BALDES + (64 - SUB_BALDES_BITS) * SUB_BALDES)
+
+// Os campos são atômicos e atualizados sem trava: workers do pool e o aplicador da ingestão
+// registram ao mesmo tempo, e a medição não pode disputar uma trava global
+typedef struct {
+    char nome[METRICAS_TAMANHO_NOME];
+    uint64_t hash;
+    _Atomic uint64_t contagem;
+    _Atomic uint64_t somaNs;
+    _Atomic uint64_t minimoNs;
+    _Atomic uint64_t maximoNs;
+    _Atomic uint64_t baldes[NUM_BALDES];
+
+    // Contadores de hardware acumulados; contador inválido se alguma amostra não o tinha
+    _Atomic uint64_t amostrasHw;
+    _Atomic long long contadores[NUM_CONTADORES_HW];
+    atomic_bool contadorInvalido[NUM_CONTADORES_HW];
+    _Atomic long long registros;
+} HistogramaOperacao;
+
+// Tabela de endereçamento aberto consultada sem trava; a trava só serializa a criação de operações
+// e protege a lista em ordem de criação usada na impressão
+static _Atomic(HistogramaOperacao*) tabela[METRICAS_CAPACIDADE_TABELA];
+static HistogramaOperacao* operacoes[METRICAS_MAX_OPERACOES];
+static int numOperacoes = 0;
+static atomic_llong medicoesDescartadas;   // de operações além de METRICAS_MAX_OPERACOES
+static pthread_mutex_t metricasMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static int bits_significativos(uint64_t valor) {
+    int bits = 0;
+    while (valor) {
+        bits++;
+        valor >>= 1;
+    }
+    return bits;
+}
+
+// Valores pequenos têm balde próprio; acima disso, cada potência de 2 é dividida em 32 baldes
+static int balde_do_valor(uint64_t valorNs) {
+    if (valorNs < SUB_BALDES) return (int)valorNs;
+
+    int expoente = bits_significativos(valorNs) - 1;
+    int deslocamento = expoente - SUB_BALDES_BITS;
+    int mantissa = (int)(valorNs >> deslocamento) - SUB_BALDES;
+    return SUB_BALDES + deslocamento * SUB_BALDES + mantissa;
+}
+
+static uint64_t limite_superior_do_balde(int balde) {
+    if (balde < SUB_BALDES) return (uint64_t)balde;
+
+    int deslocamento = (balde - SUB_BALDES) / SUB_BALDES;
+    uint64_t mantissa = (uint64_t)((balde - SUB_BALDES) % SUB_BALDES) + SUB_BALDES;
+    return ((mantissa + 1) << deslocamento) - 1;
+}
+
+// FNV-1a
+static uint64_t hash_nome(const char* nome) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (const unsigned char* c = (const unsigned char*)nome; *c; c++) {
+        hash = (hash ^ *c) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+static HistogramaOperacao* buscar_operacao(const char* nome, uint64_t hash) {
+    for (size_t i = hash & (METRICAS_CAPACIDADE_TABELA - 1); ; i = (i + 1) & (METRICAS_CAPACIDADE_TABELA - 1)) {
+        HistogramaOperacao* op = atomic_load_explicit(&tabela[i], memory_order_acquire);
+        if (op == NULL) return NULL;
+        if (op->hash == hash && strncmp(op->nome, nome, sizeof(op->nome) - 1) == 0) return op;
+    }
+}
+
+static HistogramaOperacao* obter_operacao(const char* nome) {
+    uint64_t hash = hash_nome(nome);
+    HistogramaOperacao* op = buscar_operacao(nome, hash);
+    if (op) return op;
+
+    pthread_mutex_lock(&metricasMutex);
+    op = buscar_operacao(nome, hash);
+    if (op == NULL && numOperacoes < METRICAS_MAX_OPERACOES && (op = calloc(1, sizeof(HistogramaOperacao)))) {
+        strncpy(op->nome, nome, sizeof(op->nome) - 1);
+        op->hash = hash;
+        atomic_init(&op->minimoNs, UINT64_MAX);
+        size_t i = hash & (METRICAS_CAPACIDADE_TABELA - 1);
+        while (atomic_load_explicit(&tabela[i], memory_order_relaxed) != NULL) {
+            i = (i + 1) & (METRICAS_CAPACIDADE_TABELA - 1);
+        }
+        atomic_store_explicit(&tabela[i], op, memory_order_release);
+        operacoes[numOperacoes++] = op;
+    }
+    pthread_mutex_unlock(&metricasMutex);
+    if (op == NULL) atomic_fetch_add_explicit(&medicoesDescartadas, 1, memory_order_relaxed);
+    return op;
+}
+
+static void atualizar_minimo(_Atomic uint64_t* minimo, uint64_t valor) {
+    uint64_t atual = atomic_load_explicit(minimo, memory_order_relaxed);
+    while (valor < atual &&
+           !atomic_compare_exchange_weak_explicit(minimo, &atual, valor, memory_order_relaxed, memory_order_relaxed)) {}
+}
+
+static void atualizar_maximo(_Atomic uint64_t* maximo, uint64_t valor) {
+    uint64_t atual = atomic_load_explicit(maximo, memory_order_relaxed);
+    while (valor > atual &&
+           !atomic_compare_exchange_weak_explicit(maximo, &atual, valor, memory_order_relaxed, memory_order_relaxed)) {}
+}
+
+void metricas_registrar(const char* operacao, double microssegundos) {
+    if (operacao == NULL) return;
+    uint64_t valorNs = microssegundos > 0 ? (uint64_t)(microssegundos * 1000.0) : 0;
+
+    HistogramaOperacao* op = obter_operacao(operacao);
+    if (op == NULL) return;
+    atomic_fetch_add_explicit(&op->contagem, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&op->somaNs, valorNs, memory_order_relaxed);
+    atualizar_minimo(&op->minimoNs, valorNs);
+    atualizar_maximo(&op->maximoNs, valorNs);
+    atomic_fetch_add_explicit(&op->baldes[balde_do_valor(valorNs)], 1, memory_order_relaxed);
+}
+
+void metricas_registrar_contadores(const char* operacao, const long long* variacoes, long registros) {
+    if (operacao == NULL || variacoes == NULL) return;
+
+    HistogramaOperacao* op = obter_operacao(operacao);
+    if (op == NULL) return;
+    for (int i = 0; i < NUM_CONTADORES_HW; i++) {
+        if (variacoes[i] < 0) {
+            atomic_store_explicit(&op->contadorInvalido[i], true, memory_order_relaxed);
+        } else {
+            atomic_fetch_add_explicit(&op->contadores[i], variacoes[i], memory_order_relaxed);
+        }
+    }
+    atomic_fetch_add_explicit(&op->registros, registros, memory_order_relaxed);
+    atomic_fetch_add_explicit(&op->amostrasHw, 1, memory_order_relaxed);
+}
+
+// Cópia dos campos de uma operação para imprimir; com medições em andamento, os campos podem
+// vir de instantes um pouco diferentes
+typedef struct {
+    const char* nome;
+    uint64_t contagem;
+    uint64_t somaNs;
+    uint64_t minimoNs;
+    uint64_t maximoNs;
+    uint64_t amostrasHw;
+    long long contadores[NUM_CONTADORES_HW];
+    bool contadorValido[NUM_CONTADORES_HW];
+    long long registros;
+    const HistogramaOperacao* origem;
+} ResumoOperacao;
+
+static void resumir_operacao(const HistogramaOperacao* op, ResumoOperacao* resumo) {
+    resumo->nome = op->nome;
+    resumo->contagem = atomic_load_explicit(&op->contagem, memory_order_relaxed);
+    resumo->somaNs = atomic_load_explicit(&op->somaNs, memory_order_relaxed);
+    resumo->minimoNs = atomic_load_explicit(&op->minimoNs, memory_order_relaxed);
+    resumo->maximoNs = atomic_load_explicit(&op->maximoNs, memory_order_relaxed);
+    resumo->amostrasHw = atomic_load_explicit(&op->amostrasHw, memory_order_relaxed);
+    for (int i = 0; i < NUM_CONTADORES_HW; i++) {
+        resumo->contadores[i] = atomic_load_explicit(&op->contadores[i], memory_order_relaxed);
+        resumo->contadorValido[i] = !atomic_load_explicit(&op->contadorInvalido[i], memory_order_relaxed);
+    }
+    resumo->registros = atomic_load_explicit(&op->registros, memory_order_relaxed);
+    resumo->origem = op;
+}
+
+static double contador_por_registro(const ResumoOperacao* op, ContadorHw contador) {
+    if (!op->contadorValido[contador] || op->registros <= 0) return -1.0;
+    return (double)op->contadores[contador] / op->registros;
+}
+
+static double instrucoes_por_ciclo(const ResumoOperacao* op) {
+    if (!op->contadorValido[CONTADOR_CICLOS] || !op->contadorValido[CONTADOR_INSTRUCOES] ||
+        op->contadores[CONTADOR_CICLOS] == 0) {
+        return -1.0;
+    }
+    return (double)op->contadores[CONTADOR_INSTRUCOES] / op->contadores[CONTADOR_CICLOS];
+}
+
+// Percentil em microssegundos, limitado pelo máximo observado
+static double percentil_us(const ResumoOperacao* op, double percentil) {
+    if (op->contagem == 0) return 0.0;
+
+    uint64_t alvo = (uint64_t)(percentil * op->contagem + 0.999999);
+    if (alvo < 1) alvo = 1;
+
+    uint64_t acumulado = 0;
+    for (int b = 0; b < NUM_BALDES; b++) {
+        acumulado += atomic_load_explicit(&op->origem->baldes[b], memory_order_relaxed);
+        if (acumulado >= alvo) {
+            uint64_t limite = limite_superior_do_balde(b);
+            if (limite > op->maximoNs) limite = op->maximoNs;
+            return limite / 1000.0;
+        }
+    }
+    return op->maximoNs / 1000.0;
+}
+
+void metricas_imprimir() {
+    pthread_mutex_lock(&metricasMutex);
+    printf("=== MÉTRICAS DE DESEMPENHO (μs) ===\n");
+    if (contadores_hw_ativos()) {
+        printf("Contadores de hardware: %s\n", contadores_hw_escopo());
+    }
+    for (int i = 0; i < numOperacoes; i++) {
+        ResumoOperacao resumo;
+        resumir_operacao(operacoes[i], &resumo);
+        const ResumoOperacao* op = &resumo;
+        printf("%s | n=%llu | p50: %.2f | p95: %.2f | p99: %.2f | máx: %.2f\n",
+               op->nome, (unsigned long long)op->contagem,
+               percentil_us(op, 0.50), percentil_us(op, 0.95), percentil_us(op, 0.99),
+               op->maximoNs / 1000.0);
+
+        if (op->amostrasHw > 0) {
+            double ipc = instrucoes_por_ciclo(op);
+            printf("    IPC: ");
+            if (ipc >= 0) printf("%.2f", ipc); else printf("n/d");
+            for (int c = 0; c < NUM_CONTADORES_HW; c++) {
+                printf(" | %s: ", contador_hw_nome((ContadorHw)c));
+                if (op->contadorValido[c]) printf("%lld", op->contadores[c]); else printf("n/d");
+            }
+            if (op->registros > 0) {
+                printf(" | registros: %lld | cache misses/registro: ", op->registros);
+                double porRegistro = contador_por_registro(op, CONTADOR_CACHE_MISSES);
+                if (porRegistro >= 0) printf("%.2f", porRegistro); else printf("n/d");
+            }
+            printf("\n");
+        }
+    }
+    long long descartadas = atomic_load_explicit(&medicoesDescartadas, memory_order_relaxed);
+    if (descartadas > 0) {
+        printf("Medições descartadas (limite de %d operações): %lld\n", METRICAS_MAX_OPERACOES, descartadas);
+    }
+    pthread_mutex_unlock(&metricasMutex);
+}
+
+static void escrever_string_json(FILE* arquivo, const char* texto) {
+    fputc('"', arquivo);
+    for (const unsigned char* c = (const unsigned char*)texto; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            fprintf(arquivo, "\\%c", *c);
+        } else if (*c < 0x20) {
+            fprintf(arquivo, "\\u%04x", *c);
+        } else {
+            fputc(*c, arquivo);
+        }
+    }
+    fputc('"', arquivo);
+}
+
+bool metricas_exportar_json(const char* caminho) {
+    FILE* arquivo = fopen(caminho, "w");
+    if (!arquivo) return false;
+
+    pthread_mutex_lock(&metricasMutex);
+    fprintf(arquivo, "{\n  \"unidade\": \"us\",");
+    if (contadores_hw_ativos()) {
+        fprintf(arquivo, "\n  \"escopo_contadores\": \"%s\",", contadores_hw_escopo());
+    }
+    fprintf(arquivo, "\n  \"operacoes\": [");
+    for (int i = 0; i < numOperacoes; i++) {
+        ResumoOperacao resumo;
+        resumir_operacao(operacoes[i], &resumo);
+        const ResumoOperacao* op = &resumo;
+        fprintf(arquivo, "%s\n    {\"nome\": ", i > 0 ? "," : "");
+        escrever_string_json(arquivo, op->nome);
+        fprintf(arquivo, ", \"contagem\": %llu, \"min\": %.3f, \"media\": %.3f, \"p50\": %.3f, \"p95\": %.3f, \"p99\": %.3f, \"max\": %.3f",
+                (unsigned long long)op->contagem,
+                op->contagem ? op->minimoNs / 1000.0 : 0.0,
+                op->contagem ? (double)op->somaNs / op->contagem / 1000.0 : 0.0,
+                percentil_us(op, 0.50), percentil_us(op, 0.95), percentil_us(op, 0.99),
+                op->maximoNs / 1000.0);
+
+        if (op->amostrasHw > 0) {
+            fprintf(arquivo, ",\n     \"contadores\": {\"amostras\": %llu, \"registros\": %lld, \"ipc\": ",
+                    (unsigned long long)op->amostrasHw, op->registros);
+            double ipc = instrucoes_por_ciclo(op);
+            if (ipc >= 0) fprintf(arquivo, "%.4f", ipc); else fprintf(arquivo, "null");
+            for (int c = 0; c < NUM_CONTADORES_HW; c++) {
+                const char* nome = contador_hw_nome((ContadorHw)c);
+                if (op->contadorValido[c]) {
+                    fprintf(arquivo, ", \"%s\": %lld", nome, op->contadores[c]);
+                } else {
+                    fprintf(arquivo, ", \"%s\": null", nome);
+                }
+                double porRegistro = contador_por_registro(op, (ContadorHw)c);
+                if (porRegistro >= 0) {
+                    fprintf(arquivo, ", \"%s_por_registro\": %.4f", nome, porRegistro);
+                }
+            }
+            fprintf(arquivo, "}");
+        }
+        fprintf(arquivo, "}");
+    }
+    fprintf(arquivo, "\n  ],\n  \"medicoes_descartadas\": %lld\n}\n",
+            atomic_load_explicit(&medicoesDescartadas, memory_order_relaxed));
+    pthread_mutex_unlock(&metricasMutex);
+
+    return fclose(arquivo) == 0;
+}
+
+// Sem medições em andamento: quem registra usa as operações sem trava
+void metricas_limpar() {
+    pthread_mutex_lock(&metricasMutex);
+    for (size_t i = 0; i < METRICAS_CAPACIDADE_TABELA; i++) {
+        atomic_store_explicit(&tabela[i], NULL, memory_order_relaxed);
+    }
+    for (int i = 0; i < numOperacoes; i++) {
+        free(operacoes[i]);
+        operacoes[i] = NULL;
+    }
+    numOperacoes = 0;
+    atomic_store_explicit(&medicoesDescartadas, 0, memory_order_relaxed);
+    pthread_mutex_unlock(&metricasMutex);
+}
+
+#endif
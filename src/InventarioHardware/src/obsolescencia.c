@@ -0,0 +1,140 @@
+#include "obsolescencia.h"
+#include "memoria.h"
+#include <stdlib.h>
+
+Data data_obsolescencia_campos(const Data* dataCompra, int vidaUtilAnos) {
+    Data fim = *dataCompra;
+    fim.ano += vidaUtilAnos;
+    return fim;
+}
+
+Data data_obsolescencia(const Hardware* hw) {
+    return data_obsolescencia_campos(&hw->dataCompra, hw->vidaUtilAnos);
+}
+
+void monitor_obsolescencia_init(MonitorObsolescencia* monitor) {
+    monitor->heap = NULL;
+    monitor->tamanho = 0;
+    monitor->capacidade = 0;
+    monitor->inicializado = false;
+    monitor->totalObsoletos = 0;
+}
+
+void monitor_obsolescencia_destruir(MonitorObsolescencia* monitor) {
+    mem_liberar(monitor->heap);
+    monitor_obsolescencia_init(monitor);
+}
+
+// Descarta o estado; o próximo avanço refaz a varredura completa.
+// Necessário sempre que os nós da lista forem liberados ou recriados.
+void monitor_obsolescencia_invalidar(MonitorObsolescencia* monitor) {
+    monitor->tamanho = 0;
+    monitor->inicializado = false;
+    monitor->totalObsoletos = 0;
+}
+
+static void heap_subir(MonitorObsolescencia* monitor, int i) {
+    EventoObsolescencia item = monitor->heap[i];
+    while (i > 0) {
+        int pai = (i - 1) / 2;
+        if (!data_menor_que(&item.dataObsolescencia, &monitor->heap[pai].dataObsolescencia)) break;
+        monitor->heap[i] = monitor->heap[pai];
+        i = pai;
+    }
+    monitor->heap[i] = item;
+}
+
+static void heap_descer(MonitorObsolescencia* monitor, int i) {
+    EventoObsolescencia item = monitor->heap[i];
+    while (true) {
+        int filho = 2 * i + 1;
+        if (filho >= monitor->tamanho) break;
+        if (filho + 1 < monitor->tamanho &&
+            data_menor_que(&monitor->heap[filho + 1].dataObsolescencia, &monitor->heap[filho].dataObsolescencia)) {
+            filho++;
+        }
+        if (!data_menor_que(&monitor->heap[filho].dataObsolescencia, &item.dataObsolescencia)) break;
+        monitor->heap[i] = monitor->heap[filho];
+        i = filho;
+    }
+    monitor->heap[i] = item;
+}
+
+static bool heap_garantir_capacidade(MonitorObsolescencia* monitor, int minimo) {
+    if (minimo <= monitor->capacidade) return true;
+
+    int novaCapacidade = monitor->capacidade ? monitor->capacidade * 2 : 64;
+    while (novaCapacidade < minimo) novaCapacidade *= 2;
+
+    EventoObsolescencia* novo = mem_realocar(MEMORIA_INDICES, monitor->heap, sizeof(EventoObsolescencia) * novaCapacidade);
+    if (!novo) return false;
+    monitor->heap = novo;
+    monitor->capacidade = novaCapacidade;
+    return true;
+}
+
+void monitor_obsolescencia_registrar(MonitorObsolescencia* monitor, Node* no) {
+    if (!monitor->inicializado || no->data.obsoleto) return;
+    if (!heap_garantir_capacidade(monitor, monitor->tamanho + 1)) {
+        monitor_obsolescencia_invalidar(monitor);
+        return;
+    }
+
+    monitor->heap[monitor->tamanho].dataObsolescencia = data_obsolescencia(&no->data);
+    monitor->heap[monitor->tamanho].no = no;
+    monitor->tamanho++;
+    heap_subir(monitor, monitor->tamanho - 1);
+}
+
+// Varredura completa: recalcula o status de todos e monta o heap dos ainda ativos em O(n)
+static int monitor_reconstruir(MonitorObsolescencia* monitor, LinkedList* list, const Data* hoje) {
+    int mudancas = 0;
+    monitor->tamanho = 0;
+    monitor->totalObsoletos = 0;
+    monitor->inicializado = heap_garantir_capacidade(monitor, list->size);
+
+    for (Node* current = list->head; current != NULL; current = current->next) {
+        Data fim = data_obsolescencia(&current->data);
+        bool obsoleto = !data_menor_que(hoje, &fim);
+        if (obsoleto != current->data.obsoleto) mudancas++;
+        current->data.obsoleto = obsoleto;
+
+        if (current->data.obsoleto) {
+            monitor->totalObsoletos++;
+        } else if (monitor->inicializado) {
+            monitor->heap[monitor->tamanho].dataObsolescencia = fim;
+            monitor->heap[monitor->tamanho].no = current;
+            monitor->tamanho++;
+        }
+    }
+
+    for (int i = monitor->tamanho / 2 - 1; i >= 0; i--) {
+        heap_descer(monitor, i);
+    }
+    monitor->referencia = *hoje;
+    return mudancas;
+}
+
+// Atualiza o status para a data informada e retorna quantos equipamentos mudaram.
+// Avançar a data custa O(k log n) para k mudanças; voltar no tempo refaz a varredura.
+int monitor_obsolescencia_avancar(MonitorObsolescencia* monitor, LinkedList* list, const Data* hoje) {
+    if (!monitor->inicializado || data_menor_que(hoje, &monitor->referencia)) {
+        return monitor_reconstruir(monitor, list, hoje);
+    }
+
+    int mudancas = 0;
+    while (monitor->tamanho > 0 && !data_menor_que(hoje, &monitor->heap[0].dataObsolescencia)) {
+        monitor->heap[0].no->data.obsoleto = true;
+        monitor->totalObsoletos++;
+        mudancas++;
+
+        monitor->heap[0] = monitor->heap[--monitor->tamanho];
+        if (monitor->tamanho > 0) heap_descer(monitor, 0);
+    }
+    monitor->referencia = *hoje;
+    return mudancas;
+}
+
+int monitor_obsolescencia_total(const MonitorObsolescencia* monitor) {
+    return monitor->totalObsoletos;
+}
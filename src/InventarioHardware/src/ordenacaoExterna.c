@@ -0,0 +1,309 @@
+#include "ordenacaoExterna.h"
+#include "memoria.h"
+#include "trace.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TAMANHO_FIXO_REGISTRO 47
+#define BUFFER_MINIMO_RUN 4096
+#define MAXIMO_VIAS 256
+
+static const Data* chave_registro(const Hardware* hw, ChaveOrdenacao chave) {
+    return chave == ORDENAR_DATA_COMPRA ? &hw->dataCompra : &hw->ultimaManutencao;
+}
+
+static int comparar_datas(const Data* a, const Data* b) {
+    if (a->ano != b->ano) return a->ano < b->ano ? -1 : 1;
+    if (a->mes != b->mes) return a->mes < b->mes ? -1 : 1;
+    if (a->dia != b->dia) return a->dia < b->dia ? -1 : 1;
+    return 0;
+}
+
+// Os ponteiros apontam para um vetor na ordem de entrada, então o endereço desempata e mantém a ordenação estável
+static int comparar_compra(const void* a, const void* b) {
+    const Hardware* ha = *(const Hardware* const*)a;
+    const Hardware* hb = *(const Hardware* const*)b;
+    int c = comparar_datas(&ha->dataCompra, &hb->dataCompra);
+    return c != 0 ? c : (ha > hb) - (ha < hb);
+}
+
+static int comparar_manutencao(const void* a, const void* b) {
+    const Hardware* ha = *(const Hardware* const*)a;
+    const Hardware* hb = *(const Hardware* const*)b;
+    int c = comparar_datas(&ha->ultimaManutencao, &hb->ultimaManutencao);
+    return c != 0 ? c : (ha > hb) - (ha < hb);
+}
+
+static void escrever_int32(unsigned char** p, int32_t valor) {
+    memcpy(*p, &valor, 4);
+    *p += 4;
+}
+
+static int32_t ler_int32(const unsigned char** p) {
+    int32_t valor;
+    memcpy(&valor, *p, 4);
+    *p += 4;
+    return valor;
+}
+
+// Registro em disco: campos fixos (47 bytes) seguidos de nome e fabricante sem o terminador
+static bool gravar_registro(FILE* arquivo, const Hardware* hw) {
+    unsigned char fixo[TAMANHO_FIXO_REGISTRO];
+    unsigned char* p = fixo;
+    size_t tamanhoNome = strlen(hw->nome);
+    size_t tamanhoFabricante = strlen(hw->fabricante);
+
+    escrever_int32(&p, hw->id);
+    escrever_int32(&p, hw->tipo);
+    escrever_int32(&p, hw->dataCompra.dia);
+    escrever_int32(&p, hw->dataCompra.mes);
+    escrever_int32(&p, hw->dataCompra.ano);
+    escrever_int32(&p, hw->ultimaManutencao.dia);
+    escrever_int32(&p, hw->ultimaManutencao.mes);
+    escrever_int32(&p, hw->ultimaManutencao.ano);
+    memcpy(p, &hw->valorCompra, 8);
+    p += 8;
+    escrever_int32(&p, hw->vidaUtilAnos);
+    *p++ = hw->obsoleto ? 1 : 0;
+    *p++ = (unsigned char)tamanhoNome;
+    *p++ = (unsigned char)tamanhoFabricante;
+
+    return fwrite(fixo, 1, sizeof(fixo), arquivo) == sizeof(fixo) &&
+           fwrite(hw->nome, 1, tamanhoNome, arquivo) == tamanhoNome &&
+           fwrite(hw->fabricante, 1, tamanhoFabricante, arquivo) == tamanhoFabricante;
+}
+
+// Run aberta para leitura durante a intercalação, com buffer próprio do tamanho da fatia do orçamento
+typedef struct {
+    FILE* arquivo;
+    unsigned char* buffer;
+    size_t capacidade;
+    size_t posicao;
+    size_t disponivel;
+    Hardware atual;
+    int ordem;              // posição da run na entrada, desempate que preserva a estabilidade
+} LeitorRun;
+
+static bool leitor_ler(LeitorRun* leitor, void* destino, size_t tamanho) {
+    unsigned char* saida = destino;
+    while (tamanho > 0) {
+        if (leitor->posicao == leitor->disponivel) {
+            leitor->disponivel = fread(leitor->buffer, 1, leitor->capacidade, leitor->arquivo);
+            leitor->posicao = 0;
+            if (leitor->disponivel == 0) return false;
+        }
+        size_t parte = leitor->disponivel - leitor->posicao;
+        if (parte > tamanho) parte = tamanho;
+        memcpy(saida, leitor->buffer + leitor->posicao, parte);
+        leitor->posicao += parte;
+        saida += parte;
+        tamanho -= parte;
+    }
+    return true;
+}
+
+static bool ler_registro(LeitorRun* leitor, Hardware* hw) {
+    unsigned char fixo[TAMANHO_FIXO_REGISTRO];
+    if (!leitor_ler(leitor, fixo, sizeof(fixo))) return false;
+
+    const unsigned char* p = fixo;
+    hw->id = ler_int32(&p);
+    hw->tipo = (TipoHardware)ler_int32(&p);
+    hw->dataCompra.dia = ler_int32(&p);
+    hw->dataCompra.mes = ler_int32(&p);
+    hw->dataCompra.ano = ler_int32(&p);
+    hw->ultimaManutencao.dia = ler_int32(&p);
+    hw->ultimaManutencao.mes = ler_int32(&p);
+    hw->ultimaManutencao.ano = ler_int32(&p);
+    memcpy(&hw->valorCompra, p, 8);
+    p += 8;
+    hw->vidaUtilAnos = ler_int32(&p);
+    hw->obsoleto = *p++ != 0;
+    size_t tamanhoNome = *p++;
+    size_t tamanhoFabricante = *p++;
+
+    if (tamanhoNome >= sizeof(hw->nome) || tamanhoFabricante >= sizeof(hw->fabricante) ||
+        !leitor_ler(leitor, hw->nome, tamanhoNome) ||
+        !leitor_ler(leitor, hw->fabricante, tamanhoFabricante)) {
+        return false;
+    }
+    hw->nome[tamanhoNome] = '\0';
+    hw->fabricante[tamanhoFabricante] = '\0';
+    return true;
+}
+
+typedef struct {
+    LeitorRun* leitores;
+    int* heap;
+    int tamanho;
+    ChaveOrdenacao chave;
+} HeapRuns;
+
+static bool leitor_menor(const HeapRuns* h, int a, int b) {
+    const LeitorRun* la = &h->leitores[a];
+    const LeitorRun* lb = &h->leitores[b];
+    int c = comparar_datas(chave_registro(&la->atual, h->chave), chave_registro(&lb->atual, h->chave));
+    return c != 0 ? c < 0 : la->ordem < lb->ordem;
+}
+
+static void heap_runs_descer(HeapRuns* h, int i) {
+    int item = h->heap[i];
+    while (true) {
+        int filho = 2 * i + 1;
+        if (filho >= h->tamanho) break;
+        if (filho + 1 < h->tamanho && leitor_menor(h, h->heap[filho + 1], h->heap[filho])) filho++;
+        if (!leitor_menor(h, h->heap[filho], item)) break;
+        h->heap[i] = h->heap[filho];
+        i = filho;
+    }
+    h->heap[i] = item;
+}
+
+// Intercala as runs [inicio, fim) de runs[], gravando em saida ou, se saida for NULL, entregando ao consumidor.
+// As runs intercaladas são fechadas e marcadas como NULL.
+static bool intercalar_runs(FILE** runs, int inicio, int fim, ChaveOrdenacao chave, size_t orcamentoBytes,
+                            FILE* saida, ConsumidorRegistros consumidor, void* contextoConsumidor) {
+    int vias = fim - inicio;
+    size_t tamanhoBuffer = orcamentoBytes / (size_t)(vias + 1);
+    if (tamanhoBuffer < BUFFER_MINIMO_RUN) tamanhoBuffer = BUFFER_MINIMO_RUN;
+
+    HeapRuns h;
+    h.leitores = mem_alocar_zerado(MEMORIA_TEMPORARIA, vias, sizeof(LeitorRun));
+    h.heap = mem_alocar(MEMORIA_TEMPORARIA, sizeof(int) * vias);
+    h.tamanho = 0;
+    h.chave = chave;
+    bool ok = h.leitores != NULL && h.heap != NULL;
+
+    for (int i = 0; ok && i < vias; i++) {
+        LeitorRun* leitor = &h.leitores[i];
+        leitor->arquivo = runs[inicio + i];
+        leitor->ordem = i;
+        leitor->buffer = mem_alocar(MEMORIA_TEMPORARIA, tamanhoBuffer);
+        leitor->capacidade = tamanhoBuffer;
+        ok = leitor->buffer != NULL && fflush(leitor->arquivo) == 0;
+        if (ok) {
+            rewind(leitor->arquivo);
+            if (ler_registro(leitor, &leitor->atual)) h.heap[h.tamanho++] = i;
+        }
+    }
+    for (int i = h.tamanho / 2 - 1; ok && i >= 0; i--) heap_runs_descer(&h, i);
+
+    while (ok && h.tamanho > 0) {
+        LeitorRun* menor = &h.leitores[h.heap[0]];
+        if (saida) {
+            ok = gravar_registro(saida, &menor->atual);
+        } else {
+            consumidor(contextoConsumidor, &menor->atual);
+        }
+
+        if (!ler_registro(menor, &menor->atual)) {
+            h.heap[0] = h.heap[--h.tamanho];
+        }
+        if (h.tamanho > 0) heap_runs_descer(&h, 0);
+    }
+
+    for (int i = 0; h.leitores && i < vias; i++) {
+        fclose(runs[inicio + i]);
+        runs[inicio + i] = NULL;
+        mem_liberar(h.leitores[i].buffer);
+    }
+    mem_liberar(h.leitores);
+    mem_liberar(h.heap);
+    return ok;
+}
+
+bool ordenacao_externa(FonteRegistros fonte, void* contextoFonte, ChaveOrdenacao chave, size_t orcamentoBytes,
+                       ConsumidorRegistros consumidor, void* contextoConsumidor, EstatisticaOrdenacaoExterna* estatistica) {
+    EstatisticaOrdenacaoExterna local;
+    if (estatistica == NULL) estatistica = &local;
+    memset(estatistica, 0, sizeof(*estatistica));
+    if (fonte == NULL || consumidor == NULL) return false;
+    if (orcamentoBytes == 0) orcamentoBytes = ORCAMENTO_ORDENACAO_PADRAO;
+
+    size_t capacidade = orcamentoBytes / (sizeof(Hardware) + sizeof(Hardware*));
+    if (capacidade < 16) capacidade = 16;
+
+    Hardware* itens = mem_alocar(MEMORIA_TEMPORARIA, sizeof(Hardware) * capacidade);
+    Hardware** ordem = mem_alocar(MEMORIA_TEMPORARIA, sizeof(Hardware*) * capacidade);
+    FILE** runs = NULL;
+    int numRuns = 0, capacidadeRuns = 0;
+    bool ok = itens != NULL && ordem != NULL;
+    bool fimEntrada = false;
+    int (*comparar)(const void*, const void*) = chave == ORDENAR_DATA_COMPRA ? comparar_compra : comparar_manutencao;
+
+    // Fase 1: runs ordenadas em memória; a última (ou única) fica em memória se nada foi gravado ainda
+    trace_inicio("Ordenação externa: runs");
+    while (ok && !fimEntrada) {
+        size_t n = 0;
+        while (n < capacidade && fonte(contextoFonte, &itens[n])) {
+            ordem[n] = &itens[n];
+            n++;
+        }
+        fimEntrada = n < capacidade;
+        estatistica->registros += (long)n;
+        qsort(ordem, n, sizeof(Hardware*), comparar);
+
+        if (fimEntrada && numRuns == 0) {
+            trace_fim("Ordenação externa: runs");
+            for (size_t i = 0; i < n; i++) consumidor(contextoConsumidor, ordem[i]);
+            mem_liberar(ordem);
+            mem_liberar(itens);
+            return true;
+        }
+        if (n == 0) break;
+
+        if (numRuns == capacidadeRuns) {
+            int novaCapacidade = capacidadeRuns ? capacidadeRuns * 2 : 16;
+            FILE** novo = mem_realocar(MEMORIA_TEMPORARIA, runs, sizeof(FILE*) * novaCapacidade);
+            if (!novo) {
+                ok = false;
+                break;
+            }
+            runs = novo;
+            capacidadeRuns = novaCapacidade;
+        }
+
+        FILE* run = tmpfile();
+        ok = run != NULL;
+        for (size_t i = 0; ok && i < n; i++) ok = gravar_registro(run, ordem[i]);
+        if (run) runs[numRuns++] = run;
+    }
+    trace_fim("Ordenação externa: runs");
+    estatistica->runs = numRuns;
+
+    // A memória das runs vira buffer de leitura na intercalação
+    mem_liberar(ordem);
+    mem_liberar(itens);
+
+    int maximoVias = (int)(orcamentoBytes / BUFFER_MINIMO_RUN) - 1;
+    if (maximoVias < 2) maximoVias = 2;
+    if (maximoVias > MAXIMO_VIAS) maximoVias = MAXIMO_VIAS;
+
+    // Fase 2: passadas intermediárias enquanto houver mais runs do que vias, agrupando runs vizinhas
+    trace_inicio("Ordenação externa: intercalação");
+    while (ok && numRuns > maximoVias) {
+        int novasRuns = 0;
+        for (int inicio = 0; ok && inicio < numRuns; inicio += maximoVias) {
+            int fim = inicio + maximoVias < numRuns ? inicio + maximoVias : numRuns;
+            FILE* saida = tmpfile();
+            ok = saida != NULL && intercalar_runs(runs, inicio, fim, chave, orcamentoBytes, saida, NULL, NULL);
+            if (saida) runs[novasRuns++] = saida;
+        }
+        // Em caso de falha as runs ainda não intercaladas continuam depois de novasRuns e são fechadas abaixo
+        if (ok) numRuns = novasRuns;
+        estatistica->passadas++;
+    }
+    if (ok) {
+        ok = intercalar_runs(runs, 0, numRuns, chave, orcamentoBytes, NULL, consumidor, contextoConsumidor);
+        estatistica->passadas++;
+    }
+    trace_fim("Ordenação externa: intercalação");
+
+    for (int i = 0; i < numRuns; i++) {
+        if (runs[i]) fclose(runs[i]);
+    }
+    mem_liberar(runs);
+    return ok;
+}
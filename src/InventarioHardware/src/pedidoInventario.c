@@ -0,0 +1,270 @@
+#include "pedidoInventario.h"
+#include "memoria.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char* NOMES_PEDIDOS[NUM_OPERACOES_PEDIDO] = {
+    "Pedido: inválido", "Pedido: cadastrar", "Pedido: registrar manutenção", "Pedido: consultar",
+    "Pedido: buscar", "Pedido: listar", "Pedido: listar por tipo", "Pedido: listar por data de compra",
+    "Pedido: listar por data de manutenção", "Pedido: ordenação externa", "Pedido: depreciação",
+    "Pedido: obsoletos", "Pedido: manutenção pendente", "Pedido: próximas manutenções",
+    "Pedido: relatório agregado", "Pedido: projeção do valor", "Pedido: valor em data",
+    "Pedido: previsão de substituição", "Pedido: uso de memória", "Pedido: exportação colunar",
+    "Pedido: enfileirar manutenção"
+};
+
+void pedido_init(PedidoInventario* pedido, OperacaoPedido operacao, const Data* hoje) {
+    memset(pedido, 0, sizeof(*pedido));
+    pedido->operacao = operacao;
+    if (hoje) pedido->hoje = *hoje;
+}
+
+const char* pedido_nome(OperacaoPedido operacao) {
+    return (operacao > 0 && operacao < NUM_OPERACOES_PEDIDO) ? NOMES_PEDIDOS[operacao] : NOMES_PEDIDOS[0];
+}
+
+bool pedido_executar(SistemaInventario* sistema, const PedidoInventario* pedido, Hardware* registro) {
+    const Data* hoje = &pedido->hoje;
+    switch (pedido->operacao) {
+        case PEDIDO_CADASTRAR:
+            return sistema_cadastrar_hardware(sistema, pedido->nome, pedido->fabricante, pedido->tipo, &pedido->data,
+                                              pedido->valorCompra, pedido->vidaUtilAnos);
+        case PEDIDO_REGISTRAR_MANUTENCAO:
+            return sistema_registrar_manutencao(sistema, pedido->id, &pedido->data);
+        case PEDIDO_CONSULTAR:
+            return sistema_consultar_hardware(sistema, pedido->id);
+        case PEDIDO_BUSCAR: {
+            Hardware encontrado;
+            if (!sistema_buscar_hardware(sistema, pedido->id, &encontrado)) return false;
+            if (registro) *registro = encontrado;
+            return true;
+        }
+        case PEDIDO_LISTAR:
+            sistema_listar_equipamentos(sistema);
+            return true;
+        case PEDIDO_LISTAR_POR_TIPO:
+            sistema_listar_por_tipo(sistema, pedido->tipo);
+            return true;
+        case PEDIDO_LISTAR_POR_DATA_COMPRA:
+            sistema_listar_por_data_compra(sistema);
+            return true;
+        case PEDIDO_LISTAR_POR_DATA_MANUTENCAO:
+            sistema_listar_por_data_manutencao(sistema);
+            return true;
+        case PEDIDO_LISTAR_ORDENADO_EXTERNO:
+            sistema_listar_ordenado_externo(sistema, pedido->chave, (size_t)pedido->orcamentoBytes);
+            return true;
+        case PEDIDO_DEPRECIACAO:
+            sistema_mostrar_analise_depreciacao_paralela(sistema, hoje);
+            return true;
+        case PEDIDO_OBSOLETOS:
+            sistema_identificar_obsoletos_paralelo(sistema, hoje);
+            return true;
+        case PEDIDO_MANUTENCAO_PENDENTE:
+            sistema_relatorio_manutencao_pendente_agenda(sistema, hoje, pedido->meses);
+            return true;
+        case PEDIDO_PROXIMAS_MANUTENCOES:
+            sistema_relatorio_proximas_manutencoes(sistema, hoje, pedido->meses, pedido->quantidade);
+            return true;
+        case PEDIDO_AGREGADO:
+            sistema_relatorio_agregado(sistema, pedido->campos, hoje, pedido->meses);
+            return true;
+        case PEDIDO_PROJECAO_VALOR:
+            sistema_mostrar_projecao_valor(sistema, hoje, pedido->anos);
+            return true;
+        case PEDIDO_VALOR_EM_DATA:
+            sistema_mostrar_valor_em_data(sistema, &pedido->data);
+            return true;
+        case PEDIDO_PREVISAO_SUBSTITUICAO:
+            sistema_previsao_substituicao(sistema, hoje, pedido->anos);
+            return true;
+        case PEDIDO_USO_MEMORIA:
+            sistema_relatorio_memoria(sistema);
+            return true;
+        case PEDIDO_EXPORTAR_COLUNAR:
+            return sistema_exportar_colunar(sistema, pedido->arquivo);
+        case PEDIDO_ENFILEIRAR_MANUTENCAO:
+            return sistema_enfileirar_manutencao(sistema, pedido->id, &pedido->data);
+        default:
+            fprintf(stderr, "Operação desconhecida: %d\n", (int)pedido->operacao);
+            return false;
+    }
+}
+
+void resposta_init(RespostaInventario* resposta) {
+    resposta->sucesso = false;
+    texto_buffer_init(&resposta->saida);
+    texto_buffer_init(&resposta->erros);
+    resposta->temRegistro = false;
+}
+
+void resposta_liberar(RespostaInventario* resposta) {
+    texto_buffer_liberar(&resposta->saida);
+    texto_buffer_liberar(&resposta->erros);
+    resposta->temRegistro = false;
+}
+
+// --- Codificação ---
+
+static bool anexar_u32(TextoBuffer* destino, uint32_t valor) {
+    return texto_buffer_anexar_bytes(destino, &valor, sizeof(valor));
+}
+
+static bool anexar_i32(TextoBuffer* destino, int valor) {
+    int32_t v = (int32_t)valor;
+    return texto_buffer_anexar_bytes(destino, &v, sizeof(v));
+}
+
+// Texto com prefixo de tamanho de 32 bits, sem o terminador
+static bool anexar_texto(TextoBuffer* destino, const char* texto, size_t tamanho) {
+    return anexar_u32(destino, (uint32_t)tamanho) && texto_buffer_anexar_bytes(destino, texto, tamanho);
+}
+
+// O tamanho do corpo só é conhecido no fim: reserva o cabeçalho e preenche depois
+static bool quadro_abrir(TextoBuffer* destino, uint32_t sequencia, uint32_t codigo, size_t* inicio) {
+    *inicio = destino->tamanho;
+    return anexar_u32(destino, 0) && anexar_u32(destino, sequencia) && anexar_u32(destino, codigo);
+}
+
+static void quadro_fechar(TextoBuffer* destino, size_t inicio) {
+    uint32_t tamanho = (uint32_t)(destino->tamanho - inicio - QUADRO_CABECALHO);
+    memcpy(destino->dados + inicio, &tamanho, sizeof(tamanho));
+}
+
+bool pedido_codificar(TextoBuffer* destino, const PedidoInventario* pedido, uint32_t sequencia) {
+    size_t inicio;
+    const int inteiros[] = {
+        pedido->hoje.dia, pedido->hoje.mes, pedido->hoje.ano, pedido->data.dia, pedido->data.mes, pedido->data.ano,
+        pedido->id, (int)pedido->tipo, pedido->meses, pedido->quantidade, pedido->anos, pedido->campos,
+        pedido->vidaUtilAnos, (int)pedido->chave
+    };
+    bool ok = quadro_abrir(destino, sequencia, (uint32_t)pedido->operacao, &inicio);
+    for (size_t i = 0; ok && i < sizeof(inteiros) / sizeof(inteiros[0]); i++) {
+        ok = anexar_i32(destino, inteiros[i]);
+    }
+    int64_t orcamento = pedido->orcamentoBytes;
+    ok = ok && texto_buffer_anexar_bytes(destino, &orcamento, sizeof(orcamento)) &&
+         texto_buffer_anexar_bytes(destino, &pedido->valorCompra, sizeof(pedido->valorCompra)) &&
+         anexar_texto(destino, pedido->nome, strnlen(pedido->nome, sizeof(pedido->nome) - 1)) &&
+         anexar_texto(destino, pedido->fabricante, strnlen(pedido->fabricante, sizeof(pedido->fabricante) - 1)) &&
+         anexar_texto(destino, pedido->arquivo, strnlen(pedido->arquivo, sizeof(pedido->arquivo) - 1));
+    if (!ok) {
+        destino->tamanho = inicio;
+        return false;
+    }
+    quadro_fechar(destino, inicio);
+    return true;
+}
+
+bool resposta_codificar(TextoBuffer* destino, const RespostaInventario* resposta, uint32_t sequencia) {
+    size_t inicio;
+    char* csv = resposta->temRegistro ? hardware_to_csv(&resposta->registro) : NULL;
+    bool ok = quadro_abrir(destino, sequencia, resposta->sucesso ? 1 : 0, &inicio) &&
+              anexar_texto(destino, resposta->saida.dados, resposta->saida.tamanho) &&
+              anexar_texto(destino, resposta->erros.dados, resposta->erros.tamanho) &&
+              anexar_texto(destino, csv, csv ? strlen(csv) : 0);
+    mem_liberar(csv);
+    if (!ok) {
+        destino->tamanho = inicio;
+        return false;
+    }
+    quadro_fechar(destino, inicio);
+    return true;
+}
+
+// --- Decodificação ---
+
+typedef struct {
+    const char* dados;
+    size_t restante;
+} LeitorQuadro;
+
+static bool ler_bytes(LeitorQuadro* leitor, void* destino, size_t tamanho) {
+    if (leitor->restante < tamanho) return false;
+    memcpy(destino, leitor->dados, tamanho);
+    leitor->dados += tamanho;
+    leitor->restante -= tamanho;
+    return true;
+}
+
+static bool ler_i32(LeitorQuadro* leitor, int* valor) {
+    int32_t v;
+    if (!ler_bytes(leitor, &v, sizeof(v))) return false;
+    *valor = (int)v;
+    return true;
+}
+
+// Texto em destino de capacidade fixa; mais longo que a capacidade é quadro inválido
+static bool ler_texto_fixo(LeitorQuadro* leitor, char* destino, size_t capacidade) {
+    uint32_t tamanho;
+    if (!ler_bytes(leitor, &tamanho, sizeof(tamanho)) || tamanho >= capacidade) return false;
+    if (!ler_bytes(leitor, destino, tamanho)) return false;
+    destino[tamanho] = '\0';
+    return true;
+}
+
+static bool ler_texto_buffer(LeitorQuadro* leitor, TextoBuffer* destino) {
+    uint32_t tamanho;
+    if (!ler_bytes(leitor, &tamanho, sizeof(tamanho)) || tamanho > leitor->restante) return false;
+    // Terminador incluído para o texto poder ser impresso direto
+    bool ok = texto_buffer_anexar_bytes(destino, leitor->dados, tamanho) && texto_buffer_anexar_bytes(destino, "", 1);
+    if (ok) destino->tamanho--;
+    leitor->dados += tamanho;
+    leitor->restante -= tamanho;
+    return ok;
+}
+
+bool quadro_cabecalho(const char* dados, size_t disponivel, CabecalhoQuadro* cabecalho) {
+    if (disponivel < QUADRO_CABECALHO) return false;
+    memcpy(&cabecalho->tamanho, dados, 4);
+    memcpy(&cabecalho->sequencia, dados + 4, 4);
+    memcpy(&cabecalho->codigo, dados + 8, 4);
+    return true;
+}
+
+bool pedido_decodificar(const CabecalhoQuadro* cabecalho, const char* corpo, PedidoInventario* pedido) {
+    LeitorQuadro leitor = { corpo, cabecalho->tamanho };
+    memset(pedido, 0, sizeof(*pedido));
+    if (cabecalho->codigo == 0 || cabecalho->codigo >= NUM_OPERACOES_PEDIDO) return false;
+    pedido->operacao = (OperacaoPedido)cabecalho->codigo;
+
+    int tipo = 0, chave = 0;
+    int64_t orcamento = 0;
+    bool ok = ler_i32(&leitor, &pedido->hoje.dia) && ler_i32(&leitor, &pedido->hoje.mes) &&
+              ler_i32(&leitor, &pedido->hoje.ano) && ler_i32(&leitor, &pedido->data.dia) &&
+              ler_i32(&leitor, &pedido->data.mes) && ler_i32(&leitor, &pedido->data.ano) &&
+              ler_i32(&leitor, &pedido->id) && ler_i32(&leitor, &tipo) && ler_i32(&leitor, &pedido->meses) &&
+              ler_i32(&leitor, &pedido->quantidade) && ler_i32(&leitor, &pedido->anos) &&
+              ler_i32(&leitor, &pedido->campos) && ler_i32(&leitor, &pedido->vidaUtilAnos) &&
+              ler_i32(&leitor, &chave) && ler_bytes(&leitor, &orcamento, sizeof(orcamento)) &&
+              ler_bytes(&leitor, &pedido->valorCompra, sizeof(pedido->valorCompra)) &&
+              ler_texto_fixo(&leitor, pedido->nome, sizeof(pedido->nome)) &&
+              ler_texto_fixo(&leitor, pedido->fabricante, sizeof(pedido->fabricante)) &&
+              ler_texto_fixo(&leitor, pedido->arquivo, sizeof(pedido->arquivo));
+    if (!ok || leitor.restante != 0) return false;
+    if (tipo < 0 || tipo >= NUM_TIPOS_HARDWARE || (chave != ORDENAR_DATA_COMPRA && chave != ORDENAR_DATA_MANUTENCAO)) {
+        return false;
+    }
+    pedido->tipo = (TipoHardware)tipo;
+    pedido->chave = (ChaveOrdenacao)chave;
+    pedido->orcamentoBytes = orcamento < 0 ? 0 : orcamento;
+    return true;
+}
+
+bool resposta_decodificar(const CabecalhoQuadro* cabecalho, const char* corpo, RespostaInventario* resposta) {
+    LeitorQuadro leitor = { corpo, cabecalho->tamanho };
+    resposta_init(resposta);
+    resposta->sucesso = cabecalho->codigo != 0;
+
+    TextoBuffer csv;
+    texto_buffer_init(&csv);
+    bool ok = ler_texto_buffer(&leitor, &resposta->saida) && ler_texto_buffer(&leitor, &resposta->erros) &&
+              ler_texto_buffer(&leitor, &csv) && leitor.restante == 0;
+    if (ok && csv.tamanho > 0) {
+        ok = hardware_from_csv(csv.dados, &resposta->registro);
+        resposta->temRegistro = ok;
+    }
+    texto_buffer_liberar(&csv);
+    if (!ok) resposta_liberar(resposta);
+    return ok;
+}
@@ -0,0 +1,245 @@
+#include "projecao.h"
+#include "depreciacao.h"
+#include "obsolescencia.h"
+#include "memoria.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define CHAVES_POR_MES 31
+#define CHAVES_POR_ANO (12 * CHAVES_POR_MES)
+
+void projecao_init(ProjecaoValor* projecao) {
+    projecao->anoBase = 0;
+    projecao->numChaves = 0;
+    projecao->variacoes = NULL;
+    projecao->fenwick = NULL;
+    projecao->construida = false;
+}
+
+void projecao_liberar(ProjecaoValor* projecao) {
+    mem_liberar(projecao->variacoes);
+    mem_liberar(projecao->fenwick);
+    projecao_init(projecao);
+}
+
+static int projecao_chave(const ProjecaoValor* projecao, int dia, int mes, int ano) {
+    return (ano - projecao->anoBase) * CHAVES_POR_ANO + (mes - 1) * CHAVES_POR_MES + (dia - 1);
+}
+
+static void projecao_variar(ProjecaoValor* projecao, int dia, int mes, int ano, double variacao) {
+    projecao->variacoes[projecao_chave(projecao, dia, mes, ano)] += variacao;
+}
+
+// Registra os degraus de todos os equipamentos e monta a árvore em O(n * vida útil + chaves)
+bool projecao_construir(ProjecaoValor* projecao, const LinkedList* list) {
+    projecao_liberar(projecao);
+    if (list->head == NULL) {
+        projecao->construida = true;
+        return true;
+    }
+
+    int anoMin = list->head->data.dataCompra.ano;
+    int anoMax = anoMin;
+    for (Node* current = list->head; current != NULL; current = current->next) {
+        const Hardware* hw = &current->data;
+        int fim = hw->dataCompra.ano + (hw->vidaUtilAnos > 0 ? hw->vidaUtilAnos : 1);
+        if (hw->dataCompra.ano < anoMin) anoMin = hw->dataCompra.ano;
+        if (fim > anoMax) anoMax = fim;
+    }
+
+    projecao->anoBase = anoMin;
+    projecao->numChaves = (anoMax - anoMin + 1) * CHAVES_POR_ANO;
+    projecao->variacoes = mem_alocar_zerado(MEMORIA_INDICES, projecao->numChaves, sizeof(double));
+    projecao->fenwick = mem_alocar(MEMORIA_INDICES, sizeof(double) * (projecao->numChaves + 1));
+    if (!projecao->variacoes || !projecao->fenwick) {
+        projecao_liberar(projecao);
+        return false;
+    }
+
+    for (Node* current = list->head; current != NULL; current = current->next) {
+        const Hardware* hw = &current->data;
+        const Data* compra = &hw->dataCompra;
+
+        projecao_variar(projecao, compra->dia, compra->mes, compra->ano, hw->valorCompra);
+
+        // A depreciação só muda nos aniversários da compra, até o fim da vida útil
+        // (o primeiro aniversário, se a vida útil não for positiva)
+        int ultimoAno = hw->vidaUtilAnos > 0 ? hw->vidaUtilAnos : 1;
+        double acumulada = 0.0;
+        for (int anos = 1; anos <= ultimoAno; anos++) {
+            Data aniversario = *compra;
+            aniversario.ano += anos;
+            double depreciacao = depreciacao_acumulada(hw->valorCompra, hw->vidaUtilAnos, compra, &aniversario);
+            projecao_variar(projecao, compra->dia, compra->mes, compra->ano + anos, -(depreciacao - acumulada));
+            acumulada = depreciacao;
+        }
+    }
+
+    // Construção linear da árvore de Fenwick (índices a partir de 1)
+    projecao->fenwick[0] = 0.0;
+    memcpy(projecao->fenwick + 1, projecao->variacoes, sizeof(double) * projecao->numChaves);
+    for (int i = 1; i <= projecao->numChaves; i++) {
+        int pai = i + (i & -i);
+        if (pai <= projecao->numChaves) {
+            projecao->fenwick[pai] += projecao->fenwick[i];
+        }
+    }
+
+    projecao->construida = true;
+    return true;
+}
+
+// Valor contábil total na data informada, em O(log chaves)
+double projecao_valor_em(const ProjecaoValor* projecao, const Data* data) {
+    if (projecao->numChaves == 0) return 0.0;
+
+    int chave = projecao_chave(projecao, data->dia, data->mes, data->ano);
+    if (chave < 0) return 0.0;
+    if (chave >= projecao->numChaves) chave = projecao->numChaves - 1;
+
+    double soma = 0.0;
+    for (int i = chave + 1; i > 0; i -= i & -i) {
+        soma += projecao->fenwick[i];
+    }
+    return soma;
+}
+
+// Valor no último dia de cada mês a partir de mesInicial/anoInicial, numa única varredura
+bool projecao_curva_mensal(const ProjecaoValor* projecao, int mesInicial, int anoInicial, int numMeses, double* valores) {
+    if (numMeses <= 0) return true;
+
+    Data fimDoMes = {CHAVES_POR_MES, mesInicial, anoInicial};
+    double acumulado = projecao_valor_em(projecao, &fimDoMes);
+    int chaveInicial = projecao_chave(projecao, CHAVES_POR_MES, mesInicial, anoInicial);
+
+    for (int m = 0; m < numMeses; m++) {
+        int chave = chaveInicial + m * CHAVES_POR_MES;
+        if (m > 0) {
+            for (int c = chave - CHAVES_POR_MES + 1; c <= chave; c++) {
+                if (c >= 0 && c < projecao->numChaves) acumulado += projecao->variacoes[c];
+            }
+        }
+        valores[m] = acumulado;
+    }
+    return true;
+}
+
+
+#define ITENS_MINIMOS_POR_PARTE 16384
+
+typedef struct {
+    const Hardware* const* itens;
+    int numItens;
+    int numPartes;
+    Data hoje;
+    PrevisaoSubstituicao* parciais;
+} PrevisaoParalela;
+
+static bool previsao_alocar(PrevisaoSubstituicao* previsao, const Data* hoje, int numMeses) {
+    memset(previsao, 0, sizeof(*previsao));
+    previsao->mesInicial = hoje->mes;
+    previsao->anoInicial = hoje->ano;
+    previsao->numMeses = numMeses;
+    previsao->valores = mem_alocar_zerado(MEMORIA_TEMPORARIA, (size_t)numMeses * NUM_TIPOS_HARDWARE, sizeof(double));
+    previsao->quantidades = mem_alocar_zerado(MEMORIA_TEMPORARIA, (size_t)numMeses * NUM_TIPOS_HARDWARE, sizeof(long));
+    if (!previsao->valores || !previsao->quantidades) {
+        previsao_substituicao_liberar(previsao);
+        return false;
+    }
+    return true;
+}
+
+// Uma passada: cada equipamento cai no balde (mês do fim da vida útil, tipo)
+static void previsao_acumular(PrevisaoSubstituicao* previsao, const Hardware* const* itens, int inicio, int fim,
+                              const Data* hoje) {
+    int mesBase = hoje->ano * 12 + (hoje->mes - 1);
+
+    for (int i = inicio; i < fim; i++) {
+        const Hardware* hw = itens[i];
+        int tipo = (hw->tipo >= 0 && hw->tipo < NUM_TIPOS_HARDWARE) ? (int)hw->tipo : (int)OUTRO;
+        Data fimVida = data_obsolescencia(hw);
+
+        if (!data_menor_que(hoje, &fimVida)) {
+            previsao->atrasadoValor[tipo] += hw->valorCompra;
+            previsao->atrasadoQuantidade[tipo]++;
+            continue;
+        }
+
+        int mes = fimVida.ano * 12 + (fimVida.mes - 1) - mesBase;
+        if (mes >= previsao->numMeses) continue;
+
+        previsao->valores[mes * NUM_TIPOS_HARDWARE + tipo] += hw->valorCompra;
+        previsao->quantidades[mes * NUM_TIPOS_HARDWARE + tipo]++;
+    }
+}
+
+static void tarefa_previsao(void* contexto, int parte) {
+    PrevisaoParalela* ctx = (PrevisaoParalela*)contexto;
+    int inicio = (int)((long long)ctx->numItens * parte / ctx->numPartes);
+    int fim = (int)((long long)ctx->numItens * (parte + 1) / ctx->numPartes);
+    if (ctx->parciais[parte].valores != NULL) {
+        previsao_acumular(&ctx->parciais[parte], ctx->itens, inicio, fim, &ctx->hoje);
+    }
+}
+
+bool previsao_substituicao_calcular(PrevisaoSubstituicao* previsao, const Hardware* const* itens, int numItens,
+                                    const Data* hoje, int numMeses, ThreadPool* pool) {
+    if (numMeses <= 0 || !previsao_alocar(previsao, hoje, numMeses)) return false;
+
+    int numPartes = numItens / ITENS_MINIMOS_POR_PARTE;
+    int maxPartes = threadpool_num_threads(pool);
+    if (numPartes > maxPartes) numPartes = maxPartes;
+
+    if (pool == NULL || numPartes <= 1) {
+        previsao_acumular(previsao, itens, 0, numItens, hoje);
+        return true;
+    }
+
+    PrevisaoParalela ctx;
+    ctx.itens = itens;
+    ctx.numItens = numItens;
+    ctx.numPartes = numPartes;
+    ctx.hoje = *hoje;
+    ctx.parciais = mem_alocar_zerado(MEMORIA_TEMPORARIA, numPartes, sizeof(PrevisaoSubstituicao));
+    if (!ctx.parciais) {
+        previsao_substituicao_liberar(previsao);
+        return false;
+    }
+    for (int p = 0; p < numPartes; p++) {
+        previsao_alocar(&ctx.parciais[p], hoje, numMeses);
+    }
+
+    threadpool_executar(pool, numPartes, tarefa_previsao, &ctx);
+
+    // Mescla na ordem das partes para o resultado não depender do escalonamento
+    bool ok = true;
+    int numBaldes = numMeses * NUM_TIPOS_HARDWARE;
+    for (int p = 0; p < numPartes; p++) {
+        PrevisaoSubstituicao* parcial = &ctx.parciais[p];
+        if (parcial->valores == NULL) {
+            ok = false;
+            continue;
+        }
+        for (int b = 0; b < numBaldes; b++) {
+            previsao->valores[b] += parcial->valores[b];
+            previsao->quantidades[b] += parcial->quantidades[b];
+        }
+        for (int t = 0; t < NUM_TIPOS_HARDWARE; t++) {
+            previsao->atrasadoValor[t] += parcial->atrasadoValor[t];
+            previsao->atrasadoQuantidade[t] += parcial->atrasadoQuantidade[t];
+        }
+        previsao_substituicao_liberar(parcial);
+    }
+    mem_liberar(ctx.parciais);
+
+    if (!ok) previsao_substituicao_liberar(previsao);
+    return ok;
+}
+
+void previsao_substituicao_liberar(PrevisaoSubstituicao* previsao) {
+    mem_liberar(previsao->valores);
+    mem_liberar(previsao->quantidades);
+    previsao->valores = NULL;
+    previsao->quantidades = NULL;
+    previsao->numMeses = 0;
+}
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include "relatorioStream.h"
+#include "agendaManutencao.h"
+#include "depreciacao.h"
+#include "memoria.h"
+#include "obsolescencia.h"
+#include "trace.h"
+#include "utils.h"
+#include <stdio.h>
+
+typedef void (*VisitarRegistro)(void* contexto, const Hardware* hw);
+
+// Percorre o repositório em lotes de TAMANHO_LOTE_STREAM; devolve o número de registros ou -1
+static long percorrer_repositorio(Repository* repo, VisitarRegistro visitar, void* contexto) {
+    CursorRepositorio cursor;
+    if (!repositorio_cursor_abrir(repo, &cursor)) return -1;
+
+    Hardware* lote = mem_alocar(MEMORIA_TEMPORARIA, sizeof(Hardware) * TAMANHO_LOTE_STREAM);
+    if (!lote) {
+        repositorio_cursor_fechar(&cursor);
+        return -1;
+    }
+
+    long total = 0;
+    int lidos;
+    trace_inicio("Stream: leitura do repositório");
+    while ((lidos = repositorio_cursor_proximo(&cursor, lote, TAMANHO_LOTE_STREAM)) > 0) {
+        for (int i = 0; i < lidos; i++) {
+            visitar(contexto, &lote[i]);
+        }
+        total += lidos;
+    }
+    trace_fim("Stream: leitura do repositório");
+
+    mem_liberar(lote);
+    repositorio_cursor_fechar(&cursor);
+    return lidos < 0 ? -1 : total;
+}
+
+typedef struct {
+    const Data* hoje;
+    double totalOriginal;
+    double totalDepreciado;
+} ContextoDepreciacao;
+
+static void visitar_depreciacao(void* contexto, const Hardware* hw) {
+    ContextoDepreciacao* ctx = contexto;
+    double depreciacao = calcular_depreciacao(hw, ctx->hoje);
+    printf("ID: %d | %s | Valor original: R$%.2f | Depreciação: R$%.2f | Valor atual: R$%.2f\n",
+           hw->id, hw->nome, hw->valorCompra, depreciacao, hw->valorCompra - depreciacao);
+    ctx->totalOriginal += hw->valorCompra;
+    ctx->totalDepreciado += depreciacao;
+}
+
+bool relatorio_stream_depreciacao(Repository* repo, const Data* hoje) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    if (repo == NULL || hoje == NULL) return false;
+
+    char* hojeStr = data_to_string(hoje);
+    printf("=== ANÁLISE DE DEPRECIAÇÃO (Data base: %s) ===\n", hojeStr ? hojeStr : "ERRO");
+    if (hojeStr) mem_liberar(hojeStr);
+
+    ContextoDepreciacao ctx = { hoje, 0, 0 };
+    long total = percorrer_repositorio(repo, visitar_depreciacao, &ctx);
+    if (total < 0) {
+        fprintf(stderr, "Falha ao ler o repositório.\n");
+        return false;
+    }
+    if (total == 0) {
+        printf("Nenhum equipamento para analisar.\n");
+    } else {
+        printf("----------------------------------------------------------------\n");
+        printf("TOTAL | Valor original: R$%.2f | Depreciação total: R$%.2f | Valor atual total: R$%.2f\n",
+               ctx.totalOriginal, ctx.totalDepreciado, (ctx.totalOriginal - ctx.totalDepreciado));
+    }
+
+    cronometro_parar(&crono);
+    cronometro_definir_registros(total);
+    cronometro_imprimir("Análise de depreciação (streaming)", &crono);
+    return true;
+}
+
+typedef struct {
+    const Data* hoje;
+    int contador;
+} ContextoObsoletos;
+
+// Mesma regra da varredura completa do monitor de obsolescência
+static void visitar_obsoleto(void* contexto, const Hardware* hw) {
+    ContextoObsoletos* ctx = contexto;
+    Data fim = data_obsolescencia(hw);
+    if (data_menor_que(ctx->hoje, &fim)) return;
+
+    char* dataCompraStr = data_to_string(&hw->dataCompra);
+    printf("ID: %d | %s | Compra: %s | Vida útil: %d anos\n",
+           hw->id, hw->nome, dataCompraStr ? dataCompraStr : "ERRO", hw->vidaUtilAnos);
+    if (dataCompraStr) mem_liberar(dataCompraStr);
+    ctx->contador++;
+}
+
+bool relatorio_stream_obsoletos(Repository* repo, const Data* hoje) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    if (repo == NULL || hoje == NULL) return false;
+
+    char* hojeStr = data_to_string(hoje);
+    printf("=== EQUIPAMENTOS OBSOLETOS (Data base: %s) ===\n", hojeStr ? hojeStr : "ERRO");
+    if (hojeStr) mem_liberar(hojeStr);
+
+    ContextoObsoletos ctx = { hoje, 0 };
+    long total = percorrer_repositorio(repo, visitar_obsoleto, &ctx);
+    if (total < 0) {
+        fprintf(stderr, "Falha ao ler o repositório.\n");
+        return false;
+    }
+    printf("Total de obsoletos: %d\n", ctx.contador);
+
+    cronometro_parar(&crono);
+    cronometro_definir_registros(total);
+    cronometro_imprimir("Identificação de obsoletos (streaming)", &crono);
+    return true;
+}
+
+typedef struct {
+    const Data* hoje;
+    int mesesLimite;
+    int contador;
+} ContextoManutencao;
+
+static void visitar_manutencao(void* contexto, const Hardware* hw) {
+    ContextoManutencao* ctx = contexto;
+    int mesesDesdeManutencao = meses_desde(&hw->ultimaManutencao, ctx->hoje);
+    if (mesesDesdeManutencao < ctx->mesesLimite) return;
+
+    char* ultimaManutencaoStr = data_to_string(&hw->ultimaManutencao);
+    printf("ID: %d | %s | Última manutenção: %s | Meses sem manutenção: %d\n",
+           hw->id, hw->nome, ultimaManutencaoStr ? ultimaManutencaoStr : "ERRO", mesesDesdeManutencao);
+    if (ultimaManutencaoStr) mem_liberar(ultimaManutencaoStr);
+    ctx->contador++;
+}
+
+bool relatorio_stream_manutencao_pendente(Repository* repo, const Data* hoje, int mesesLimite) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    if (repo == NULL || hoje == NULL || mesesLimite <= 0) return false;
+
+    char* hojeStr = data_to_string(hoje);
+    printf("=== EQUIPAMENTOS COM MANUTENÇÃO PENDENTE (> %d meses, Data base: %s) ===\n",
+           mesesLimite, hojeStr ? hojeStr : "ERRO");
+    if (hojeStr) mem_liberar(hojeStr);
+
+    ContextoManutencao ctx = { hoje, mesesLimite, 0 };
+    long total = percorrer_repositorio(repo, visitar_manutencao, &ctx);
+    if (total < 0) {
+        fprintf(stderr, "Falha ao ler o repositório.\n");
+        return false;
+    }
+    printf("Total com manutenção pendente: %d\n", ctx.contador);
+
+    cronometro_parar(&crono);
+    cronometro_definir_registros(total);
+    cronometro_imprimir("Relatório de manutenção pendente (streaming)", &crono);
+    return true;
+}
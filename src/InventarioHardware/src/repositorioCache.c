@@ -0,0 +1,246 @@
+#include "repositorioCache.h"
+#include "mapaInt.h"
+#include "memoria.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Entradas numa lista duplamente ligada por índice: cabeca é a mais recente, cauda a próxima a sair
+typedef struct {
+    Hardware hw;
+    int anterior;
+    int proximo;
+} EntradaCache;
+
+typedef struct {
+    Repository* interno;
+    EntradaCache* entradas;
+    int capacidade;
+    int ocupacao;
+    int cabeca;
+    int cauda;
+    int livre;              // pilha de entradas livres encadeada por proximo
+    MapaInt posicoes;       // id -> índice em entradas
+    long long acertos;
+    long long falhas;
+    long long invalidacoes;
+} CacheRepository;
+
+static void lru_desligar(CacheRepository* cache, int i) {
+    EntradaCache* e = &cache->entradas[i];
+    if (e->anterior >= 0) cache->entradas[e->anterior].proximo = e->proximo;
+    else cache->cabeca = e->proximo;
+    if (e->proximo >= 0) cache->entradas[e->proximo].anterior = e->anterior;
+    else cache->cauda = e->anterior;
+}
+
+static void lru_inserir_na_frente(CacheRepository* cache, int i) {
+    EntradaCache* e = &cache->entradas[i];
+    e->anterior = -1;
+    e->proximo = cache->cabeca;
+    if (cache->cabeca >= 0) cache->entradas[cache->cabeca].anterior = i;
+    cache->cabeca = i;
+    if (cache->cauda < 0) cache->cauda = i;
+}
+
+static void cache_invalidar(CacheRepository* cache, int id) {
+    intptr_t i;
+    if (!mapa_int_buscar(&cache->posicoes, id, &i)) return;
+
+    lru_desligar(cache, (int)i);
+    mapa_int_remover(&cache->posicoes, id);
+    cache->entradas[i].proximo = cache->livre;
+    cache->livre = (int)i;
+    cache->ocupacao--;
+    cache->invalidacoes++;
+}
+
+static void cache_limpar(CacheRepository* cache) {
+    if (cache->ocupacao > 0) cache->invalidacoes += cache->ocupacao;
+    mapa_int_limpar(&cache->posicoes);
+    cache->ocupacao = 0;
+    cache->cabeca = cache->cauda = -1;
+    cache->livre = cache->capacidade > 0 ? 0 : -1;
+    for (int i = 0; i < cache->capacidade; i++) {
+        cache->entradas[i].proximo = i + 1 < cache->capacidade ? i + 1 : -1;
+    }
+}
+
+// Grava hw na entrada do seu id (nova ou existente) e a marca como mais recente
+static void cache_guardar(CacheRepository* cache, const Hardware* hw) {
+    if (cache->capacidade == 0) return;
+
+    intptr_t i;
+    if (mapa_int_buscar(&cache->posicoes, hw->id, &i)) {
+        lru_desligar(cache, (int)i);
+    } else {
+        if (cache->livre < 0) {
+            int vitima = cache->cauda;
+            lru_desligar(cache, vitima);
+            mapa_int_remover(&cache->posicoes, cache->entradas[vitima].hw.id);
+            cache->entradas[vitima].proximo = cache->livre;
+            cache->livre = vitima;
+            cache->ocupacao--;
+        }
+        i = cache->livre;
+        cache->livre = cache->entradas[i].proximo;
+        if (!mapa_int_inserir(&cache->posicoes, hw->id, i)) {
+            cache->entradas[i].proximo = cache->livre;
+            cache->livre = (int)i;
+            return;
+        }
+        cache->ocupacao++;
+    }
+    cache->entradas[i].hw = *hw;
+    lru_inserir_na_frente(cache, (int)i);
+}
+
+static bool cache_carregar(void* self, LinkedList* list) {
+    CacheRepository* cache = (CacheRepository*)self;
+    const RepositoryInterface* api = cache->interno->interface;
+    return api->carregar ? api->carregar(cache->interno->implementacao, list) : false;
+}
+
+// A lista salva pode ter registros alterados só em memória; o cache inteiro deixa de ser confiável
+static bool cache_salvar(void* self, const LinkedList* list) {
+    CacheRepository* cache = (CacheRepository*)self;
+    const RepositoryInterface* api = cache->interno->interface;
+    cache_limpar(cache);
+    return api->salvar ? api->salvar(cache->interno->implementacao, list) : false;
+}
+
+static bool cache_adicionar(void* self, const Hardware* hw) {
+    CacheRepository* cache = (CacheRepository*)self;
+    const RepositoryInterface* api = cache->interno->interface;
+    bool ok = api->adicionar ? api->adicionar(cache->interno->implementacao, hw) : false;
+    if (ok) cache_guardar(cache, hw);
+    return ok;
+}
+
+static bool cache_atualizar(void* self, const Hardware* hw) {
+    CacheRepository* cache = (CacheRepository*)self;
+    const RepositoryInterface* api = cache->interno->interface;
+    bool ok = api->atualizar ? api->atualizar(cache->interno->implementacao, hw) : false;
+    if (ok) {
+        cache_guardar(cache, hw);
+    } else {
+        cache_invalidar(cache, hw->id);
+    }
+    return ok;
+}
+
+static bool cache_remover(void* self, int id) {
+    CacheRepository* cache = (CacheRepository*)self;
+    const RepositoryInterface* api = cache->interno->interface;
+    cache_invalidar(cache, id);
+    return api->remover ? api->remover(cache->interno->implementacao, id) : false;
+}
+
+// Mesmo contrato do repositório interno: devolve uma cópia alocada com malloc
+static Hardware* cache_buscar_por_id(void* self, int id) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    CacheRepository* cache = (CacheRepository*)self;
+    intptr_t i;
+    if (mapa_int_buscar(&cache->posicoes, id, &i)) {
+        cache->acertos++;
+        lru_desligar(cache, (int)i);
+        lru_inserir_na_frente(cache, (int)i);
+
+        Hardware* copia = malloc(sizeof(Hardware));
+        if (copia) *copia = cache->entradas[i].hw;
+        cronometro_parar(&crono);
+        cronometro_imprimir("Cache - Buscar (acerto)", &crono);
+        return copia;
+    }
+
+    cache->falhas++;
+    const RepositoryInterface* api = cache->interno->interface;
+    Hardware* hw = api->buscar_por_id ? api->buscar_por_id(cache->interno->implementacao, id) : NULL;
+    if (hw) cache_guardar(cache, hw);
+    cronometro_parar(&crono);
+    cronometro_imprimir("Cache - Buscar (falha)", &crono);
+    return hw;
+}
+
+static bool cache_carregar_tipo(void* self, TipoHardware tipo, LinkedList* list) {
+    CacheRepository* cache = (CacheRepository*)self;
+    return repositorio_carregar_tipo(cache->interno, tipo, list);
+}
+
+// Sem cursor no interno, a abertura falha e repositorio_cursor_abrir informa isso ao chamador
+static void* cache_cursor_abrir(void* self) {
+    CacheRepository* cache = (CacheRepository*)self;
+    const RepositoryInterface* api = cache->interno->interface;
+    return api->cursor_abrir ? api->cursor_abrir(cache->interno->implementacao) : NULL;
+}
+
+static int cache_cursor_proximo(void* self, void* cursor, Hardware* lote, int capacidade) {
+    CacheRepository* cache = (CacheRepository*)self;
+    return cache->interno->interface->cursor_proximo(cache->interno->implementacao, cursor, lote, capacidade);
+}
+
+static void cache_cursor_fechar(void* self, void* cursor) {
+    CacheRepository* cache = (CacheRepository*)self;
+    cache->interno->interface->cursor_fechar(cache->interno->implementacao, cursor);
+}
+
+static void cache_destruir(void* self) {
+    CacheRepository* cache = (CacheRepository*)self;
+    destruir_repositorio(cache->interno);
+    mapa_int_destruir(&cache->posicoes);
+    mem_liberar(cache->entradas);
+    mem_liberar(cache);
+}
+
+static const RepositoryInterface cache_interface = {
+    .carregar = cache_carregar,
+    .salvar = cache_salvar,
+    .adicionar = cache_adicionar,
+    .atualizar = cache_atualizar,
+    .remover = cache_remover,
+    .buscar_por_id = cache_buscar_por_id,
+    .carregar_tipo = cache_carregar_tipo,
+    .cursor_abrir = cache_cursor_abrir,
+    .cursor_proximo = cache_cursor_proximo,
+    .cursor_fechar = cache_cursor_fechar,
+    .destruir = cache_destruir
+};
+
+Repository* criar_repositorio_cache(Repository* interno, size_t capacidade) {
+    if (interno == NULL || interno->interface == NULL || capacidade > (size_t)(1 << 30)) return NULL;
+
+    CacheRepository* cache = mem_alocar_zerado(MEMORIA_OUTROS, 1, sizeof(CacheRepository));
+    Repository* repo = mem_alocar(MEMORIA_OUTROS, sizeof(Repository));
+    EntradaCache* entradas = capacidade > 0 ? mem_alocar(MEMORIA_INDICES, sizeof(EntradaCache) * capacidade) : NULL;
+    if (!cache || !repo || (capacidade > 0 && !entradas)) {
+        mem_liberar(cache);
+        mem_liberar(repo);
+        mem_liberar(entradas);
+        return NULL;
+    }
+
+    cache->interno = interno;
+    cache->entradas = entradas;
+    cache->capacidade = (int)capacidade;
+    mapa_int_init(&cache->posicoes);
+    cache_limpar(cache);
+    cache->invalidacoes = 0;
+
+    repo->implementacao = cache;
+    repo->interface = &cache_interface;
+    return repo;
+}
+
+bool repositorio_cache_estatisticas(const Repository* repo, EstatisticaCache* estatistica) {
+    if (repo == NULL || repo->interface != &cache_interface) return false;
+
+    const CacheRepository* cache = (const CacheRepository*)repo->implementacao;
+    estatistica->acertos = cache->acertos;
+    estatistica->falhas = cache->falhas;
+    estatistica->invalidacoes = cache->invalidacoes;
+    estatistica->ocupacao = (size_t)cache->ocupacao;
+    estatistica->capacidade = (size_t)cache->capacidade;
+    return true;
+}
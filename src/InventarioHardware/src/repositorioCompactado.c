@@ -0,0 +1,904 @@
+#include "repositorioCompactado.h"
+#include "compressaoLz.h"
+#include "crc32c.h"
+#include "hardware.h"
+#include "linkedList.h"
+#include "trace.h"
+#include "utils.h"
+#include "memoria.h"
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Versão 2 acrescentou o CRC32C de cada bloco; arquivos da versão 1 ainda são lidos, sem verificação
+#define COMPACTADO_VERSAO 2
+#define COMPACTADO_MARCADOR 0x01020304u      // detecta arquivo gravado com outra ordem de bytes
+#define CODIFICACAO_BRUTA 0
+#define CODIFICACAO_LZ 1
+// Limite de sanidade para o tamanho descomprimido de um bloco lido do disco
+#define MAIOR_BLOCO_BRUTO (64u << 20)
+
+typedef struct {
+    char magica[8];
+    uint32_t versao;
+    uint32_t marcador;
+    uint32_t numBlocos;
+    uint32_t reservado;
+    int64_t numRegistros;
+} CabecalhoCompactado;
+
+typedef struct {
+    uint32_t numRegistros;
+    uint32_t tamanhoBruto;
+    uint32_t tamanhoGravado;
+    uint32_t codificacao;
+    int32_t menorId;
+    int32_t maiorId;
+    // CRC32C deste cabeçalho (com crc = 0) seguido dos bytes gravados do bloco
+    uint32_t crc;
+    uint32_t reservado;
+} CabecalhoBloco;
+
+// bloco_ler: o bloco não confere, mas o próximo ainda pode ser lido
+#define BLOCO_CORROMPIDO -2
+// bloco_ler: cabeçalho ilegível; não há como achar o início do próximo bloco
+#define BLOCO_ILEGIVEL -1
+
+static const char MAGICA_COMPACTADO[8] = {'I', 'N', 'V', 'Z', 'I', 'P', '1', '\0'};
+
+typedef struct {
+    const char* filename;
+    // A última leitura pulou blocos corrompidos: gravar agora perderia esses registros
+    bool leituraParcial;
+} CompactadoRepository;
+
+// ---------- Leitura e escrita de campos ----------
+
+typedef struct {
+    unsigned char* dados;
+    size_t tamanho;
+    size_t capacidade;
+    bool falha;
+} BufferBytes;
+
+static void buffer_reservar(BufferBytes* buffer, size_t extra) {
+    if (buffer->falha || buffer->tamanho + extra <= buffer->capacidade) return;
+    size_t capacidade = buffer->capacidade > 0 ? buffer->capacidade : 4096;
+    while (capacidade < buffer->tamanho + extra) capacidade *= 2;
+    unsigned char* dados = mem_realocar(MEMORIA_TEMPORARIA, buffer->dados, capacidade);
+    if (!dados) {
+        buffer->falha = true;
+        return;
+    }
+    buffer->dados = dados;
+    buffer->capacidade = capacidade;
+}
+
+static void buffer_byte(BufferBytes* buffer, unsigned char valor) {
+    buffer_reservar(buffer, 1);
+    if (!buffer->falha) buffer->dados[buffer->tamanho++] = valor;
+}
+
+static void buffer_varint(BufferBytes* buffer, uint64_t valor) {
+    buffer_reservar(buffer, 10);
+    if (buffer->falha) return;
+    while (valor >= 0x80) {
+        buffer->dados[buffer->tamanho++] = (unsigned char)(valor | 0x80);
+        valor >>= 7;
+    }
+    buffer->dados[buffer->tamanho++] = (unsigned char)valor;
+}
+
+// Textos do Hardware têm menos de 100 bytes; o comprimento cabe em um byte
+static void buffer_texto(BufferBytes* buffer, const char* texto) {
+    size_t tamanho = strlen(texto);
+    buffer_byte(buffer, (unsigned char)tamanho);
+    buffer_reservar(buffer, tamanho);
+    if (buffer->falha) return;
+    memcpy(buffer->dados + buffer->tamanho, texto, tamanho);
+    buffer->tamanho += tamanho;
+}
+
+typedef struct {
+    const unsigned char* atual;
+    const unsigned char* fim;
+    bool falha;
+} LeitorBytes;
+
+static unsigned char leitor_byte(LeitorBytes* leitor) {
+    if (leitor->atual >= leitor->fim) {
+        leitor->falha = true;
+        return 0;
+    }
+    return *leitor->atual++;
+}
+
+static uint64_t leitor_varint(LeitorBytes* leitor) {
+    uint64_t valor = 0;
+    for (int deslocamento = 0; deslocamento < 64 && !leitor->falha; deslocamento += 7) {
+        unsigned char byte = leitor_byte(leitor);
+        valor |= (uint64_t)(byte & 0x7F) << deslocamento;
+        if ((byte & 0x80) == 0) return valor;
+    }
+    leitor->falha = true;
+    return 0;
+}
+
+static void leitor_texto(LeitorBytes* leitor, char* destino, size_t capacidade) {
+    size_t tamanho = leitor_byte(leitor);
+    if (leitor->falha || tamanho >= capacidade || (size_t)(leitor->fim - leitor->atual) < tamanho) {
+        leitor->falha = true;
+        destino[0] = '\0';
+        return;
+    }
+    memcpy(destino, leitor->atual, tamanho);
+    destino[tamanho] = '\0';
+    leitor->atual += tamanho;
+}
+
+static uint64_t zigzag(int64_t valor) {
+    return ((uint64_t)valor << 1) ^ (uint64_t)(valor >> 63);
+}
+
+static int64_t dezigzag(uint64_t valor) {
+    return (int64_t)(valor >> 1) ^ -(int64_t)(valor & 1);
+}
+
+// Data como inteiro ordenado (ano, mês, dia em bits), para que datas próximas deem deltas pequenos
+static bool data_para_serial(const Data* data, int64_t* serial) {
+    if (data->dia < 0 || data->dia > 31 || data->mes < 0 || data->mes > 15 || data->ano < 0 || data->ano > (1 << 22)) {
+        return false;
+    }
+    *serial = ((int64_t)data->ano << 9) | ((int64_t)data->mes << 5) | data->dia;
+    return true;
+}
+
+static bool serial_para_data(int64_t serial, Data* data) {
+    if (serial < 0 || (serial >> 9) > (1 << 22)) return false;
+    data->dia = (int)(serial & 31);
+    data->mes = (int)((serial >> 5) & 15);
+    data->ano = (int)(serial >> 9);
+    return true;
+}
+
+// ---------- Codificação de blocos ----------
+
+// Dicionário de fabricantes do bloco: tabela hash (sondagem linear) de texto para índice
+#define SLOTS_DICIONARIO (2 * REGISTROS_POR_BLOCO)
+
+typedef struct {
+    const Hardware** itens;
+    int* indiceFabricante;
+    const char** fabricantes;
+    int* slots;
+    int numFabricantes;
+    BufferBytes bruto;
+    unsigned char* gravado;
+    size_t capacidadeGravado;
+} CodificadorBlocos;
+
+static bool codificador_init(CodificadorBlocos* cod) {
+    memset(cod, 0, sizeof(*cod));
+    cod->itens = mem_alocar(MEMORIA_TEMPORARIA, sizeof(const Hardware*) * REGISTROS_POR_BLOCO);
+    cod->indiceFabricante = mem_alocar(MEMORIA_TEMPORARIA, sizeof(int) * REGISTROS_POR_BLOCO);
+    cod->fabricantes = mem_alocar(MEMORIA_TEMPORARIA, sizeof(const char*) * REGISTROS_POR_BLOCO);
+    cod->slots = mem_alocar(MEMORIA_TEMPORARIA, sizeof(int) * SLOTS_DICIONARIO);
+    return cod->itens && cod->indiceFabricante && cod->fabricantes && cod->slots;
+}
+
+static void codificador_liberar(CodificadorBlocos* cod) {
+    mem_liberar(cod->itens);
+    mem_liberar(cod->indiceFabricante);
+    mem_liberar(cod->fabricantes);
+    mem_liberar(cod->slots);
+    mem_liberar(cod->bruto.dados);
+    mem_liberar(cod->gravado);
+}
+
+static int dicionario_indice(CodificadorBlocos* cod, const char* texto) {
+    uint32_t h = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)texto; *p; p++) {
+        h = (h ^ *p) * 16777619u;
+    }
+    for (uint32_t slot = h & (SLOTS_DICIONARIO - 1);; slot = (slot + 1) & (SLOTS_DICIONARIO - 1)) {
+        int indice = cod->slots[slot] - 1;
+        if (indice < 0) {
+            indice = cod->numFabricantes++;
+            cod->fabricantes[indice] = texto;
+            cod->slots[slot] = indice + 1;
+            return indice;
+        }
+        if (strcmp(cod->fabricantes[indice], texto) == 0) return indice;
+    }
+}
+
+// Colunas do bloco, nesta ordem: dicionário de fabricantes, ids (delta), tipos, índices de fabricante,
+// data de compra (delta sobre o registro anterior), última manutenção (delta sobre a compra),
+// valor em centavos, vida útil, bitmap de obsoletos e por fim os nomes.
+static bool bloco_codificar(CodificadorBlocos* cod, int n, CabecalhoBloco* cabecalho) {
+    BufferBytes* bruto = &cod->bruto;
+    bruto->tamanho = 0;
+    cod->numFabricantes = 0;
+    memset(cod->slots, 0, sizeof(int) * SLOTS_DICIONARIO);
+
+    cabecalho->menorId = cod->itens[0]->id;
+    cabecalho->maiorId = cod->itens[0]->id;
+    for (int i = 0; i < n; i++) {
+        const Hardware* hw = cod->itens[i];
+        if (hw->id < cabecalho->menorId) cabecalho->menorId = hw->id;
+        if (hw->id > cabecalho->maiorId) cabecalho->maiorId = hw->id;
+        cod->indiceFabricante[i] = dicionario_indice(cod, hw->fabricante);
+    }
+
+    buffer_varint(bruto, (uint64_t)cod->numFabricantes);
+    for (int i = 0; i < cod->numFabricantes; i++) buffer_texto(bruto, cod->fabricantes[i]);
+
+    int64_t anterior = 0;
+    for (int i = 0; i < n; i++) {
+        buffer_varint(bruto, zigzag((int64_t)cod->itens[i]->id - anterior));
+        anterior = cod->itens[i]->id;
+    }
+    for (int i = 0; i < n; i++) buffer_byte(bruto, (unsigned char)cod->itens[i]->tipo);
+    for (int i = 0; i < n; i++) buffer_varint(bruto, (uint64_t)cod->indiceFabricante[i]);
+
+    anterior = 0;
+    for (int i = 0; i < n; i++) {
+        int64_t compra, manutencao;
+        if (!data_para_serial(&cod->itens[i]->dataCompra, &compra) ||
+            !data_para_serial(&cod->itens[i]->ultimaManutencao, &manutencao)) {
+            fprintf(stderr, "Data fora do intervalo suportado no registro %d\n", cod->itens[i]->id);
+            return false;
+        }
+        buffer_varint(bruto, zigzag(compra - anterior));
+        anterior = compra;
+    }
+    for (int i = 0; i < n; i++) {
+        int64_t compra = 0, manutencao = 0;
+        data_para_serial(&cod->itens[i]->dataCompra, &compra);
+        data_para_serial(&cod->itens[i]->ultimaManutencao, &manutencao);
+        buffer_varint(bruto, zigzag(manutencao - compra));
+    }
+    // Mesma precisão do CSV, que grava o valor com duas casas
+    for (int i = 0; i < n; i++) {
+        double centavos = round(cod->itens[i]->valorCompra * 100.0);
+        if (!(fabs(centavos) < 9.0e15)) {
+            fprintf(stderr, "Valor fora do intervalo suportado no registro %d\n", cod->itens[i]->id);
+            return false;
+        }
+        buffer_varint(bruto, zigzag((int64_t)centavos));
+    }
+    for (int i = 0; i < n; i++) buffer_varint(bruto, zigzag(cod->itens[i]->vidaUtilAnos));
+    for (int i = 0; i < n; i += 8) {
+        unsigned char bits = 0;
+        for (int j = 0; j < 8 && i + j < n; j++) {
+            if (cod->itens[i + j]->obsoleto) bits |= (unsigned char)(1u << j);
+        }
+        buffer_byte(bruto, bits);
+    }
+    for (int i = 0; i < n; i++) buffer_texto(bruto, cod->itens[i]->nome);
+    if (bruto->falha) return false;
+
+    size_t limite = lz_limite_comprimido(bruto->tamanho);
+    if (limite > cod->capacidadeGravado) {
+        unsigned char* gravado = mem_realocar(MEMORIA_TEMPORARIA, cod->gravado, limite);
+        if (!gravado) return false;
+        cod->gravado = gravado;
+        cod->capacidadeGravado = limite;
+    }
+    size_t comprimido = lz_comprimir(bruto->dados, bruto->tamanho, cod->gravado, cod->capacidadeGravado);
+
+    cabecalho->numRegistros = (uint32_t)n;
+    cabecalho->tamanhoBruto = (uint32_t)bruto->tamanho;
+    if (comprimido > 0 && comprimido < bruto->tamanho) {
+        cabecalho->codificacao = CODIFICACAO_LZ;
+        cabecalho->tamanhoGravado = (uint32_t)comprimido;
+    } else {
+        cabecalho->codificacao = CODIFICACAO_BRUTA;
+        cabecalho->tamanhoGravado = (uint32_t)bruto->tamanho;
+        memcpy(cod->gravado, bruto->dados, bruto->tamanho);
+    }
+    return true;
+}
+
+static uint32_t bloco_crc(const CabecalhoBloco* cabecalho, const unsigned char* gravado) {
+    CabecalhoBloco semCrc = *cabecalho;
+    semCrc.crc = 0;
+    uint32_t crc = crc32c_atualizar(0, &semCrc, sizeof(semCrc));
+    return crc32c_atualizar(crc, gravado, cabecalho->tamanhoGravado);
+}
+
+static bool bloco_gravar(FILE* arquivo, CodificadorBlocos* cod, int n) {
+    CabecalhoBloco cabecalho;
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    if (!bloco_codificar(cod, n, &cabecalho)) return false;
+    cabecalho.crc = bloco_crc(&cabecalho, cod->gravado);
+    return fwrite(&cabecalho, sizeof(cabecalho), 1, arquivo) == 1 &&
+           fwrite(cod->gravado, 1, cabecalho.tamanhoGravado, arquivo) == cabecalho.tamanhoGravado;
+}
+
+// ---------- Decodificação de blocos ----------
+
+typedef struct {
+    const unsigned char* texto;
+    unsigned tamanho;
+} TextoDicionario;
+
+typedef struct {
+    unsigned char* gravado;
+    size_t capacidadeGravado;
+    unsigned char* bruto;
+    size_t capacidadeBruto;
+    TextoDicionario* fabricantes;
+    Hardware* registros;
+} DecodificadorBlocos;
+
+static bool decodificador_init(DecodificadorBlocos* dec) {
+    memset(dec, 0, sizeof(*dec));
+    dec->fabricantes = mem_alocar(MEMORIA_TEMPORARIA, sizeof(TextoDicionario) * REGISTROS_POR_BLOCO);
+    dec->registros = mem_alocar(MEMORIA_TEMPORARIA, sizeof(Hardware) * REGISTROS_POR_BLOCO);
+    return dec->fabricantes && dec->registros;
+}
+
+static void decodificador_liberar(DecodificadorBlocos* dec) {
+    mem_liberar(dec->gravado);
+    mem_liberar(dec->bruto);
+    mem_liberar(dec->fabricantes);
+    mem_liberar(dec->registros);
+}
+
+static bool garantir_capacidade(unsigned char** buffer, size_t* capacidade, size_t tamanho) {
+    if (tamanho <= *capacidade) return true;
+    unsigned char* novo = mem_realocar(MEMORIA_TEMPORARIA, *buffer, tamanho);
+    if (!novo) return false;
+    *buffer = novo;
+    *capacidade = tamanho;
+    return true;
+}
+
+static bool cabecalho_bloco_valido(const CabecalhoBloco* cabecalho) {
+    if (cabecalho->numRegistros == 0 || cabecalho->numRegistros > REGISTROS_POR_BLOCO) return false;
+    if (cabecalho->tamanhoBruto > MAIOR_BLOCO_BRUTO || cabecalho->menorId > cabecalho->maiorId) return false;
+    if (cabecalho->codificacao == CODIFICACAO_BRUTA) return cabecalho->tamanhoGravado == cabecalho->tamanhoBruto;
+    return cabecalho->codificacao == CODIFICACAO_LZ &&
+           cabecalho->tamanhoGravado <= lz_limite_comprimido(cabecalho->tamanhoBruto);
+}
+
+static bool bloco_decodificar(DecodificadorBlocos* dec, const unsigned char* bruto, size_t tamanho, int n) {
+    LeitorBytes leitor = { bruto, bruto + tamanho, false };
+    Hardware* registros = dec->registros;
+
+    uint64_t numFabricantes = leitor_varint(&leitor);
+    if (numFabricantes > (uint64_t)n) return false;
+    for (uint64_t i = 0; i < numFabricantes && !leitor.falha; i++) {
+        unsigned tamanhoTexto = leitor_byte(&leitor);
+        if (tamanhoTexto >= sizeof(registros->fabricante) || (size_t)(leitor.fim - leitor.atual) < tamanhoTexto) return false;
+        dec->fabricantes[i].texto = leitor.atual;
+        dec->fabricantes[i].tamanho = tamanhoTexto;
+        leitor.atual += tamanhoTexto;
+    }
+
+    int64_t anterior = 0;
+    for (int i = 0; i < n; i++) {
+        anterior += dezigzag(leitor_varint(&leitor));
+        if (anterior < INT32_MIN || anterior > INT32_MAX) return false;
+        registros[i].id = (int)anterior;
+    }
+    for (int i = 0; i < n; i++) {
+        unsigned tipo = leitor_byte(&leitor);
+        if (tipo >= NUM_TIPOS_HARDWARE) return false;
+        registros[i].tipo = (TipoHardware)tipo;
+    }
+    for (int i = 0; i < n; i++) {
+        uint64_t indice = leitor_varint(&leitor);
+        if (indice >= numFabricantes) return false;
+        memcpy(registros[i].fabricante, dec->fabricantes[indice].texto, dec->fabricantes[indice].tamanho);
+        registros[i].fabricante[dec->fabricantes[indice].tamanho] = '\0';
+    }
+    anterior = 0;
+    for (int i = 0; i < n; i++) {
+        anterior += dezigzag(leitor_varint(&leitor));
+        if (!serial_para_data(anterior, &registros[i].dataCompra)) return false;
+    }
+    for (int i = 0; i < n; i++) {
+        int64_t compra = ((int64_t)registros[i].dataCompra.ano << 9) | (registros[i].dataCompra.mes << 5) | registros[i].dataCompra.dia;
+        if (!serial_para_data(compra + dezigzag(leitor_varint(&leitor)), &registros[i].ultimaManutencao)) return false;
+    }
+    for (int i = 0; i < n; i++) registros[i].valorCompra = (double)dezigzag(leitor_varint(&leitor)) / 100.0;
+    for (int i = 0; i < n; i++) registros[i].vidaUtilAnos = (int)dezigzag(leitor_varint(&leitor));
+    for (int i = 0; i < n; i += 8) {
+        unsigned char bits = leitor_byte(&leitor);
+        for (int j = 0; j < 8 && i + j < n; j++) registros[i + j].obsoleto = (bits >> j) & 1;
+    }
+    for (int i = 0; i < n; i++) leitor_texto(&leitor, registros[i].nome, sizeof(registros[i].nome));
+
+    return !leitor.falha && leitor.atual == leitor.fim;
+}
+
+// A versão 1 não tinha o CRC: o cabeçalho do bloco terminava antes dele
+static bool bloco_ler_cabecalho(FILE* arquivo, uint32_t versao, CabecalhoBloco* cabecalho) {
+    memset(cabecalho, 0, sizeof(*cabecalho));
+    size_t tamanho = versao == 1 ? offsetof(CabecalhoBloco, crc) : sizeof(CabecalhoBloco);
+    return fread(cabecalho, tamanho, 1, arquivo) == 1 && cabecalho_bloco_valido(cabecalho);
+}
+
+// Lê e decodifica o próximo bloco em dec->registros; devolve o número de registros, BLOCO_CORROMPIDO
+// (arquivo posicionado no bloco seguinte) ou BLOCO_ILEGIVEL
+static int bloco_ler(FILE* arquivo, uint32_t versao, DecodificadorBlocos* dec, CabecalhoBloco* cabecalho) {
+    if (!bloco_ler_cabecalho(arquivo, versao, cabecalho)) return BLOCO_ILEGIVEL;
+    if (!garantir_capacidade(&dec->gravado, &dec->capacidadeGravado, cabecalho->tamanhoGravado) ||
+        fread(dec->gravado, 1, cabecalho->tamanhoGravado, arquivo) != cabecalho->tamanhoGravado) {
+        return BLOCO_ILEGIVEL;
+    }
+    if (versao >= 2 && bloco_crc(cabecalho, dec->gravado) != cabecalho->crc) return BLOCO_CORROMPIDO;
+
+    const unsigned char* bruto = dec->gravado;
+    if (cabecalho->codificacao == CODIFICACAO_LZ) {
+        if (!garantir_capacidade(&dec->bruto, &dec->capacidadeBruto, cabecalho->tamanhoBruto) ||
+            !lz_descomprimir(dec->gravado, cabecalho->tamanhoGravado, dec->bruto, cabecalho->tamanhoBruto)) {
+            return BLOCO_CORROMPIDO;
+        }
+        bruto = dec->bruto;
+    }
+    int n = (int)cabecalho->numRegistros;
+    return bloco_decodificar(dec, bruto, cabecalho->tamanhoBruto, n) ? n : BLOCO_CORROMPIDO;
+}
+
+// Relata um bloco que não pôde ser usado, com a faixa de registros (posição no arquivo) e de ids
+static void bloco_relatar(const char* filename, uint32_t bloco, int64_t primeiroRegistro, const CabecalhoBloco* cabecalho) {
+    fprintf(stderr, "[Compactado] %s: bloco %u (registros %lld-%lld, ids %d-%d) corrompido; registros ignorados\n",
+            filename, bloco, (long long)primeiroRegistro, (long long)(primeiroRegistro + cabecalho->numRegistros - 1),
+            cabecalho->menorId, cabecalho->maiorId);
+}
+
+static void blocos_ilegiveis_relatar(const char* filename, uint32_t bloco, const CabecalhoCompactado* cabecalho, int64_t primeiroRegistro) {
+    fprintf(stderr, "[Compactado] %s: blocos %u-%u (registros %lld-%lld) ilegíveis; leitura interrompida\n",
+            filename, bloco, cabecalho->numBlocos - 1, (long long)primeiroRegistro, (long long)(cabecalho->numRegistros - 1));
+}
+
+static FILE* compactado_abrir(const char* filename, CabecalhoCompactado* cabecalho) {
+    FILE* arquivo = fopen(filename, "rb");
+    if (!arquivo) return NULL;
+    if (fread(cabecalho, sizeof(*cabecalho), 1, arquivo) != 1 ||
+        memcmp(cabecalho->magica, MAGICA_COMPACTADO, sizeof(cabecalho->magica)) != 0 ||
+        cabecalho->versao < 1 || cabecalho->versao > COMPACTADO_VERSAO || cabecalho->marcador != COMPACTADO_MARCADOR) {
+        fprintf(stderr, "%s não é um inventário compactado válido\n", filename);
+        fclose(arquivo);
+        return NULL;
+    }
+    return arquivo;
+}
+
+// Percorre só os cabeçalhos dos blocos: true se algum bloco cobre o id
+static bool compactado_pode_conter(const CompactadoRepository* repo, int id) {
+    CabecalhoCompactado cabecalho;
+    FILE* arquivo = compactado_abrir(repo->filename, &cabecalho);
+    if (!arquivo) return false;
+
+    bool encontrado = false;
+    for (uint32_t b = 0; b < cabecalho.numBlocos && !encontrado; b++) {
+        CabecalhoBloco bloco;
+        if (!bloco_ler_cabecalho(arquivo, cabecalho.versao, &bloco)) {
+            // Cabeçalho ilegível: sem como descartar, deixa a operação seguir pelo caminho completo
+            encontrado = true;
+            break;
+        }
+        encontrado = id >= bloco.menorId && id <= bloco.maiorId;
+        if (fseek(arquivo, (long)bloco.tamanhoGravado, SEEK_CUR) != 0) encontrado = true;
+    }
+    fclose(arquivo);
+    return encontrado;
+}
+
+// ---------- Operações do repositório ----------
+
+static bool compactado_carregar(void* self, LinkedList* list) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    CompactadoRepository* repo = (CompactadoRepository*)self;
+    CabecalhoCompactado cabecalho;
+    FILE* arquivo = compactado_abrir(repo->filename, &cabecalho);
+    if (!arquivo) {
+        cronometro_parar(&crono);
+        cronometro_imprimir("Compactado - Carregar dados (falha)", &crono);
+        return false;
+    }
+
+    DecodificadorBlocos dec;
+    bool ok = decodificador_init(&dec);
+    int contador = 0;
+    int64_t primeiroRegistro = 0;
+    bool corrompido = false;
+    trace_inicio("Compactado: descompressão e decodificação");
+    for (uint32_t b = 0; ok && b < cabecalho.numBlocos; b++) {
+        CabecalhoBloco bloco;
+        int n = bloco_ler(arquivo, cabecalho.versao, &dec, &bloco);
+        if (n == BLOCO_ILEGIVEL) {
+            blocos_ilegiveis_relatar(repo->filename, b, &cabecalho, primeiroRegistro);
+            corrompido = true;
+            break;
+        }
+        if (n == BLOCO_CORROMPIDO) {
+            bloco_relatar(repo->filename, b, primeiroRegistro, &bloco);
+            corrompido = true;
+        }
+        for (int i = 0; i < n; i++) {
+            linkedlist_push_back(list, &dec.registros[i]);
+        }
+        contador += n > 0 ? n : 0;
+        primeiroRegistro += bloco.numRegistros;
+    }
+    trace_fim("Compactado: descompressão e decodificação");
+    decodificador_liberar(&dec);
+    fclose(arquivo);
+
+    repo->leituraParcial = corrompido;
+    if (corrompido) {
+        size_t tamanhoNome = strlen(repo->filename) + 12;
+        char* copia = mem_alocar(MEMORIA_TEMPORARIA, tamanhoNome);
+        if (copia) {
+            snprintf(copia, tamanhoNome, "%s.corrompido", repo->filename);
+            if (copiar_arquivo(repo->filename, copia)) {
+                fprintf(stderr, "[Compactado] Cópia do arquivo original preservada em %s\n", copia);
+            }
+            mem_liberar(copia);
+        }
+        fprintf(stderr, "[Compactado] Gravações em %s recusadas até uma leitura completa\n", repo->filename);
+    }
+
+    cronometro_parar(&crono);
+    if (cronometro_console_ativo()) printf("[Compactado] Carregados %d itens - ", contador);
+    cronometro_definir_registros(contador);
+    cronometro_imprimir(ok ? "Carregar dados" : "Carregar dados (falha)", &crono);
+    return ok;
+}
+
+static bool compactado_salvar(void* self, const LinkedList* list) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    CompactadoRepository* repo = (CompactadoRepository*)self;
+    if (repo->leituraParcial) {
+        fprintf(stderr, "[Compactado] %s: a última leitura ignorou blocos corrompidos; gravação recusada para "
+                "não perder esses registros\n", repo->filename);
+        cronometro_parar(&crono);
+        cronometro_imprimir("Compactado - Salvar dados (leitura parcial)", &crono);
+        return false;
+    }
+    CabecalhoCompactado cabecalho;
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    memcpy(cabecalho.magica, MAGICA_COMPACTADO, sizeof(cabecalho.magica));
+    cabecalho.versao = COMPACTADO_VERSAO;
+    cabecalho.marcador = COMPACTADO_MARCADOR;
+    cabecalho.numBlocos = (uint32_t)((list->size + REGISTROS_POR_BLOCO - 1) / REGISTROS_POR_BLOCO);
+    cabecalho.numRegistros = list->size;
+
+    // Grava num arquivo temporário e renomeia, para nunca deixar o inventário pela metade
+    size_t tamanhoNome = strlen(repo->filename) + 5;
+    char* arquivoTemporario = mem_alocar(MEMORIA_TEMPORARIA, tamanhoNome);
+    CodificadorBlocos cod;
+    bool ok = codificador_init(&cod) && arquivoTemporario != NULL;
+    FILE* arquivo = NULL;
+    if (ok) {
+        snprintf(arquivoTemporario, tamanhoNome, "%s.tmp", repo->filename);
+        arquivo = fopen(arquivoTemporario, "wb");
+        ok = arquivo != NULL && fwrite(&cabecalho, sizeof(cabecalho), 1, arquivo) == 1;
+    }
+
+    trace_inicio("Compactado: codificação e escrita");
+    Node* current = list->head;
+    while (ok && current != NULL) {
+        int n = 0;
+        for (; current != NULL && n < REGISTROS_POR_BLOCO; current = current->next) {
+            cod.itens[n++] = &current->data;
+        }
+        ok = bloco_gravar(arquivo, &cod, n);
+    }
+    trace_fim("Compactado: codificação e escrita");
+
+    if (arquivo && fclose(arquivo) != 0) ok = false;
+    if (arquivoTemporario) {
+        if (ok && rename(arquivoTemporario, repo->filename) != 0) {
+            // No Windows rename não substitui um arquivo existente
+            remove(repo->filename);
+            ok = rename(arquivoTemporario, repo->filename) == 0;
+        }
+        if (!ok) remove(arquivoTemporario);
+    }
+    codificador_liberar(&cod);
+    mem_liberar(arquivoTemporario);
+
+    cronometro_parar(&crono);
+    if (cronometro_console_ativo()) printf("[Compactado] Salvos %d itens - ", ok ? list->size : 0);
+    cronometro_definir_registros(list->size);
+    cronometro_imprimir(ok ? "Salvar dados" : "Salvar dados (falha)", &crono);
+    return ok;
+}
+
+// Acrescenta um bloco de um registro no fim e atualiza o cabeçalho; salvar reagrupa os blocos depois
+static bool compactado_adicionar(void* self, const Hardware* hw) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    CompactadoRepository* repo = (CompactadoRepository*)self;
+    CabecalhoCompactado cabecalho;
+    FILE* existente = compactado_abrir(repo->filename, &cabecalho);
+    if (!existente) {
+        // Arquivo presente mas inválido não é sobrescrito por um inventário de um item
+        FILE* outro = fopen(repo->filename, "rb");
+        if (outro) {
+            fclose(outro);
+            cronometro_parar(&crono);
+            cronometro_imprimir("Compactado - Adicionar (arquivo inválido)", &crono);
+            return false;
+        }
+        LinkedList unico;
+        linkedlist_init(&unico);
+        linkedlist_push_back(&unico, hw);
+        bool resultado = compactado_salvar(repo, &unico);
+        linkedlist_clear(&unico);
+        cronometro_parar(&crono);
+        cronometro_imprimir("Adicionar hardware", &crono);
+        return resultado;
+    }
+    fclose(existente);
+
+    if (cabecalho.versao != COMPACTADO_VERSAO) {
+        // Não mistura blocos de versões diferentes: regrava tudo na versão atual
+        LinkedList temp;
+        linkedlist_init(&temp);
+        bool resultado = compactado_carregar(repo, &temp);
+        if (resultado) {
+            linkedlist_push_back(&temp, hw);
+            resultado = compactado_salvar(repo, &temp);
+        }
+        linkedlist_clear(&temp);
+        cronometro_parar(&crono);
+        cronometro_imprimir(resultado ? "Adicionar hardware" : "Compactado - Adicionar (falha)", &crono);
+        return resultado;
+    }
+
+    CodificadorBlocos cod;
+    bool ok = codificador_init(&cod);
+    FILE* arquivo = ok ? fopen(repo->filename, "r+b") : NULL;
+    if (arquivo) {
+        cod.itens[0] = hw;
+        cabecalho.numBlocos++;
+        cabecalho.numRegistros++;
+        ok = fseek(arquivo, 0, SEEK_END) == 0 && bloco_gravar(arquivo, &cod, 1) &&
+             fseek(arquivo, 0, SEEK_SET) == 0 && fwrite(&cabecalho, sizeof(cabecalho), 1, arquivo) == 1;
+        if (fclose(arquivo) != 0) ok = false;
+    } else {
+        ok = false;
+    }
+    codificador_liberar(&cod);
+
+    cronometro_parar(&crono);
+    cronometro_imprimir(ok ? "Adicionar hardware" : "Compactado - Adicionar (falha)", &crono);
+    return ok;
+}
+
+static bool compactado_atualizar(void* self, const Hardware* hw) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    CompactadoRepository* repo = (CompactadoRepository*)self;
+    if (!compactado_pode_conter(repo, hw->id)) {
+        cronometro_parar(&crono);
+        cronometro_imprimir("Compactado - Atualizar (fora das faixas de id)", &crono);
+        return false;
+    }
+
+    LinkedList temp;
+    linkedlist_init(&temp);
+    bool resultado = false;
+    if (compactado_carregar(repo, &temp)) {
+        for (Node* current = temp.head; current != NULL; current = current->next) {
+            if (current->data.id == hw->id) {
+                current->data = *hw;
+                resultado = compactado_salvar(repo, &temp);
+                break;
+            }
+        }
+    }
+    linkedlist_clear(&temp);
+
+    cronometro_parar(&crono);
+    cronometro_imprimir(resultado ? "Atualizar hardware" : "Compactado - Atualizar (não encontrado)", &crono);
+    return resultado;
+}
+
+static bool compactado_remover(void* self, int id) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    CompactadoRepository* repo = (CompactadoRepository*)self;
+    if (!compactado_pode_conter(repo, id)) {
+        cronometro_parar(&crono);
+        cronometro_imprimir("Compactado - Remover (fora das faixas de id)", &crono);
+        return false;
+    }
+
+    LinkedList temp;
+    linkedlist_init(&temp);
+    bool resultado = false;
+    if (compactado_carregar(repo, &temp)) {
+        Node* prev = NULL;
+        for (Node* current = temp.head; current != NULL; prev = current, current = current->next) {
+            if (current->data.id != id) continue;
+            if (prev == NULL) {
+                temp.head = current->next;
+            } else {
+                prev->next = current->next;
+            }
+            if (current == temp.tail) temp.tail = prev;
+            temp.size--;
+            mem_liberar(current);
+            resultado = compactado_salvar(repo, &temp);
+            break;
+        }
+    }
+    linkedlist_clear(&temp);
+
+    cronometro_parar(&crono);
+    cronometro_imprimir(resultado ? "Remover hardware" : "Compactado - Remover (não encontrado)", &crono);
+    return resultado;
+}
+
+// Só descomprime os blocos cuja faixa de ids cobre o id pedido
+static Hardware* compactado_buscar_por_id(void* self, int id) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    CompactadoRepository* repo = (CompactadoRepository*)self;
+    CabecalhoCompactado cabecalho;
+    FILE* arquivo = compactado_abrir(repo->filename, &cabecalho);
+    if (!arquivo) {
+        cronometro_parar(&crono);
+        cronometro_imprimir("Compactado - Buscar (falha ao abrir)", &crono);
+        return NULL;
+    }
+
+    DecodificadorBlocos dec;
+    Hardware* copia = NULL;
+    bool ok = decodificador_init(&dec);
+    int64_t primeiroRegistro = 0;
+    for (uint32_t b = 0; ok && copia == NULL && b < cabecalho.numBlocos; b++) {
+        CabecalhoBloco bloco;
+        long inicio = ftell(arquivo);
+        if (!bloco_ler_cabecalho(arquivo, cabecalho.versao, &bloco)) {
+            blocos_ilegiveis_relatar(repo->filename, b, &cabecalho, primeiroRegistro);
+            break;
+        }
+        if (id < bloco.menorId || id > bloco.maiorId) {
+            ok = fseek(arquivo, (long)bloco.tamanhoGravado, SEEK_CUR) == 0;
+            primeiroRegistro += bloco.numRegistros;
+            continue;
+        }
+
+        int n = fseek(arquivo, inicio, SEEK_SET) == 0 ? bloco_ler(arquivo, cabecalho.versao, &dec, &bloco) : BLOCO_ILEGIVEL;
+        if (n == BLOCO_CORROMPIDO) bloco_relatar(repo->filename, b, primeiroRegistro, &bloco);
+        if (n == BLOCO_ILEGIVEL) blocos_ilegiveis_relatar(repo->filename, b, &cabecalho, primeiroRegistro);
+        ok = n != BLOCO_ILEGIVEL;
+        primeiroRegistro += bloco.numRegistros;
+        for (int i = 0; i < n; i++) {
+            if (dec.registros[i].id != id) continue;
+            copia = malloc(sizeof(Hardware));
+            if (copia) *copia = dec.registros[i];
+            break;
+        }
+    }
+    decodificador_liberar(&dec);
+    fclose(arquivo);
+
+    cronometro_parar(&crono);
+    cronometro_imprimir(copia ? "Buscar hardware" : "Compactado - Buscar (não encontrado)", &crono);
+    return copia;
+}
+
+// Cursor: um bloco decodificado por vez
+typedef struct {
+    const char* filename;
+    FILE* arquivo;
+    CabecalhoCompactado cabecalho;
+    DecodificadorBlocos dec;
+    uint32_t proximoBloco;
+    int64_t primeiroRegistro;
+    int quantidade;
+    int posicao;
+    bool corrompido;
+} CursorCompactado;
+
+static void compactado_cursor_fechar(void* self, void* estado) {
+    CursorCompactado* cursor = (CursorCompactado*)estado;
+    if (cursor == NULL) return;
+    if (cursor->corrompido) ((CompactadoRepository*)self)->leituraParcial = true;
+    if (cursor->arquivo) fclose(cursor->arquivo);
+    decodificador_liberar(&cursor->dec);
+    mem_liberar(cursor);
+}
+
+static void* compactado_cursor_abrir(void* self) {
+    CompactadoRepository* repo = (CompactadoRepository*)self;
+    CursorCompactado* cursor = mem_alocar_zerado(MEMORIA_TEMPORARIA, 1, sizeof(CursorCompactado));
+    if (!cursor) return NULL;
+
+    cursor->filename = repo->filename;
+    cursor->arquivo = compactado_abrir(repo->filename, &cursor->cabecalho);
+    if (!cursor->arquivo || !decodificador_init(&cursor->dec)) {
+        compactado_cursor_fechar(repo, cursor);
+        return NULL;
+    }
+    return cursor;
+}
+
+static int compactado_cursor_proximo(void* self, void* estado, Hardware* lote, int capacidade) {
+    (void)self;
+    CursorCompactado* cursor = (CursorCompactado*)estado;
+    int lidos = 0;
+    while (lidos < capacidade) {
+        if (cursor->posicao == cursor->quantidade) {
+            if (cursor->proximoBloco >= cursor->cabecalho.numBlocos) break;
+            uint32_t b = cursor->proximoBloco++;
+            CabecalhoBloco bloco;
+            int n = bloco_ler(cursor->arquivo, cursor->cabecalho.versao, &cursor->dec, &bloco);
+            cursor->quantidade = 0;
+            cursor->posicao = 0;
+            if (n == BLOCO_ILEGIVEL) {
+                blocos_ilegiveis_relatar(cursor->filename, b, &cursor->cabecalho, cursor->primeiroRegistro);
+                cursor->proximoBloco = cursor->cabecalho.numBlocos;
+                cursor->corrompido = true;
+                break;
+            }
+            if (n == BLOCO_CORROMPIDO) {
+                bloco_relatar(cursor->filename, b, cursor->primeiroRegistro, &bloco);
+                cursor->corrompido = true;
+            } else {
+                cursor->quantidade = n;
+            }
+            cursor->primeiroRegistro += bloco.numRegistros;
+            continue;
+        }
+        int disponiveis = cursor->quantidade - cursor->posicao;
+        int copiar = disponiveis < capacidade - lidos ? disponiveis : capacidade - lidos;
+        memcpy(&lote[lidos], &cursor->dec.registros[cursor->posicao], sizeof(Hardware) * copiar);
+        cursor->posicao += copiar;
+        lidos += copiar;
+    }
+    return lidos;
+}
+
+static void compactado_destruir(void* self) {
+    mem_liberar(self);
+}
+
+static const RepositoryInterface compactado_interface = {
+    .carregar = compactado_carregar,
+    .salvar = compactado_salvar,
+    .adicionar = compactado_adicionar,
+    .atualizar = compactado_atualizar,
+    .remover = compactado_remover,
+    .buscar_por_id = compactado_buscar_por_id,
+    .cursor_abrir = compactado_cursor_abrir,
+    .cursor_proximo = compactado_cursor_proximo,
+    .cursor_fechar = compactado_cursor_fechar,
+    .destruir = compactado_destruir
+};
+
+Repository* criar_repositorio_compactado(const char* filename) {
+    CompactadoRepository* impl = mem_alocar(MEMORIA_OUTROS, sizeof(CompactadoRepository));
+    Repository* repo = mem_alocar(MEMORIA_OUTROS, sizeof(Repository));
+    if (!impl || !repo) {
+        mem_liberar(impl);
+        mem_liberar(repo);
+        return NULL;
+    }
+    impl->filename = filename;
+    impl->leituraParcial = false;
+    repo->implementacao = impl;
+    repo->interface = &compactado_interface;
+    return repo;
+}
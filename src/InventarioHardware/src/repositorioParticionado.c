@@ -0,0 +1,427 @@
+#include "repositorioParticionado.h"
+#include "threadPool.h"
+#include "trace.h"
+#include "utils.h"
+#include "memoria.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Cada partição é um repositório CSV comum, com seu próprio mapa de ids. A assinatura guarda o
+// conteúdo da partição na última leitura/gravação feita por aqui, para salvar só o que mudou.
+typedef struct {
+    char* arquivo;
+    Repository* csv;
+    unsigned long long assinatura;
+    bool assinaturaValida;
+} Particao;
+
+typedef struct {
+    Particao particoes[NUM_TIPOS_HARDWARE];
+    ThreadPool* pool;
+} ParticionadoRepository;
+
+static bool arquivo_existe(const char* nome) {
+    FILE* arquivo = fopen(nome, "r");
+    if (!arquivo) return false;
+    fclose(arquivo);
+    return true;
+}
+
+static unsigned long long assinatura_misturar(unsigned long long h, const void* dados, size_t tamanho) {
+    const unsigned char* bytes = dados;
+    for (size_t i = 0; i < tamanho; i++) {
+        h ^= bytes[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+// Campo a campo: o preenchimento da struct e o resto dos buffers de texto não entram na conta
+static unsigned long long assinatura_registro(unsigned long long h, const Hardware* hw) {
+    int obsoleto = hw->obsoleto ? 1 : 0;
+    h = assinatura_misturar(h, &hw->id, sizeof(hw->id));
+    h = assinatura_misturar(h, hw->nome, strlen(hw->nome) + 1);
+    h = assinatura_misturar(h, hw->fabricante, strlen(hw->fabricante) + 1);
+    h = assinatura_misturar(h, &hw->tipo, sizeof(hw->tipo));
+    h = assinatura_misturar(h, &hw->dataCompra, sizeof(hw->dataCompra));
+    h = assinatura_misturar(h, &hw->valorCompra, sizeof(hw->valorCompra));
+    h = assinatura_misturar(h, &hw->vidaUtilAnos, sizeof(hw->vidaUtilAnos));
+    h = assinatura_misturar(h, &hw->ultimaManutencao, sizeof(hw->ultimaManutencao));
+    return assinatura_misturar(h, &obsoleto, sizeof(obsoleto));
+}
+
+static unsigned long long assinatura_lista(const LinkedList* list) {
+    unsigned long long h = 14695981039346656037ULL;
+    for (Node* current = list->head; current != NULL; current = current->next) {
+        h = assinatura_registro(h, &current->data);
+    }
+    return h;
+}
+
+// Carga paralela: cada tarefa lê uma partição para sua própria lista
+typedef struct {
+    ParticionadoRepository* repo;
+    LinkedList listas[NUM_TIPOS_HARDWARE];
+    bool ok[NUM_TIPOS_HARDWARE];
+} CargaParticoes;
+
+static void tarefa_carregar_particao(void* contexto, int indice) {
+    CargaParticoes* carga = contexto;
+    Particao* particao = &carga->repo->particoes[indice];
+    if (!arquivo_existe(particao->arquivo)) {
+        carga->ok[indice] = false;
+        return;
+    }
+
+    trace_inicio("Partição: carregar");
+    carga->ok[indice] = particao->csv->interface->carregar(particao->csv->implementacao, &carga->listas[indice]);
+    trace_fim("Partição: carregar");
+    if (carga->ok[indice]) {
+        particao->assinatura = assinatura_lista(&carga->listas[indice]);
+        particao->assinaturaValida = true;
+    }
+}
+
+// Intercala as partições por id movendo os nós, sem copiar registros. Como os ids são atribuídos
+// em ordem crescente, isso reproduz a ordem de cadastro que o CSV único teria.
+static void intercalar_por_id(LinkedList* listas, LinkedList* destino) {
+    for (;;) {
+        int menor = -1;
+        for (int t = 0; t < NUM_TIPOS_HARDWARE; t++) {
+            if (listas[t].head == NULL) continue;
+            if (menor < 0 || listas[t].head->data.id < listas[menor].head->data.id) menor = t;
+        }
+        if (menor < 0) break;
+
+        Node* no = listas[menor].head;
+        listas[menor].head = no->next;
+        listas[menor].size--;
+        no->next = NULL;
+        if (destino->tail) {
+            destino->tail->next = no;
+        } else {
+            destino->head = no;
+        }
+        destino->tail = no;
+        destino->size++;
+    }
+    for (int t = 0; t < NUM_TIPOS_HARDWARE; t++) {
+        linkedlist_init(&listas[t]);
+    }
+}
+
+static bool particionado_carregar(void* self, LinkedList* list) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    ParticionadoRepository* repo = (ParticionadoRepository*)self;
+    CargaParticoes carga;
+    carga.repo = repo;
+    for (int t = 0; t < NUM_TIPOS_HARDWARE; t++) {
+        linkedlist_init(&carga.listas[t]);
+        carga.ok[t] = false;
+    }
+
+    threadpool_executar(repo->pool, NUM_TIPOS_HARDWARE, tarefa_carregar_particao, &carga);
+
+    bool algumaParticao = false;
+    for (int t = 0; t < NUM_TIPOS_HARDWARE; t++) {
+        algumaParticao = algumaParticao || carga.ok[t];
+    }
+    int antes = list->size;
+    intercalar_por_id(carga.listas, list);
+
+    cronometro_parar(&crono);
+    cronometro_definir_registros(list->size - antes);
+    cronometro_imprimir(algumaParticao ? "Partições - Carregar dados" : "Partições - Carregar dados (nenhuma partição)", &crono);
+    return algumaParticao;
+}
+
+// Gravação paralela: cada tarefa separa os registros do seu tipo e só grava se a partição mudou
+typedef struct {
+    ParticionadoRepository* repo;
+    const LinkedList* list;
+    bool ok[NUM_TIPOS_HARDWARE];
+    bool gravada[NUM_TIPOS_HARDWARE];
+} GravacaoParticoes;
+
+static void tarefa_salvar_particao(void* contexto, int indice) {
+    GravacaoParticoes* gravacao = contexto;
+    Particao* particao = &gravacao->repo->particoes[indice];
+
+    LinkedList registros;
+    linkedlist_init(&registros);
+    for (Node* current = gravacao->list->head; current != NULL; current = current->next) {
+        if ((int)current->data.tipo == indice) linkedlist_push_back(&registros, &current->data);
+    }
+
+    unsigned long long assinatura = assinatura_lista(&registros);
+    gravacao->ok[indice] = true;
+    gravacao->gravada[indice] = false;
+    bool inalterada = particao->assinaturaValida && particao->assinatura == assinatura && arquivo_existe(particao->arquivo);
+    // Partição vazia que nunca existiu continua sem arquivo
+    bool dispensavel = registros.size == 0 && !arquivo_existe(particao->arquivo);
+    if (!inalterada && !dispensavel) {
+        trace_inicio("Partição: salvar");
+        gravacao->ok[indice] = particao->csv->interface->salvar(particao->csv->implementacao, &registros);
+        trace_fim("Partição: salvar");
+        gravacao->gravada[indice] = true;
+        particao->assinatura = assinatura;
+        particao->assinaturaValida = gravacao->ok[indice];
+    }
+    linkedlist_clear(&registros);
+}
+
+static bool particionado_salvar(void* self, const LinkedList* list) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    ParticionadoRepository* repo = (ParticionadoRepository*)self;
+    GravacaoParticoes gravacao;
+    gravacao.repo = repo;
+    gravacao.list = list;
+    threadpool_executar(repo->pool, NUM_TIPOS_HARDWARE, tarefa_salvar_particao, &gravacao);
+
+    bool ok = true;
+    int gravadas = 0;
+    for (int t = 0; t < NUM_TIPOS_HARDWARE; t++) {
+        ok = ok && gravacao.ok[t];
+        if (gravacao.gravada[t]) gravadas++;
+    }
+
+    cronometro_parar(&crono);
+    if (cronometro_console_ativo()) printf("[Partições] %d de %d reescritas - ", gravadas, NUM_TIPOS_HARDWARE);
+    cronometro_definir_registros(list->size);
+    cronometro_imprimir(ok ? "Salvar dados" : "Salvar dados (falha)", &crono);
+    return ok;
+}
+
+static bool tipo_valido(TipoHardware tipo) {
+    return (int)tipo >= 0 && (int)tipo < NUM_TIPOS_HARDWARE;
+}
+
+static bool particionado_adicionar(void* self, const Hardware* hw) {
+    ParticionadoRepository* repo = (ParticionadoRepository*)self;
+    if (!tipo_valido(hw->tipo)) return false;
+    Particao* particao = &repo->particoes[hw->tipo];
+    particao->assinaturaValida = false;
+
+    // O CSV não acrescenta em arquivo inexistente; a primeira gravação da partição cria o arquivo
+    if (!arquivo_existe(particao->arquivo)) {
+        LinkedList registro;
+        linkedlist_init(&registro);
+        linkedlist_push_back(&registro, hw);
+        bool ok = particao->csv->interface->salvar(particao->csv->implementacao, &registro);
+        linkedlist_clear(&registro);
+        return ok;
+    }
+    return particao->csv->interface->adicionar(particao->csv->implementacao, hw);
+}
+
+static bool particionado_remover(void* self, int id) {
+    ParticionadoRepository* repo = (ParticionadoRepository*)self;
+    // O mapa de ids de cada partição descarta as que não têm o registro sem abrir o arquivo
+    for (int t = 0; t < NUM_TIPOS_HARDWARE; t++) {
+        Particao* particao = &repo->particoes[t];
+        if (!arquivo_existe(particao->arquivo)) continue;
+        if (particao->csv->interface->remover(particao->csv->implementacao, id)) {
+            particao->assinaturaValida = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool particionado_atualizar(void* self, const Hardware* hw) {
+    ParticionadoRepository* repo = (ParticionadoRepository*)self;
+    if (!tipo_valido(hw->tipo)) return false;
+    Particao* particao = &repo->particoes[hw->tipo];
+    if (arquivo_existe(particao->arquivo) &&
+        particao->csv->interface->atualizar(particao->csv->implementacao, hw)) {
+        particao->assinaturaValida = false;
+        return true;
+    }
+
+    // Tipo alterado: o registro sai da partição antiga e entra na nova
+    for (int t = 0; t < NUM_TIPOS_HARDWARE; t++) {
+        Particao* antiga = &repo->particoes[t];
+        if (t == (int)hw->tipo || !arquivo_existe(antiga->arquivo)) continue;
+        if (antiga->csv->interface->remover(antiga->csv->implementacao, hw->id)) {
+            antiga->assinaturaValida = false;
+            return particionado_adicionar(repo, hw);
+        }
+    }
+    return false;
+}
+
+static Hardware* particionado_buscar_por_id(void* self, int id) {
+    ParticionadoRepository* repo = (ParticionadoRepository*)self;
+    for (int t = 0; t < NUM_TIPOS_HARDWARE; t++) {
+        Particao* particao = &repo->particoes[t];
+        if (!arquivo_existe(particao->arquivo)) continue;
+        Hardware* hw = particao->csv->interface->buscar_por_id(particao->csv->implementacao, id);
+        if (hw) return hw;
+    }
+    return NULL;
+}
+
+static bool particionado_carregar_tipo(void* self, TipoHardware tipo, LinkedList* list) {
+    ParticionadoRepository* repo = (ParticionadoRepository*)self;
+    if (!tipo_valido(tipo)) return false;
+    Particao* particao = &repo->particoes[tipo];
+    // Partição sem arquivo é só um tipo sem equipamentos
+    if (!arquivo_existe(particao->arquivo)) return true;
+    return particao->csv->interface->carregar(particao->csv->implementacao, list);
+}
+
+// Cursor: um cursor CSV por partição, cada um com um lote pequeno, intercalados por id
+#define LOTE_CURSOR_PARTICAO 64
+
+typedef struct {
+    void* estado;
+    Hardware lote[LOTE_CURSOR_PARTICAO];
+    int quantidade;
+    int posicao;
+} CursorParticao;
+
+typedef struct {
+    CursorParticao particoes[NUM_TIPOS_HARDWARE];
+} CursorParticionado;
+
+static bool cursor_particao_abastecer(ParticionadoRepository* repo, int t, CursorParticao* cursor) {
+    if (cursor->estado == NULL) return false;
+    if (cursor->posicao < cursor->quantidade) return true;
+
+    Repository* csv = repo->particoes[t].csv;
+    int lidos = csv->interface->cursor_proximo(csv->implementacao, cursor->estado, cursor->lote, LOTE_CURSOR_PARTICAO);
+    cursor->quantidade = lidos > 0 ? lidos : 0;
+    cursor->posicao = 0;
+    return cursor->quantidade > 0;
+}
+
+static void particionado_cursor_fechar(void* self, void* estado) {
+    ParticionadoRepository* repo = (ParticionadoRepository*)self;
+    CursorParticionado* cursor = (CursorParticionado*)estado;
+    if (cursor == NULL) return;
+    for (int t = 0; t < NUM_TIPOS_HARDWARE; t++) {
+        Repository* csv = repo->particoes[t].csv;
+        if (cursor->particoes[t].estado) csv->interface->cursor_fechar(csv->implementacao, cursor->particoes[t].estado);
+    }
+    mem_liberar(cursor);
+}
+
+static void* particionado_cursor_abrir(void* self) {
+    ParticionadoRepository* repo = (ParticionadoRepository*)self;
+    CursorParticionado* cursor = mem_alocar_zerado(MEMORIA_TEMPORARIA, 1, sizeof(CursorParticionado));
+    if (!cursor) return NULL;
+
+    bool algumaParticao = false;
+    for (int t = 0; t < NUM_TIPOS_HARDWARE; t++) {
+        Particao* particao = &repo->particoes[t];
+        if (!arquivo_existe(particao->arquivo)) continue;
+        cursor->particoes[t].estado = particao->csv->interface->cursor_abrir(particao->csv->implementacao);
+        algumaParticao = algumaParticao || cursor->particoes[t].estado != NULL;
+    }
+    if (!algumaParticao) {
+        particionado_cursor_fechar(repo, cursor);
+        return NULL;
+    }
+    return cursor;
+}
+
+static int particionado_cursor_proximo(void* self, void* estado, Hardware* lote, int capacidade) {
+    ParticionadoRepository* repo = (ParticionadoRepository*)self;
+    CursorParticionado* cursor = (CursorParticionado*)estado;
+    int lidos = 0;
+    while (lidos < capacidade) {
+        int menor = -1;
+        for (int t = 0; t < NUM_TIPOS_HARDWARE; t++) {
+            CursorParticao* particao = &cursor->particoes[t];
+            if (!cursor_particao_abastecer(repo, t, particao)) continue;
+            if (menor < 0 ||
+                particao->lote[particao->posicao].id < cursor->particoes[menor].lote[cursor->particoes[menor].posicao].id) {
+                menor = t;
+            }
+        }
+        if (menor < 0) break;
+        CursorParticao* escolhida = &cursor->particoes[menor];
+        lote[lidos++] = escolhida->lote[escolhida->posicao++];
+    }
+    return lidos;
+}
+
+static void particionado_destruir(void* self) {
+    ParticionadoRepository* repo = (ParticionadoRepository*)self;
+    for (int t = 0; t < NUM_TIPOS_HARDWARE; t++) {
+        destruir_repositorio(repo->particoes[t].csv);
+        mem_liberar(repo->particoes[t].arquivo);
+    }
+    threadpool_destruir(repo->pool);
+    mem_liberar(repo);
+}
+
+static const RepositoryInterface particionado_interface = {
+    .carregar = particionado_carregar,
+    .salvar = particionado_salvar,
+    .adicionar = particionado_adicionar,
+    .atualizar = particionado_atualizar,
+    .remover = particionado_remover,
+    .buscar_por_id = particionado_buscar_por_id,
+    .carregar_tipo = particionado_carregar_tipo,
+    .cursor_abrir = particionado_cursor_abrir,
+    .cursor_proximo = particionado_cursor_proximo,
+    .cursor_fechar = particionado_cursor_fechar,
+    .destruir = particionado_destruir
+};
+
+Repository* criar_repositorio_particionado(const char* prefixo) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    ParticionadoRepository* impl = mem_alocar_zerado(MEMORIA_OUTROS, 1, sizeof(ParticionadoRepository));
+    Repository* repo = mem_alocar(MEMORIA_OUTROS, sizeof(Repository));
+    bool ok = impl != NULL && repo != NULL;
+    for (int t = 0; ok && t < NUM_TIPOS_HARDWARE; t++) {
+        const char* nomeTipo = tipo_to_string((TipoHardware)t);
+        size_t tamanho = strlen(prefixo) + strlen(nomeTipo) + 6;
+        impl->particoes[t].arquivo = mem_alocar(MEMORIA_OUTROS, tamanho);
+        ok = impl->particoes[t].arquivo != NULL;
+        if (ok) {
+            snprintf(impl->particoes[t].arquivo, tamanho, "%s_%s.csv", prefixo, nomeTipo);
+            impl->particoes[t].csv = criar_repositorio_csv(impl->particoes[t].arquivo);
+            ok = impl->particoes[t].csv != NULL;
+        }
+    }
+    if (!ok) {
+        if (impl) particionado_destruir(impl);
+        mem_liberar(repo);
+        cronometro_parar(&crono);
+        cronometro_imprimir("Criar repositório particionado (falha alocação)", &crono);
+        return NULL;
+    }
+
+    int nucleos = obter_numero_nucleos();
+    impl->pool = threadpool_criar(nucleos < NUM_TIPOS_HARDWARE ? nucleos : NUM_TIPOS_HARDWARE);
+
+    repo->implementacao = impl;
+    repo->interface = &particionado_interface;
+    cronometro_parar(&crono);
+    cronometro_imprimir("Criar repositório particionado", &crono);
+    return repo;
+}
+
+bool repositorio_particionado_existe(const Repository* repo) {
+    if (repo == NULL || repo->interface != &particionado_interface) return false;
+
+    const ParticionadoRepository* impl = (const ParticionadoRepository*)repo->implementacao;
+    for (int t = 0; t < NUM_TIPOS_HARDWARE; t++) {
+        if (arquivo_existe(impl->particoes[t].arquivo)) return true;
+    }
+    return false;
+}
+
+bool repositorio_particionado_importar(Repository* repo, const LinkedList* list) {
+    if (repo == NULL || repo->interface != &particionado_interface) return false;
+    return particionado_salvar(repo->implementacao, list);
+}
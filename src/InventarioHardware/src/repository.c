@@ -1,49 +1,432 @@
 #include "repository.h"
 #include "hardware.h"
 #include "linkedList.h"
+#include "trace.h"
 #include "utils.h"
+#include "memoria.h"
+#include "crc32c.h"
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+
+// Bitmap dos ids presentes no CSV, persistido em "<arquivo>.ids". Vale enquanto tamanho e data de
+// modificação do CSV forem os registrados; com ele, ids ausentes são rejeitados sem abrir o CSV.
+typedef struct {
+    unsigned char* bits;
+    int maiorId;
+    long long tamanhoCsv;
+    long long modificacaoCsv;
+    bool valido;
+} MapaIds;
+
+typedef struct {
+    char magica[8];
+    long long tamanhoCsv;
+    long long modificacaoCsv;
+    int maiorId;
+    int reservado;
+} CabecalhoIds;
+
+static const char MAGICA_IDS[8] = {'I', 'N', 'V', 'I', 'D', 'S', '1', '\0'};
+
+// Ids acima deste limite deixariam o bitmap grande demais; nesse caso o mapa fica desligado
+#define MAIOR_ID_MAPA (1 << 26)
+
+// Somas CRC32C do CSV em "<arquivo>.crc": as linhas de dados formam blocos de LINHAS_POR_BLOCO_CRC
+// linhas e cada bloco guarda deslocamento, tamanho em bytes e CRC. Como o .ids, o .crc só vale
+// enquanto tamanho e data de modificação do CSV forem os registrados: um CSV editado fora do sistema
+// é lido inteiro, sem verificação. Com o .crc válido, um bloco que não confere é relatado com a faixa
+// de linhas e pulado, e o repositório recusa gravações até uma leitura completa.
+#define LINHAS_POR_BLOCO_CRC 1024
+// Blocos maiores que isso só aparecem em .crc corrompido
+#define MAIOR_BLOCO_CRC (64u << 20)
+// Sem .crc o CSV é lido em trechos deste tamanho, cortados na última quebra de linha
+#define TRECHO_SEM_CRC (64 * 1024)
+
+typedef struct {
+    char magica[8];
+    long long tamanhoCsv;
+    long long modificacaoCsv;
+    long long totalLinhas;
+    int linhasPorBloco;
+    int numBlocos;
+} CabecalhoCrc;
+
+typedef struct {
+    long long deslocamento;
+    uint32_t tamanho;
+    uint32_t crc;
+} BlocoCrc;
+
+static const char MAGICA_CRC[8] = {'I', 'N', 'V', 'C', 'R', 'C', '2', '\0'};
+
+static const char CABECALHO_CSV[] = "ID;Nome;Fabricante;Tipo;DataCompra;Valor;VidaUtil;UltimaManutencao;Obsoleto\n";
 
 typedef struct {
     const char* filename;
+    char* arquivoIds;
+    char* arquivoCrc;
+    MapaIds ids;
+    // A última leitura pulou blocos corrompidos: gravar agora perderia esses registros
+    bool leituraParcial;
 } CsvRepository;
 
+static bool csv_metadados(const char* filename, long long* tamanho, long long* modificacao) {
+    struct stat info;
+    if (stat(filename, &info) != 0) return false;
+    *tamanho = (long long)info.st_size;
+    *modificacao = (long long)info.st_mtime;
+    return true;
+}
+
+static void ids_descartar(MapaIds* ids) {
+    mem_liberar(ids->bits);
+    ids->bits = NULL;
+    ids->maiorId = 0;
+    ids->valido = false;
+}
+
+static bool ids_gravar(const CsvRepository* repo) {
+    CabecalhoIds cabecalho;
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    memcpy(cabecalho.magica, MAGICA_IDS, sizeof(cabecalho.magica));
+    cabecalho.tamanhoCsv = repo->ids.tamanhoCsv;
+    cabecalho.modificacaoCsv = repo->ids.modificacaoCsv;
+    cabecalho.maiorId = repo->ids.maiorId;
+
+    FILE* arquivo = fopen(repo->arquivoIds, "wb");
+    if (!arquivo) return false;
+    size_t bytes = (size_t)repo->ids.maiorId / 8 + 1;
+    bool ok = fwrite(&cabecalho, sizeof(cabecalho), 1, arquivo) == 1 &&
+              fwrite(repo->ids.bits, 1, bytes, arquivo) == bytes;
+    return fclose(arquivo) == 0 && ok;
+}
+
+// Refaz o bitmap a partir da lista que acabou de ser lida ou gravada e o persiste
+static void ids_reconstruir(CsvRepository* repo, const LinkedList* list) {
+    ids_descartar(&repo->ids);
+    if (!csv_metadados(repo->filename, &repo->ids.tamanhoCsv, &repo->ids.modificacaoCsv)) return;
+
+    int maiorId = 0;
+    for (Node* current = list->head; current != NULL; current = current->next) {
+        if (current->data.id < 0 || current->data.id > MAIOR_ID_MAPA) {
+            remove(repo->arquivoIds);
+            return;
+        }
+        if (current->data.id > maiorId) maiorId = current->data.id;
+    }
+
+    repo->ids.bits = mem_alocar_zerado(MEMORIA_INDICES, (size_t)maiorId / 8 + 1, 1);
+    if (!repo->ids.bits) return;
+    for (Node* current = list->head; current != NULL; current = current->next) {
+        repo->ids.bits[current->data.id / 8] |= (unsigned char)(1u << (current->data.id % 8));
+    }
+    repo->ids.maiorId = maiorId;
+    repo->ids.valido = true;
+
+    if (!ids_gravar(repo)) remove(repo->arquivoIds);
+}
+
+static bool ids_ler(CsvRepository* repo, long long tamanhoCsv, long long modificacaoCsv) {
+    ids_descartar(&repo->ids);
+    FILE* arquivo = fopen(repo->arquivoIds, "rb");
+    if (!arquivo) return false;
+
+    CabecalhoIds cabecalho;
+    bool ok = fread(&cabecalho, sizeof(cabecalho), 1, arquivo) == 1 &&
+              memcmp(cabecalho.magica, MAGICA_IDS, sizeof(cabecalho.magica)) == 0 &&
+              cabecalho.tamanhoCsv == tamanhoCsv && cabecalho.modificacaoCsv == modificacaoCsv &&
+              cabecalho.maiorId >= 0 && cabecalho.maiorId <= MAIOR_ID_MAPA;
+    if (ok) {
+        size_t bytes = (size_t)cabecalho.maiorId / 8 + 1;
+        repo->ids.bits = mem_alocar(MEMORIA_INDICES, bytes);
+        ok = repo->ids.bits != NULL && fread(repo->ids.bits, 1, bytes, arquivo) == bytes;
+    }
+    fclose(arquivo);
+
+    if (!ok) {
+        ids_descartar(&repo->ids);
+        return false;
+    }
+    repo->ids.maiorId = cabecalho.maiorId;
+    repo->ids.tamanhoCsv = tamanhoCsv;
+    repo->ids.modificacaoCsv = modificacaoCsv;
+    repo->ids.valido = true;
+    return true;
+}
+
+// true só quando o bitmap, válido para o CSV atual, garante que o id não existe. Custa um stat do CSV;
+// se o bitmap estiver desatualizado ou ausente, devolve false e a operação segue pelo caminho normal.
+static bool csv_id_ausente(CsvRepository* repo, int id) {
+    long long tamanho, modificacao;
+    if (!csv_metadados(repo->filename, &tamanho, &modificacao)) return false;
+
+    bool atual = repo->ids.valido && repo->ids.tamanhoCsv == tamanho && repo->ids.modificacaoCsv == modificacao;
+    if (!atual && !ids_ler(repo, tamanho, modificacao)) return false;
+
+    if (id < 0 || id > repo->ids.maiorId) return true;
+    return (repo->ids.bits[id / 8] & (1u << (id % 8))) == 0;
+}
+
+// ---------- Blocos verificados por CRC32C ----------
+
+static bool crc_gravar(const CsvRepository* repo, const CabecalhoCrc* cabecalho, const BlocoCrc* blocos) {
+    FILE* arquivo = fopen(repo->arquivoCrc, "wb");
+    if (!arquivo) return false;
+    bool ok = fwrite(cabecalho, sizeof(*cabecalho), 1, arquivo) == 1 &&
+              fwrite(blocos, sizeof(BlocoCrc), (size_t)cabecalho->numBlocos, arquivo) == (size_t)cabecalho->numBlocos;
+    return fclose(arquivo) == 0 && ok;
+}
+
+// Carrega o .crc se existir, for coerente e corresponder ao CSV atual; blocos deve ser liberado com mem_liberar
+static bool crc_ler(const CsvRepository* repo, CabecalhoCrc* cabecalho, BlocoCrc** blocos) {
+    *blocos = NULL;
+    long long tamanhoCsv, modificacaoCsv;
+    if (!csv_metadados(repo->filename, &tamanhoCsv, &modificacaoCsv)) return false;
+    FILE* arquivo = fopen(repo->arquivoCrc, "rb");
+    if (!arquivo) return false;
+
+    bool ok = fread(cabecalho, sizeof(*cabecalho), 1, arquivo) == 1 &&
+              memcmp(cabecalho->magica, MAGICA_CRC, sizeof(cabecalho->magica)) == 0 &&
+              cabecalho->linhasPorBloco > 0 && cabecalho->totalLinhas >= 0 &&
+              cabecalho->numBlocos == (cabecalho->totalLinhas + cabecalho->linhasPorBloco - 1) / cabecalho->linhasPorBloco;
+    if (ok && (cabecalho->tamanhoCsv != tamanhoCsv || cabecalho->modificacaoCsv != modificacaoCsv)) {
+        fclose(arquivo);
+        fprintf(stderr, "[CSV] %s alterado fora do sistema desde a última gravação; lido sem verificação\n",
+                repo->filename);
+        return false;
+    }
+    if (ok && cabecalho->numBlocos > 0) {
+        *blocos = mem_alocar(MEMORIA_TEMPORARIA, sizeof(BlocoCrc) * (size_t)cabecalho->numBlocos);
+        ok = *blocos != NULL &&
+             fread(*blocos, sizeof(BlocoCrc), (size_t)cabecalho->numBlocos, arquivo) == (size_t)cabecalho->numBlocos;
+    }
+    fclose(arquivo);
+
+    // Blocos em sequência, sem sobreposição
+    for (int b = 0; ok && b < cabecalho->numBlocos; b++) {
+        const BlocoCrc* bloco = &(*blocos)[b];
+        ok = bloco->tamanho > 0 && bloco->tamanho <= MAIOR_BLOCO_CRC && bloco->deslocamento >= 0 &&
+             (b == 0 || bloco->deslocamento == (*blocos)[b - 1].deslocamento + (*blocos)[b - 1].tamanho);
+    }
+    if (!ok) {
+        mem_liberar(*blocos);
+        *blocos = NULL;
+        fprintf(stderr, "[CSV] %s ilegível; CSV lido sem verificação\n", repo->arquivoCrc);
+    }
+    return ok;
+}
+
+// Entrega o CSV em blocos de linhas inteiras: os blocos do .crc, já conferidos, ou trechos sem
+// verificação quando não há .crc
+typedef struct {
+    const CsvRepository* repo;
+    FILE* arquivo;
+    long long tamanhoArquivo;
+    bool verificado;
+    CabecalhoCrc cabecalho;
+    BlocoCrc* blocos;
+    int proximoBloco;
+    int blocosCorrompidos;
+    char* buffer;
+    size_t capacidade;
+    char* atual;
+    char* fim;
+} LeitorCsv;
+
+static void leitor_csv_fechar(LeitorCsv* leitor) {
+    if (leitor->arquivo) fclose(leitor->arquivo);
+    mem_liberar(leitor->blocos);
+    mem_liberar(leitor->buffer);
+    memset(leitor, 0, sizeof(*leitor));
+}
+
+// Abre o CSV e pula o cabeçalho; false se o arquivo não existe ou está vazio
+static bool leitor_csv_abrir(LeitorCsv* leitor, const CsvRepository* repo) {
+    memset(leitor, 0, sizeof(*leitor));
+    leitor->repo = repo;
+    leitor->arquivo = fopen(repo->filename, "rb");
+    if (!leitor->arquivo) return false;
+
+    char cabecalho[1024];
+    if (fgets(cabecalho, sizeof(cabecalho), leitor->arquivo) == NULL || fseek(leitor->arquivo, 0, SEEK_END) != 0) {
+        leitor_csv_fechar(leitor);
+        return false;
+    }
+    leitor->tamanhoArquivo = ftell(leitor->arquivo);
+    leitor->verificado = crc_ler(repo, &leitor->cabecalho, &leitor->blocos);
+    if (fseek(leitor->arquivo, (long)strlen(cabecalho), SEEK_SET) != 0) {
+        leitor_csv_fechar(leitor);
+        return false;
+    }
+    return true;
+}
+
+static bool leitor_csv_reservar(LeitorCsv* leitor, size_t tamanho) {
+    // Um byte a mais para terminar a última linha quando ela não tem '\n'
+    if (tamanho + 1 <= leitor->capacidade) return true;
+    char* buffer = mem_realocar(MEMORIA_TEMPORARIA, leitor->buffer, tamanho + 1);
+    if (!buffer) return false;
+    leitor->buffer = buffer;
+    leitor->capacidade = tamanho + 1;
+    return true;
+}
+
+static void leitor_csv_relatar(const LeitorCsv* leitor, int primeiro, int ultimo, const char* motivo) {
+    long long linhasPorBloco = leitor->cabecalho.linhasPorBloco;
+    long long primeiraLinha = (long long)primeiro * linhasPorBloco + 2;
+    long long ultimaLinha = (long long)(ultimo + 1) * linhasPorBloco + 1;
+    if (ultimaLinha > leitor->cabecalho.totalLinhas + 1) ultimaLinha = leitor->cabecalho.totalLinhas + 1;
+    if (primeiro == ultimo) {
+        fprintf(stderr, "[CSV] %s: bloco %d (linhas %lld-%lld) %s; registros ignorados\n",
+                leitor->repo->filename, primeiro, primeiraLinha, ultimaLinha, motivo);
+    } else {
+        fprintf(stderr, "[CSV] %s: blocos %d-%d (linhas %lld-%lld) %s; registros ignorados\n",
+                leitor->repo->filename, primeiro, ultimo, primeiraLinha, ultimaLinha, motivo);
+    }
+}
+
+static bool leitor_csv_proximo_bloco(LeitorCsv* leitor) {
+    if (!leitor->verificado) {
+        if (!leitor_csv_reservar(leitor, TRECHO_SEM_CRC)) return false;
+        size_t lidos = fread(leitor->buffer, 1, TRECHO_SEM_CRC, leitor->arquivo);
+        if (lidos == 0) return false;
+        size_t util = lidos;
+        if (lidos == TRECHO_SEM_CRC) {
+            // Devolve ao arquivo a linha incompleta do fim do trecho
+            while (util > 0 && leitor->buffer[util - 1] != '\n') util--;
+            if (util == 0) util = lidos;
+            else if (fseek(leitor->arquivo, -(long)(lidos - util), SEEK_CUR) != 0) return false;
+        }
+        leitor->atual = leitor->buffer;
+        leitor->fim = leitor->buffer + util;
+        return true;
+    }
+
+    while (leitor->proximoBloco < leitor->cabecalho.numBlocos) {
+        int b = leitor->proximoBloco++;
+        const BlocoCrc* bloco = &leitor->blocos[b];
+        if (bloco->deslocamento + bloco->tamanho > leitor->tamanhoArquivo) {
+            // Arquivo truncado: este e todos os blocos seguintes estão ausentes
+            int ultimo = leitor->cabecalho.numBlocos - 1;
+            leitor_csv_relatar(leitor, b, ultimo, b == ultimo ? "ausente (arquivo truncado)" : "ausentes (arquivo truncado)");
+            leitor->blocosCorrompidos += leitor->cabecalho.numBlocos - b;
+            leitor->proximoBloco = leitor->cabecalho.numBlocos;
+            return false;
+        }
+        if (!leitor_csv_reservar(leitor, bloco->tamanho) ||
+            fseek(leitor->arquivo, (long)bloco->deslocamento, SEEK_SET) != 0 ||
+            fread(leitor->buffer, 1, bloco->tamanho, leitor->arquivo) != bloco->tamanho) {
+            leitor_csv_relatar(leitor, b, b, "ilegível");
+            leitor->blocosCorrompidos++;
+            continue;
+        }
+        if (crc32c_atualizar(0, leitor->buffer, bloco->tamanho) != bloco->crc) {
+            leitor_csv_relatar(leitor, b, b, "corrompido (CRC32C não confere)");
+            leitor->blocosCorrompidos++;
+            continue;
+        }
+        leitor->atual = leitor->buffer;
+        leitor->fim = leitor->buffer + bloco->tamanho;
+        return true;
+    }
+
+    if (leitor->proximoBloco == leitor->cabecalho.numBlocos) {
+        leitor->proximoBloco++;
+        long long fimVerificado = leitor->cabecalho.numBlocos > 0
+            ? leitor->blocos[leitor->cabecalho.numBlocos - 1].deslocamento + leitor->blocos[leitor->cabecalho.numBlocos - 1].tamanho
+            : ftell(leitor->arquivo);
+        if (leitor->tamanhoArquivo > fimVerificado && leitor->cabecalho.numBlocos > 0) {
+            fprintf(stderr, "[CSV] %s: %lld bytes após o último bloco sem soma CRC32C; ignorados\n",
+                    leitor->repo->filename, leitor->tamanhoArquivo - fimVerificado);
+            leitor->blocosCorrompidos++;
+        }
+    }
+    return false;
+}
+
+// Próxima linha não vazia, terminada em '\0' dentro do buffer do leitor; NULL no fim
+static char* leitor_csv_linha(LeitorCsv* leitor) {
+    while (true) {
+        if (leitor->atual >= leitor->fim && !leitor_csv_proximo_bloco(leitor)) return NULL;
+        char* linha = leitor->atual;
+        char* quebra = memchr(linha, '\n', (size_t)(leitor->fim - linha));
+        if (quebra == NULL) quebra = leitor->fim;
+        *quebra = '\0';
+        leitor->atual = quebra + 1;
+        if (quebra > linha && quebra[-1] == '\r') quebra[-1] = '\0';
+        if (linha[0] != '\0') return linha;
+    }
+}
+
 static bool csv_carregar(void* self, LinkedList* list) {
     Cronometro crono;
     cronometro_iniciar(&crono);
     
     CsvRepository* repo = (CsvRepository*)self;
-    FILE* arquivo = fopen(repo->filename, "r");
-    if (!arquivo) {
-        cronometro_imprimir("CSV - Carregar dados (falha)", cronometro_parar(&crono));
+    FILE* existe = fopen(repo->filename, "rb");
+    if (!existe) {
+        cronometro_parar(&crono);
+        cronometro_imprimir("CSV - Carregar dados (falha)", &crono);
         return false;
     }
+    fclose(existe);
 
-    char linha[1024];
-    if (fgets(linha, sizeof(linha), arquivo) == NULL) {
-        fclose(arquivo);
-        cronometro_imprimir("CSV - Carregar dados (vazio)", cronometro_parar(&crono));
+    LeitorCsv leitor;
+    if (!leitor_csv_abrir(&leitor, repo)) {
+        cronometro_parar(&crono);
+        cronometro_imprimir("CSV - Carregar dados (vazio)", &crono);
         return false;
     }
 
     int contador = 0;
-    while (fgets(linha, sizeof(linha), arquivo) != NULL) {
-        linha[strcspn(linha, "\n")] = '\0';
-        if (linha[0] == '\0') continue;
-        
+    int invalidas = 0;
+    trace_inicio("CSV: leitura e parsing");
+    char* linha;
+    while ((linha = leitor_csv_linha(&leitor)) != NULL) {
         Hardware hw;
         if (hardware_from_csv(linha, &hw)) {
             linkedlist_push_back(list, &hw);
             contador++;
+        } else {
+            invalidas++;
         }
     }
-    fclose(arquivo);
+    trace_fim("CSV: leitura e parsing");
+    int blocosCorrompidos = leitor.blocosCorrompidos;
+    leitor_csv_fechar(&leitor);
+
+    if (invalidas > 0) {
+        fprintf(stderr, "[CSV] %s: %d linhas com formato inválido ignoradas\n", repo->filename, invalidas);
+    }
+    repo->leituraParcial = blocosCorrompidos > 0;
+    if (blocosCorrompidos > 0) {
+        size_t tamanhoNome = strlen(repo->filename) + 12;
+        char* copia = mem_alocar(MEMORIA_TEMPORARIA, tamanhoNome);
+        if (copia) {
+            snprintf(copia, tamanhoNome, "%s.corrompido", repo->filename);
+            if (copiar_arquivo(repo->filename, copia)) {
+                fprintf(stderr, "[CSV] Cópia do arquivo original preservada em %s\n", copia);
+            }
+            mem_liberar(copia);
+        }
+        fprintf(stderr, "[CSV] Gravações em %s recusadas até uma leitura completa; restaure o arquivo "
+                "ou apague %s para lê-lo sem verificação\n", repo->filename, repo->arquivoCrc);
+    }
+
+    long long tamanho, modificacao;
+    if (csv_metadados(repo->filename, &tamanho, &modificacao) &&
+        !(repo->ids.valido && repo->ids.tamanhoCsv == tamanho && repo->ids.modificacaoCsv == modificacao) &&
+        !ids_ler(repo, tamanho, modificacao)) {
+        ids_reconstruir(repo, list);
+    }
     
-    double tempo = cronometro_parar(&crono);
-    printf("[CSV] Carregados %d itens - ", contador);
-    cronometro_imprimir("Carregar dados", tempo);
+    cronometro_parar(&crono);
+    if (cronometro_console_ativo()) printf("[CSV] Carregados %d itens - ", contador);
+    cronometro_definir_registros(contador);
+    cronometro_imprimir("Carregar dados", &crono);
     return true;
 }
 
@@ -52,31 +435,97 @@ static bool csv_salvar(void* self, const LinkedList* list) {
     cronometro_iniciar(&crono);
     
     CsvRepository* repo = (CsvRepository*)self;
-    FILE* arquivo = fopen(repo->filename, "w");
+    if (repo->leituraParcial) {
+        fprintf(stderr, "[CSV] %s: a última leitura ignorou blocos corrompidos; gravação recusada para não "
+                "perder esses registros\n", repo->filename);
+        cronometro_parar(&crono);
+        cronometro_imprimir("CSV - Salvar dados (leitura parcial)", &crono);
+        return false;
+    }
+
+    // Grava num arquivo temporário e renomeia, para nunca deixar o inventário pela metade.
+    // Binário: os deslocamentos e CRCs do .crc valem para os bytes exatamente como estão no disco
+    size_t tamanhoNome = strlen(repo->filename) + 5;
+    char* arquivoTemporario = mem_alocar(MEMORIA_TEMPORARIA, tamanhoNome);
+    FILE* arquivo = NULL;
+    if (arquivoTemporario) {
+        snprintf(arquivoTemporario, tamanhoNome, "%s.tmp", repo->filename);
+        arquivo = fopen(arquivoTemporario, "wb");
+    }
     if (!arquivo) {
-        cronometro_imprimir("CSV - Salvar dados (falha)", cronometro_parar(&crono));
+        mem_liberar(arquivoTemporario);
+        cronometro_parar(&crono);
+        cronometro_imprimir("CSV - Salvar dados (falha)", &crono);
         return false;
     }
 
-    fprintf(arquivo, "ID;Nome;Fabricante;Tipo;DataCompra;Valor;VidaUtil;UltimaManutencao;Obsoleto\n");
+    fputs(CABECALHO_CSV, arquivo);
+
+    CabecalhoCrc cabecalhoCrc;
+    memset(&cabecalhoCrc, 0, sizeof(cabecalhoCrc));
+    memcpy(cabecalhoCrc.magica, MAGICA_CRC, sizeof(cabecalhoCrc.magica));
+    cabecalhoCrc.linhasPorBloco = LINHAS_POR_BLOCO_CRC;
+    BlocoCrc* blocos = mem_alocar(MEMORIA_TEMPORARIA, sizeof(BlocoCrc) * ((size_t)list->size / LINHAS_POR_BLOCO_CRC + 1));
+    long long deslocamento = (long long)strlen(CABECALHO_CSV);
 
     int contador = 0;
+    trace_inicio("CSV: formatação e escrita");
     Node* current = list->head;
     while (current != NULL) {
         char* csv = hardware_to_csv(&current->data);
         if (csv) {
             fprintf(arquivo, "%s\n", csv);
-            free(csv);
+            if (blocos) {
+                BlocoCrc* bloco = &blocos[contador / LINHAS_POR_BLOCO_CRC];
+                if (contador % LINHAS_POR_BLOCO_CRC == 0) {
+                    bloco->deslocamento = deslocamento;
+                    bloco->tamanho = 0;
+                    bloco->crc = 0;
+                }
+                size_t tamanho = strlen(csv);
+                bloco->crc = crc32c_atualizar(crc32c_atualizar(bloco->crc, csv, tamanho), "\n", 1);
+                bloco->tamanho += (uint32_t)tamanho + 1;
+                deslocamento += (long long)tamanho + 1;
+            }
+            mem_liberar(csv);
             contador++;
         }
         current = current->next;
     }
-    fclose(arquivo);
+    trace_fim("CSV: formatação e escrita");
+    bool gravado = !ferror(arquivo);
+    if (fclose(arquivo) != 0) gravado = false;
+    if (gravado && rename(arquivoTemporario, repo->filename) != 0) {
+        // No Windows rename não substitui um arquivo existente
+        remove(repo->filename);
+        gravado = rename(arquivoTemporario, repo->filename) == 0;
+    }
+    if (!gravado) {
+        remove(arquivoTemporario);
+        fprintf(stderr, "[CSV] Falha ao gravar %s\n", repo->filename);
+    }
+    mem_liberar(arquivoTemporario);
+
+    // Sem gravação, o CSV e o .crc anteriores continuam valendo juntos. Com ela, o .crc registra
+    // tamanho e data do CSV como ficaram no disco, depois de renomeado
+    if (gravado) {
+        cabecalhoCrc.totalLinhas = contador;
+        cabecalhoCrc.numBlocos = (contador + LINHAS_POR_BLOCO_CRC - 1) / LINHAS_POR_BLOCO_CRC;
+        if (!blocos ||
+            !csv_metadados(repo->filename, &cabecalhoCrc.tamanhoCsv, &cabecalhoCrc.modificacaoCsv) ||
+            cabecalhoCrc.tamanhoCsv != deslocamento ||
+            !crc_gravar(repo, &cabecalhoCrc, blocos)) {
+            remove(repo->arquivoCrc);
+        }
+        ids_reconstruir(repo, list);
+    }
+    mem_liberar(blocos);
     
-    double tempo = cronometro_parar(&crono);
-    printf("[CSV] Salvos %d itens - ", contador);
-    cronometro_imprimir("Salvar dados", tempo);
-    return true;
+    cronometro_parar(&crono);
+    if (cronometro_console_ativo()) printf("[CSV] Salvos %d itens - ", gravado ? contador : 0);
+    cronometro_definir_registros(contador);
+    cronometro_imprimir(gravado ? "Salvar dados" : "Salvar dados (falha)", &crono);
+    return gravado;
 }
 
 static bool csv_adicionar(void* self, const Hardware* hw) {
@@ -89,7 +538,8 @@ static bool csv_adicionar(void* self, const Hardware* hw) {
     
     if (!csv_carregar(repo, &temp)) {
         linkedlist_clear(&temp);
-        cronometro_imprimir("CSV - Adicionar (falha ao carregar)", cronometro_parar(&crono));
+        cronometro_parar(&crono);
+        cronometro_imprimir("CSV - Adicionar (falha ao carregar)", &crono);
         return false;
     }
     
@@ -97,8 +547,8 @@ static bool csv_adicionar(void* self, const Hardware* hw) {
     bool resultado = csv_salvar(repo, &temp);
     linkedlist_clear(&temp);
     
-    double tempo = cronometro_parar(&crono);
-    cronometro_imprimir("Adicionar hardware", tempo);
+    cronometro_parar(&crono);
+    cronometro_imprimir("Adicionar hardware", &crono);
     return resultado;
 }
 
@@ -107,12 +557,18 @@ static bool csv_atualizar(void* self, const Hardware* hw) {
     cronometro_iniciar(&crono);
     
     CsvRepository* repo = (CsvRepository*)self;
+    if (csv_id_ausente(repo, hw->id)) {
+        cronometro_parar(&crono);
+        cronometro_imprimir("CSV - Atualizar (id ausente no mapa)", &crono);
+        return false;
+    }
     LinkedList temp;
     linkedlist_init(&temp);
     
     if (!csv_carregar(repo, &temp)) {
         linkedlist_clear(&temp);
-        cronometro_imprimir("CSV - Atualizar (falha ao carregar)", cronometro_parar(&crono));
+        cronometro_parar(&crono);
+        cronometro_imprimir("CSV - Atualizar (falha ao carregar)", &crono);
         return false;
     }
     
@@ -123,15 +579,16 @@ static bool csv_atualizar(void* self, const Hardware* hw) {
             bool resultado = csv_salvar(repo, &temp);
             linkedlist_clear(&temp);
             
-            double tempo = cronometro_parar(&crono);
-            cronometro_imprimir("Atualizar hardware", tempo);
+            cronometro_parar(&crono);
+            cronometro_imprimir("Atualizar hardware", &crono);
             return resultado;
         }
         current = current->next;
     }
     
     linkedlist_clear(&temp);
-    cronometro_imprimir("CSV - Atualizar (não encontrado)", cronometro_parar(&crono));
+    cronometro_parar(&crono);
+    cronometro_imprimir("CSV - Atualizar (não encontrado)", &crono);
     return false;
 }
 
@@ -140,12 +597,18 @@ static bool csv_remover(void* self, int id) {
     cronometro_iniciar(&crono);
     
     CsvRepository* repo = (CsvRepository*)self;
+    if (csv_id_ausente(repo, id)) {
+        cronometro_parar(&crono);
+        cronometro_imprimir("CSV - Remover (id ausente no mapa)", &crono);
+        return false;
+    }
     LinkedList temp;
     linkedlist_init(&temp);
     
     if (!csv_carregar(repo, &temp)) {
         linkedlist_clear(&temp);
-        cronometro_imprimir("CSV - Remover (falha ao carregar)", cronometro_parar(&crono));
+        cronometro_parar(&crono);
+        cronometro_imprimir("CSV - Remover (falha ao carregar)", &crono);
         return false;
     }
     
@@ -163,11 +626,11 @@ static bool csv_remover(void* self, int id) {
             }
             
             bool resultado = csv_salvar(repo, &temp);
-            free(current);
+            mem_liberar(current);
             linkedlist_clear(&temp);
             
-            double tempo = cronometro_parar(&crono);
-            cronometro_imprimir("Remover hardware", tempo);
+            cronometro_parar(&crono);
+            cronometro_imprimir("Remover hardware", &crono);
             return resultado;
         }
         prev = current;
@@ -175,7 +638,8 @@ static bool csv_remover(void* self, int id) {
     }
     
     linkedlist_clear(&temp);
-    cronometro_imprimir("CSV - Remover (não encontrado)", cronometro_parar(&crono));
+    cronometro_parar(&crono);
+    cronometro_imprimir("CSV - Remover (não encontrado)", &crono);
     return false;
 }
 
@@ -184,12 +648,18 @@ static Hardware* csv_buscar_por_id(void* self, int id) {
     cronometro_iniciar(&crono);
     
     CsvRepository* repo = (CsvRepository*)self;
+    if (csv_id_ausente(repo, id)) {
+        cronometro_parar(&crono);
+        cronometro_imprimir("CSV - Buscar (id ausente no mapa)", &crono);
+        return NULL;
+    }
     LinkedList temp;
     linkedlist_init(&temp);
     
     if (!csv_carregar(repo, &temp)) {
         linkedlist_clear(&temp);
-        cronometro_imprimir("CSV - Buscar (falha ao carregar)", cronometro_parar(&crono));
+        cronometro_parar(&crono);
+        cronometro_imprimir("CSV - Buscar (falha ao carregar)", &crono);
         return NULL;
     }
     
@@ -202,25 +672,63 @@ static Hardware* csv_buscar_por_id(void* self, int id) {
             }
             linkedlist_clear(&temp);
             
-            double tempo = cronometro_parar(&crono);
-            cronometro_imprimir("Buscar hardware", tempo);
+            cronometro_parar(&crono);
+            cronometro_imprimir("Buscar hardware", &crono);
             return copia;
         }
         current = current->next;
     }
     
     linkedlist_clear(&temp);
-    cronometro_imprimir("CSV - Buscar (não encontrado)", cronometro_parar(&crono));
+    cronometro_parar(&crono);
+    cronometro_imprimir("CSV - Buscar (não encontrado)", &crono);
     return NULL;
 }
 
+// Cursor do CSV: mantém o arquivo aberto e só o bloco atual em memória
+static void* csv_cursor_abrir(void* self) {
+    CsvRepository* repo = (CsvRepository*)self;
+    LeitorCsv* cursor = mem_alocar(MEMORIA_TEMPORARIA, sizeof(LeitorCsv));
+    if (!cursor) return NULL;
+
+    if (!leitor_csv_abrir(cursor, repo)) {
+        mem_liberar(cursor);
+        return NULL;
+    }
+    return cursor;
+}
+
+static int csv_cursor_proximo(void* self, void* estado, Hardware* lote, int capacidade) {
+    (void)self;
+    LeitorCsv* cursor = (LeitorCsv*)estado;
+    int lidos = 0;
+    char* linha;
+    while (lidos < capacidade && (linha = leitor_csv_linha(cursor)) != NULL) {
+        if (hardware_from_csv(linha, &lote[lidos])) lidos++;
+    }
+    return (lidos == 0 && ferror(cursor->arquivo)) ? -1 : lidos;
+}
+
+static void csv_cursor_fechar(void* self, void* estado) {
+    LeitorCsv* cursor = (LeitorCsv*)estado;
+    if (cursor == NULL) return;
+    if (cursor->blocosCorrompidos > 0) ((CsvRepository*)self)->leituraParcial = true;
+    leitor_csv_fechar(cursor);
+    mem_liberar(cursor);
+}
+
 static void csv_destruir(void* self) {
     Cronometro crono;
     cronometro_iniciar(&crono);
     
-    free(self);
+    CsvRepository* repo = (CsvRepository*)self;
+    ids_descartar(&repo->ids);
+    mem_liberar(repo->arquivoIds);
+    mem_liberar(repo->arquivoCrc);
+    mem_liberar(repo);
     
-    cronometro_imprimir("Destruir repositório", cronometro_parar(&crono));
+    cronometro_parar(&crono);
+    cronometro_imprimir("Destruir repositório", &crono);
 }
 
 static const RepositoryInterface csv_interface = {
@@ -230,6 +738,9 @@ static const RepositoryInterface csv_interface = {
     .atualizar = csv_atualizar,
     .remover = csv_remover,
     .buscar_por_id = csv_buscar_por_id,
+    .cursor_abrir = csv_cursor_abrir,
+    .cursor_proximo = csv_cursor_proximo,
+    .cursor_fechar = csv_cursor_fechar,
     .destruir = csv_destruir
 };
 
@@ -237,25 +748,40 @@ Repository* criar_repositorio_csv(const char* filename) {
     Cronometro crono;
     cronometro_iniciar(&crono);
     
-    CsvRepository* impl = malloc(sizeof(CsvRepository));
-    if (!impl) {
-        cronometro_imprimir("Criar repositório (falha alocação)", cronometro_parar(&crono));
+    CsvRepository* impl = mem_alocar_zerado(MEMORIA_OUTROS, 1, sizeof(CsvRepository));
+    size_t tamanhoNomeIds = strlen(filename) + 5;
+    char* arquivoIds = mem_alocar(MEMORIA_OUTROS, tamanhoNomeIds);
+    char* arquivoCrc = mem_alocar(MEMORIA_OUTROS, tamanhoNomeIds);
+    if (!impl || !arquivoIds || !arquivoCrc) {
+        mem_liberar(impl);
+        mem_liberar(arquivoIds);
+        mem_liberar(arquivoCrc);
+        cronometro_parar(&crono);
+        cronometro_imprimir("Criar repositório (falha alocação)", &crono);
         return NULL;
     }
     
     impl->filename = filename;
+    snprintf(arquivoIds, tamanhoNomeIds, "%s.ids", filename);
+    impl->arquivoIds = arquivoIds;
+    snprintf(arquivoCrc, tamanhoNomeIds, "%s.crc", filename);
+    impl->arquivoCrc = arquivoCrc;
     
-    Repository* repo = malloc(sizeof(Repository));
+    Repository* repo = mem_alocar(MEMORIA_OUTROS, sizeof(Repository));
     if (!repo) {
-        free(impl);
-        cronometro_imprimir("Criar repositório (falha alocação)", cronometro_parar(&crono));
+        mem_liberar(arquivoIds);
+        mem_liberar(arquivoCrc);
+        mem_liberar(impl);
+        cronometro_parar(&crono);
+        cronometro_imprimir("Criar repositório (falha alocação)", &crono);
         return NULL;
     }
     
     repo->implementacao = impl;
     repo->interface = &csv_interface;
     
-    cronometro_imprimir("Criar repositório", cronometro_parar(&crono));
+    cronometro_parar(&crono);
+    cronometro_imprimir("Criar repositório", &crono);
     return repo;
 }
 
@@ -264,6 +790,46 @@ void destruir_repositorio(Repository* repo) {
         if (repo->interface && repo->interface->destruir) {
             repo->interface->destruir(repo->implementacao);
         }
-        free(repo);
+        mem_liberar(repo);
+    }
+}
+
+bool repositorio_carregar_tipo(Repository* repo, TipoHardware tipo, LinkedList* list) {
+    if (repo == NULL || repo->interface == NULL) return false;
+    if (repo->interface->carregar_tipo) {
+        return repo->interface->carregar_tipo(repo->implementacao, tipo, list);
+    }
+    if (repo->interface->carregar == NULL) return false;
+
+    LinkedList todos;
+    linkedlist_init(&todos);
+    bool ok = repo->interface->carregar(repo->implementacao, &todos);
+    for (Node* current = todos.head; ok && current != NULL; current = current->next) {
+        if (current->data.tipo == tipo) linkedlist_push_back(list, &current->data);
     }
-}
\ No newline at end of file
+    linkedlist_clear(&todos);
+    return ok;
+}
+
+bool repositorio_cursor_abrir(Repository* repo, CursorRepositorio* cursor) {
+    cursor->repositorio = repo;
+    cursor->estado = NULL;
+    if (repo == NULL || repo->interface == NULL || repo->interface->cursor_abrir == NULL) return false;
+
+    cursor->estado = repo->interface->cursor_abrir(repo->implementacao);
+    return cursor->estado != NULL;
+}
+
+int repositorio_cursor_proximo(CursorRepositorio* cursor, Hardware* lote, int capacidade) {
+    if (cursor->estado == NULL || capacidade <= 0) return 0;
+    Repository* repo = cursor->repositorio;
+    return repo->interface->cursor_proximo(repo->implementacao, cursor->estado, lote, capacidade);
+}
+
+void repositorio_cursor_fechar(CursorRepositorio* cursor) {
+    if (cursor->estado != NULL) {
+        Repository* repo = cursor->repositorio;
+        repo->interface->cursor_fechar(repo->implementacao, cursor->estado);
+    }
+    cursor->estado = NULL;
+}
@@ -0,0 +1,254 @@
+#include "segmentoInventario.h"
+#include "memoria.h"
+#include "trace.h"
+#include <stdio.h>
+#include <string.h>
+
+uint32_t segmento_espalhar(int id, int32_t capacidadeTabela) {
+    uint32_t h = (uint32_t)id * 2654435761u;
+    h ^= h >> 16;
+    return h & (uint32_t)(capacidadeTabela - 1);
+}
+
+#ifndef _WIN32
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CAPACIDADE_MINIMA 1024
+
+struct SegmentoInventario {
+    char nome[256];
+    int descritor;
+    unsigned char* base;
+    size_t mapeado;
+};
+
+static CabecalhoSegmento* segmento_cabecalho(SegmentoInventario* segmento) {
+    return (CabecalhoSegmento*)segmento->base;
+}
+
+static int32_t* segmento_tabela(SegmentoInventario* segmento) {
+    return (int32_t*)(segmento->base + segmento_cabecalho(segmento)->deslocamentoTabela);
+}
+
+static RegistroSegmento* segmento_registros(SegmentoInventario* segmento) {
+    return (RegistroSegmento*)(segmento->base + segmento_cabecalho(segmento)->deslocamentoRegistros);
+}
+
+static uint64_t alinhar_64(uint64_t valor) {
+    return (valor + 63) & ~(uint64_t)63;
+}
+
+// Seqlock: a sequência ímpar fica visível antes de qualquer escrita nos dados, e a par seguinte só
+// depois de todas elas
+static void escrita_iniciar(CabecalhoSegmento* cabecalho) {
+    uint64_t sequencia = atomic_load_explicit(&cabecalho->sequencia, memory_order_relaxed);
+    atomic_store_explicit(&cabecalho->sequencia, sequencia + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+static void escrita_concluir(CabecalhoSegmento* cabecalho) {
+    uint64_t sequencia = atomic_load_explicit(&cabecalho->sequencia, memory_order_relaxed);
+    atomic_store_explicit(&cabecalho->sequencia, sequencia + 1, memory_order_release);
+}
+
+static void registro_de_hardware(RegistroSegmento* destino, const Hardware* hw) {
+    memset(destino, 0, sizeof(*destino));
+    destino->id = hw->id;
+    destino->tipo = (int32_t)hw->tipo;
+    destino->dataCompra = hw->dataCompra;
+    destino->ultimaManutencao = hw->ultimaManutencao;
+    destino->vidaUtilAnos = hw->vidaUtilAnos;
+    destino->obsoleto = hw->obsoleto ? 1 : 0;
+    destino->valorCompra = hw->valorCompra;
+    memcpy(destino->nome, hw->nome, sizeof(destino->nome) - 1);
+    memcpy(destino->fabricante, hw->fabricante, sizeof(destino->fabricante) - 1);
+}
+
+// A tabela fica com no máximo metade das posições ocupadas, então a sondagem sempre termina
+static void tabela_inserir(SegmentoInventario* segmento, int id, int posicao) {
+    CabecalhoSegmento* cabecalho = segmento_cabecalho(segmento);
+    int32_t* tabela = segmento_tabela(segmento);
+    const RegistroSegmento* registros = segmento_registros(segmento);
+    uint32_t mascara = (uint32_t)cabecalho->capacidadeTabela - 1;
+    for (uint32_t i = segmento_espalhar(id, cabecalho->capacidadeTabela); ; i = (i + 1) & mascara) {
+        if (tabela[i] == 0 || registros[tabela[i] - 1].id == id) {
+            tabela[i] = posicao + 1;
+            return;
+        }
+    }
+}
+
+// Aumenta o arquivo e remapeia, mantendo os registros; chamado dentro de uma escrita
+static bool segmento_crescer(SegmentoInventario* segmento, int capacidade) {
+    int32_t capacidadeTabela = 64;
+    while (capacidadeTabela < capacidade * 2) capacidadeTabela *= 2;
+    uint64_t deslocamentoTabela = alinhar_64(sizeof(CabecalhoSegmento));
+    uint64_t deslocamentoRegistros = alinhar_64(deslocamentoTabela + (uint64_t)capacidadeTabela * sizeof(int32_t));
+    uint64_t tamanho = deslocamentoRegistros + (uint64_t)capacidade * sizeof(RegistroSegmento);
+
+    if (ftruncate(segmento->descritor, (off_t)tamanho) != 0) return false;
+    unsigned char* base = mmap(NULL, tamanho, PROT_READ | PROT_WRITE, MAP_SHARED, segmento->descritor, 0);
+    if (base == MAP_FAILED) return false;
+    if (segmento->base) munmap(segmento->base, segmento->mapeado);
+    segmento->base = base;
+    segmento->mapeado = tamanho;
+
+    // A tabela só cresce, então os registros andam para a frente no mesmo arquivo
+    CabecalhoSegmento* cabecalho = segmento_cabecalho(segmento);
+    int numRegistros = cabecalho->numRegistros;
+    if (numRegistros > 0) {
+        memmove(base + deslocamentoRegistros, base + cabecalho->deslocamentoRegistros,
+                (size_t)numRegistros * sizeof(RegistroSegmento));
+    }
+    cabecalho->tamanho = tamanho;
+    cabecalho->deslocamentoTabela = deslocamentoTabela;
+    cabecalho->deslocamentoRegistros = deslocamentoRegistros;
+    cabecalho->capacidadeTabela = capacidadeTabela;
+    cabecalho->capacidade = capacidade;
+
+    memset(segmento_tabela(segmento), 0, (size_t)capacidadeTabela * sizeof(int32_t));
+    const RegistroSegmento* registros = segmento_registros(segmento);
+    for (int i = 0; i < numRegistros; i++) {
+        tabela_inserir(segmento, registros[i].id, i);
+    }
+    return true;
+}
+
+SegmentoInventario* segmento_criar(const char* nome, int capacidadeInicial) {
+    if (nome == NULL || strlen(nome) >= sizeof(((SegmentoInventario*)0)->nome)) return NULL;
+
+    SegmentoInventario* segmento = mem_alocar_zerado(MEMORIA_OUTROS, 1, sizeof(SegmentoInventario));
+    if (!segmento) return NULL;
+    strcpy(segmento->nome, nome);
+
+    // Um segmento que sobrou de uma execução anterior é recriado do zero
+    shm_unlink(nome);
+    segmento->descritor = shm_open(nome, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (segmento->descritor < 0) {
+        perror(nome);
+        mem_liberar(segmento);
+        return NULL;
+    }
+
+    // O arquivo novo vem zerado: nenhum registro e sequência par
+    if (!segmento_crescer(segmento, capacidadeInicial > CAPACIDADE_MINIMA ? capacidadeInicial : CAPACIDADE_MINIMA)) {
+        perror(nome);
+        if (segmento->base) munmap(segmento->base, segmento->mapeado);
+        close(segmento->descritor);
+        shm_unlink(nome);
+        mem_liberar(segmento);
+        return NULL;
+    }
+
+    CabecalhoSegmento* cabecalho = segmento_cabecalho(segmento);
+    cabecalho->magico = SEGMENTO_MAGICO;
+    cabecalho->versaoFormato = SEGMENTO_VERSAO_FORMATO;
+    cabecalho->ativo = 1;
+    atomic_thread_fence(memory_order_release);
+    return segmento;
+}
+
+void segmento_destruir(SegmentoInventario* segmento) {
+    if (segmento == NULL) return;
+
+    CabecalhoSegmento* cabecalho = segmento_cabecalho(segmento);
+    escrita_iniciar(cabecalho);
+    cabecalho->ativo = 0;
+    escrita_concluir(cabecalho);
+
+    munmap(segmento->base, segmento->mapeado);
+    close(segmento->descritor);
+    shm_unlink(segmento->nome);
+    mem_liberar(segmento);
+}
+
+bool segmento_sincronizar(SegmentoInventario* segmento, const VersaoInventario* versao) {
+    if (segmento == NULL || versao == NULL) return false;
+    trace_inicio("Segmento: sincronizar");
+
+    CabecalhoSegmento* cabecalho = segmento_cabecalho(segmento);
+    escrita_iniciar(cabecalho);
+    bool ok = true;
+    if (versao->numRegistros > cabecalho->capacidade) {
+        int capacidade = cabecalho->capacidade * 2;
+        if (capacidade < versao->numRegistros) capacidade = versao->numRegistros;
+        ok = segmento_crescer(segmento, capacidade);
+        cabecalho = segmento_cabecalho(segmento);
+    }
+    if (ok) {
+        memset(segmento_tabela(segmento), 0, (size_t)cabecalho->capacidadeTabela * sizeof(int32_t));
+        RegistroSegmento* registros = segmento_registros(segmento);
+        for (int i = 0; i < versao->numRegistros; i++) {
+            const Hardware* hw = versao_registro(versao, i);
+            registro_de_hardware(&registros[i], hw);
+            tabela_inserir(segmento, hw->id, i);
+        }
+        cabecalho->numRegistros = versao->numRegistros;
+    }
+    escrita_concluir(cabecalho);
+
+    trace_fim("Segmento: sincronizar");
+    return ok;
+}
+
+bool segmento_gravar_registro(SegmentoInventario* segmento, int posicao, const Hardware* hw) {
+    if (segmento == NULL || hw == NULL) return false;
+
+    CabecalhoSegmento* cabecalho = segmento_cabecalho(segmento);
+    if (posicao < 0 || posicao > cabecalho->numRegistros) return false;
+
+    escrita_iniciar(cabecalho);
+    bool ok = true;
+    if (posicao == cabecalho->capacidade) {
+        ok = segmento_crescer(segmento, cabecalho->capacidade * 2);
+        cabecalho = segmento_cabecalho(segmento);
+    }
+    if (ok) {
+        registro_de_hardware(&segmento_registros(segmento)[posicao], hw);
+        if (posicao == cabecalho->numRegistros) cabecalho->numRegistros++;
+        tabela_inserir(segmento, hw->id, posicao);
+    }
+    escrita_concluir(cabecalho);
+    return ok;
+}
+
+size_t segmento_tamanho(const SegmentoInventario* segmento) {
+    return segmento ? segmento->mapeado : 0;
+}
+
+#else
+
+SegmentoInventario* segmento_criar(const char* nome, int capacidadeInicial) {
+    (void)nome;
+    (void)capacidadeInicial;
+    fprintf(stderr, "O segmento compartilhado está disponível apenas em sistemas POSIX.\n");
+    return NULL;
+}
+
+void segmento_destruir(SegmentoInventario* segmento) {
+    (void)segmento;
+}
+
+bool segmento_sincronizar(SegmentoInventario* segmento, const VersaoInventario* versao) {
+    (void)segmento;
+    (void)versao;
+    return false;
+}
+
+bool segmento_gravar_registro(SegmentoInventario* segmento, int posicao, const Hardware* hw) {
+    (void)segmento;
+    (void)posicao;
+    (void)hw;
+    return false;
+}
+
+size_t segmento_tamanho(const SegmentoInventario* segmento) {
+    (void)segmento;
+    return 0;
+}
+
+#endif
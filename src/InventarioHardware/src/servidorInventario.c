@@ -0,0 +1,546 @@
+#include "servidorInventario.h"
+#include "pedidoInventario.h"
+#include "memoria.h"
+#include "trace.h"
+#include "utils.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define MAX_EVENTOS 64
+#define TRECHO_LEITURA (64 * 1024)
+// Entrada ainda não atendida por conexão; um cliente que manda mais que isso sem ler as respostas
+// é desconectado em vez de fazer o servidor guardar tudo
+#define ENTRADA_MAXIMA_CONEXAO (1024 * 1024)
+
+typedef struct {
+    int fd;
+    int posicao;                // índice em Servidor.conexoes; -1 depois de fechada
+    TextoBuffer entrada;
+    size_t consumido;           // bytes de entrada já transformados em pedidos
+    TextoBuffer saida;
+    size_t enviado;
+    bool aguardandoEscrita;     // EPOLLOUT registrado
+    bool encerrando;            // cliente fechou o envio; fecha depois de mandar as respostas
+    bool emAtendimento;         // tem um lote no pool; fechada nesse meio tempo, é liberada na conclusão
+} ConexaoCliente;
+
+struct Servidor;
+
+// Lote de pedidos de uma conexão executado num worker do pool. Os quadros são copiados da entrada,
+// que o laço continua enchendo, e as respostas só passam para a conexão na conclusão.
+typedef struct {
+    struct Servidor* servidor;
+    ConexaoCliente* conexao;
+    TextoBuffer pedidos;
+    TextoBuffer respostas;
+    long long numPedidos;
+    bool falhou;
+} LoteAtendimento;
+
+typedef struct Servidor {
+    SistemaInventario* sistema;
+    int epoll;
+    int aviso;                  // eventfd: o worker avisa o laço que o lote terminou
+    // stdout e stderr são redirecionados para estes arquivos enquanto um pedido executa
+    FILE* capturaSaida;
+    FILE* capturaErros;
+    int saidaOriginal;
+    int errosOriginal;          // também recebe os erros do laço, que roda durante a captura
+    ConexaoCliente** conexoes;
+    int numConexoes;
+    int capacidadeConexoes;
+    long long pedidos;
+    long long totalConexoes;
+    long long desconectadosPorExcesso;
+    // Um lote por vez: a captura de stdout e stderr vale para o processo inteiro
+    LoteAtendimento lote;
+    bool loteEmAndamento;
+    bool encerrando;            // não despacha lotes novos
+    int proximaConexao;         // onde começa a busca pelo próximo lote, para revezar as conexões
+} Servidor;
+
+// Marcadores de epoll para os descritores que não são conexões
+static int marcadorEscuta;
+static int marcadorSinal;
+static int marcadorAviso;
+
+// perror no stderr original: o laço e o worker rodam ao mesmo tempo, e o stderr do processo pode
+// estar redirecionado para a resposta de um pedido
+static void servidor_erro(const Servidor* servidor, const char* contexto) {
+    int erro = errno;
+    int fd = servidor->errosOriginal >= 0 ? servidor->errosOriginal : STDERR_FILENO;
+    dprintf(fd, "%s: %s\n", contexto, strerror(erro));
+}
+
+// Depois do fim do envio do cliente só interessa a escrita; EPOLLIN se repetiria a cada espera
+static bool conexao_eventos(Servidor* servidor, ConexaoCliente* conexao, bool escrita) {
+    struct epoll_event evento;
+    evento.events = (conexao->encerrando ? 0 : EPOLLIN | EPOLLRDHUP) | (escrita ? EPOLLOUT : 0);
+    evento.data.ptr = conexao;
+    conexao->aguardandoEscrita = escrita;
+    return epoll_ctl(servidor->epoll, EPOLL_CTL_MOD, conexao->fd, &evento) == 0;
+}
+
+static void conexao_fechar(Servidor* servidor, ConexaoCliente* conexao) {
+    epoll_ctl(servidor->epoll, EPOLL_CTL_DEL, conexao->fd, NULL);
+    close(conexao->fd);
+    texto_buffer_liberar(&conexao->entrada);
+    texto_buffer_liberar(&conexao->saida);
+
+    ConexaoCliente* ultima = servidor->conexoes[--servidor->numConexoes];
+    servidor->conexoes[conexao->posicao] = ultima;
+    ultima->posicao = conexao->posicao;
+    conexao->posicao = -1;
+    if (!conexao->emAtendimento) mem_liberar(conexao);
+}
+
+static void servidor_aceitar(Servidor* servidor, int escuta) {
+    while (true) {
+        int fd = accept(escuta, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) servidor_erro(servidor, "accept");
+            return;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+        if (servidor->numConexoes == servidor->capacidadeConexoes) {
+            int capacidade = servidor->capacidadeConexoes ? servidor->capacidadeConexoes * 2 : 16;
+            ConexaoCliente** conexoes = mem_realocar(MEMORIA_OUTROS, servidor->conexoes, sizeof(ConexaoCliente*) * capacidade);
+            if (!conexoes) {
+                close(fd);
+                continue;
+            }
+            servidor->conexoes = conexoes;
+            servidor->capacidadeConexoes = capacidade;
+        }
+
+        ConexaoCliente* conexao = mem_alocar_zerado(MEMORIA_OUTROS, 1, sizeof(ConexaoCliente));
+        struct epoll_event evento;
+        evento.events = EPOLLIN | EPOLLRDHUP;
+        evento.data.ptr = conexao;
+        if (!conexao || epoll_ctl(servidor->epoll, EPOLL_CTL_ADD, fd, &evento) != 0) {
+            mem_liberar(conexao);
+            close(fd);
+            continue;
+        }
+        conexao->fd = fd;
+        conexao->posicao = servidor->numConexoes;
+        texto_buffer_init(&conexao->entrada);
+        texto_buffer_init(&conexao->saida);
+        servidor->conexoes[servidor->numConexoes++] = conexao;
+        servidor->totalConexoes++;
+    }
+}
+
+static bool captura_ler(FILE* captura, TextoBuffer* destino) {
+    int fd = fileno(captura);
+    off_t tamanho = lseek(fd, 0, SEEK_END);
+    char trecho[TRECHO_LEITURA];
+    for (off_t posicao = 0; posicao < tamanho; ) {
+        ssize_t lidos = pread(fd, trecho, sizeof(trecho), posicao);
+        if (lidos <= 0) return false;
+        if (!texto_buffer_anexar_bytes(destino, trecho, (size_t)lidos)) return false;
+        posicao += lidos;
+    }
+    return true;
+}
+
+static void captura_esvaziar(const Servidor* servidor, FILE* captura) {
+    if (ftruncate(fileno(captura), 0) != 0) servidor_erro(servidor, "ftruncate");
+    lseek(fileno(captura), 0, SEEK_SET);
+}
+
+// Executa o pedido com stdout e stderr apontando para os arquivos de captura, de modo que o
+// cliente receba exatamente o que a operação imprimiria no terminal. A trava de saída deixa
+// de fora as threads que imprimem por conta própria.
+static void servidor_atender(Servidor* servidor, const PedidoInventario* pedido, RespostaInventario* resposta) {
+    saida_travar();
+    fflush(stdout);
+    fflush(stderr);
+    captura_esvaziar(servidor, servidor->capturaSaida);
+    captura_esvaziar(servidor, servidor->capturaErros);
+    dup2(fileno(servidor->capturaSaida), STDOUT_FILENO);
+    dup2(fileno(servidor->capturaErros), STDERR_FILENO);
+
+    trace_inicio(pedido_nome(pedido->operacao));
+    resposta->sucesso = pedido_executar(servidor->sistema, pedido, &resposta->registro);
+    resposta->temRegistro = resposta->sucesso && pedido->operacao == PEDIDO_BUSCAR;
+    trace_fim(pedido_nome(pedido->operacao));
+
+    fflush(stdout);
+    fflush(stderr);
+    dup2(servidor->saidaOriginal, STDOUT_FILENO);
+    dup2(servidor->errosOriginal, STDERR_FILENO);
+
+    if (!captura_ler(servidor->capturaSaida, &resposta->saida) ||
+        !captura_ler(servidor->capturaErros, &resposta->erros)) {
+        fprintf(stderr, "Falha ao ler a saída capturada do pedido.\n");
+    }
+    saida_destravar();
+}
+
+// Move para o lote todos os quadros completos da entrada (pipelining). Quadro maior que o
+// permitido é erro de protocolo e derruba a conexão.
+static bool conexao_separar_pedidos(ConexaoCliente* conexao, LoteAtendimento* lote) {
+    CabecalhoQuadro cabecalho;
+    size_t inicio = conexao->consumido;
+    while (quadro_cabecalho(conexao->entrada.dados + conexao->consumido,
+                            conexao->entrada.tamanho - conexao->consumido, &cabecalho)) {
+        if (cabecalho.tamanho > QUADRO_PEDIDO_MAXIMO) return false;
+        if (conexao->entrada.tamanho - conexao->consumido < QUADRO_CABECALHO + (size_t)cabecalho.tamanho) break;
+        conexao->consumido += QUADRO_CABECALHO + cabecalho.tamanho;
+        lote->numPedidos++;
+    }
+    if (conexao->consumido > inicio &&
+        !texto_buffer_anexar_bytes(&lote->pedidos, conexao->entrada.dados + inicio, conexao->consumido - inicio)) {
+        return false;
+    }
+
+    // Quadro incompleto vai para o início do buffer
+    size_t restante = conexao->entrada.tamanho - conexao->consumido;
+    if (conexao->consumido > 0) {
+        memmove(conexao->entrada.dados, conexao->entrada.dados + conexao->consumido, restante);
+        conexao->entrada.tamanho = restante;
+        conexao->consumido = 0;
+    }
+    return true;
+}
+
+// Há um quadro completo (ou um cabeçalho inválido, que derruba a conexão) esperando lote
+static bool conexao_tem_pedido(const ConexaoCliente* conexao) {
+    CabecalhoQuadro cabecalho;
+    size_t disponivel = conexao->entrada.tamanho - conexao->consumido;
+    return quadro_cabecalho(conexao->entrada.dados + conexao->consumido, disponivel, &cabecalho) &&
+           (cabecalho.tamanho > QUADRO_PEDIDO_MAXIMO || disponivel >= QUADRO_CABECALHO + (size_t)cabecalho.tamanho);
+}
+
+// Conexão com o envio encerrado e nada mais a atender nem a mandar
+static bool conexao_concluida(const ConexaoCliente* conexao) {
+    return conexao->encerrando && !conexao->emAtendimento && conexao->saida.tamanho == 0 && !conexao_tem_pedido(conexao);
+}
+
+// Executa os pedidos do lote em ordem; roda num worker do pool (ou no laço, sem workers)
+static void lote_executar(void* contexto, int indice) {
+    (void)indice;
+    LoteAtendimento* lote = (LoteAtendimento*)contexto;
+    CabecalhoQuadro cabecalho;
+    size_t posicao = 0;
+    while (!lote->falhou && quadro_cabecalho(lote->pedidos.dados + posicao, lote->pedidos.tamanho - posicao, &cabecalho)) {
+        const char* corpo = lote->pedidos.dados + posicao + QUADRO_CABECALHO;
+        PedidoInventario pedido;
+        RespostaInventario resposta;
+        resposta_init(&resposta);
+        bool ok = true;
+        if (pedido_decodificar(&cabecalho, corpo, &pedido)) {
+            servidor_atender(lote->servidor, &pedido, &resposta);
+        } else {
+            ok = texto_buffer_anexar(&resposta.erros, "Pedido inválido (operação %u).\n", cabecalho.codigo);
+        }
+        ok = ok && resposta_codificar(&lote->respostas, &resposta, cabecalho.sequencia);
+        resposta_liberar(&resposta);
+        lote->falhou = !ok;
+        posicao += QUADRO_CABECALHO + cabecalho.tamanho;
+    }
+
+    uint64_t um = 1;
+    if (write(lote->servidor->aviso, &um, sizeof(um)) != (ssize_t)sizeof(um)) servidor_erro(lote->servidor, "eventfd");
+}
+
+// Leva o próximo lote pendente ao pool, revezando entre as conexões com pedidos completos
+static void servidor_despachar(Servidor* servidor) {
+    while (!servidor->loteEmAndamento && !servidor->encerrando && servidor->numConexoes > 0) {
+        ConexaoCliente* escolhida = NULL;
+        for (int k = 0; k < servidor->numConexoes && !escolhida; k++) {
+            ConexaoCliente* conexao = servidor->conexoes[(servidor->proximaConexao + k) % servidor->numConexoes];
+            if (conexao_tem_pedido(conexao)) escolhida = conexao;
+        }
+        if (!escolhida) return;
+        servidor->proximaConexao = escolhida->posicao + 1;
+
+        LoteAtendimento* lote = &servidor->lote;
+        texto_buffer_liberar(&lote->pedidos);
+        texto_buffer_liberar(&lote->respostas);
+        lote->servidor = servidor;
+        lote->conexao = escolhida;
+        lote->numPedidos = 0;
+        lote->falhou = false;
+        if (!conexao_separar_pedidos(escolhida, lote)) {
+            conexao_fechar(servidor, escolhida);
+            continue;
+        }
+
+        escolhida->emAtendimento = true;
+        servidor->loteEmAndamento = true;
+        if (!threadpool_enviar(servidor->sistema->pool, lote_executar, lote)) {
+            // Pool sem workers: o laço executa o lote e a conclusão chega pelo mesmo aviso
+            lote_executar(lote, 0);
+        }
+    }
+}
+
+static bool conexao_enviar(Servidor* servidor, ConexaoCliente* conexao);
+
+// Chamada pelo laço depois do aviso do worker: entrega as respostas e passa ao próximo lote
+static void servidor_concluir_lote(Servidor* servidor) {
+    LoteAtendimento* lote = &servidor->lote;
+    ConexaoCliente* conexao = lote->conexao;
+    servidor->loteEmAndamento = false;
+    lote->conexao = NULL;
+    conexao->emAtendimento = false;
+    servidor->pedidos += lote->numPedidos;
+
+    if (conexao->posicao < 0) {
+        // Cliente desconectou durante o lote
+        mem_liberar(conexao);
+    } else {
+        bool ok = !lote->falhou &&
+                  texto_buffer_anexar_bytes(&conexao->saida, lote->respostas.dados, lote->respostas.tamanho) &&
+                  conexao_enviar(servidor, conexao);
+        if (!ok || conexao_concluida(conexao)) {
+            conexao_fechar(servidor, conexao);
+        }
+    }
+    texto_buffer_liberar(&lote->pedidos);
+    texto_buffer_liberar(&lote->respostas);
+}
+
+// Lê tudo o que estiver disponível; false em erro ou com a entrada pendente acima de
+// ENTRADA_MAXIMA_CONEXAO. Fim do envio do cliente marca encerrando.
+static bool conexao_ler(Servidor* servidor, ConexaoCliente* conexao) {
+    char trecho[TRECHO_LEITURA];
+    while (true) {
+        ssize_t lidos = read(conexao->fd, trecho, sizeof(trecho));
+        if (lidos > 0) {
+            if (conexao->entrada.tamanho - conexao->consumido + (size_t)lidos > ENTRADA_MAXIMA_CONEXAO) {
+                servidor->desconectadosPorExcesso++;
+                return false;
+            }
+            if (!texto_buffer_anexar_bytes(&conexao->entrada, trecho, (size_t)lidos)) return false;
+            continue;
+        }
+        if (lidos == 0) {
+            conexao->encerrando = true;
+            return true;
+        }
+        if (errno == EINTR) continue;
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+}
+
+// Envia o máximo possível; o que sobrar espera EPOLLOUT
+static bool conexao_enviar(Servidor* servidor, ConexaoCliente* conexao) {
+    while (conexao->enviado < conexao->saida.tamanho) {
+        ssize_t enviados = send(conexao->fd, conexao->saida.dados + conexao->enviado,
+                                conexao->saida.tamanho - conexao->enviado, MSG_NOSIGNAL);
+        if (enviados < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return false;
+        }
+        conexao->enviado += (size_t)enviados;
+    }
+
+    bool pendente = conexao->enviado < conexao->saida.tamanho;
+    if (!pendente) {
+        conexao->saida.tamanho = 0;
+        conexao->enviado = 0;
+    }
+    if (pendente != conexao->aguardandoEscrita && !conexao_eventos(servidor, conexao, pendente)) return false;
+    return true;
+}
+
+// Só E/S: os pedidos lidos ficam na entrada até servidor_despachar levá-los ao pool. EPOLLHUP
+// indica que o cliente fechou os dois sentidos, e as respostas não teriam para onde ir.
+static void servidor_evento_conexao(Servidor* servidor, ConexaoCliente* conexao, uint32_t eventos) {
+    bool ok = (eventos & (EPOLLERR | EPOLLHUP)) == 0;
+    if (ok && (eventos & (EPOLLIN | EPOLLRDHUP))) {
+        bool jaEncerrando = conexao->encerrando;
+        ok = conexao_ler(servidor, conexao);
+        if (ok && conexao->encerrando && !jaEncerrando) ok = conexao_eventos(servidor, conexao, conexao->aguardandoEscrita);
+    }
+    if (ok) ok = conexao_enviar(servidor, conexao);
+    if (!ok || conexao_concluida(conexao)) {
+        conexao_fechar(servidor, conexao);
+    }
+}
+
+// Espera o lote em andamento no encerramento; o worker ainda usa a captura e o sistema
+static void servidor_aguardar_lote(Servidor* servidor) {
+    while (servidor->loteEmAndamento) {
+        struct pollfd espera = {servidor->aviso, POLLIN, 0};
+        uint64_t avisos;
+        if (poll(&espera, 1, -1) > 0 && read(servidor->aviso, &avisos, sizeof(avisos)) == (ssize_t)sizeof(avisos)) {
+            servidor_concluir_lote(servidor);
+        }
+    }
+}
+
+static int servidor_escutar(const char* caminhoSocket) {
+    struct sockaddr_un endereco;
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    if (strlen(caminhoSocket) >= sizeof(endereco.sun_path)) {
+        fprintf(stderr, "Caminho do socket longo demais: %s\n", caminhoSocket);
+        return -1;
+    }
+    strcpy(endereco.sun_path, caminhoSocket);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+
+    // Um socket que aceita conexão pertence a outro servidor; um que recusa sobrou de um servidor encerrado
+    int teste = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (teste >= 0 && connect(teste, (struct sockaddr*)&endereco, sizeof(endereco)) == 0) {
+        close(teste);
+        close(fd);
+        fprintf(stderr, "Já existe um servidor atendendo em %s\n", caminhoSocket);
+        return -1;
+    }
+    if (teste >= 0) close(teste);
+    unlink(caminhoSocket);
+
+    if (bind(fd, (struct sockaddr*)&endereco, sizeof(endereco)) != 0 || listen(fd, SOMAXCONN) != 0) {
+        perror(caminhoSocket);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static bool servidor_registrar(Servidor* servidor, int fd, void* marcador) {
+    struct epoll_event evento;
+    evento.events = EPOLLIN;
+    evento.data.ptr = marcador;
+    return epoll_ctl(servidor->epoll, EPOLL_CTL_ADD, fd, &evento) == 0;
+}
+
+bool servidor_executar(SistemaInventario* sistema, const char* caminhoSocket) {
+    if (sistema == NULL || caminhoSocket == NULL) return false;
+
+    Servidor servidor;
+    memset(&servidor, 0, sizeof(servidor));
+    servidor.sistema = sistema;
+    servidor.epoll = -1;
+    servidor.aviso = -1;
+    servidor.saidaOriginal = -1;
+    servidor.errosOriginal = -1;
+
+    int escuta = servidor_escutar(caminhoSocket);
+    if (escuta < 0) return false;
+
+    // Sinais de encerramento chegam pelo epoll, sem interromper um pedido no meio
+    // e continuam bloqueados na volta: um sinal repetido (o mesmo kill enviado ao processo e ao
+    // grupo, por exemplo) mataria o processo durante a gravação feita pelo chamador
+    sigset_t sinais;
+    sigemptyset(&sinais);
+    sigaddset(&sinais, SIGINT);
+    sigaddset(&sinais, SIGTERM);
+    sigprocmask(SIG_BLOCK, &sinais, NULL);
+    int sinal = signalfd(-1, &sinais, SFD_NONBLOCK | SFD_CLOEXEC);
+
+    servidor.epoll = epoll_create1(EPOLL_CLOEXEC);
+    servidor.aviso = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    texto_buffer_init(&servidor.lote.pedidos);
+    texto_buffer_init(&servidor.lote.respostas);
+    servidor.capturaSaida = tmpfile();
+    servidor.capturaErros = tmpfile();
+    servidor.saidaOriginal = dup(STDOUT_FILENO);
+    servidor.errosOriginal = dup(STDERR_FILENO);
+    bool ok = sinal >= 0 && servidor.epoll >= 0 && servidor.aviso >= 0 && servidor.capturaSaida &&
+              servidor.capturaErros && servidor.saidaOriginal >= 0 && servidor.errosOriginal >= 0 &&
+              servidor_registrar(&servidor, escuta, &marcadorEscuta) &&
+              servidor_registrar(&servidor, sinal, &marcadorSinal) &&
+              servidor_registrar(&servidor, servidor.aviso, &marcadorAviso);
+    if (!ok) perror("Falha ao preparar o servidor");
+
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+    if (ok) printf("Servidor do inventário atendendo em %s (SIGINT ou SIGTERM encerram)\n", caminhoSocket);
+    fflush(stdout);
+
+    bool executando = ok;
+    struct epoll_event eventos[MAX_EVENTOS];
+    while (executando) {
+        int prontos = epoll_wait(servidor.epoll, eventos, MAX_EVENTOS, -1);
+        if (prontos < 0) {
+            if (errno == EINTR) continue;
+            servidor_erro(&servidor, "epoll_wait");
+            break;
+        }
+        bool loteConcluido = false;
+        for (int i = 0; i < prontos; i++) {
+            void* origem = eventos[i].data.ptr;
+            if (origem == &marcadorEscuta) {
+                servidor_aceitar(&servidor, escuta);
+            } else if (origem == &marcadorSinal) {
+                struct signalfd_siginfo info;
+                while (read(sinal, &info, sizeof(info)) == sizeof(info)) {}
+                executando = false;
+            } else if (origem == &marcadorAviso) {
+                uint64_t avisos;
+                loteConcluido = read(servidor.aviso, &avisos, sizeof(avisos)) == (ssize_t)sizeof(avisos);
+            } else {
+                servidor_evento_conexao(&servidor, (ConexaoCliente*)origem, eventos[i].events);
+            }
+        }
+        // Conexões só são fechadas fora do laço de eventos acima, que ainda pode citá-las
+        if (loteConcluido) servidor_concluir_lote(&servidor);
+        servidor_despachar(&servidor);
+    }
+
+    servidor.encerrando = true;
+    servidor_aguardar_lote(&servidor);
+    while (servidor.numConexoes > 0) {
+        conexao_fechar(&servidor, servidor.conexoes[0]);
+    }
+    mem_liberar(servidor.conexoes);
+    close(escuta);
+    unlink(caminhoSocket);
+    if (sinal >= 0) close(sinal);
+    if (servidor.aviso >= 0) close(servidor.aviso);
+    if (servidor.epoll >= 0) close(servidor.epoll);
+    if (servidor.capturaSaida) fclose(servidor.capturaSaida);
+    if (servidor.capturaErros) fclose(servidor.capturaErros);
+    if (servidor.saidaOriginal >= 0) close(servidor.saidaOriginal);
+    if (servidor.errosOriginal >= 0) close(servidor.errosOriginal);
+
+    if (ok) {
+        printf("Servidor encerrado: %lld pedidos de %lld conexões\n", servidor.pedidos, servidor.totalConexoes);
+        if (servidor.desconectadosPorExcesso > 0) {
+            printf("Conexões encerradas por excesso de pedidos pendentes: %lld\n", servidor.desconectadosPorExcesso);
+        }
+        cronometro_definir_registros(servidor.pedidos);
+        cronometro_parar(&crono);
+        cronometro_imprimir("Servidor do inventário", &crono);
+    }
+    return ok;
+}
+
+#else
+
+bool servidor_executar(SistemaInventario* sistema, const char* caminhoSocket) {
+    (void)sistema;
+    (void)caminhoSocket;
+    fprintf(stderr, "O modo servidor está disponível apenas no Linux.\n");
+    return false;
+}
+
+#endif
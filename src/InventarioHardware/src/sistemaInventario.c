@@ -1,20 +1,89 @@
 #include "sistemaInventario.h"
+#include "depreciacao.h"
+#include "ordenacaoExterna.h"
+#include "repositorioCache.h"
+#include "snapshot.h"
+#include "trace.h"
 #include "utils.h"
+#include "memoria.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 
 void sistema_init(SistemaInventario* sistema, Repository* repo) {
-    Cronometro crono;
-    cronometro_iniciar(&crono);
-    
+    sistema_init_com_snapshot(sistema, repo, NULL, NULL);
+}
+
+static void sistema_init_campos(SistemaInventario* sistema, Repository* repo, const char* arquivoSnapshot, const char* arquivoOrigem) {
     linkedlist_init(&sistema->inventario);
     sistema->repositorio = repo;
     sistema->proximoId = 1;
-    
+    sistema->pool = threadpool_criar(obter_numero_nucleos());
+    monitor_obsolescencia_init(&sistema->obsolescencia);
+    agenda_manutencao_init(&sistema->agendaManutencao);
+    projecao_init(&sistema->projecao);
+    sistema->arquivoSnapshot = arquivoSnapshot;
+    sistema->arquivoOrigem = arquivoOrigem;
+    atomic_init(&sistema->inventarioCarregado, true);
+    indice_inventario_init(&sistema->indice);
+    pthread_mutex_init(&sistema->leituraIndice, NULL);
+    pthread_mutex_init(&sistema->escrita, NULL);
+    pthread_rwlock_init(&sistema->estruturas, NULL);
+    publicacao_init(&sistema->versoes);
+    mapa_int_init(&sistema->posicoes);
+    sistema->segmento = NULL;
+    atomic_init(&sistema->ingestaoAtiva, false);
+}
+
+// Publica a lista inteira, reaproveitando as páginas inalteradas da versão anterior.
+// Chamado pelo escritor com estruturas em modo de escrita; reposicionar refaz o mapa id -> posição.
+static void sistema_publicar(SistemaInventario* sistema, bool reposicionar) {
+    VersaoInventario* nova = versao_sincronizar(sistema->versoes.atual, &sistema->inventario);
+    if (!nova) {
+        fprintf(stderr, "Memória insuficiente para publicar a versão do inventário.\n");
+        return;
+    }
+    publicacao_trocar(&sistema->versoes, nova);
+    if (sistema->segmento) segmento_sincronizar(sistema->segmento, nova);
+    if (!reposicionar) return;
+
+    mapa_int_limpar(&sistema->posicoes);
+    mapa_int_reservar(&sistema->posicoes, (size_t)sistema->inventario.size);
+    int posicao = 0;
+    for (Node* atual = sistema->inventario.head; atual != NULL; atual = atual->next) {
+        mapa_int_inserir(&sistema->posicoes, atual->data.id, posicao++);
+    }
+}
+
+// Publica a alteração de um registro copiando só a página dele; registro novo vai para o fim
+static void sistema_publicar_registro(SistemaInventario* sistema, const Hardware* hw) {
+    const VersaoInventario* atual = sistema->versoes.atual;
+    intptr_t posicao;
+    VersaoInventario* nova;
+    if (mapa_int_buscar(&sistema->posicoes, hw->id, &posicao)) {
+        nova = versao_substituir(atual, (int)posicao, hw);
+    } else {
+        posicao = atual ? atual->numRegistros : 0;
+        nova = versao_anexar(atual, hw);
+        if (nova) mapa_int_inserir(&sistema->posicoes, hw->id, posicao);
+    }
+
+    if (nova) {
+        publicacao_trocar(&sistema->versoes, nova);
+        if (sistema->segmento) segmento_gravar_registro(sistema->segmento, (int)posicao, hw);
+    } else {
+        sistema_publicar(sistema, true);
+    }
+}
+
+// Carrega a lista inteira pelo repositório e monta proximoId e a agenda
+static void sistema_carregar_inventario(SistemaInventario* sistema) {
+    Repository* repo = sistema->repositorio;
     if (repo && repo->interface && repo->interface->carregar) {
+        trace_inicio("Repositório: carregar");
         repo->interface->carregar(repo->implementacao, &sistema->inventario);
+        trace_fim("Repositório: carregar");
     }
     
     Node* current = sistema->inventario.head;
@@ -24,9 +93,77 @@ void sistema_init(SistemaInventario* sistema, Repository* repo) {
         }
         current = current->next;
     }
+    agenda_manutencao_construir(&sistema->agendaManutencao, &sistema->inventario);
+    sistema_publicar(sistema, true);
+}
+
+// No modo sob demanda, a primeira operação que precisa da lista completa descarta o índice e carrega tudo
+// Chamado pelo escritor com estruturas em modo de escrita
+static void sistema_garantir_inventario(SistemaInventario* sistema) {
+    if (sistema->inventarioCarregado) return;
+
+    indice_inventario_liberar(&sistema->indice);
+    sistema_carregar_inventario(sistema);
+    sistema->inventarioCarregado = true;
+}
+
+// Versão para quem não é escritor: a carga só toma as travas enquanto o inventário não está residente
+static void sistema_garantir_carregado(SistemaInventario* sistema) {
+    if (sistema->inventarioCarregado) return;
+
+    pthread_mutex_lock(&sistema->escrita);
+    pthread_rwlock_wrlock(&sistema->estruturas);
+    sistema_garantir_inventario(sistema);
+    pthread_rwlock_unlock(&sistema->estruturas);
+    pthread_mutex_unlock(&sistema->escrita);
+}
+
+const VersaoInventario* sistema_obter_versao(SistemaInventario* sistema) {
+    sistema_garantir_carregado(sistema);
+    return publicacao_obter(&sistema->versoes);
+}
+
+static int sistema_total_registros(SistemaInventario* sistema) {
+    const VersaoInventario* versao = publicacao_obter(&sistema->versoes);
+    int total = versao ? versao->numRegistros : 0;
+    versao_liberar(versao);
+    return total;
+}
+
+// Com snapshot configurado, usa a imagem quando ela corresponde ao CSV e só faz o parsing completo se não corresponder
+void sistema_init_com_snapshot(SistemaInventario* sistema, Repository* repo, const char* arquivoSnapshot, const char* arquivoOrigem) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+    
+    sistema_init_campos(sistema, repo, arquivoSnapshot, arquivoOrigem);
+    if (arquivoSnapshot == NULL || !snapshot_carregar(arquivoSnapshot, arquivoOrigem, sistema)) {
+        sistema_carregar_inventario(sistema);
+    } else {
+        sistema_publicar(sistema, true);
+    }
     
-    double tempo = cronometro_parar(&crono);
-    cronometro_imprimir("Inicialização do sistema", tempo);
+    cronometro_parar(&crono);
+    cronometro_imprimir("Inicialização do sistema", &crono);
+}
+
+// Modo sob demanda: só o índice do CSV fica residente; registros completos são lidos quando acessados
+void sistema_init_lazy(SistemaInventario* sistema, Repository* repo, const char* arquivoOrigem) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    sistema_init_campos(sistema, repo, NULL, arquivoOrigem);
+    if (arquivoOrigem != NULL && indice_inventario_construir(&sistema->indice, arquivoOrigem)) {
+        sistema->inventarioCarregado = false;
+        sistema->proximoId = sistema->indice.maiorId + 1;
+    } else if (arquivoOrigem == NULL && repo && repo->interface && repo->interface->carregar_tipo) {
+        // Repositório particionado: nada fica residente; cada tipo é lido da sua partição
+        sistema->inventarioCarregado = false;
+    } else {
+        sistema_carregar_inventario(sistema);
+    }
+
+    cronometro_parar(&crono);
+    cronometro_imprimir("Inicialização do sistema", &crono);
 }
 
 void sistema_destroy(SistemaInventario* sistema) {
@@ -35,16 +172,47 @@ void sistema_destroy(SistemaInventario* sistema) {
     Cronometro crono;
     cronometro_iniciar(&crono);
 
-    if (sistema->repositorio != NULL && 
+    // Os eventos ainda na fila entram antes da gravação final
+    if (atomic_load(&sistema->ingestaoAtiva)) {
+        ingestao_encerrar(&sistema->ingestao);
+        atomic_store(&sistema->ingestaoAtiva, false);
+        if (sistema->ingestao.falhasGravacao > 0) {
+            fprintf(stderr, "Ingestão: %lld lotes de manutenções não foram gravados\n", sistema->ingestao.falhasGravacao);
+        }
+    }
+
+    // Sem a lista carregada não houve alteração em memória; o CSV continua como estava
+    if (sistema->inventarioCarregado &&
+        sistema->repositorio != NULL && 
         sistema->repositorio->interface != NULL && 
         sistema->repositorio->interface->salvar != NULL) {
-        sistema->repositorio->interface->salvar(sistema->repositorio->implementacao, &sistema->inventario);
+        trace_inicio("Repositório: salvar");
+        bool salvo = sistema->repositorio->interface->salvar(sistema->repositorio->implementacao, &sistema->inventario);
+        trace_fim("Repositório: salvar");
+
+        if (salvo && sistema->arquivoSnapshot != NULL &&
+            !snapshot_gravar(sistema->arquivoSnapshot, sistema->arquivoOrigem, sistema)) {
+            fprintf(stderr, "Falha ao gravar snapshot em %s\n", sistema->arquivoSnapshot);
+        }
     }
     
+    segmento_destruir(sistema->segmento);
+    sistema->segmento = NULL;
     linkedlist_clear(&sistema->inventario);
+    monitor_obsolescencia_destruir(&sistema->obsolescencia);
+    agenda_manutencao_destruir(&sistema->agendaManutencao);
+    projecao_liberar(&sistema->projecao);
+    indice_inventario_liberar(&sistema->indice);
+    threadpool_destruir(sistema->pool);
+    sistema->pool = NULL;
+    publicacao_destruir(&sistema->versoes);
+    mapa_int_destruir(&sistema->posicoes);
+    pthread_rwlock_destroy(&sistema->estruturas);
+    pthread_mutex_destroy(&sistema->leituraIndice);
+    pthread_mutex_destroy(&sistema->escrita);
     
-    double tempo = cronometro_parar(&crono);
-    cronometro_imprimir("Destruição do sistema", tempo);
+    cronometro_parar(&crono);
+    cronometro_imprimir("Destruição do sistema", &crono);
 }
 
 bool sistema_cadastrar_hardware(SistemaInventario* sistema, const char* nome, const char* fabricante, 
@@ -67,6 +235,10 @@ bool sistema_cadastrar_hardware(SistemaInventario* sistema, const char* nome, co
         return false;
     }
 
+    pthread_mutex_lock(&sistema->escrita);
+    pthread_rwlock_wrlock(&sistema->estruturas);
+    sistema_garantir_inventario(sistema);
+
     Hardware hw;
     hw.id = sistema->proximoId++;
     strncpy(hw.nome, nome, sizeof(hw.nome) - 1);
@@ -83,22 +255,38 @@ bool sistema_cadastrar_hardware(SistemaInventario* sistema, const char* nome, co
     hw.obsoleto = false;
 
     linkedlist_push_back(&sistema->inventario, &hw);
-    
+    monitor_obsolescencia_registrar(&sistema->obsolescencia, sistema->inventario.tail);
+    agenda_manutencao_registrar(&sistema->agendaManutencao, sistema->inventario.tail);
+    sistema->projecao.construida = false;
+    sistema_publicar_registro(sistema, &hw);
+    pthread_rwlock_unlock(&sistema->estruturas);
+
+    // A gravação fica fora da trava das estruturas: leitores seguem enquanto o repositório escreve
     if (sistema->repositorio != NULL && 
         sistema->repositorio->interface != NULL && 
         sistema->repositorio->interface->adicionar != NULL) {
-        if (!sistema->repositorio->interface->adicionar(sistema->repositorio->implementacao, &hw)) {
+        trace_inicio("Repositório: adicionar");
+        bool adicionado = sistema->repositorio->interface->adicionar(sistema->repositorio->implementacao, &hw);
+        trace_fim("Repositório: adicionar");
+        if (!adicionado) {
             fprintf(stderr, "Erro ao salvar no repositório\n");
+            pthread_rwlock_wrlock(&sistema->estruturas);
+            monitor_obsolescencia_invalidar(&sistema->obsolescencia);
             linkedlist_clear(&sistema->inventario);
             if (sistema->repositorio->interface->carregar) {
                 sistema->repositorio->interface->carregar(sistema->repositorio->implementacao, &sistema->inventario);
             }
+            agenda_manutencao_construir(&sistema->agendaManutencao, &sistema->inventario);
+            sistema_publicar(sistema, true);
+            pthread_rwlock_unlock(&sistema->estruturas);
+            pthread_mutex_unlock(&sistema->escrita);
             return false;
         }
     }
+    pthread_mutex_unlock(&sistema->escrita);
     
-    double tempo = cronometro_parar(&crono);
-    cronometro_imprimir("Cadastro de hardware", tempo);
+    cronometro_parar(&crono);
+    cronometro_imprimir("Cadastro de hardware", &crono);
     
     printf("Hardware cadastrado com ID: %d\n", hw.id);
     return true;
@@ -109,57 +297,268 @@ bool sistema_registrar_manutencao(SistemaInventario* sistema, int id, const Data
     cronometro_iniciar(&crono);
 
     if (sistema == NULL || dataManutencao == NULL) return false;
+    pthread_mutex_lock(&sistema->escrita);
+    pthread_rwlock_wrlock(&sistema->estruturas);
+    sistema_garantir_inventario(sistema);
 
-    Node* current = sistema->inventario.head;
-    while (current != NULL) {
-        if (current->data.id == id) {
-            current->data.ultimaManutencao = *dataManutencao;
-            
-            if (sistema->repositorio != NULL && 
-                sistema->repositorio->interface != NULL && 
-                sistema->repositorio->interface->atualizar != NULL) {
-                bool resultado = sistema->repositorio->interface->atualizar(sistema->repositorio->implementacao, &current->data);
-                double tempo = cronometro_parar(&crono);
-                cronometro_imprimir("Registro de manutenção", tempo);
-                return resultado;
-            }
-            
-            double tempo = cronometro_parar(&crono);
-            cronometro_imprimir("Registro de manutenção", tempo);
-            return true;
+    Node* current = agenda_manutencao_buscar(&sistema->agendaManutencao, id);
+    if (current != NULL) {
+        Data anterior = current->data.ultimaManutencao;
+        current->data.ultimaManutencao = *dataManutencao;
+        agenda_manutencao_atualizar(&sistema->agendaManutencao, id);
+        sistema_publicar_registro(sistema, &current->data);
+        pthread_rwlock_unlock(&sistema->estruturas);
+        
+        // Só o escritor remove nós, então current segue válido sem a trava das estruturas
+        bool resultado = true;
+        if (sistema->repositorio != NULL && 
+            sistema->repositorio->interface != NULL && 
+            sistema->repositorio->interface->atualizar != NULL) {
+            trace_inicio("Repositório: atualizar");
+            resultado = sistema->repositorio->interface->atualizar(sistema->repositorio->implementacao, &current->data);
+            trace_fim("Repositório: atualizar");
         }
-        current = current->next;
+        if (!resultado) {
+            // A memória volta a refletir o repositório, que não recebeu a data nova
+            fprintf(stderr, "Erro ao salvar no repositório\n");
+            pthread_rwlock_wrlock(&sistema->estruturas);
+            current->data.ultimaManutencao = anterior;
+            agenda_manutencao_atualizar(&sistema->agendaManutencao, id);
+            sistema_publicar_registro(sistema, &current->data);
+            pthread_rwlock_unlock(&sistema->estruturas);
+        }
+        pthread_mutex_unlock(&sistema->escrita);
+        
+        cronometro_parar(&crono);
+        cronometro_imprimir("Registro de manutenção", &crono);
+        return resultado;
     }
+    pthread_rwlock_unlock(&sistema->estruturas);
+    pthread_mutex_unlock(&sistema->escrita);
+    fprintf(stderr, "Equipamento %d não encontrado\n", id);
     
-    double tempo = cronometro_parar(&crono);
-    cronometro_imprimir("Registro de manutenção (falha)", tempo);
+    cronometro_parar(&crono);
+    cronometro_imprimir("Registro de manutenção (falha)", &crono);
     return false;
 }
 
+#define INGESTAO_CAPACIDADE_FILA 65536
+#define INGESTAO_LOTE_MAXIMO 4096
+
+bool sistema_enfileirar_manutencao(SistemaInventario* sistema, int id, const Data* dataManutencao) {
+    if (sistema == NULL || dataManutencao == NULL) return false;
+
+    if (!atomic_load_explicit(&sistema->ingestaoAtiva, memory_order_acquire)) {
+        // Só quem encontra o aplicador parado passa pela trava do escritor
+        pthread_mutex_lock(&sistema->escrita);
+        if (!atomic_load_explicit(&sistema->ingestaoAtiva, memory_order_relaxed) &&
+            ingestao_iniciar(&sistema->ingestao, sistema, INGESTAO_CAPACIDADE_FILA, INGESTAO_LOTE_MAXIMO)) {
+            atomic_store_explicit(&sistema->ingestaoAtiva, true, memory_order_release);
+        }
+        pthread_mutex_unlock(&sistema->escrita);
+        if (!atomic_load_explicit(&sistema->ingestaoAtiva, memory_order_acquire)) return false;
+    }
+
+    if (!ingestao_enviar(&sistema->ingestao, id, dataManutencao)) {
+        fprintf(stderr, "Fila de manutenções cheia; tente novamente.\n");
+        return false;
+    }
+    return true;
+}
+
+// Acima disso o lote é publicado de uma vez: versao_sincronizar compara as páginas em vez de copiar
+// uma página por registro alterado
+#define PUBLICACAO_AVULSA_MAXIMA 16
+
+// Data que um evento do lote substituiu, para desfazê-lo se a gravação falhar
+typedef struct {
+    Node* no;
+    Data anterior;
+} AlteracaoManutencao;
+
+static void sistema_publicar_alteracoes(SistemaInventario* sistema, const AlteracaoManutencao* alteracoes, int quantidade) {
+    if (quantidade > PUBLICACAO_AVULSA_MAXIMA) {
+        sistema_publicar(sistema, false);
+        return;
+    }
+    for (int i = 0; i < quantidade; i++) {
+        sistema_publicar_registro(sistema, &alteracoes[i].no->data);
+    }
+}
+
+int sistema_aplicar_manutencoes(SistemaInventario* sistema, const EventoManutencao* eventos, int quantidade) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    if (sistema == NULL || eventos == NULL || quantidade <= 0) return 0;
+    AlteracaoManutencao* alteracoes = mem_alocar(MEMORIA_TEMPORARIA, (size_t)quantidade * sizeof(AlteracaoManutencao));
+    if (!alteracoes) {
+        fprintf(stderr, "Memória insuficiente para o lote de manutenções\n");
+        return -1;
+    }
+    pthread_mutex_lock(&sistema->escrita);
+    pthread_rwlock_wrlock(&sistema->estruturas);
+    sistema_garantir_inventario(sistema);
+
+    int numAlterados = 0;
+    for (int i = 0; i < quantidade; i++) {
+        Node* no = agenda_manutencao_buscar(&sistema->agendaManutencao, eventos[i].id);
+        if (no == NULL || !data_menor_que(&no->data.ultimaManutencao, &eventos[i].data)) continue;
+
+        alteracoes[numAlterados].no = no;
+        alteracoes[numAlterados].anterior = no->data.ultimaManutencao;
+        numAlterados++;
+        no->data.ultimaManutencao = eventos[i].data;
+        agenda_manutencao_atualizar(&sistema->agendaManutencao, eventos[i].id);
+    }
+    sistema_publicar_alteracoes(sistema, alteracoes, numAlterados);
+    pthread_rwlock_unlock(&sistema->estruturas);
+
+    // Uma gravação da lista inteira por lote, no lugar de uma reescrita por evento
+    bool gravado = true;
+    if (numAlterados > 0 &&
+        sistema->repositorio != NULL &&
+        sistema->repositorio->interface != NULL &&
+        sistema->repositorio->interface->salvar != NULL) {
+        trace_inicio("Repositório: salvar lote de manutenções");
+        gravado = sistema->repositorio->interface->salvar(sistema->repositorio->implementacao, &sistema->inventario);
+        trace_fim("Repositório: salvar lote de manutenções");
+    }
+    if (!gravado) {
+        // Desfeito do último para o primeiro: com o mesmo id repetido no lote, volta a data original
+        fprintf(stderr, "Erro ao gravar o lote de manutenções no repositório\n");
+        pthread_rwlock_wrlock(&sistema->estruturas);
+        for (int i = numAlterados - 1; i >= 0; i--) {
+            alteracoes[i].no->data.ultimaManutencao = alteracoes[i].anterior;
+            agenda_manutencao_atualizar(&sistema->agendaManutencao, alteracoes[i].no->data.id);
+        }
+        sistema_publicar_alteracoes(sistema, alteracoes, numAlterados);
+        pthread_rwlock_unlock(&sistema->estruturas);
+    }
+    pthread_mutex_unlock(&sistema->escrita);
+    mem_liberar(alteracoes);
+
+    cronometro_parar(&crono);
+    cronometro_definir_registros(quantidade);
+    cronometro_imprimir("Aplicação de lote de manutenções", &crono);
+    return gravado ? numAlterados : -1;
+}
+
+bool sistema_buscar_hardware(SistemaInventario* sistema, int id, Hardware* destino) {
+    if (sistema == NULL || destino == NULL) return false;
+
+    // O registro é copiado sob a trava para ser usado depois dela
+    bool encontrado = false;
+    if (sistema->inventarioCarregado) {
+        pthread_rwlock_rdlock(&sistema->estruturas);
+        Node* no = agenda_manutencao_buscar(&sistema->agendaManutencao, id);
+        if (no) {
+            *destino = no->data;
+            encontrado = true;
+        }
+        pthread_rwlock_unlock(&sistema->estruturas);
+        return encontrado;
+    }
+
+    // Sob demanda, o cache do índice e o repositório mudam de estado ao serem lidos
+    pthread_mutex_lock(&sistema->escrita);
+    pthread_rwlock_wrlock(&sistema->estruturas);
+    const Hardware* origem = NULL;
+    Hardware* copia = NULL;
+    if (sistema->inventarioCarregado) {
+        Node* no = agenda_manutencao_buscar(&sistema->agendaManutencao, id);
+        if (no) origem = &no->data;
+    } else if (sistema->arquivoOrigem != NULL) {
+        origem = indice_inventario_buscar(&sistema->indice, id);
+    } else if (sistema->repositorio && sistema->repositorio->interface->buscar_por_id) {
+        copia = sistema->repositorio->interface->buscar_por_id(sistema->repositorio->implementacao, id);
+        origem = copia;
+    }
+    if (origem) {
+        *destino = *origem;
+        encontrado = true;
+    }
+    free(copia);
+    pthread_rwlock_unlock(&sistema->estruturas);
+    pthread_mutex_unlock(&sistema->escrita);
+    return encontrado;
+}
+
+bool sistema_consultar_hardware(SistemaInventario* sistema, int id) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    if (sistema == NULL) return false;
+
+    Hardware hw;
+    if (!sistema_buscar_hardware(sistema, id, &hw)) {
+        printf("Equipamento com ID %d não encontrado.\n", id);
+        cronometro_parar(&crono);
+        cronometro_imprimir("Consulta por ID (não encontrado)", &crono);
+        return false;
+    }
+
+    char* str = hardware_to_string(&hw);
+    if (str) {
+        printf("%s\n", str);
+        mem_liberar(str);
+    }
+
+    cronometro_parar(&crono);
+    cronometro_imprimir("Consulta por ID", &crono);
+    return true;
+}
+
+bool sistema_publicar_segmento(SistemaInventario* sistema, const char* nome) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    if (sistema == NULL || nome == NULL) return false;
+    pthread_mutex_lock(&sistema->escrita);
+    pthread_rwlock_wrlock(&sistema->estruturas);
+    sistema_garantir_inventario(sistema);
+
+    // A partir daqui sistema_publicar e sistema_publicar_registro mantêm o segmento em dia
+    bool ok = false;
+    if (sistema->segmento == NULL) {
+        sistema->segmento = segmento_criar(nome, sistema->inventario.size);
+        ok = sistema->segmento != NULL && segmento_sincronizar(sistema->segmento, sistema->versoes.atual);
+    }
+    pthread_rwlock_unlock(&sistema->estruturas);
+    pthread_mutex_unlock(&sistema->escrita);
+
+    cronometro_definir_registros(sistema_total_registros(sistema));
+    cronometro_parar(&crono);
+    cronometro_imprimir("Publicação do segmento compartilhado", &crono);
+    return ok;
+}
+
 void sistema_listar_equipamentos(SistemaInventario* sistema) {
     Cronometro crono;
     cronometro_iniciar(&crono);
 
     if (sistema == NULL) return;
+    const VersaoInventario* versao = sistema_obter_versao(sistema);
+    if (versao == NULL) return;
 
-    printf("=== LISTA DE EQUIPAMENTOS (%d) ===\n", sistema->inventario.size);
-    if (sistema->inventario.size == 0) {
+    printf("=== LISTA DE EQUIPAMENTOS (%d) ===\n", versao->numRegistros);
+    if (versao->numRegistros == 0) {
         printf("Nenhum equipamento cadastrado.\n");
+        versao_liberar(versao);
         return;
     }
 
-    Node* current = sistema->inventario.head;
-    while (current != NULL) {
-        char* str = hardware_to_string(&current->data);
+    for (int i = 0; i < versao->numRegistros; i++) {
+        char* str = hardware_to_string(versao_registro(versao, i));
         if (str) {
             printf("%s\n", str);
-            free(str);
+            mem_liberar(str);
         }
-        current = current->next;
     }
+    versao_liberar(versao);
     
-    double tempo = cronometro_parar(&crono);
-    cronometro_imprimir("Listagem de equipamentos", tempo);
+    cronometro_parar(&crono);
+    cronometro_imprimir("Listagem de equipamentos", &crono);
 }
 
 void sistema_listar_por_tipo(SistemaInventario* sistema, TipoHardware tipo) {
@@ -170,22 +569,68 @@ void sistema_listar_por_tipo(SistemaInventario* sistema, TipoHardware tipo) {
 
     printf("=== EQUIPAMENTOS POR TIPO (%s) ===\n", tipo_to_string(tipo));
     int contador = 0;
-    Node* current = sistema->inventario.head;
-    while (current != NULL) {
+    LinkedList particao;
+    linkedlist_init(&particao);
+
+    bool sobDemanda = false;
+    if (!sistema->inventarioCarregado) {
+        pthread_mutex_lock(&sistema->escrita);
+        pthread_rwlock_wrlock(&sistema->estruturas);
+        sobDemanda = !sistema->inventarioCarregado;
+
+        // Sob demanda, o tipo está no índice: só os registros do tipo pedido são lidos do arquivo
+        for (int i = 0; sobDemanda && i < sistema->indice.tamanho; i++) {
+            if (sistema->indice.entradas[i].tipo != tipo) continue;
+
+            const Hardware* hw = indice_inventario_obter(&sistema->indice, i);
+            char* str = hw ? hardware_to_string(hw) : NULL;
+            if (str) {
+                printf("%s\n", str);
+                mem_liberar(str);
+            }
+            contador++;
+        }
+
+        // Sem índice (repositório particionado), só a partição do tipo é lida
+        if (sobDemanda && sistema->arquivoOrigem == NULL) {
+            trace_inicio("Repositório: carregar tipo");
+            repositorio_carregar_tipo(sistema->repositorio, tipo, &particao);
+            trace_fim("Repositório: carregar tipo");
+        }
+        pthread_rwlock_unlock(&sistema->estruturas);
+        pthread_mutex_unlock(&sistema->escrita);
+    }
+
+    const VersaoInventario* versao = sobDemanda ? NULL : publicacao_obter(&sistema->versoes);
+    int total = versao ? versao->numRegistros : 0;
+    for (int i = 0; i < total; i++) {
+        const Hardware* hw = versao_registro(versao, i);
+        if (hw->tipo != tipo) continue;
+
+        char* str = hardware_to_string(hw);
+        if (str) {
+            printf("%s\n", str);
+            mem_liberar(str);
+        }
+        contador++;
+    }
+    versao_liberar(versao);
+
+    for (Node* current = particao.head; current != NULL; current = current->next) {
         if (current->data.tipo == tipo) {
             char* str = hardware_to_string(&current->data);
             if (str) {
                 printf("%s\n", str);
-                free(str);
+                mem_liberar(str);
             }
             contador++;
         }
-        current = current->next;
     }
+    linkedlist_clear(&particao);
     printf("Total encontrado: %d equipamentos\n", contador);
     
-    double tempo = cronometro_parar(&crono);
-    cronometro_imprimir("Listagem por tipo", tempo);
+    cronometro_parar(&crono);
+    cronometro_imprimir("Listagem por tipo", &crono);
 }
 
 void sistema_listar_por_data_compra(SistemaInventario* sistema) {
@@ -193,37 +638,43 @@ void sistema_listar_por_data_compra(SistemaInventario* sistema) {
     cronometro_iniciar(&crono);
 
     if (sistema == NULL) return;
+    const VersaoInventario* versao = sistema_obter_versao(sistema);
+    if (versao == NULL) return;
 
     LinkedList temp;
     linkedlist_init(&temp);
     
-    Node* current = sistema->inventario.head;
-    while (current != NULL) {
-        linkedlist_push_back(&temp, &current->data);
-        current = current->next;
+    for (int i = 0; i < versao->numRegistros; i++) {
+        linkedlist_push_back(&temp, versao_registro(versao, i));
     }
+    versao_liberar(versao);
     
+    Cronometro cronoOrdenacao;
+    cronometro_iniciar(&cronoOrdenacao);
     linkedlist_insertion_sort(&temp, compare_data_compra);
+    cronometro_parar(&cronoOrdenacao);
+    cronometro_definir_registros(temp.size);
+    cronometro_imprimir("Ordenação por data de compra", &cronoOrdenacao);
     
     printf("=== EQUIPAMENTOS ORDENADOS POR DATA DE COMPRA ===\n");
     if (temp.size == 0) {
         printf("Nenhum equipamento para listar.\n");
     }
     
-    current = temp.head;
+    Node* current = temp.head;
     while (current != NULL) {
         char* str = hardware_to_string(&current->data);
         if (str) {
             printf("%s\n", str);
-            free(str);
+            mem_liberar(str);
         }
         current = current->next;
     }
     
     linkedlist_clear(&temp);
     
-    double tempo = cronometro_parar(&crono);
-    cronometro_imprimir("Listagem por data de compra", tempo);
+    cronometro_parar(&crono);
+    cronometro_imprimir("Listagem por data de compra", &crono);
 }
 
 void sistema_listar_por_data_manutencao(SistemaInventario* sistema) {
@@ -231,51 +682,291 @@ void sistema_listar_por_data_manutencao(SistemaInventario* sistema) {
     cronometro_iniciar(&crono);
 
     if (sistema == NULL) return;
+    const VersaoInventario* versao = sistema_obter_versao(sistema);
+    if (versao == NULL) return;
 
     LinkedList temp;
     linkedlist_init(&temp);
     
-    Node* current = sistema->inventario.head;
-    while (current != NULL) {
-        linkedlist_push_back(&temp, &current->data);
-        current = current->next;
+    for (int i = 0; i < versao->numRegistros; i++) {
+        linkedlist_push_back(&temp, versao_registro(versao, i));
     }
+    versao_liberar(versao);
     
+    Cronometro cronoOrdenacao;
+    cronometro_iniciar(&cronoOrdenacao);
     linkedlist_bubble_sort(&temp, compare_data_manutencao);
+    cronometro_parar(&cronoOrdenacao);
+    cronometro_definir_registros(temp.size);
+    cronometro_imprimir("Ordenação por data de manutenção", &cronoOrdenacao);
     
     printf("=== EQUIPAMENTOS ORDENADOS POR DATA DE MANUTENÇÃO ===\n");
     if (temp.size == 0) {
         printf("Nenhum equipamento para listar.\n");
     }
     
-    current = temp.head;
+    Node* current = temp.head;
     while (current != NULL) {
         char* str = hardware_to_string(&current->data);
         if (str) {
             printf("%s\n", str);
-            free(str);
+            mem_liberar(str);
         }
         current = current->next;
     }
     
     linkedlist_clear(&temp);
     
-    double tempo = cronometro_parar(&crono);
-    cronometro_imprimir("Listagem por data de manutenção", tempo);
+    cronometro_parar(&crono);
+    cronometro_imprimir("Listagem por data de manutenção", &crono);
 }
 
-double calcular_depreciacao(const Hardware* hw, const Data* hoje) {
-    if (hw == NULL || hoje == NULL) return 0.0;
+typedef struct {
+    const VersaoInventario* versao;
+    int posicao;
+} FonteVersao;
 
-    int anos = hoje->ano - hw->dataCompra.ano;
-    if (hoje->mes < hw->dataCompra.mes || (hoje->mes == hw->dataCompra.mes && hoje->dia < hw->dataCompra.dia)) {
-        anos--;
+static bool fonte_versao(void* contexto, Hardware* hw) {
+    FonteVersao* fonte = contexto;
+    if (fonte->posicao >= fonte->versao->numRegistros) return false;
+    *hw = *versao_registro(fonte->versao, fonte->posicao++);
+    return true;
+}
+
+// Lê o CSV linha a linha, com as mesmas regras de csv_carregar, sem montar a lista
+typedef struct {
+    FILE* arquivo;
+} FonteCsv;
+
+static bool fonte_csv(void* contexto, Hardware* hw) {
+    FonteCsv* fonte = contexto;
+    char linha[1024];
+    while (fgets(linha, sizeof(linha), fonte->arquivo) != NULL) {
+        linha[strcspn(linha, "\n")] = '\0';
+        if (linha[0] != '\0' && hardware_from_csv(linha, hw)) return true;
     }
-    
-    if (anos <= 0) return 0.0;
-    if (anos >= hw->vidaUtilAnos) return hw->valorCompra;
-    
-    return (hw->valorCompra / hw->vidaUtilAnos) * anos;
+    return false;
+}
+
+static void imprimir_registro_ordenado(void* contexto, const Hardware* hw) {
+    char* str = hardware_to_string(hw);
+    if (str) {
+        printf("%s\n", str);
+        mem_liberar(str);
+    }
+    (*(long*)contexto)++;
+}
+
+// Listagem por data com ordenação externa. No modo sob demanda os registros vêm direto do CSV,
+// então o inventário nunca precisa caber inteiro na memória.
+void sistema_listar_ordenado_externo(SistemaInventario* sistema, ChaveOrdenacao chave, size_t orcamentoBytes) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    if (sistema == NULL) return;
+
+    FonteVersao fonteVersao = { NULL, 0 };
+    FonteCsv fonteCsv = { NULL };
+    FonteRegistros fonte = fonte_versao;
+    void* contextoFonte = &fonteVersao;
+    if (!sistema->inventarioCarregado && sistema->arquivoOrigem != NULL) {
+        char cabecalho[1024];
+        fonteCsv.arquivo = fopen(sistema->arquivoOrigem, "r");
+        if (fonteCsv.arquivo == NULL || fgets(cabecalho, sizeof(cabecalho), fonteCsv.arquivo) == NULL) {
+            if (fonteCsv.arquivo) fclose(fonteCsv.arquivo);
+            fprintf(stderr, "Falha ao abrir %s para ordenação externa.\n", sistema->arquivoOrigem);
+            return;
+        }
+        fonte = fonte_csv;
+        contextoFonte = &fonteCsv;
+    } else {
+        fonteVersao.versao = sistema_obter_versao(sistema);
+        if (fonteVersao.versao == NULL) return;
+    }
+
+    if (chave == ORDENAR_DATA_COMPRA) {
+        printf("=== EQUIPAMENTOS ORDENADOS POR DATA DE COMPRA ===\n");
+    } else {
+        printf("=== EQUIPAMENTOS ORDENADOS POR DATA DE MANUTENÇÃO ===\n");
+    }
+
+    long impressos = 0;
+    EstatisticaOrdenacaoExterna estatistica;
+    bool ok = ordenacao_externa(fonte, contextoFonte, chave, orcamentoBytes, imprimir_registro_ordenado, &impressos, &estatistica);
+    if (fonteCsv.arquivo) fclose(fonteCsv.arquivo);
+    versao_liberar(fonteVersao.versao);
+
+    if (!ok) {
+        fprintf(stderr, "Falha na ordenação externa (memória ou arquivo temporário).\n");
+    } else if (impressos == 0) {
+        printf("Nenhum equipamento para listar.\n");
+    }
+    printf("Registros: %ld | Runs em disco: %d | Passadas de intercalação: %d\n",
+           estatistica.registros, estatistica.runs, estatistica.passadas);
+
+    cronometro_parar(&crono);
+    cronometro_definir_registros(estatistica.registros);
+    cronometro_imprimir("Listagem com ordenação externa", &crono);
+}
+
+// ---------- Relatórios sobre o índice (modo sob demanda) ----------
+// Enquanto só o índice está residente, depreciação, obsoletos e manutenção pendente filtram e somam
+// pelas entradas do índice e leem do CSV apenas o nome das linhas impressas, sem carregar a lista.
+// Cada função devolve false, sem imprimir nada, quando o inventário já está residente. As linhas são
+// montadas num buffer com as travas e impressas depois delas, para um terminal lento não segurar o escritor.
+
+// Com true, o chamador fica com as travas: estruturas em modo de leitura mantêm o índice (só o escritor
+// o descarta) e leituraIndice protege a posição do arquivo, que as leituras movem
+static bool sistema_travar_indice(SistemaInventario* sistema) {
+    if (sistema->inventarioCarregado) return false;
+
+    pthread_rwlock_rdlock(&sistema->estruturas);
+    if (!sistema->inventarioCarregado && sistema->indice.arquivo != NULL) {
+        pthread_mutex_lock(&sistema->leituraIndice);
+        return true;
+    }
+    pthread_rwlock_unlock(&sistema->estruturas);
+    return false;
+}
+
+static void sistema_destravar_indice(SistemaInventario* sistema) {
+    pthread_mutex_unlock(&sistema->leituraIndice);
+    pthread_rwlock_unlock(&sistema->estruturas);
+}
+
+// Imprime o que foi montado com as travas; false se alguma linha não coube no buffer
+static bool sistema_imprimir_indice(TextoBuffer* saida, bool completo) {
+    if (completo && saida->dados) fwrite(saida->dados, 1, saida->tamanho, stdout);
+    texto_buffer_liberar(saida);
+    if (!completo) fprintf(stderr, "Memória insuficiente para o relatório.\n");
+    return completo;
+}
+
+static const char* indice_nome(IndiceInventario* indice, int posicao, Hardware* linha) {
+    return indice_inventario_ler(indice, posicao, linha) ? linha->nome : "ERRO";
+}
+
+static bool sistema_depreciacao_indice(SistemaInventario* sistema, const Data* hoje) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+    if (!sistema_travar_indice(sistema)) return false;
+    IndiceInventario* indice = &sistema->indice;
+
+    TextoBuffer saida;
+    texto_buffer_init(&saida);
+    char* hojeStr = data_to_string(hoje);
+    bool completo = texto_buffer_anexar(&saida, "=== ANÁLISE DE DEPRECIAÇÃO (Data base: %s) ===\n", hojeStr ? hojeStr : "ERRO");
+    if (hojeStr) mem_liberar(hojeStr);
+
+    if (indice->tamanho == 0) {
+        sistema_destravar_indice(sistema);
+        if (sistema_imprimir_indice(&saida, completo)) printf("Nenhum equipamento para analisar.\n");
+        return true;
+    }
+
+    double total_original = 0, total_depreciado = 0;
+    for (int i = 0; completo && i < indice->tamanho; i++) {
+        const EntradaIndice* entrada = &indice->entradas[i];
+        double depreciacao = depreciacao_acumulada(entrada->valorCompra, entrada->vidaUtilAnos, &entrada->dataCompra, hoje);
+        Hardware linha;
+        completo = texto_buffer_anexar(&saida, "ID: %d | %s | Valor original: R$%.2f | Depreciação: R$%.2f | Valor atual: R$%.2f\n",
+                                       entrada->id, indice_nome(indice, i, &linha), entrada->valorCompra,
+                                       depreciacao, entrada->valorCompra - depreciacao);
+
+        total_original += entrada->valorCompra;
+        total_depreciado += depreciacao;
+    }
+    int numRegistros = indice->tamanho;
+    sistema_destravar_indice(sistema);
+    if (!sistema_imprimir_indice(&saida, completo)) return true;
+
+    printf("----------------------------------------------------------------\n");
+    printf("TOTAL | Valor original: R$%.2f | Depreciação total: R$%.2f | Valor atual total: R$%.2f\n",
+           total_original, total_depreciado, (total_original - total_depreciado));
+
+    cronometro_parar(&crono);
+    cronometro_definir_registros(numRegistros);
+    cronometro_imprimir("Análise de depreciação (índice)", &crono);
+    return true;
+}
+
+// Mesma regra do monitor, calculada na hora: o status obsoleto gravado no CSV só é atualizado quando
+// uma operação carrega a lista
+static bool sistema_obsoletos_indice(SistemaInventario* sistema, const Data* hoje) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+    if (!sistema_travar_indice(sistema)) return false;
+    IndiceInventario* indice = &sistema->indice;
+
+    TextoBuffer saida;
+    texto_buffer_init(&saida);
+    char* hojeStr = data_to_string(hoje);
+    bool completo = texto_buffer_anexar(&saida, "=== EQUIPAMENTOS OBSOLETOS (Data base: %s) ===\n", hojeStr ? hojeStr : "ERRO");
+    if (hojeStr) mem_liberar(hojeStr);
+
+    int contador = 0;
+    for (int i = 0; completo && i < indice->tamanho; i++) {
+        const EntradaIndice* entrada = &indice->entradas[i];
+        Data fim = data_obsolescencia_campos(&entrada->dataCompra, entrada->vidaUtilAnos);
+        if (data_menor_que(hoje, &fim)) continue;
+
+        Hardware linha;
+        char* dataCompraStr = data_to_string(&entrada->dataCompra);
+        completo = texto_buffer_anexar(&saida, "ID: %d | %s | Compra: %s | Vida útil: %d anos\n",
+                                       entrada->id, indice_nome(indice, i, &linha),
+                                       dataCompraStr ? dataCompraStr : "ERRO",
+                                       entrada->vidaUtilAnos);
+        if (dataCompraStr) mem_liberar(dataCompraStr);
+        contador++;
+    }
+    int numRegistros = indice->tamanho;
+    sistema_destravar_indice(sistema);
+    if (!sistema_imprimir_indice(&saida, completo)) return true;
+    printf("Total de obsoletos: %d\n", contador);
+
+    cronometro_parar(&crono);
+    cronometro_definir_registros(numRegistros);
+    cronometro_imprimir("Identificação de obsoletos (índice)", &crono);
+    return true;
+}
+
+static bool sistema_manutencao_pendente_indice(SistemaInventario* sistema, const Data* hoje, int mesesLimite) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+    if (!sistema_travar_indice(sistema)) return false;
+    IndiceInventario* indice = &sistema->indice;
+
+    TextoBuffer saida;
+    texto_buffer_init(&saida);
+    char* hojeStr = data_to_string(hoje);
+    bool completo = texto_buffer_anexar(&saida, "=== EQUIPAMENTOS COM MANUTENÇÃO PENDENTE (> %d meses, Data base: %s) ===\n",
+                                        mesesLimite, hojeStr ? hojeStr : "ERRO");
+    if (hojeStr) mem_liberar(hojeStr);
+
+    int contador = 0;
+    for (int i = 0; completo && i < indice->tamanho; i++) {
+        const EntradaIndice* entrada = &indice->entradas[i];
+        int mesesDesdeManutencao = meses_desde(&entrada->ultimaManutencao, hoje);
+        if (mesesDesdeManutencao < mesesLimite) continue;
+
+        Hardware linha;
+        char* ultimaManutencaoStr = data_to_string(&entrada->ultimaManutencao);
+        completo = texto_buffer_anexar(&saida, "ID: %d | %s | Última manutenção: %s | Meses sem manutenção: %d\n",
+                                       entrada->id, indice_nome(indice, i, &linha),
+                                       ultimaManutencaoStr ? ultimaManutencaoStr : "ERRO",
+                                       mesesDesdeManutencao);
+        if (ultimaManutencaoStr) mem_liberar(ultimaManutencaoStr);
+        contador++;
+    }
+    int numRegistros = indice->tamanho;
+    sistema_destravar_indice(sistema);
+    if (!sistema_imprimir_indice(&saida, completo)) return true;
+    printf("Total com manutenção pendente: %d\n", contador);
+
+    cronometro_parar(&crono);
+    cronometro_definir_registros(numRegistros);
+    cronometro_imprimir("Relatório de manutenção pendente (índice)", &crono);
+    return true;
 }
 
 void sistema_mostrar_analise_depreciacao(SistemaInventario* sistema, const Data* hoje) {
@@ -283,38 +974,43 @@ void sistema_mostrar_analise_depreciacao(SistemaInventario* sistema, const Data*
     cronometro_iniciar(&crono);
 
     if (sistema == NULL || hoje == NULL) return;
+    if (sistema_depreciacao_indice(sistema, hoje)) return;
+    const VersaoInventario* versao = sistema_obter_versao(sistema);
+    if (versao == NULL) return;
+    int numRegistros = versao->numRegistros;
 
     char* hojeStr = data_to_string(hoje);
     printf("=== ANÁLISE DE DEPRECIAÇÃO (Data base: %s) ===\n", hojeStr ? hojeStr : "ERRO");
-    if (hojeStr) free(hojeStr);
+    if (hojeStr) mem_liberar(hojeStr);
 
-    if (sistema->inventario.size == 0) {
+    if (numRegistros == 0) {
         printf("Nenhum equipamento para analisar.\n");
+        versao_liberar(versao);
         return;
     }
     
     double total_original = 0, total_depreciado = 0;
-    Node* current = sistema->inventario.head;
-    
-    while (current != NULL) {
-        double depreciacao = calcular_depreciacao(&current->data, hoje);
-        double valorAtual = current->data.valorCompra - depreciacao;
+    for (int i = 0; i < numRegistros; i++) {
+        const Hardware* hw = versao_registro(versao, i);
+        double depreciacao = calcular_depreciacao(hw, hoje);
+        double valorAtual = hw->valorCompra - depreciacao;
         
         printf("ID: %d | %s | Valor original: R$%.2f | Depreciação: R$%.2f | Valor atual: R$%.2f\n",
-               current->data.id, current->data.nome, current->data.valorCompra,
+               hw->id, hw->nome, hw->valorCompra,
                depreciacao, valorAtual);
         
-        total_original += current->data.valorCompra;
+        total_original += hw->valorCompra;
         total_depreciado += depreciacao;
-        current = current->next;
     }
+    versao_liberar(versao);
     
     printf("----------------------------------------------------------------\n");
     printf("TOTAL | Valor original: R$%.2f | Depreciação total: R$%.2f | Valor atual total: R$%.2f\n",
            total_original, total_depreciado, (total_original - total_depreciado));
     
-    double tempo = cronometro_parar(&crono);
-    cronometro_imprimir("Análise de depreciação", tempo);
+    cronometro_parar(&crono);
+    cronometro_definir_registros(numRegistros);
+    cronometro_imprimir("Análise de depreciação", &crono);
 }
 
 void sistema_atualizar_status_obsoleto(SistemaInventario* sistema, const Data* hoje) {
@@ -322,20 +1018,27 @@ void sistema_atualizar_status_obsoleto(SistemaInventario* sistema, const Data* h
     cronometro_iniciar(&crono);
 
     if (sistema == NULL || hoje == NULL) return;
+    pthread_mutex_lock(&sistema->escrita);
+    pthread_rwlock_wrlock(&sistema->estruturas);
+    sistema_garantir_inventario(sistema);
 
-    Node* current = sistema->inventario.head;
-    while (current != NULL) {
-        int anos = hoje->ano - current->data.dataCompra.ano;
-        if (hoje->mes < current->data.dataCompra.mes || 
-            (hoje->mes == current->data.dataCompra.mes && hoje->dia < current->data.dataCompra.dia)) {
-            anos--;
-        }
-        current->data.obsoleto = (anos >= current->data.vidaUtilAnos);
-        current = current->next;
+    // Só os equipamentos cuja data de obsolescência passou desde a última atualização são visitados
+    if (monitor_obsolescencia_avancar(&sistema->obsolescencia, &sistema->inventario, hoje) > 0) {
+        sistema_publicar(sistema, false);
     }
+    pthread_rwlock_unlock(&sistema->estruturas);
+    pthread_mutex_unlock(&sistema->escrita);
     
-    double tempo = cronometro_parar(&crono);
-    cronometro_imprimir("Atualização de status obsoleto", tempo);
+    cronometro_parar(&crono);
+    cronometro_imprimir("Atualização de status obsoleto", &crono);
+}
+
+int sistema_total_obsoletos(SistemaInventario* sistema) {
+    if (sistema == NULL) return 0;
+    pthread_rwlock_rdlock(&sistema->estruturas);
+    int total = monitor_obsolescencia_total(&sistema->obsolescencia);
+    pthread_rwlock_unlock(&sistema->estruturas);
+    return total;
 }
 
 void sistema_identificar_obsoletos(SistemaInventario* sistema, const Data* hoje) {
@@ -343,30 +1046,37 @@ void sistema_identificar_obsoletos(SistemaInventario* sistema, const Data* hoje)
     cronometro_iniciar(&crono);
 
     if (sistema == NULL || hoje == NULL) return;
+    if (sistema_obsoletos_indice(sistema, hoje)) return;
 
+    // O status é avançado antes de obter a versão, que então já traz os obsoletos marcados
     sistema_atualizar_status_obsoleto(sistema, hoje);
+    const VersaoInventario* versao = sistema_obter_versao(sistema);
+    if (versao == NULL) return;
+    int numRegistros = versao->numRegistros;
+
     char* hojeStr = data_to_string(hoje);
     printf("=== EQUIPAMENTOS OBSOLETOS (Data base: %s) ===\n", hojeStr ? hojeStr : "ERRO");
-    if (hojeStr) free(hojeStr);
+    if (hojeStr) mem_liberar(hojeStr);
     
     int contador = 0;
-    Node* current = sistema->inventario.head;
-    while (current != NULL) {
-        if (current->data.obsoleto) {
-            char* dataCompraStr = data_to_string(&current->data.dataCompra);
+    for (int i = 0; i < numRegistros; i++) {
+        const Hardware* hw = versao_registro(versao, i);
+        if (hw->obsoleto) {
+            char* dataCompraStr = data_to_string(&hw->dataCompra);
             printf("ID: %d | %s | Compra: %s | Vida útil: %d anos\n",
-                   current->data.id, current->data.nome, 
+                   hw->id, hw->nome, 
                    dataCompraStr ? dataCompraStr : "ERRO", 
-                   current->data.vidaUtilAnos);
-            if (dataCompraStr) free(dataCompraStr);
+                   hw->vidaUtilAnos);
+            if (dataCompraStr) mem_liberar(dataCompraStr);
             contador++;
         }
-        current = current->next;
     }
+    versao_liberar(versao);
     printf("Total de obsoletos: %d\n", contador);
     
-    double tempo = cronometro_parar(&crono);
-    cronometro_imprimir("Identificação de obsoletos", tempo);
+    cronometro_parar(&crono);
+    cronometro_definir_registros(numRegistros);
+    cronometro_imprimir("Identificação de obsoletos", &crono);
 }
 
 void sistema_relatorio_manutencao_pendente(SistemaInventario* sistema, const Data* hoje, int mesesLimite) {
@@ -374,34 +1084,802 @@ void sistema_relatorio_manutencao_pendente(SistemaInventario* sistema, const Dat
     cronometro_iniciar(&crono);
 
     if (sistema == NULL || hoje == NULL || mesesLimite <= 0) return;
+    if (sistema_manutencao_pendente_indice(sistema, hoje, mesesLimite)) return;
+    const VersaoInventario* versao = sistema_obter_versao(sistema);
+    if (versao == NULL) return;
+    int numRegistros = versao->numRegistros;
 
     char* hojeStr = data_to_string(hoje);
     printf("=== EQUIPAMENTOS COM MANUTENÇÃO PENDENTE (> %d meses, Data base: %s) ===\n",
            mesesLimite, hojeStr ? hojeStr : "ERRO");
-    if (hojeStr) free(hojeStr);
+    if (hojeStr) mem_liberar(hojeStr);
     
     int contador = 0;
-    Node* current = sistema->inventario.head;
-    while (current != NULL) {
-        int mesesDesdeManutencao = (hoje->ano - current->data.ultimaManutencao.ano) * 12 + 
-                                   (hoje->mes - current->data.ultimaManutencao.mes);
-        if (hoje->dia < current->data.ultimaManutencao.dia) {
+    for (int i = 0; i < numRegistros; i++) {
+        const Hardware* hw = versao_registro(versao, i);
+        int mesesDesdeManutencao = (hoje->ano - hw->ultimaManutencao.ano) * 12 + 
+                                   (hoje->mes - hw->ultimaManutencao.mes);
+        if (hoje->dia < hw->ultimaManutencao.dia) {
             mesesDesdeManutencao--;
         }
         
         if (mesesDesdeManutencao >= mesesLimite) {
-            char* ultimaManutencaoStr = data_to_string(&current->data.ultimaManutencao);
+            char* ultimaManutencaoStr = data_to_string(&hw->ultimaManutencao);
             printf("ID: %d | %s | Última manutenção: %s | Meses sem manutenção: %d\n",
-                   current->data.id, current->data.nome, 
+                   hw->id, hw->nome, 
                    ultimaManutencaoStr ? ultimaManutencaoStr : "ERRO", 
                    mesesDesdeManutencao);
-            if (ultimaManutencaoStr) free(ultimaManutencaoStr);
+            if (ultimaManutencaoStr) mem_liberar(ultimaManutencaoStr);
             contador++;
         }
-        current = current->next;
     }
+    versao_liberar(versao);
     printf("Total com manutenção pendente: %d\n", contador);
     
-    double tempo = cronometro_parar(&crono);
-    cronometro_imprimir("Relatório de manutenção pendente", tempo);
-}
\ No newline at end of file
+    cronometro_parar(&crono);
+    cronometro_definir_registros(numRegistros);
+    cronometro_imprimir("Relatório de manutenção pendente", &crono);
+}
+
+// Mesmo relatório, mas consultando a agenda: custo proporcional aos equipamentos vencidos
+void sistema_relatorio_manutencao_pendente_agenda(SistemaInventario* sistema, const Data* hoje, int mesesLimite) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    if (sistema == NULL || hoje == NULL || mesesLimite <= 0) return;
+    // Sob demanda não há agenda; a varredura do índice dispensa carregar a lista para montá-la
+    if (sistema_manutencao_pendente_indice(sistema, hoje, mesesLimite)) return;
+    sistema_garantir_carregado(sistema);
+
+    char* hojeStr = data_to_string(hoje);
+    printf("=== EQUIPAMENTOS COM MANUTENÇÃO PENDENTE (> %d meses, Data base: %s) ===\n",
+           mesesLimite, hojeStr ? hojeStr : "ERRO");
+    if (hojeStr) mem_liberar(hojeStr);
+
+    // Os nós devolvidos pela agenda são da lista viva: a trava de leitura vale até a impressão
+    pthread_rwlock_rdlock(&sistema->estruturas);
+    int numRegistros = sistema->inventario.size;
+    Node** vencidos;
+    int contador = agenda_manutencao_vencidos(&sistema->agendaManutencao, hoje, mesesLimite, &vencidos);
+    if (contador < 0) {
+        pthread_rwlock_unlock(&sistema->estruturas);
+        fprintf(stderr, "Memória insuficiente para consultar a agenda de manutenção.\n");
+        return;
+    }
+
+    for (int i = 0; i < contador; i++) {
+        const Hardware* hw = &vencidos[i]->data;
+        char* ultimaManutencaoStr = data_to_string(&hw->ultimaManutencao);
+        printf("ID: %d | %s | Última manutenção: %s | Meses sem manutenção: %d\n",
+               hw->id, hw->nome,
+               ultimaManutencaoStr ? ultimaManutencaoStr : "ERRO",
+               meses_desde(&hw->ultimaManutencao, hoje));
+        if (ultimaManutencaoStr) mem_liberar(ultimaManutencaoStr);
+    }
+    pthread_rwlock_unlock(&sistema->estruturas);
+    mem_liberar(vencidos);
+    printf("Total com manutenção pendente: %d\n", contador);
+
+    cronometro_parar(&crono);
+    cronometro_definir_registros(numRegistros);
+    cronometro_imprimir("Relatório de manutenção pendente (agenda)", &crono);
+}
+
+void sistema_relatorio_proximas_manutencoes(SistemaInventario* sistema, const Data* hoje, int mesesLimite, int quantidade) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    if (sistema == NULL || hoje == NULL || mesesLimite <= 0 || quantidade <= 0) return;
+    sistema_garantir_carregado(sistema);
+
+    char* hojeStr = data_to_string(hoje);
+    printf("=== PRÓXIMAS %d MANUTENÇÕES A VENCER (limite %d meses, Data base: %s) ===\n",
+           quantidade, mesesLimite, hojeStr ? hojeStr : "ERRO");
+    if (hojeStr) mem_liberar(hojeStr);
+
+    pthread_rwlock_rdlock(&sistema->estruturas);
+    Node** proximos;
+    int encontrados = agenda_manutencao_proximos(&sistema->agendaManutencao, hoje, mesesLimite, quantidade, &proximos);
+    if (encontrados < 0) {
+        pthread_rwlock_unlock(&sistema->estruturas);
+        fprintf(stderr, "Memória insuficiente para consultar a agenda de manutenção.\n");
+        return;
+    }
+
+    for (int i = 0; i < encontrados; i++) {
+        const Hardware* hw = &proximos[i]->data;
+        Data vencimento = data_vencimento_manutencao(&hw->ultimaManutencao, mesesLimite);
+        char* ultimaManutencaoStr = data_to_string(&hw->ultimaManutencao);
+        char* vencimentoStr = data_to_string(&vencimento);
+        printf("ID: %d | %s | Última manutenção: %s | Vence em: %s\n",
+               hw->id, hw->nome,
+               ultimaManutencaoStr ? ultimaManutencaoStr : "ERRO",
+               vencimentoStr ? vencimentoStr : "ERRO");
+        if (ultimaManutencaoStr) mem_liberar(ultimaManutencaoStr);
+        if (vencimentoStr) mem_liberar(vencimentoStr);
+    }
+    pthread_rwlock_unlock(&sistema->estruturas);
+    mem_liberar(proximos);
+    printf("Total listado: %d\n", encontrados);
+
+    cronometro_parar(&crono);
+    cronometro_imprimir("Próximas manutenções", &crono);
+}
+
+// Relatórios paralelos: o inventário é dividido em partes contíguas, cada parte
+// formata suas linhas num buffer próprio e os buffers são impressos na ordem da lista.
+#define ITENS_MINIMOS_POR_PARTE 512
+
+typedef struct {
+    const VersaoInventario* versao;
+    const Hardware** itens;
+    int numItens;
+    int numPartes;
+    TextoBuffer* saidas;
+    const Data* hoje;
+    int mesesLimite;
+    double* depreciacoes;
+    int* contadores;
+    bool* falhas;           // parte cujo buffer não pôde crescer; o relatório não é impresso
+} RelatorioParalelo;
+
+// Os itens apontam para os registros da versão, que o relatório mantém até relatorio_paralelo_liberar
+static bool relatorio_paralelo_init(RelatorioParalelo* rel, SistemaInventario* sistema, const Data* hoje) {
+    memset(rel, 0, sizeof(*rel));
+    rel->hoje = hoje;
+    rel->versao = sistema_obter_versao(sistema);
+    if (!rel->versao) return false;
+    rel->numItens = rel->versao->numRegistros;
+
+    rel->itens = versao_coletar_itens(rel->versao);
+    if (!rel->itens) {
+        versao_liberar(rel->versao);
+        return false;
+    }
+
+    int maxPartes = threadpool_num_threads(sistema->pool) * 4;
+    rel->numPartes = rel->numItens / ITENS_MINIMOS_POR_PARTE;
+    if (rel->numPartes > maxPartes) rel->numPartes = maxPartes;
+    if (rel->numPartes < 1) rel->numPartes = 1;
+
+    rel->saidas = mem_alocar(MEMORIA_TEMPORARIA, sizeof(TextoBuffer) * rel->numPartes);
+    rel->contadores = mem_alocar_zerado(MEMORIA_TEMPORARIA, rel->numPartes, sizeof(int));
+    rel->falhas = mem_alocar_zerado(MEMORIA_TEMPORARIA, rel->numPartes, sizeof(bool));
+    if (!rel->saidas || !rel->contadores || !rel->falhas) {
+        versao_liberar(rel->versao);
+        mem_liberar(rel->itens);
+        mem_liberar(rel->saidas);
+        mem_liberar(rel->contadores);
+        mem_liberar(rel->falhas);
+        return false;
+    }
+    for (int p = 0; p < rel->numPartes; p++) {
+        texto_buffer_init(&rel->saidas[p]);
+    }
+    return true;
+}
+
+static void relatorio_paralelo_intervalo(const RelatorioParalelo* rel, int parte, int* inicio, int* fim) {
+    *inicio = (int)((long long)rel->numItens * parte / rel->numPartes);
+    *fim = (int)((long long)rel->numItens * (parte + 1) / rel->numPartes);
+}
+
+// -1, sem imprimir nada, se alguma parte falhou: uma parte incompleta sumiria do relatório sem aviso
+static int relatorio_paralelo_imprimir(const RelatorioParalelo* rel) {
+    for (int p = 0; p < rel->numPartes; p++) {
+        if (rel->falhas[p]) return -1;
+    }
+    int total = 0;
+    for (int p = 0; p < rel->numPartes; p++) {
+        if (rel->saidas[p].dados) {
+            fwrite(rel->saidas[p].dados, 1, rel->saidas[p].tamanho, stdout);
+        }
+        total += rel->contadores[p];
+    }
+    return total;
+}
+
+static void relatorio_paralelo_liberar(RelatorioParalelo* rel) {
+    for (int p = 0; p < rel->numPartes; p++) {
+        texto_buffer_liberar(&rel->saidas[p]);
+    }
+    mem_liberar(rel->saidas);
+    mem_liberar(rel->contadores);
+    mem_liberar(rel->falhas);
+    mem_liberar(rel->depreciacoes);
+    mem_liberar(rel->itens);
+    versao_liberar(rel->versao);
+}
+
+static void tarefa_depreciacao(void* contexto, int parte) {
+    RelatorioParalelo* rel = (RelatorioParalelo*)contexto;
+    int inicio, fim;
+    relatorio_paralelo_intervalo(rel, parte, &inicio, &fim);
+
+    for (int i = inicio; i < fim; i++) {
+        const Hardware* hw = rel->itens[i];
+        double depreciacao = calcular_depreciacao(hw, rel->hoje);
+        rel->depreciacoes[i] = depreciacao;
+
+        if (!texto_buffer_anexar(&rel->saidas[parte],
+                                 "ID: %d | %s | Valor original: R$%.2f | Depreciação: R$%.2f | Valor atual: R$%.2f\n",
+                                 hw->id, hw->nome, hw->valorCompra, depreciacao, hw->valorCompra - depreciacao)) {
+            rel->falhas[parte] = true;
+            return;
+        }
+    }
+}
+
+void sistema_mostrar_analise_depreciacao_paralela(SistemaInventario* sistema, const Data* hoje) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    if (sistema == NULL || hoje == NULL) return;
+    if (sistema_depreciacao_indice(sistema, hoje)) return;
+
+    char* hojeStr = data_to_string(hoje);
+    printf("=== ANÁLISE DE DEPRECIAÇÃO (Data base: %s) ===\n", hojeStr ? hojeStr : "ERRO");
+    if (hojeStr) mem_liberar(hojeStr);
+
+    RelatorioParalelo rel;
+    if (!relatorio_paralelo_init(&rel, sistema, hoje)) {
+        fprintf(stderr, "Memória insuficiente para o relatório paralelo.\n");
+        return;
+    }
+    int numRegistros = rel.numItens;
+    if (numRegistros == 0) {
+        relatorio_paralelo_liberar(&rel);
+        printf("Nenhum equipamento para analisar.\n");
+        return;
+    }
+    rel.depreciacoes = mem_alocar(MEMORIA_TEMPORARIA, sizeof(double) * rel.numItens);
+    if (!rel.depreciacoes) {
+        relatorio_paralelo_liberar(&rel);
+        fprintf(stderr, "Memória insuficiente para o relatório paralelo.\n");
+        return;
+    }
+
+    threadpool_executar(sistema->pool, rel.numPartes, tarefa_depreciacao, &rel);
+    if (relatorio_paralelo_imprimir(&rel) < 0) {
+        relatorio_paralelo_liberar(&rel);
+        fprintf(stderr, "Memória insuficiente para o relatório paralelo.\n");
+        return;
+    }
+
+    // Os totais são somados na ordem da lista para reproduzir exatamente o arredondamento da versão serial
+    double total_original = 0, total_depreciado = 0;
+    for (int i = 0; i < rel.numItens; i++) {
+        total_original += rel.itens[i]->valorCompra;
+        total_depreciado += rel.depreciacoes[i];
+    }
+    relatorio_paralelo_liberar(&rel);
+
+    printf("----------------------------------------------------------------\n");
+    printf("TOTAL | Valor original: R$%.2f | Depreciação total: R$%.2f | Valor atual total: R$%.2f\n",
+           total_original, total_depreciado, (total_original - total_depreciado));
+
+    cronometro_parar(&crono);
+    cronometro_definir_registros(numRegistros);
+    cronometro_imprimir("Análise de depreciação (paralela)", &crono);
+}
+
+static void tarefa_obsoletos(void* contexto, int parte) {
+    RelatorioParalelo* rel = (RelatorioParalelo*)contexto;
+    int inicio, fim;
+    relatorio_paralelo_intervalo(rel, parte, &inicio, &fim);
+
+    for (int i = inicio; i < fim; i++) {
+        const Hardware* hw = rel->itens[i];
+        if (!hw->obsoleto) continue;
+
+        char* dataCompraStr = data_to_string(&hw->dataCompra);
+        bool anexado = texto_buffer_anexar(&rel->saidas[parte], "ID: %d | %s | Compra: %s | Vida útil: %d anos\n",
+                                           hw->id, hw->nome, dataCompraStr ? dataCompraStr : "ERRO", hw->vidaUtilAnos);
+        if (dataCompraStr) mem_liberar(dataCompraStr);
+        if (!anexado) {
+            rel->falhas[parte] = true;
+            return;
+        }
+        rel->contadores[parte]++;
+    }
+}
+
+void sistema_identificar_obsoletos_paralelo(SistemaInventario* sistema, const Data* hoje) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    if (sistema == NULL || hoje == NULL) return;
+    if (sistema_obsoletos_indice(sistema, hoje)) return;
+
+    sistema_atualizar_status_obsoleto(sistema, hoje);
+    char* hojeStr = data_to_string(hoje);
+    printf("=== EQUIPAMENTOS OBSOLETOS (Data base: %s) ===\n", hojeStr ? hojeStr : "ERRO");
+    if (hojeStr) mem_liberar(hojeStr);
+
+    if (sistema_total_obsoletos(sistema) == 0) {
+        printf("Total de obsoletos: 0\n");
+        cronometro_parar(&crono);
+        cronometro_imprimir("Identificação de obsoletos (paralela)", &crono);
+        return;
+    }
+
+    RelatorioParalelo rel;
+    if (!relatorio_paralelo_init(&rel, sistema, hoje)) {
+        fprintf(stderr, "Memória insuficiente para o relatório paralelo.\n");
+        return;
+    }
+
+    threadpool_executar(sistema->pool, rel.numPartes, tarefa_obsoletos, &rel);
+    int contador = relatorio_paralelo_imprimir(&rel);
+    int numRegistros = rel.numItens;
+    relatorio_paralelo_liberar(&rel);
+    if (contador < 0) {
+        fprintf(stderr, "Memória insuficiente para o relatório paralelo.\n");
+        return;
+    }
+    printf("Total de obsoletos: %d\n", contador);
+
+    cronometro_parar(&crono);
+    cronometro_definir_registros(numRegistros);
+    cronometro_imprimir("Identificação de obsoletos (paralela)", &crono);
+}
+
+static void tarefa_manutencao_pendente(void* contexto, int parte) {
+    RelatorioParalelo* rel = (RelatorioParalelo*)contexto;
+    const Data* hoje = rel->hoje;
+    int inicio, fim;
+    relatorio_paralelo_intervalo(rel, parte, &inicio, &fim);
+
+    for (int i = inicio; i < fim; i++) {
+        const Hardware* hw = rel->itens[i];
+        int mesesDesdeManutencao = (hoje->ano - hw->ultimaManutencao.ano) * 12 +
+                                   (hoje->mes - hw->ultimaManutencao.mes);
+        if (hoje->dia < hw->ultimaManutencao.dia) {
+            mesesDesdeManutencao--;
+        }
+        if (mesesDesdeManutencao < rel->mesesLimite) continue;
+
+        char* ultimaManutencaoStr = data_to_string(&hw->ultimaManutencao);
+        bool anexado = texto_buffer_anexar(&rel->saidas[parte],
+                                           "ID: %d | %s | Última manutenção: %s | Meses sem manutenção: %d\n",
+                                           hw->id, hw->nome, ultimaManutencaoStr ? ultimaManutencaoStr : "ERRO",
+                                           mesesDesdeManutencao);
+        if (ultimaManutencaoStr) mem_liberar(ultimaManutencaoStr);
+        if (!anexado) {
+            rel->falhas[parte] = true;
+            return;
+        }
+        rel->contadores[parte]++;
+    }
+}
+
+void sistema_relatorio_manutencao_pendente_paralelo(SistemaInventario* sistema, const Data* hoje, int mesesLimite) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    if (sistema == NULL || hoje == NULL || mesesLimite <= 0) return;
+    if (sistema_manutencao_pendente_indice(sistema, hoje, mesesLimite)) return;
+
+    char* hojeStr = data_to_string(hoje);
+    printf("=== EQUIPAMENTOS COM MANUTENÇÃO PENDENTE (> %d meses, Data base: %s) ===\n",
+           mesesLimite, hojeStr ? hojeStr : "ERRO");
+    if (hojeStr) mem_liberar(hojeStr);
+
+    RelatorioParalelo rel;
+    if (!relatorio_paralelo_init(&rel, sistema, hoje)) {
+        fprintf(stderr, "Memória insuficiente para o relatório paralelo.\n");
+        return;
+    }
+    rel.mesesLimite = mesesLimite;
+
+    threadpool_executar(sistema->pool, rel.numPartes, tarefa_manutencao_pendente, &rel);
+    int contador = relatorio_paralelo_imprimir(&rel);
+    int numRegistros = rel.numItens;
+    relatorio_paralelo_liberar(&rel);
+    if (contador < 0) {
+        fprintf(stderr, "Memória insuficiente para o relatório paralelo.\n");
+        return;
+    }
+    printf("Total com manutenção pendente: %d\n", contador);
+
+    cronometro_parar(&crono);
+    cronometro_definir_registros(numRegistros);
+    cronometro_imprimir("Relatório de manutenção pendente (paralelo)", &crono);
+}
+
+bool sistema_agregar(SistemaInventario* sistema, int campos, const Data* hoje, int mesesLimite,
+                     bool paralelo, Agregacao* resultado) {
+    if (sistema == NULL || hoje == NULL || resultado == NULL) return false;
+
+    agregacao_init(resultado, campos, hoje, mesesLimite);
+    if (campos & AGRUPAR_OBSOLETO) {
+        sistema_atualizar_status_obsoleto(sistema, hoje);
+    }
+
+    const VersaoInventario* versao = sistema_obter_versao(sistema);
+    const Hardware** itens = versao ? versao_coletar_itens(versao) : NULL;
+    if (!itens) {
+        versao_liberar(versao);
+        return false;
+    }
+
+    bool ok = agregacao_executar(resultado, itens, versao->numRegistros, paralelo ? sistema->pool : NULL);
+    mem_liberar(itens);
+    versao_liberar(versao);
+    if (!ok) agregacao_liberar(resultado);
+    return ok;
+}
+
+void sistema_relatorio_agregado(SistemaInventario* sistema, int campos, const Data* hoje, int mesesLimite) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    if (sistema == NULL || hoje == NULL) return;
+
+    char* hojeStr = data_to_string(hoje);
+    printf("=== RELATÓRIO AGREGADO (Data base: %s) ===\n", hojeStr ? hojeStr : "ERRO");
+    if (hojeStr) mem_liberar(hojeStr);
+
+    Agregacao agregacao;
+    if (!sistema_agregar(sistema, campos, hoje, mesesLimite, true, &agregacao)) {
+        fprintf(stderr, "Memória insuficiente para o relatório agregado.\n");
+        return;
+    }
+    agregacao_imprimir(&agregacao);
+    agregacao_liberar(&agregacao);
+
+    cronometro_parar(&crono);
+    cronometro_definir_registros(sistema_total_registros(sistema));
+    cronometro_imprimir("Relatório agregado", &crono);
+}
+
+// A projeção é montada sob demanda e reaproveitada até o inventário mudar.
+// Montá-la altera o sistema, então a consulta toda roda com estruturas em modo de escrita.
+static bool sistema_garantir_projecao(SistemaInventario* sistema) {
+    if (sistema->projecao.construida) return true;
+    return projecao_construir(&sistema->projecao, &sistema->inventario);
+}
+
+double sistema_valor_contabil_em(SistemaInventario* sistema, const Data* data) {
+    if (sistema == NULL || data == NULL) return 0.0;
+    sistema_garantir_carregado(sistema);
+
+    pthread_rwlock_wrlock(&sistema->estruturas);
+    double valor = sistema_garantir_projecao(sistema) ? projecao_valor_em(&sistema->projecao, data) : 0.0;
+    pthread_rwlock_unlock(&sistema->estruturas);
+    return valor;
+}
+
+void sistema_mostrar_projecao_valor(SistemaInventario* sistema, const Data* hoje, int anos) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    if (sistema == NULL || hoje == NULL || anos <= 0) return;
+    sistema_garantir_carregado(sistema);
+
+    char* hojeStr = data_to_string(hoje);
+    printf("=== PROJEÇÃO DO VALOR CONTÁBIL (%d anos, Data base: %s) ===\n", anos, hojeStr ? hojeStr : "ERRO");
+    if (hojeStr) mem_liberar(hojeStr);
+
+    int numMeses = anos * 12;
+    double* valores = mem_alocar(MEMORIA_TEMPORARIA, sizeof(double) * numMeses);
+    pthread_rwlock_wrlock(&sistema->estruturas);
+    int numRegistros = sistema->inventario.size;
+    if (!valores || !sistema_garantir_projecao(sistema)) {
+        pthread_rwlock_unlock(&sistema->estruturas);
+        mem_liberar(valores);
+        fprintf(stderr, "Memória insuficiente para a projeção.\n");
+        return;
+    }
+
+    projecao_curva_mensal(&sistema->projecao, hoje->mes, hoje->ano, numMeses, valores);
+    pthread_rwlock_unlock(&sistema->estruturas);
+
+    int mes = hoje->mes, ano = hoje->ano;
+    for (int m = 0; m < numMeses; m++) {
+        printf("%02d/%04d | Valor contábil: R$%.2f\n", mes, ano, valores[m]);
+        if (++mes > 12) {
+            mes = 1;
+            ano++;
+        }
+    }
+    mem_liberar(valores);
+
+    cronometro_parar(&crono);
+    cronometro_definir_registros(numRegistros);
+    cronometro_imprimir("Projeção do valor contábil", &crono);
+}
+
+void sistema_mostrar_valor_em_data(SistemaInventario* sistema, const Data* data) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    if (sistema == NULL || data == NULL) return;
+
+    char* dataStr = data_to_string(data);
+    printf("Valor contábil em %s: R$%.2f\n", dataStr ? dataStr : "ERRO", sistema_valor_contabil_em(sistema, data));
+    if (dataStr) mem_liberar(dataStr);
+
+    cronometro_parar(&crono);
+    cronometro_imprimir("Valor contábil em data", &crono);
+}
+
+static void imprimir_baldes_por_tipo(const double* valores, const long* quantidades) {
+    for (int t = 0; t < NUM_TIPOS_HARDWARE; t++) {
+        if (quantidades[t] == 0) continue;
+        printf("    %s: %ld equipamentos | R$%.2f\n", tipo_to_string((TipoHardware)t), quantidades[t], valores[t]);
+    }
+}
+
+void sistema_previsao_substituicao(SistemaInventario* sistema, const Data* hoje, int anos) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    if (sistema == NULL || hoje == NULL || anos <= 0) return;
+    const VersaoInventario* versao = sistema_obter_versao(sistema);
+    if (versao == NULL) return;
+    int numRegistros = versao->numRegistros;
+
+    char* hojeStr = data_to_string(hoje);
+    printf("=== PREVISÃO DE SUBSTITUIÇÃO (%d anos, Data base: %s) ===\n", anos, hojeStr ? hojeStr : "ERRO");
+    if (hojeStr) mem_liberar(hojeStr);
+
+    const Hardware** itens = versao_coletar_itens(versao);
+    PrevisaoSubstituicao previsao;
+    if (!itens || !previsao_substituicao_calcular(&previsao, itens, numRegistros, hoje, anos * 12, sistema->pool)) {
+        mem_liberar(itens);
+        versao_liberar(versao);
+        fprintf(stderr, "Memória insuficiente para a previsão de substituição.\n");
+        return;
+    }
+    mem_liberar(itens);
+    versao_liberar(versao);
+
+    double acumulado = 0;
+    double totalTipo[NUM_TIPOS_HARDWARE] = {0};
+    long quantidadeTipo[NUM_TIPOS_HARDWARE] = {0};
+
+    long atrasados = 0;
+    double valorAtrasado = 0;
+    for (int t = 0; t < NUM_TIPOS_HARDWARE; t++) {
+        atrasados += previsao.atrasadoQuantidade[t];
+        valorAtrasado += previsao.atrasadoValor[t];
+        totalTipo[t] += previsao.atrasadoValor[t];
+        quantidadeTipo[t] += previsao.atrasadoQuantidade[t];
+    }
+    acumulado += valorAtrasado;
+    printf("Vida útil já encerrada | Qtd: %ld | Valor: R$%.2f | Acumulado: R$%.2f\n", atrasados, valorAtrasado, acumulado);
+    imprimir_baldes_por_tipo(previsao.atrasadoValor, previsao.atrasadoQuantidade);
+
+    int mes = previsao.mesInicial, ano = previsao.anoInicial;
+    for (int m = 0; m < previsao.numMeses; m++) {
+        const double* valores = &previsao.valores[m * NUM_TIPOS_HARDWARE];
+        const long* quantidades = &previsao.quantidades[m * NUM_TIPOS_HARDWARE];
+
+        long quantidadeMes = 0;
+        double valorMes = 0;
+        for (int t = 0; t < NUM_TIPOS_HARDWARE; t++) {
+            quantidadeMes += quantidades[t];
+            valorMes += valores[t];
+            totalTipo[t] += valores[t];
+            quantidadeTipo[t] += quantidades[t];
+        }
+        acumulado += valorMes;
+
+        printf("%02d/%04d | Qtd: %ld | Valor: R$%.2f | Acumulado: R$%.2f\n", mes, ano, quantidadeMes, valorMes, acumulado);
+        imprimir_baldes_por_tipo(valores, quantidades);
+
+        if (++mes > 12) {
+            mes = 1;
+            ano++;
+        }
+    }
+    previsao_substituicao_liberar(&previsao);
+
+    printf("----------------------------------------------------------------\n");
+    printf("TOTAL POR TIPO:\n");
+    imprimir_baldes_por_tipo(totalTipo, quantidadeTipo);
+    printf("TOTAL | Valor de substituição: R$%.2f\n", acumulado);
+
+    cronometro_parar(&crono);
+    cronometro_definir_registros(numRegistros);
+    cronometro_imprimir("Previsão de substituição", &crono);
+}
+
+// Bytes ocupados pelas estruturas do inventário, calculados a partir das capacidades atuais
+void sistema_relatorio_memoria(SistemaInventario* sistema) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    if (sistema == NULL) return;
+    pthread_rwlock_rdlock(&sistema->estruturas);
+
+    int total = sistema->inventario.size;
+    size_t bytesRegistros = (size_t)total * sizeof(Node);
+    size_t bytesTextoReservado = (size_t)total * (sizeof(((Hardware*)0)->nome) + sizeof(((Hardware*)0)->fabricante));
+    size_t bytesTextoUsado = 0;
+    for (Node* atual = sistema->inventario.head; atual != NULL; atual = atual->next) {
+        bytesTextoUsado += strlen(atual->data.nome) + 1 + strlen(atual->data.fabricante) + 1;
+    }
+
+    const AgendaManutencao* agenda = &sistema->agendaManutencao;
+    size_t bytesAgenda = (size_t)agenda->capacidade * sizeof(EntradaManutencao) +
+                         agenda->posicoes.capacidade * (sizeof(int) + sizeof(intptr_t) + 1);
+    size_t bytesObsolescencia = (size_t)sistema->obsolescencia.capacidade * sizeof(EventoObsolescencia);
+    size_t bytesProjecao = sistema->projecao.construida
+        ? (size_t)sistema->projecao.numChaves * sizeof(double) + (size_t)(sistema->projecao.numChaves + 1) * sizeof(double)
+        : 0;
+    size_t bytesIndices = bytesAgenda + bytesObsolescencia + bytesProjecao;
+
+    // Páginas compartilhadas com versões anteriores ainda em uso por leitores não entram na conta
+    const VersaoInventario* versao = publicacao_obter(&sistema->versoes);
+    int numPaginas = versao ? versao->numPaginas : 0;
+    size_t bytesVersao = versao ? (size_t)numPaginas * (sizeof(PaginaInventario) + sizeof(PaginaInventario*)) : 0;
+    versao_liberar(versao);
+
+    printf("=== USO DE MEMÓRIA (%d itens) ===\n", total);
+    printf("Registros (nós da lista):    %12zu bytes\n", bytesRegistros);
+    printf("  Textos embutidos:          %12zu bytes reservados, %zu usados (%.1f%%)\n",
+           bytesTextoReservado, bytesTextoUsado,
+           bytesTextoReservado > 0 ? 100.0 * bytesTextoUsado / bytesTextoReservado : 0.0);
+    printf("Índices:                     %12zu bytes\n", bytesIndices);
+    printf("  Agenda de manutenção:      %12zu bytes\n", bytesAgenda);
+    printf("  Monitor de obsolescência:  %12zu bytes\n", bytesObsolescencia);
+    printf("  Projeção de valor:         %12zu bytes\n", bytesProjecao);
+    if (total > 0) {
+        printf("Por item:                    %12.1f bytes\n", (double)(bytesRegistros + bytesIndices) / total);
+    }
+    printf("Versão publicada:            %12zu bytes (%d páginas)\n", bytesVersao, numPaginas);
+    if (sistema->segmento) {
+        printf("Segmento compartilhado:      %12zu bytes\n", segmento_tamanho(sistema->segmento));
+    }
+    if (!sistema->inventarioCarregado) {
+        const IndiceInventario* indice = &sistema->indice;
+        size_t bytesIndice = (size_t)indice->capacidade * sizeof(EntradaIndice) +
+                             (indice->porId.capacidade + indice->cache.capacidade) * (sizeof(int) + sizeof(intptr_t) + 1);
+        printf("Índice sob demanda:          %12zu bytes (%d itens, %zu registros lidos)\n",
+               bytesIndice + indice->cache.tamanho * sizeof(Hardware), indice->tamanho, indice->cache.tamanho);
+    }
+    pthread_rwlock_unlock(&sistema->estruturas);
+
+    EstatisticaCache cache;
+    if (repositorio_cache_estatisticas(sistema->repositorio, &cache)) {
+        long long consultas = cache.acertos + cache.falhas;
+        printf("Cache do repositório:        %zu/%zu registros | acertos: %lld | falhas: %lld (%.1f%% acertos) | invalidações: %lld\n",
+               cache.ocupacao, cache.capacidade, cache.acertos, cache.falhas,
+               consultas > 0 ? 100.0 * cache.acertos / consultas : 0.0, cache.invalidacoes);
+    }
+
+    printf("\n%-12s %12s %12s %14s %14s %16s\n", "Subsistema", "Alocações", "Liberações", "Vivos (B)", "Pico (B)", "Total (B)");
+    for (int s = 0; s < NUM_SUBSISTEMAS_MEMORIA; s++) {
+        EstatisticaMemoria estatistica;
+        memoria_obter_estatisticas((SubsistemaMemoria)s, &estatistica);
+        printf("%-12s %12lld %12lld %14lld %14lld %16lld\n", subsistema_memoria_nome((SubsistemaMemoria)s),
+               estatistica.alocacoes, estatistica.liberacoes, estatistica.bytesVivos,
+               estatistica.picoBytes, estatistica.bytesAlocados);
+    }
+
+    cronometro_definir_registros(total);
+    cronometro_parar(&crono);
+    cronometro_imprimir("Relatório de uso de memória", &crono);
+}
+
+bool sistema_exportar_colunar(SistemaInventario* sistema, const char* arquivo) {
+    if (sistema == NULL || arquivo == NULL) return false;
+    sistema_garantir_carregado(sistema);
+
+    pthread_rwlock_rdlock(&sistema->estruturas);
+    int numRegistros = sistema->inventario.size;
+    trace_inicio("Exportação colunar");
+    bool ok = colunar_exportar(&sistema->inventario, arquivo);
+    trace_fim("Exportação colunar");
+    pthread_rwlock_unlock(&sistema->estruturas);
+    if (ok) {
+        printf("%d equipamentos exportados para %s\n", numRegistros, arquivo);
+    } else {
+        fprintf(stderr, "Falha ao exportar para %s\n", arquivo);
+    }
+    return ok;
+}
+
+// Os relatórios colunares leem só as colunas que usam; nomes saem direto da área de textos
+void sistema_mostrar_analise_depreciacao_colunar(const TabelaColunar* tabela, const Data* hoje) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    if (tabela == NULL || hoje == NULL) return;
+
+    char* hojeStr = data_to_string(hoje);
+    printf("=== ANÁLISE DE DEPRECIAÇÃO (Data base: %s) ===\n", hojeStr ? hojeStr : "ERRO");
+    if (hojeStr) mem_liberar(hojeStr);
+
+    if (tabela->numLinhas == 0) {
+        printf("Nenhum equipamento para analisar.\n");
+        return;
+    }
+
+    double total_original = 0, total_depreciado = 0;
+    for (int64_t i = 0; i < tabela->numLinhas; i++) {
+        Data dataCompra = colunar_data(tabela->dataCompra[i]);
+        double valorCompra = tabela->valorCompra[i];
+        double depreciacao = depreciacao_acumulada(valorCompra, tabela->vidaUtilAnos[i], &dataCompra, hoje);
+        int tamanhoNome;
+        const char* nome = colunar_texto(tabela->nomeOffsets, tabela->nomeDados, i, &tamanhoNome);
+
+        printf("ID: %d | %.*s | Valor original: R$%.2f | Depreciação: R$%.2f | Valor atual: R$%.2f\n",
+               tabela->id[i], tamanhoNome, nome, valorCompra, depreciacao, valorCompra - depreciacao);
+
+        total_original += valorCompra;
+        total_depreciado += depreciacao;
+    }
+
+    printf("----------------------------------------------------------------\n");
+    printf("TOTAL | Valor original: R$%.2f | Depreciação total: R$%.2f | Valor atual total: R$%.2f\n",
+           total_original, total_depreciado, (total_original - total_depreciado));
+
+    cronometro_parar(&crono);
+    cronometro_definir_registros(tabela->numLinhas);
+    cronometro_imprimir("Análise de depreciação (colunar)", &crono);
+}
+
+// Mesma regra do monitor de obsolescência, pela mesma função
+void sistema_identificar_obsoletos_colunar(const TabelaColunar* tabela, const Data* hoje) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    if (tabela == NULL || hoje == NULL) return;
+
+    char* hojeStr = data_to_string(hoje);
+    printf("=== EQUIPAMENTOS OBSOLETOS (Data base: %s) ===\n", hojeStr ? hojeStr : "ERRO");
+    if (hojeStr) mem_liberar(hojeStr);
+
+    int contador = 0;
+    for (int64_t i = 0; i < tabela->numLinhas; i++) {
+        Data dataCompra = colunar_data(tabela->dataCompra[i]);
+        Data fim = data_obsolescencia_campos(&dataCompra, tabela->vidaUtilAnos[i]);
+        if (data_menor_que(hoje, &fim)) continue;
+
+        int tamanhoNome;
+        const char* nome = colunar_texto(tabela->nomeOffsets, tabela->nomeDados, i, &tamanhoNome);
+        printf("ID: %d | %.*s | Compra: %02d/%02d/%04d | Vida útil: %d anos\n",
+               tabela->id[i], tamanhoNome, nome, dataCompra.dia, dataCompra.mes, dataCompra.ano,
+               tabela->vidaUtilAnos[i]);
+        contador++;
+    }
+    printf("Total de obsoletos: %d\n", contador);
+
+    cronometro_parar(&crono);
+    cronometro_definir_registros(tabela->numLinhas);
+    cronometro_imprimir("Identificação de obsoletos (colunar)", &crono);
+}
+
+void sistema_relatorio_manutencao_pendente_colunar(const TabelaColunar* tabela, const Data* hoje, int mesesLimite) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    if (tabela == NULL || hoje == NULL || mesesLimite <= 0) return;
+
+    char* hojeStr = data_to_string(hoje);
+    printf("=== EQUIPAMENTOS COM MANUTENÇÃO PENDENTE (> %d meses, Data base: %s) ===\n",
+           mesesLimite, hojeStr ? hojeStr : "ERRO");
+    if (hojeStr) mem_liberar(hojeStr);
+
+    int contador = 0;
+    for (int64_t i = 0; i < tabela->numLinhas; i++) {
+        Data ultimaManutencao = colunar_data(tabela->ultimaManutencao[i]);
+        int mesesDesdeManutencao = meses_desde(&ultimaManutencao, hoje);
+        if (mesesDesdeManutencao < mesesLimite) continue;
+
+        int tamanhoNome;
+        const char* nome = colunar_texto(tabela->nomeOffsets, tabela->nomeDados, i, &tamanhoNome);
+        printf("ID: %d | %.*s | Última manutenção: %02d/%02d/%04d | Meses sem manutenção: %d\n",
+               tabela->id[i], tamanhoNome, nome, ultimaManutencao.dia, ultimaManutencao.mes, ultimaManutencao.ano,
+               mesesDesdeManutencao);
+        contador++;
+    }
+    printf("Total com manutenção pendente: %d\n", contador);
+
+    cronometro_parar(&crono);
+    cronometro_definir_registros(tabela->numLinhas);
+    cronometro_imprimir("Relatório de manutenção pendente (colunar)", &crono);
+}
@@ -0,0 +1,455 @@
+#include "snapshot.h"
+#include "mapaInt.h"
+#include "memoria.h"
+#include "trace.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#define SNAPSHOT_VERSAO 1
+#define SNAPSHOT_MARCADOR 0x01020304u      // detecta imagem gravada com outra ordem de bytes
+
+typedef struct {
+    char magica[8];
+    uint32_t versao;
+    uint32_t marcador;
+    int64_t tamanhoOrigem;
+    int64_t modificacaoOrigem;
+    uint64_t checksumOrigem;
+    uint64_t checksumConteudo;
+    int32_t numItens;
+    int32_t proximoId;
+    int32_t tamanhoAgenda;
+    int32_t proximaSequencia;
+    uint32_t tamanhoTextos;
+    uint32_t reservado;
+} CabecalhoSnapshot;
+
+// Nome e fabricante viram deslocamentos na área de textos, onde cada string aparece uma vez
+typedef struct {
+    int32_t id;
+    int32_t tipo;
+    Data dataCompra;
+    Data ultimaManutencao;
+    double valorCompra;
+    int32_t vidaUtilAnos;
+    int32_t obsoleto;
+    uint32_t nome;
+    uint32_t fabricante;
+} RegistroSnapshot;
+
+// Entrada do heap da agenda, com o nó trocado pela posição do item na lista
+typedef struct {
+    int32_t posicao;
+    int32_t sequencia;
+} EntradaSnapshot;
+
+static const char MAGICA_SNAPSHOT[8] = {'I', 'N', 'V', 'S', 'N', 'A', 'P', '\0'};
+
+// Hash de 64 bits processando 8 bytes por vez; blocos intermediários devem ter tamanho múltiplo de 8
+static uint64_t checksum_bloco(uint64_t hash, const unsigned char* dados, size_t tamanho) {
+    while (tamanho >= 8) {
+        uint64_t palavra;
+        memcpy(&palavra, dados, 8);
+        hash = (hash ^ palavra) * 0x100000001b3ULL;
+        hash ^= hash >> 29;
+        dados += 8;
+        tamanho -= 8;
+    }
+    while (tamanho-- > 0) {
+        hash = (hash ^ *dados++) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+#define CHECKSUM_INICIAL 0xcbf29ce484222325ULL
+
+static bool checksum_arquivo(const char* caminho, uint64_t* checksum) {
+    FILE* arquivo = fopen(caminho, "rb");
+    if (!arquivo) return false;
+
+    unsigned char* bloco = mem_alocar(MEMORIA_TEMPORARIA, 1 << 16);
+    if (!bloco) {
+        fclose(arquivo);
+        return false;
+    }
+
+    uint64_t hash = CHECKSUM_INICIAL;
+    size_t lidos;
+    while ((lidos = fread(bloco, 1, 1 << 16, arquivo)) > 0) {
+        hash = checksum_bloco(hash, bloco, lidos);
+    }
+    bool ok = !ferror(arquivo);
+
+    mem_liberar(bloco);
+    fclose(arquivo);
+    *checksum = hash;
+    return ok;
+}
+
+static bool metadados_origem(const char* caminho, int64_t* tamanho, int64_t* modificacao) {
+    struct stat info;
+    if (stat(caminho, &info) != 0) return false;
+    *tamanho = (int64_t)info.st_size;
+#ifdef __linux__
+    // Em nanossegundos: uma edição no mesmo segundo da gravação também muda a data
+    *modificacao = (int64_t)info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec;
+#else
+    *modificacao = (int64_t)info.st_mtime;
+#endif
+    return true;
+}
+
+// Área de textos com tabela de internação (deslocamento + 1, zero marca posição livre)
+typedef struct {
+    char* dados;
+    size_t tamanho;
+    size_t capacidade;
+    uint32_t* tabela;
+    size_t capacidadeTabela;
+} TextosInternados;
+
+static uint32_t hash_texto(const char* texto) {
+    uint32_t hash = 2166136261u;
+    while (*texto) {
+        hash = (hash ^ (unsigned char)*texto++) * 16777619u;
+    }
+    return hash;
+}
+
+static bool textos_init(TextosInternados* textos, int numItens) {
+    textos->capacidadeTabela = 64;
+    while (textos->capacidadeTabela < (size_t)numItens * 4) textos->capacidadeTabela *= 2;
+
+    textos->tabela = mem_alocar_zerado(MEMORIA_TEMPORARIA, textos->capacidadeTabela, sizeof(uint32_t));
+    textos->dados = NULL;
+    textos->tamanho = 0;
+    textos->capacidade = 0;
+    return textos->tabela != NULL;
+}
+
+static void textos_liberar(TextosInternados* textos) {
+    mem_liberar(textos->dados);
+    mem_liberar(textos->tabela);
+}
+
+// Cada item contribui com no máximo duas strings, então a tabela (4 posições por item) nunca enche
+static bool textos_internar(TextosInternados* textos, const char* texto, uint32_t* deslocamento) {
+    size_t mascara = textos->capacidadeTabela - 1;
+    size_t i = hash_texto(texto) & mascara;
+    while (textos->tabela[i] != 0) {
+        uint32_t existente = textos->tabela[i] - 1;
+        if (strcmp(textos->dados + existente, texto) == 0) {
+            *deslocamento = existente;
+            return true;
+        }
+        i = (i + 1) & mascara;
+    }
+
+    size_t comprimento = strlen(texto) + 1;
+    if (textos->tamanho + comprimento > textos->capacidade) {
+        size_t novaCapacidade = textos->capacidade ? textos->capacidade * 2 : 4096;
+        while (novaCapacidade < textos->tamanho + comprimento) novaCapacidade *= 2;
+        if (novaCapacidade >= UINT32_MAX) return false;
+
+        char* novo = mem_realocar(MEMORIA_TEMPORARIA, textos->dados, novaCapacidade);
+        if (!novo) return false;
+        textos->dados = novo;
+        textos->capacidade = novaCapacidade;
+    }
+
+    *deslocamento = (uint32_t)textos->tamanho;
+    memcpy(textos->dados + textos->tamanho, texto, comprimento);
+    textos->tamanho += comprimento;
+    textos->tabela[i] = *deslocamento + 1;
+    return true;
+}
+
+static bool escrever_tudo(FILE* arquivo, const void* dados, size_t tamanho) {
+    return tamanho == 0 || fwrite(dados, 1, tamanho, arquivo) == tamanho;
+}
+
+bool snapshot_gravar(const char* arquivoImagem, const char* arquivoOrigem, const SistemaInventario* sistema) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    if (arquivoImagem == NULL || arquivoOrigem == NULL || sistema == NULL) return false;
+
+    CabecalhoSnapshot cabecalho;
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    memcpy(cabecalho.magica, MAGICA_SNAPSHOT, sizeof(cabecalho.magica));
+    cabecalho.versao = SNAPSHOT_VERSAO;
+    cabecalho.marcador = SNAPSHOT_MARCADOR;
+    if (!metadados_origem(arquivoOrigem, &cabecalho.tamanhoOrigem, &cabecalho.modificacaoOrigem) ||
+        !checksum_arquivo(arquivoOrigem, &cabecalho.checksumOrigem)) {
+        cronometro_parar(&crono);
+        cronometro_imprimir("Snapshot - Gravar (origem inacessível)", &crono);
+        return false;
+    }
+
+    const AgendaManutencao* agenda = &sistema->agendaManutencao;
+    int numItens = sistema->inventario.size;
+    cabecalho.numItens = numItens;
+    cabecalho.proximoId = sistema->proximoId;
+    cabecalho.tamanhoAgenda = agenda->tamanho;
+    cabecalho.proximaSequencia = agenda->proximaSequencia;
+
+    RegistroSnapshot* registros = mem_alocar(MEMORIA_TEMPORARIA, sizeof(RegistroSnapshot) * (numItens > 0 ? numItens : 1));
+    EntradaSnapshot* entradas = mem_alocar(MEMORIA_TEMPORARIA, sizeof(EntradaSnapshot) * (agenda->tamanho > 0 ? agenda->tamanho : 1));
+    MapaInt posicoes;
+    mapa_int_init(&posicoes);
+    TextosInternados textos;
+    bool ok = registros && entradas && textos_init(&textos, numItens) && mapa_int_reservar(&posicoes, numItens);
+
+    int i = 0;
+    for (Node* atual = sistema->inventario.head; ok && atual != NULL; atual = atual->next, i++) {
+        const Hardware* hw = &atual->data;
+        RegistroSnapshot* registro = &registros[i];
+        memset(registro, 0, sizeof(*registro));
+        registro->id = hw->id;
+        registro->tipo = hw->tipo;
+        registro->dataCompra = hw->dataCompra;
+        registro->ultimaManutencao = hw->ultimaManutencao;
+        registro->valorCompra = hw->valorCompra;
+        registro->vidaUtilAnos = hw->vidaUtilAnos;
+        registro->obsoleto = hw->obsoleto;
+        ok = textos_internar(&textos, hw->nome, &registro->nome) &&
+             textos_internar(&textos, hw->fabricante, &registro->fabricante) &&
+             mapa_int_inserir(&posicoes, hw->id, i);
+    }
+
+    for (int j = 0; ok && j < agenda->tamanho; j++) {
+        intptr_t posicao;
+        ok = mapa_int_buscar(&posicoes, agenda->heap[j].no->data.id, &posicao);
+        entradas[j].posicao = (int32_t)posicao;
+        entradas[j].sequencia = agenda->heap[j].sequencia;
+    }
+
+    char* arquivoTemporario = NULL;
+    if (ok) {
+        cabecalho.tamanhoTextos = (uint32_t)textos.tamanho;
+        uint64_t hash = checksum_bloco(CHECKSUM_INICIAL, (const unsigned char*)registros, sizeof(RegistroSnapshot) * numItens);
+        hash = checksum_bloco(hash, (const unsigned char*)entradas, sizeof(EntradaSnapshot) * agenda->tamanho);
+        cabecalho.checksumConteudo = checksum_bloco(hash, (const unsigned char*)textos.dados, textos.tamanho);
+
+        // Grava num arquivo temporário e renomeia, para nunca deixar uma imagem pela metade
+        size_t tamanhoNome = strlen(arquivoImagem) + 5;
+        arquivoTemporario = mem_alocar(MEMORIA_TEMPORARIA, tamanhoNome);
+        ok = arquivoTemporario != NULL;
+        if (ok) snprintf(arquivoTemporario, tamanhoNome, "%s.tmp", arquivoImagem);
+    }
+
+    if (ok) {
+        trace_inicio("Snapshot: escrita");
+        FILE* arquivo = fopen(arquivoTemporario, "wb");
+        ok = arquivo != NULL &&
+             escrever_tudo(arquivo, &cabecalho, sizeof(cabecalho)) &&
+             escrever_tudo(arquivo, registros, sizeof(RegistroSnapshot) * numItens) &&
+             escrever_tudo(arquivo, entradas, sizeof(EntradaSnapshot) * agenda->tamanho) &&
+             escrever_tudo(arquivo, textos.dados, textos.tamanho);
+        if (arquivo && fclose(arquivo) != 0) ok = false;
+        trace_fim("Snapshot: escrita");
+
+        if (ok && rename(arquivoTemporario, arquivoImagem) != 0) {
+            // No Windows rename não substitui um arquivo existente
+            remove(arquivoImagem);
+            ok = rename(arquivoTemporario, arquivoImagem) == 0;
+        }
+        if (!ok) remove(arquivoTemporario);
+    }
+
+    mem_liberar(arquivoTemporario);
+    if (registros && entradas) textos_liberar(&textos);
+    mapa_int_destruir(&posicoes);
+    mem_liberar(entradas);
+    mem_liberar(registros);
+
+    cronometro_parar(&crono);
+    cronometro_definir_registros(numItens);
+    cronometro_imprimir(ok ? "Gravar snapshot" : "Snapshot - Gravar (falha)", &crono);
+    return ok;
+}
+
+// Mapeia a imagem para leitura; no Windows ela é lida inteira para um buffer
+static const unsigned char* mapear_imagem(const char* caminho, size_t* tamanho) {
+#ifdef _WIN32
+    FILE* arquivo = fopen(caminho, "rb");
+    if (!arquivo) return NULL;
+
+    unsigned char* dados = NULL;
+    long fim;
+    if (fseek(arquivo, 0, SEEK_END) == 0 && (fim = ftell(arquivo)) > 0 && fseek(arquivo, 0, SEEK_SET) == 0) {
+        dados = mem_alocar(MEMORIA_TEMPORARIA, (size_t)fim);
+        if (dados && fread(dados, 1, (size_t)fim, arquivo) != (size_t)fim) {
+            mem_liberar(dados);
+            dados = NULL;
+        }
+        *tamanho = (size_t)fim;
+    }
+    fclose(arquivo);
+    return dados;
+#else
+    int descritor = open(caminho, O_RDONLY);
+    if (descritor < 0) return NULL;
+
+    struct stat info;
+    void* dados = MAP_FAILED;
+    if (fstat(descritor, &info) == 0 && info.st_size > 0) {
+        *tamanho = (size_t)info.st_size;
+        dados = mmap(NULL, *tamanho, PROT_READ, MAP_PRIVATE, descritor, 0);
+    }
+    close(descritor);
+    return dados == MAP_FAILED ? NULL : dados;
+#endif
+}
+
+static void desmapear_imagem(const unsigned char* dados, size_t tamanho) {
+#ifdef _WIN32
+    (void)tamanho;
+    mem_liberar((void*)dados);
+#else
+    munmap((void*)dados, tamanho);
+#endif
+}
+
+// Confere cabeçalho, tamanhos e checksum do conteúdo; a origem é conferida à parte
+static bool imagem_valida(const unsigned char* dados, size_t tamanho) {
+    if (tamanho < sizeof(CabecalhoSnapshot)) return false;
+
+    const CabecalhoSnapshot* cabecalho = (const CabecalhoSnapshot*)dados;
+    if (memcmp(cabecalho->magica, MAGICA_SNAPSHOT, sizeof(cabecalho->magica)) != 0 ||
+        cabecalho->versao != SNAPSHOT_VERSAO || cabecalho->marcador != SNAPSHOT_MARCADOR) {
+        return false;
+    }
+    if (cabecalho->numItens < 0 || cabecalho->tamanhoAgenda < 0 || cabecalho->tamanhoAgenda > cabecalho->numItens) {
+        return false;
+    }
+
+    size_t esperado = sizeof(CabecalhoSnapshot) + sizeof(RegistroSnapshot) * (size_t)cabecalho->numItens +
+                      sizeof(EntradaSnapshot) * (size_t)cabecalho->tamanhoAgenda + cabecalho->tamanhoTextos;
+    if (tamanho != esperado) return false;
+    if (cabecalho->tamanhoTextos > 0 && dados[tamanho - 1] != '\0') return false;
+
+    return checksum_bloco(CHECKSUM_INICIAL, dados + sizeof(CabecalhoSnapshot), tamanho - sizeof(CabecalhoSnapshot)) ==
+           cabecalho->checksumConteudo;
+}
+
+static void copiar_texto(char* destino, size_t capacidade, const char* textos, uint32_t tamanhoTextos, uint32_t deslocamento) {
+    if (deslocamento >= tamanhoTextos) {
+        destino[0] = '\0';
+        return;
+    }
+    // A área de textos termina em '\0' (conferido em imagem_valida), então strlen não passa do fim
+    size_t comprimento = strlen(textos + deslocamento);
+    if (comprimento >= capacidade) comprimento = capacidade - 1;
+    memcpy(destino, textos + deslocamento, comprimento);
+    destino[comprimento] = '\0';
+}
+
+bool snapshot_carregar(const char* arquivoImagem, const char* arquivoOrigem, SistemaInventario* sistema) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    if (arquivoImagem == NULL || arquivoOrigem == NULL || sistema == NULL || sistema->inventario.size != 0) return false;
+
+    int64_t tamanhoOrigem, modificacaoOrigem;
+    if (!metadados_origem(arquivoOrigem, &tamanhoOrigem, &modificacaoOrigem)) {
+        cronometro_parar(&crono);
+        cronometro_imprimir("Snapshot - Carregar (origem ausente)", &crono);
+        return false;
+    }
+
+    size_t tamanho = 0;
+    const unsigned char* dados = mapear_imagem(arquivoImagem, &tamanho);
+    if (!dados) {
+        cronometro_parar(&crono);
+        cronometro_imprimir("Snapshot - Carregar (imagem ausente)", &crono);
+        return false;
+    }
+
+    trace_inicio("Snapshot: validação");
+    const CabecalhoSnapshot* cabecalho = (const CabecalhoSnapshot*)dados;
+    bool ok = imagem_valida(dados, tamanho) && cabecalho->tamanhoOrigem == tamanhoOrigem;
+    // Mesmo tamanho e data do CSV bastam, como no índice de ids do repositório; só com a data
+    // diferente (arquivo copiado ou tocado) o conteúdo é lido para comparar o checksum
+    if (ok && cabecalho->modificacaoOrigem != modificacaoOrigem) {
+        uint64_t checksumOrigem;
+        ok = checksum_arquivo(arquivoOrigem, &checksumOrigem) && checksumOrigem == cabecalho->checksumOrigem;
+    }
+    trace_fim("Snapshot: validação");
+    if (!ok) {
+        desmapear_imagem(dados, tamanho);
+        cronometro_parar(&crono);
+        cronometro_imprimir("Snapshot - Carregar (desatualizado)", &crono);
+        return false;
+    }
+
+    int numItens = cabecalho->numItens;
+    int tamanhoAgenda = cabecalho->tamanhoAgenda;
+    const RegistroSnapshot* registros = (const RegistroSnapshot*)(dados + sizeof(CabecalhoSnapshot));
+    const EntradaSnapshot* entradasImagem = (const EntradaSnapshot*)(registros + numItens);
+    const char* textos = (const char*)(entradasImagem + tamanhoAgenda);
+
+    Node** nos = mem_alocar(MEMORIA_TEMPORARIA, sizeof(Node*) * (numItens > 0 ? numItens : 1));
+    EntradaManutencao* entradas = mem_alocar(MEMORIA_TEMPORARIA, sizeof(EntradaManutencao) * (tamanhoAgenda > 0 ? tamanhoAgenda : 1));
+    ok = nos != NULL && entradas != NULL;
+
+    trace_inicio("Snapshot: montagem da lista");
+    for (int i = 0; ok && i < numItens; i++) {
+        const RegistroSnapshot* registro = &registros[i];
+        Hardware hw;
+        hw.id = registro->id;
+        copiar_texto(hw.nome, sizeof(hw.nome), textos, cabecalho->tamanhoTextos, registro->nome);
+        copiar_texto(hw.fabricante, sizeof(hw.fabricante), textos, cabecalho->tamanhoTextos, registro->fabricante);
+        hw.tipo = (TipoHardware)registro->tipo;
+        hw.dataCompra = registro->dataCompra;
+        hw.valorCompra = registro->valorCompra;
+        hw.vidaUtilAnos = registro->vidaUtilAnos;
+        hw.ultimaManutencao = registro->ultimaManutencao;
+        hw.obsoleto = registro->obsoleto != 0;
+
+        linkedlist_push_back(&sistema->inventario, &hw);
+        ok = sistema->inventario.size == i + 1;
+        if (ok) nos[i] = sistema->inventario.tail;
+    }
+    trace_fim("Snapshot: montagem da lista");
+
+    for (int j = 0; ok && j < tamanhoAgenda; j++) {
+        int32_t posicao = entradasImagem[j].posicao;
+        ok = posicao >= 0 && posicao < numItens;
+        if (ok) {
+            entradas[j].no = nos[posicao];
+            entradas[j].ultimaManutencao = nos[posicao]->data.ultimaManutencao;
+            entradas[j].sequencia = entradasImagem[j].sequencia;
+        }
+    }
+    ok = ok && agenda_manutencao_restaurar(&sistema->agendaManutencao, entradas, tamanhoAgenda, cabecalho->proximaSequencia);
+
+    if (ok) {
+        sistema->proximoId = cabecalho->proximoId;
+    } else {
+        linkedlist_clear(&sistema->inventario);
+        agenda_manutencao_destruir(&sistema->agendaManutencao);
+    }
+
+    mem_liberar(entradas);
+    mem_liberar(nos);
+    desmapear_imagem(dados, tamanho);
+
+    cronometro_parar(&crono);
+    if (ok) {
+        if (cronometro_console_ativo()) printf("[SNAPSHOT] Carregados %d itens - ", numItens);
+        cronometro_definir_registros(numItens);
+    }
+    cronometro_imprimir(ok ? "Carregar snapshot" : "Snapshot - Carregar (falha)", &crono);
+    return ok;
+}
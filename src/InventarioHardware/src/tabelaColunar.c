@@ -0,0 +1,431 @@
+#include "tabelaColunar.h"
+#include "hardware.h"
+#include "memoria.h"
+#include "trace.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#define COLUNAR_VERSAO 1
+#define COLUNAR_MARCADOR 0x01020304u      // detecta arquivo gravado com outra ordem de bytes
+#define COLUNAR_ALINHAMENTO 64
+#define TAMANHO_NOME_COLUNA 32
+#define TAMANHO_BUFFER_ESCRITA (64 * 1024)
+
+typedef struct {
+    char magica[8];
+    uint32_t versao;
+    uint32_t marcador;
+    int64_t numLinhas;
+    uint32_t numColunas;
+    uint32_t reservado;
+} CabecalhoColunar;
+
+typedef struct {
+    char nome[TAMANHO_NOME_COLUNA];
+    uint32_t tipo;
+    uint32_t reservado;
+    uint64_t deslocamentoValores;
+    uint64_t tamanhoValores;
+    uint64_t deslocamentoTextos;
+    uint64_t tamanhoTextos;
+} DescritorColuna;
+
+static const char MAGICA_COLUNAR[8] = {'I', 'N', 'V', 'C', 'O', 'L', '1', '\0'};
+
+// Ordem das colunas no arquivo; o leitor as localiza pelo nome, não pela posição
+enum {
+    COL_ID, COL_NOME, COL_FABRICANTE, COL_TIPO, COL_DATA_COMPRA, COL_VALOR,
+    COL_VIDA_UTIL, COL_ULTIMA_MANUTENCAO, COL_OBSOLETO, NUM_COLUNAS_INVENTARIO
+};
+
+static const struct {
+    const char* nome;
+    TipoColuna tipo;
+} COLUNAS[NUM_COLUNAS_INVENTARIO] = {
+    {"id", COLUNA_INT32},
+    {"nome", COLUNA_TEXTO},
+    {"fabricante", COLUNA_TEXTO},
+    {"tipo", COLUNA_CATEGORIA},
+    {"data_compra", COLUNA_DATA},
+    {"valor_compra", COLUNA_FLOAT64},
+    {"vida_util_anos", COLUNA_INT32},
+    {"ultima_manutencao", COLUNA_DATA},
+    {"obsoleto", COLUNA_BOOL},
+};
+
+static uint64_t alinhar(uint64_t valor) {
+    return (valor + COLUNAR_ALINHAMENTO - 1) & ~(uint64_t)(COLUNAR_ALINHAMENTO - 1);
+}
+
+static int32_t data_para_aaaammdd(const Data* data) {
+    return (int32_t)(data->ano * 10000 + data->mes * 100 + data->dia);
+}
+
+Data colunar_data(int32_t aaaammdd) {
+    Data data;
+    data.ano = aaaammdd / 10000;
+    data.mes = (aaaammdd / 100) % 100;
+    data.dia = aaaammdd % 100;
+    return data;
+}
+
+const char* colunar_texto(const int32_t* offsets, const char* dados, int64_t linha, int* tamanho) {
+    *tamanho = offsets[linha + 1] - offsets[linha];
+    return dados + offsets[linha];
+}
+
+// ---------- Escrita ----------
+
+// Buffer de escrita fixo: os valores são acumulados e descarregados em blocos de 64 KB
+typedef struct {
+    FILE* arquivo;
+    unsigned char dados[TAMANHO_BUFFER_ESCRITA];
+    size_t usado;
+    uint64_t posicao;
+    bool falha;
+} EscritorColunar;
+
+static void escritor_descarregar(EscritorColunar* escritor) {
+    if (!escritor->falha && escritor->usado > 0 &&
+        fwrite(escritor->dados, 1, escritor->usado, escritor->arquivo) != escritor->usado) {
+        escritor->falha = true;
+    }
+    escritor->usado = 0;
+}
+
+static void escritor_bytes(EscritorColunar* escritor, const void* bytes, size_t tamanho) {
+    const unsigned char* origem = bytes;
+    escritor->posicao += tamanho;
+    while (tamanho > 0) {
+        if (escritor->usado == TAMANHO_BUFFER_ESCRITA) escritor_descarregar(escritor);
+        size_t livre = TAMANHO_BUFFER_ESCRITA - escritor->usado;
+        size_t parte = tamanho < livre ? tamanho : livre;
+        memcpy(escritor->dados + escritor->usado, origem, parte);
+        escritor->usado += parte;
+        origem += parte;
+        tamanho -= parte;
+    }
+}
+
+static void escritor_alinhar(EscritorColunar* escritor) {
+    static const unsigned char zeros[COLUNAR_ALINHAMENTO] = {0};
+    escritor_bytes(escritor, zeros, (size_t)(alinhar(escritor->posicao) - escritor->posicao));
+}
+
+// Calcula onde cada buffer vai ficar; só os tamanhos dos textos exigem uma passada pela lista
+static bool colunar_planejar(const LinkedList* list, DescritorColuna* descritores, uint64_t* nomesCategorias) {
+    int64_t n = list->size;
+    uint64_t bytesNome = 0, bytesFabricante = 0;
+    for (Node* current = list->head; current != NULL; current = current->next) {
+        bytesNome += strlen(current->data.nome);
+        bytesFabricante += strlen(current->data.fabricante);
+    }
+    if (bytesNome > INT32_MAX || bytesFabricante > INT32_MAX) return false;
+
+    *nomesCategorias = 0;
+    for (int t = 0; t < NUM_TIPOS_HARDWARE; t++) {
+        *nomesCategorias += strlen(tipo_to_string((TipoHardware)t)) + 1;
+    }
+
+    uint64_t posicao = alinhar(sizeof(CabecalhoColunar) + sizeof(DescritorColuna) * NUM_COLUNAS_INVENTARIO);
+    for (int c = 0; c < NUM_COLUNAS_INVENTARIO; c++) {
+        DescritorColuna* d = &descritores[c];
+        memset(d, 0, sizeof(*d));
+        strncpy(d->nome, COLUNAS[c].nome, sizeof(d->nome) - 1);
+        d->tipo = COLUNAS[c].tipo;
+
+        switch (COLUNAS[c].tipo) {
+            case COLUNA_INT32:
+            case COLUNA_DATA:    d->tamanhoValores = (uint64_t)n * sizeof(int32_t); break;
+            case COLUNA_FLOAT64: d->tamanhoValores = (uint64_t)n * sizeof(double); break;
+            case COLUNA_BOOL:
+            case COLUNA_CATEGORIA: d->tamanhoValores = (uint64_t)n; break;
+            case COLUNA_TEXTO:   d->tamanhoValores = (uint64_t)(n + 1) * sizeof(int32_t); break;
+        }
+        d->deslocamentoValores = posicao;
+        posicao = alinhar(posicao + d->tamanhoValores);
+
+        if (COLUNAS[c].tipo == COLUNA_TEXTO || COLUNAS[c].tipo == COLUNA_CATEGORIA) {
+            d->tamanhoTextos = c == COL_NOME ? bytesNome : c == COL_FABRICANTE ? bytesFabricante : *nomesCategorias;
+            d->deslocamentoTextos = posicao;
+            posicao = alinhar(posicao + d->tamanhoTextos);
+        }
+    }
+    return true;
+}
+
+static void escrever_coluna_texto(EscritorColunar* escritor, const LinkedList* list, size_t deslocamentoCampo) {
+    int32_t offset = 0;
+    escritor_bytes(escritor, &offset, sizeof(offset));
+    for (Node* current = list->head; current != NULL; current = current->next) {
+        offset += (int32_t)strlen((const char*)&current->data + deslocamentoCampo);
+        escritor_bytes(escritor, &offset, sizeof(offset));
+    }
+    escritor_alinhar(escritor);
+    for (Node* current = list->head; current != NULL; current = current->next) {
+        const char* texto = (const char*)&current->data + deslocamentoCampo;
+        escritor_bytes(escritor, texto, strlen(texto));
+    }
+    escritor_alinhar(escritor);
+}
+
+static void escrever_coluna(EscritorColunar* escritor, const LinkedList* list, int coluna) {
+    if (coluna == COL_NOME) {
+        escrever_coluna_texto(escritor, list, offsetof(Hardware, nome));
+        return;
+    }
+    if (coluna == COL_FABRICANTE) {
+        escrever_coluna_texto(escritor, list, offsetof(Hardware, fabricante));
+        return;
+    }
+
+    for (Node* current = list->head; current != NULL; current = current->next) {
+        const Hardware* hw = &current->data;
+        int32_t inteiro;
+        uint8_t byte;
+        switch (coluna) {
+            case COL_ID: escritor_bytes(escritor, &hw->id, sizeof(int32_t)); break;
+            case COL_TIPO: byte = (uint8_t)hw->tipo; escritor_bytes(escritor, &byte, 1); break;
+            case COL_DATA_COMPRA: inteiro = data_para_aaaammdd(&hw->dataCompra); escritor_bytes(escritor, &inteiro, sizeof(inteiro)); break;
+            case COL_VALOR: escritor_bytes(escritor, &hw->valorCompra, sizeof(double)); break;
+            case COL_VIDA_UTIL: escritor_bytes(escritor, &hw->vidaUtilAnos, sizeof(int32_t)); break;
+            case COL_ULTIMA_MANUTENCAO: inteiro = data_para_aaaammdd(&hw->ultimaManutencao); escritor_bytes(escritor, &inteiro, sizeof(inteiro)); break;
+            case COL_OBSOLETO: byte = hw->obsoleto ? 1 : 0; escritor_bytes(escritor, &byte, 1); break;
+        }
+    }
+    escritor_alinhar(escritor);
+
+    if (coluna == COL_TIPO) {
+        for (int t = 0; t < NUM_TIPOS_HARDWARE; t++) {
+            const char* nome = tipo_to_string((TipoHardware)t);
+            escritor_bytes(escritor, nome, strlen(nome) + 1);
+        }
+        escritor_alinhar(escritor);
+    }
+}
+
+bool colunar_exportar(const LinkedList* list, const char* arquivo) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    DescritorColuna descritores[NUM_COLUNAS_INVENTARIO];
+    uint64_t nomesCategorias;
+    if (list == NULL || arquivo == NULL || !colunar_planejar(list, descritores, &nomesCategorias)) {
+        cronometro_parar(&crono);
+        cronometro_imprimir("Exportação colunar (falha)", &crono);
+        return false;
+    }
+
+    CabecalhoColunar cabecalho;
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    memcpy(cabecalho.magica, MAGICA_COLUNAR, sizeof(cabecalho.magica));
+    cabecalho.versao = COLUNAR_VERSAO;
+    cabecalho.marcador = COLUNAR_MARCADOR;
+    cabecalho.numLinhas = list->size;
+    cabecalho.numColunas = NUM_COLUNAS_INVENTARIO;
+
+    EscritorColunar* escritor = mem_alocar(MEMORIA_TEMPORARIA, sizeof(EscritorColunar));
+    if (!escritor) {
+        cronometro_parar(&crono);
+        cronometro_imprimir("Exportação colunar (falha)", &crono);
+        return false;
+    }
+    escritor->arquivo = fopen(arquivo, "wb");
+    escritor->usado = 0;
+    escritor->posicao = 0;
+    escritor->falha = escritor->arquivo == NULL;
+
+    trace_inicio("Colunar: escrita");
+    escritor_bytes(escritor, &cabecalho, sizeof(cabecalho));
+    escritor_bytes(escritor, descritores, sizeof(descritores));
+    escritor_alinhar(escritor);
+    for (int c = 0; c < NUM_COLUNAS_INVENTARIO && !escritor->falha; c++) {
+        escrever_coluna(escritor, list, c);
+    }
+    escritor_descarregar(escritor);
+    trace_fim("Colunar: escrita");
+
+    bool ok = !escritor->falha;
+    if (escritor->arquivo && fclose(escritor->arquivo) != 0) ok = false;
+    if (!ok && escritor->arquivo) remove(arquivo);
+    mem_liberar(escritor);
+
+    cronometro_parar(&crono);
+    cronometro_definir_registros(list->size);
+    cronometro_imprimir(ok ? "Exportação colunar" : "Exportação colunar (falha)", &crono);
+    return ok;
+}
+
+// ---------- Leitura ----------
+
+// Mapeia o arquivo para leitura; no Windows ele é lido inteiro para um buffer
+static const unsigned char* mapear_arquivo(const char* caminho, size_t* tamanho) {
+#ifdef _WIN32
+    FILE* arquivo = fopen(caminho, "rb");
+    if (!arquivo) return NULL;
+
+    unsigned char* dados = NULL;
+    long fim;
+    if (fseek(arquivo, 0, SEEK_END) == 0 && (fim = ftell(arquivo)) > 0 && fseek(arquivo, 0, SEEK_SET) == 0) {
+        dados = mem_alocar(MEMORIA_TEMPORARIA, (size_t)fim);
+        if (dados && fread(dados, 1, (size_t)fim, arquivo) != (size_t)fim) {
+            mem_liberar(dados);
+            dados = NULL;
+        }
+        *tamanho = (size_t)fim;
+    }
+    fclose(arquivo);
+    return dados;
+#else
+    int descritor = open(caminho, O_RDONLY);
+    if (descritor < 0) return NULL;
+
+    struct stat info;
+    void* dados = MAP_FAILED;
+    if (fstat(descritor, &info) == 0 && info.st_size > 0) {
+        *tamanho = (size_t)info.st_size;
+        dados = mmap(NULL, *tamanho, PROT_READ, MAP_PRIVATE, descritor, 0);
+    }
+    close(descritor);
+    return dados == MAP_FAILED ? NULL : dados;
+#endif
+}
+
+static void desmapear_arquivo(const unsigned char* dados, size_t tamanho) {
+#ifdef _WIN32
+    (void)tamanho;
+    mem_liberar((void*)dados);
+#else
+    munmap((void*)dados, tamanho);
+#endif
+}
+
+static bool faixa_valida(const TabelaColunar* tabela, uint64_t deslocamento, uint64_t tamanho) {
+    return deslocamento % 8 == 0 && deslocamento <= tabela->tamanho && tamanho <= tabela->tamanho - deslocamento;
+}
+
+// Confere tipo e tamanhos de uma coluna obrigatória; devolve o descritor ou NULL
+static const DescritorColuna* localizar_coluna(const TabelaColunar* tabela, const DescritorColuna* descritores,
+                                               uint32_t numColunas, int coluna) {
+    const DescritorColuna* d = NULL;
+    for (uint32_t i = 0; i < numColunas && d == NULL; i++) {
+        if (strncmp(descritores[i].nome, COLUNAS[coluna].nome, TAMANHO_NOME_COLUNA) == 0) d = &descritores[i];
+    }
+    if (d == NULL || d->tipo != (uint32_t)COLUNAS[coluna].tipo) return NULL;
+
+    uint64_t n = (uint64_t)tabela->numLinhas;
+    uint64_t esperado = 0;
+    switch (COLUNAS[coluna].tipo) {
+        case COLUNA_INT32:
+        case COLUNA_DATA:    esperado = n * sizeof(int32_t); break;
+        case COLUNA_FLOAT64: esperado = n * sizeof(double); break;
+        case COLUNA_BOOL:
+        case COLUNA_CATEGORIA: esperado = n; break;
+        case COLUNA_TEXTO:   esperado = (n + 1) * sizeof(int32_t); break;
+    }
+    if (d->tamanhoValores != esperado || !faixa_valida(tabela, d->deslocamentoValores, d->tamanhoValores)) return NULL;
+    if ((COLUNAS[coluna].tipo == COLUNA_TEXTO || COLUNAS[coluna].tipo == COLUNA_CATEGORIA) &&
+        !faixa_valida(tabela, d->deslocamentoTextos, d->tamanhoTextos)) {
+        return NULL;
+    }
+    return d;
+}
+
+// Offsets precisam começar em 0, nunca diminuir e terminar dentro da área de textos
+static bool offsets_validos(const int32_t* offsets, int64_t n, uint64_t tamanhoTextos) {
+    if (offsets[0] != 0) return false;
+    for (int64_t i = 0; i < n; i++) {
+        if (offsets[i + 1] < offsets[i]) return false;
+    }
+    return (uint64_t)offsets[n] <= tamanhoTextos;
+}
+
+// Nomes das categorias, na ordem dos códigos, convertidos uma vez para TipoHardware
+static bool mapear_categorias(TabelaColunar* tabela, const char* nomes, uint64_t tamanho) {
+    for (int c = 0; c < 256; c++) tabela->tipoPorCodigo[c] = OUTRO;
+    if (tamanho == 0 || nomes[tamanho - 1] != '\0') return false;
+
+    int codigo = 0;
+    for (uint64_t i = 0; i < tamanho && codigo < 256; codigo++) {
+        tabela->tipoPorCodigo[codigo] = string_to_tipo(nomes + i);
+        i += strlen(nomes + i) + 1;
+    }
+    return true;
+}
+
+bool colunar_abrir(TabelaColunar* tabela, const char* arquivo) {
+    Cronometro crono;
+    cronometro_iniciar(&crono);
+
+    memset(tabela, 0, sizeof(*tabela));
+    tabela->base = mapear_arquivo(arquivo, &tabela->tamanho);
+    if (tabela->base == NULL) {
+        cronometro_parar(&crono);
+        cronometro_imprimir("Abrir arquivo colunar (falha)", &crono);
+        return false;
+    }
+
+    CabecalhoColunar cabecalho;
+    bool ok = tabela->tamanho >= sizeof(cabecalho);
+    if (ok) {
+        memcpy(&cabecalho, tabela->base, sizeof(cabecalho));
+        ok = memcmp(cabecalho.magica, MAGICA_COLUNAR, sizeof(cabecalho.magica)) == 0 &&
+             cabecalho.versao == COLUNAR_VERSAO && cabecalho.marcador == COLUNAR_MARCADOR &&
+             cabecalho.numLinhas >= 0 && cabecalho.numLinhas < INT32_MAX &&
+             cabecalho.numColunas <= (tabela->tamanho - sizeof(cabecalho)) / sizeof(DescritorColuna);
+    }
+
+    const DescritorColuna* d[NUM_COLUNAS_INVENTARIO];
+    if (ok) {
+        tabela->numLinhas = cabecalho.numLinhas;
+        const DescritorColuna* descritores = (const DescritorColuna*)(tabela->base + sizeof(cabecalho));
+        for (int c = 0; c < NUM_COLUNAS_INVENTARIO && ok; c++) {
+            d[c] = localizar_coluna(tabela, descritores, cabecalho.numColunas, c);
+            ok = d[c] != NULL;
+        }
+    }
+
+    if (ok) {
+        const unsigned char* base = tabela->base;
+        tabela->id = (const int32_t*)(base + d[COL_ID]->deslocamentoValores);
+        tabela->nomeOffsets = (const int32_t*)(base + d[COL_NOME]->deslocamentoValores);
+        tabela->nomeDados = (const char*)(base + d[COL_NOME]->deslocamentoTextos);
+        tabela->fabricanteOffsets = (const int32_t*)(base + d[COL_FABRICANTE]->deslocamentoValores);
+        tabela->fabricanteDados = (const char*)(base + d[COL_FABRICANTE]->deslocamentoTextos);
+        tabela->tipo = base + d[COL_TIPO]->deslocamentoValores;
+        tabela->dataCompra = (const int32_t*)(base + d[COL_DATA_COMPRA]->deslocamentoValores);
+        tabela->valorCompra = (const double*)(base + d[COL_VALOR]->deslocamentoValores);
+        tabela->vidaUtilAnos = (const int32_t*)(base + d[COL_VIDA_UTIL]->deslocamentoValores);
+        tabela->ultimaManutencao = (const int32_t*)(base + d[COL_ULTIMA_MANUTENCAO]->deslocamentoValores);
+        tabela->obsoleto = base + d[COL_OBSOLETO]->deslocamentoValores;
+
+        ok = offsets_validos(tabela->nomeOffsets, tabela->numLinhas, d[COL_NOME]->tamanhoTextos) &&
+             offsets_validos(tabela->fabricanteOffsets, tabela->numLinhas, d[COL_FABRICANTE]->tamanhoTextos) &&
+             mapear_categorias(tabela, (const char*)(base + d[COL_TIPO]->deslocamentoTextos), d[COL_TIPO]->tamanhoTextos);
+    }
+
+    if (!ok) {
+        fprintf(stderr, "%s não é um arquivo colunar válido\n", arquivo);
+        colunar_fechar(tabela);
+    }
+
+    cronometro_parar(&crono);
+    cronometro_definir_registros(ok ? tabela->numLinhas : 0);
+    cronometro_imprimir(ok ? "Abrir arquivo colunar" : "Abrir arquivo colunar (falha)", &crono);
+    return ok;
+}
+
+void colunar_fechar(TabelaColunar* tabela) {
+    if (tabela == NULL) return;
+    if (tabela->base) desmapear_arquivo(tabela->base, tabela->tamanho);
+    memset(tabela, 0, sizeof(*tabela));
+}
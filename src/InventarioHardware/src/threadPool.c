@@ -0,0 +1,227 @@
+#include "threadPool.h"
+#include "trace.h"
+#include <stdlib.h>
+#include <pthread.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <signal.h>
+#endif
+
+// Tarefa avulsa de threadpool_enviar, executada por um worker sem que o chamador espere
+typedef struct TarefaAvulsa {
+    TarefaPool tarefa;
+    void* contexto;
+    struct TarefaAvulsa* proxima;
+} TarefaAvulsa;
+
+struct ThreadPool {
+    pthread_t* threads;
+    int numThreads;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t temTrabalho;
+    pthread_cond_t trabalhoConcluido;
+    pthread_mutex_t execucao;   // serializa chamadas a threadpool_executar
+
+    TarefaPool tarefa;
+    void* contexto;
+    int numTarefas;
+    int proximaTarefa;
+    int tarefasConcluidas;
+    unsigned long geracao;
+    bool encerrar;
+
+    TarefaAvulsa* primeiraAvulsa;
+    TarefaAvulsa* ultimaAvulsa;
+};
+
+int obter_numero_nucleos() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+// Retira e executa tarefas do job atual até acabarem. Deve ser chamada com o mutex travado.
+static void executar_tarefas_pendentes(ThreadPool* pool) {
+    while (pool->proximaTarefa < pool->numTarefas) {
+        int indice = pool->proximaTarefa++;
+        TarefaPool tarefa = pool->tarefa;
+        void* contexto = pool->contexto;
+
+        pthread_mutex_unlock(&pool->mutex);
+        trace_inicio("Pool: tarefa");
+        tarefa(contexto, indice);
+        trace_fim("Pool: tarefa");
+        pthread_mutex_lock(&pool->mutex);
+
+        pool->tarefasConcluidas++;
+        if (pool->tarefasConcluidas == pool->numTarefas) {
+            pthread_cond_broadcast(&pool->trabalhoConcluido);
+        }
+    }
+}
+
+static void* threadpool_worker(void* arg) {
+    ThreadPool* pool = (ThreadPool*)arg;
+    unsigned long geracaoVista = 0;
+#ifndef _WIN32
+    // Sinais do processo ficam com a thread principal (o modo servidor os lê por signalfd)
+    sigset_t todos;
+    sigfillset(&todos);
+    pthread_sigmask(SIG_BLOCK, &todos, NULL);
+#endif
+
+    pthread_mutex_lock(&pool->mutex);
+    while (true) {
+        while (!pool->encerrar && pool->geracao == geracaoVista && pool->primeiraAvulsa == NULL) {
+            pthread_cond_wait(&pool->temTrabalho, &pool->mutex);
+        }
+        if (pool->encerrar) break;
+
+        // O job de threadpool_executar tem prioridade: o chamador está parado esperando por ele
+        if (pool->geracao != geracaoVista) {
+            geracaoVista = pool->geracao;
+            executar_tarefas_pendentes(pool);
+            continue;
+        }
+
+        TarefaAvulsa* avulsa = pool->primeiraAvulsa;
+        pool->primeiraAvulsa = avulsa->proxima;
+        if (pool->primeiraAvulsa == NULL) pool->ultimaAvulsa = NULL;
+        pthread_mutex_unlock(&pool->mutex);
+        trace_inicio("Pool: tarefa avulsa");
+        avulsa->tarefa(avulsa->contexto, 0);
+        trace_fim("Pool: tarefa avulsa");
+        free(avulsa);
+        pthread_mutex_lock(&pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return NULL;
+}
+
+ThreadPool* threadpool_criar(int numThreads) {
+    if (numThreads < 1) numThreads = 1;
+
+    ThreadPool* pool = calloc(1, sizeof(ThreadPool));
+    if (!pool) return NULL;
+
+    // A thread chamadora também executa tarefas, então criamos uma a menos
+    int numWorkers = numThreads - 1;
+    if (numWorkers > 0) {
+        pool->threads = malloc(sizeof(pthread_t) * numWorkers);
+        if (!pool->threads) {
+            free(pool);
+            return NULL;
+        }
+    }
+
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_mutex_init(&pool->execucao, NULL);
+    pthread_cond_init(&pool->temTrabalho, NULL);
+    pthread_cond_init(&pool->trabalhoConcluido, NULL);
+
+    for (int i = 0; i < numWorkers; i++) {
+        if (pthread_create(&pool->threads[i], NULL, threadpool_worker, pool) != 0) {
+            break;
+        }
+        pool->numThreads++;
+    }
+    pool->numThreads++;
+
+    return pool;
+}
+
+// Tarefas avulsas ainda na fila não são executadas; quem enviou deve esperar as suas antes
+void threadpool_destruir(ThreadPool* pool) {
+    if (pool == NULL) return;
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->encerrar = true;
+    pthread_cond_broadcast(&pool->temTrabalho);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (int i = 0; i < pool->numThreads - 1; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    while (pool->primeiraAvulsa) {
+        TarefaAvulsa* proxima = pool->primeiraAvulsa->proxima;
+        free(pool->primeiraAvulsa);
+        pool->primeiraAvulsa = proxima;
+    }
+    pthread_cond_destroy(&pool->temTrabalho);
+    pthread_cond_destroy(&pool->trabalhoConcluido);
+    pthread_mutex_destroy(&pool->execucao);
+    pthread_mutex_destroy(&pool->mutex);
+    free(pool->threads);
+    free(pool);
+}
+
+int threadpool_num_threads(const ThreadPool* pool) {
+    return pool ? pool->numThreads : 1;
+}
+
+// Executa tarefa(contexto, 0..numTarefas-1) distribuindo entre as threads e
+// retorna somente quando todas terminarem. Sem pool, executa em série.
+void threadpool_executar(ThreadPool* pool, int numTarefas, TarefaPool tarefa, void* contexto) {
+    if (numTarefas <= 0 || tarefa == NULL) return;
+
+    if (pool == NULL || pool->numThreads <= 1 || numTarefas == 1) {
+        for (int i = 0; i < numTarefas; i++) {
+            tarefa(contexto, i);
+        }
+        return;
+    }
+
+    pthread_mutex_lock(&pool->execucao);
+    pthread_mutex_lock(&pool->mutex);
+
+    pool->tarefa = tarefa;
+    pool->contexto = contexto;
+    pool->numTarefas = numTarefas;
+    pool->proximaTarefa = 0;
+    pool->tarefasConcluidas = 0;
+    pool->geracao++;
+    pthread_cond_broadcast(&pool->temTrabalho);
+
+    executar_tarefas_pendentes(pool);
+    while (pool->tarefasConcluidas < pool->numTarefas) {
+        pthread_cond_wait(&pool->trabalhoConcluido, &pool->mutex);
+    }
+
+    pool->tarefa = NULL;
+    pool->contexto = NULL;
+    pthread_mutex_unlock(&pool->mutex);
+    pthread_mutex_unlock(&pool->execucao);
+}
+
+// Enfileira tarefa(contexto, 0) para um worker e retorna sem esperar. A tarefa pode chamar
+// threadpool_executar no mesmo pool; o worker que a executa participa do job como chamador.
+// false se o pool não tem workers (máquina de um núcleo) ou sem memória: aí o chamador executa.
+bool threadpool_enviar(ThreadPool* pool, TarefaPool tarefa, void* contexto) {
+    if (pool == NULL || pool->numThreads <= 1 || tarefa == NULL) return false;
+
+    TarefaAvulsa* avulsa = malloc(sizeof(TarefaAvulsa));
+    if (!avulsa) return false;
+    avulsa->tarefa = tarefa;
+    avulsa->contexto = contexto;
+    avulsa->proxima = NULL;
+
+    pthread_mutex_lock(&pool->mutex);
+    if (pool->ultimaAvulsa) {
+        pool->ultimaAvulsa->proxima = avulsa;
+    } else {
+        pool->primeiraAvulsa = avulsa;
+    }
+    pool->ultimaAvulsa = avulsa;
+    pthread_cond_broadcast(&pool->temTrabalho);
+    pthread_mutex_unlock(&pool->mutex);
+    return true;
+}
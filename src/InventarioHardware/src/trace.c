@@ -0,0 +1,151 @@
+#include "trace.h"
+
+#ifndef INVENTARIO_SEM_TRACE
+
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#else
+#include <pthread.h>
+#endif
+
+#define TRACE_TAMANHO_NOME 48
+
+typedef struct {
+    char nome[TRACE_TAMANHO_NOME];
+    char fase;              // 'B' início, 'E' fim, 'X' intervalo completo
+    int tid;
+    long long inicioNs;
+    long long duracaoNs;
+} EventoTrace;
+
+static EventoTrace* eventos = NULL;
+static size_t capacidade = 0;
+static atomic_size_t proximoEvento;
+static atomic_bool ativo;
+static char* caminhoSaida = NULL;
+static long long origemNs = 0;
+
+static int trace_tid() {
+    static __thread int tid = 0;
+    if (tid == 0) {
+#ifdef _WIN32
+        tid = (int)GetCurrentThreadId();
+#elif defined(__linux__)
+        tid = (int)syscall(SYS_gettid);
+#else
+        tid = (int)((size_t)pthread_self() & 0x7fffffff);
+#endif
+    }
+    return tid;
+}
+
+bool trace_iniciar(const char* caminho, size_t capacidadeEventos) {
+    if (caminho == NULL || capacidadeEventos == 0 || atomic_load(&ativo)) return false;
+
+    eventos = malloc(sizeof(EventoTrace) * capacidadeEventos);
+    caminhoSaida = malloc(strlen(caminho) + 1);
+    if (!eventos || !caminhoSaida) {
+        free(eventos);
+        free(caminhoSaida);
+        eventos = NULL;
+        caminhoSaida = NULL;
+        return false;
+    }
+    strcpy(caminhoSaida, caminho);
+
+    capacidade = capacidadeEventos;
+    origemNs = tempo_monotonico_ns();
+    atomic_store(&proximoEvento, 0);
+    atomic_store(&ativo, true);
+    return true;
+}
+
+bool trace_ativo() {
+    return atomic_load_explicit(&ativo, memory_order_relaxed);
+}
+
+// Reserva uma posição no buffer circular; quando cheio, sobrescreve os eventos mais antigos
+static void trace_registrar(const char* nome, char fase, long long inicioNs, long long duracaoNs) {
+    size_t indice = atomic_fetch_add_explicit(&proximoEvento, 1, memory_order_relaxed) % capacidade;
+    EventoTrace* evento = &eventos[indice];
+
+    strncpy(evento->nome, nome, TRACE_TAMANHO_NOME - 1);
+    evento->nome[TRACE_TAMANHO_NOME - 1] = '\0';
+    evento->fase = fase;
+    evento->tid = trace_tid();
+    evento->inicioNs = inicioNs;
+    evento->duracaoNs = duracaoNs;
+}
+
+void trace_inicio(const char* nome) {
+    if (!trace_ativo()) return;
+    trace_registrar(nome, 'B', tempo_monotonico_ns(), 0);
+}
+
+void trace_fim(const char* nome) {
+    if (!trace_ativo()) return;
+    trace_registrar(nome, 'E', tempo_monotonico_ns(), 0);
+}
+
+void trace_completo(const char* nome, long long inicioNs, long long fimNs) {
+    if (!trace_ativo()) return;
+    trace_registrar(nome, 'X', inicioNs, fimNs - inicioNs);
+}
+
+static void escrever_nome_json(FILE* arquivo, const char* nome) {
+    fputc('"', arquivo);
+    for (const unsigned char* c = (const unsigned char*)nome; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            fprintf(arquivo, "\\%c", *c);
+        } else if (*c < 0x20) {
+            fprintf(arquivo, "\\u%04x", *c);
+        } else {
+            fputc(*c, arquivo);
+        }
+    }
+    fputc('"', arquivo);
+}
+
+// Desliga o rastreamento e grava os eventos retidos no buffer, do mais antigo ao mais recente
+bool trace_finalizar() {
+    if (!atomic_exchange(&ativo, false)) return true;
+
+    size_t total = atomic_load(&proximoEvento);
+    size_t primeiro = total > capacidade ? total - capacidade : 0;
+
+    bool ok = false;
+    FILE* arquivo = fopen(caminhoSaida, "w");
+    if (arquivo) {
+        fprintf(arquivo, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+        for (size_t i = primeiro; i < total; i++) {
+            const EventoTrace* evento = &eventos[i % capacidade];
+            fprintf(arquivo, "%s\n{\"name\": ", i > primeiro ? "," : "");
+            escrever_nome_json(arquivo, evento->nome);
+            fprintf(arquivo, ", \"cat\": \"inventario\", \"ph\": \"%c\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f",
+                    evento->fase, evento->tid, (evento->inicioNs - origemNs) / 1000.0);
+            if (evento->fase == 'X') {
+                fprintf(arquivo, ", \"dur\": %.3f", evento->duracaoNs / 1000.0);
+            }
+            fputc('}', arquivo);
+        }
+        fprintf(arquivo, "\n]}\n");
+        ok = fclose(arquivo) == 0;
+    }
+
+    free(eventos);
+    free(caminhoSaida);
+    eventos = NULL;
+    caminhoSaida = NULL;
+    capacidade = 0;
+    return ok;
+}
+
+#endif
@@ -1,8 +1,22 @@
 #include "utils.h"
 #include "hardware.h"
 #include "data.h"
+#include "metricas.h"
+#include "trace.h"
+#include "memoria.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
 #include <ctype.h>
+#include <pthread.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+static bool temposNoConsole = false;
+static pthread_mutex_t travaSaida = PTHREAD_MUTEX_INITIALIZER;
+static __thread long registrosPendentes = 0;
 
 bool compare_data_compra(const Hardware* a, const Hardware* b) {
     return data_menor_que(&a->dataCompra, &b->dataCompra);
@@ -60,15 +74,153 @@ void limpar_buffer_entrada() {
     while ((c = getchar()) != '\n' && c != EOF) {}
 }
 
+long long tempo_monotonico_ns() {
+#ifdef _WIN32
+    static LARGE_INTEGER frequencia;
+    LARGE_INTEGER contador;
+    if (frequencia.QuadPart == 0) QueryPerformanceFrequency(&frequencia);
+    QueryPerformanceCounter(&contador);
+    return (long long)((double)contador.QuadPart * 1000000000.0 / frequencia.QuadPart);
+#else
+    struct timespec agora;
+    clock_gettime(CLOCK_MONOTONIC, &agora);
+    return (long long)agora.tv_sec * 1000000000LL + agora.tv_nsec;
+#endif
+}
+
 void cronometro_iniciar(Cronometro* cronometro) {
-    cronometro->inicio = clock();
+    cronometro->hwMedido = false;
+    if (contadores_hw_ativos()) {
+        contadores_hw_ler(&cronometro->hwInicio);
+    }
+    cronometro->inicio = tempo_monotonico_ns();
 }
 
 double cronometro_parar(Cronometro* cronometro) {
-    cronometro->fim = clock();
-    return ((double)(cronometro->fim - cronometro->inicio)) * 1000000 / CLOCKS_PER_SEC;
+    cronometro->fim = tempo_monotonico_ns();
+
+    if (contadores_hw_ativos()) {
+        LeituraHw fim;
+        contadores_hw_ler(&fim);
+        contadores_hw_variacao(&cronometro->hwInicio, &fim, cronometro->hwVariacao);
+        cronometro->hwMedido = true;
+    }
+    return (double)(cronometro->fim - cronometro->inicio) / 1000.0;
 }
 
-void cronometro_imprimir(const char* operacao, double tempo) {
-    printf("[TEMPO] %s: %.2f μs (%.2f ms)\n", operacao, tempo, tempo/1000);
-}
\ No newline at end of file
+// Registra a medição de um cronômetro parado no histograma e no trace da operação; a linha [TEMPO]
+// só é impressa se o console tiver sido ativado com cronometro_definir_console
+void cronometro_imprimir(const char* operacao, const Cronometro* cronometro) {
+    double tempo = (double)(cronometro->fim - cronometro->inicio) / 1000.0;
+    metricas_registrar(operacao, tempo);
+    trace_completo(operacao, cronometro->inicio, cronometro->fim);
+    if (cronometro->hwMedido) {
+        metricas_registrar_contadores(operacao, cronometro->hwVariacao, registrosPendentes);
+    }
+    registrosPendentes = 0;
+    if (temposNoConsole) {
+        printf("[TEMPO] %s: %.2f μs (%.2f ms)\n", operacao, tempo, tempo/1000);
+    }
+}
+
+void cronometro_definir_console(bool ativo) {
+    temposNoConsole = ativo;
+}
+
+bool cronometro_console_ativo(void) {
+    return temposNoConsole;
+}
+
+// Quantidade de registros processados pela próxima medição impressa nesta thread,
+// usada para normalizar os contadores de hardware (misses por registro)
+void cronometro_definir_registros(long registros) {
+    registrosPendentes = registros;
+}
+
+void saida_travar(void) {
+    pthread_mutex_lock(&travaSaida);
+}
+
+// O que ficou no buffer do stdio sairia no próximo fflush, talvez já dentro de uma captura
+void saida_destravar(void) {
+    fflush(stdout);
+    fflush(stderr);
+    pthread_mutex_unlock(&travaSaida);
+}
+
+void texto_buffer_init(TextoBuffer* buffer) {
+    buffer->dados = NULL;
+    buffer->tamanho = 0;
+    buffer->capacidade = 0;
+}
+
+// Garante espaço para mais `adicional` bytes, dobrando a capacidade
+static bool texto_buffer_reservar(TextoBuffer* buffer, size_t adicional) {
+    size_t minimo = buffer->tamanho + adicional;
+    if (minimo <= buffer->capacidade) return true;
+
+    size_t novaCapacidade = buffer->capacidade ? buffer->capacidade * 2 : 256;
+    while (novaCapacidade < minimo) novaCapacidade *= 2;
+
+    char* novo = mem_realocar(MEMORIA_TEMPORARIA, buffer->dados, novaCapacidade);
+    if (!novo) return false;
+    buffer->dados = novo;
+    buffer->capacidade = novaCapacidade;
+    return true;
+}
+
+bool texto_buffer_anexar(TextoBuffer* buffer, const char* formato, ...) {
+    // Tenta formatar direto no espaço livre; só formata de novo se precisar crescer
+    size_t livre = buffer->capacidade - buffer->tamanho;
+    va_list args;
+    va_start(args, formato);
+    int necessario = vsnprintf(livre ? buffer->dados + buffer->tamanho : NULL, livre, formato, args);
+    va_end(args);
+    if (necessario < 0) return false;
+    if ((size_t)necessario < livre) {
+        buffer->tamanho += (size_t)necessario;
+        return true;
+    }
+
+    if (!texto_buffer_reservar(buffer, (size_t)necessario + 1)) return false;
+
+    va_start(args, formato);
+    vsnprintf(buffer->dados + buffer->tamanho, buffer->capacidade - buffer->tamanho, formato, args);
+    va_end(args);
+    buffer->tamanho += (size_t)necessario;
+    return true;
+}
+
+bool texto_buffer_anexar_bytes(TextoBuffer* buffer, const void* dados, size_t tamanho) {
+    if (tamanho == 0) return true;
+    if (!texto_buffer_reservar(buffer, tamanho)) return false;
+    memcpy(buffer->dados + buffer->tamanho, dados, tamanho);
+    buffer->tamanho += tamanho;
+    return true;
+}
+
+void texto_buffer_liberar(TextoBuffer* buffer) {
+    mem_liberar(buffer->dados);
+    texto_buffer_init(buffer);
+}
+bool copiar_arquivo(const char* origem, const char* destino) {
+    FILE* entrada = fopen(origem, "rb");
+    if (!entrada) return false;
+    FILE* saida = fopen(destino, "wb");
+    if (!saida) {
+        fclose(entrada);
+        return false;
+    }
+
+    char trecho[64 * 1024];
+    size_t lidos;
+    bool ok = true;
+    while (ok && (lidos = fread(trecho, 1, sizeof(trecho), entrada)) > 0) {
+        ok = fwrite(trecho, 1, lidos, saida) == lidos;
+    }
+    if (ferror(entrada)) ok = false;
+    fclose(entrada);
+    if (fclose(saida) != 0) ok = false;
+    if (!ok) remove(destino);
+    return ok;
+}
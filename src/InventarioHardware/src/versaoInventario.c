@@ -0,0 +1,180 @@
+#include "versaoInventario.h"
+#include "memoria.h"
+#include <string.h>
+
+static PaginaInventario* pagina_nova(void) {
+    PaginaInventario* pagina = mem_alocar(MEMORIA_REGISTROS, sizeof(PaginaInventario));
+    if (!pagina) return NULL;
+    atomic_init(&pagina->referencias, 1);
+    pagina->quantidade = 0;
+    return pagina;
+}
+
+static PaginaInventario* pagina_copiar(const PaginaInventario* origem) {
+    PaginaInventario* pagina = pagina_nova();
+    if (!pagina) return NULL;
+    pagina->quantidade = origem->quantidade;
+    memcpy(pagina->registros, origem->registros, sizeof(Hardware) * (size_t)origem->quantidade);
+    return pagina;
+}
+
+static void pagina_reter(PaginaInventario* pagina) {
+    atomic_fetch_add_explicit(&pagina->referencias, 1, memory_order_relaxed);
+}
+
+static void pagina_soltar(PaginaInventario* pagina) {
+    if (pagina != NULL && atomic_fetch_sub_explicit(&pagina->referencias, 1, memory_order_acq_rel) == 1) {
+        mem_liberar(pagina);
+    }
+}
+
+static VersaoInventario* versao_nova(int numPaginas) {
+    VersaoInventario* versao = mem_alocar(MEMORIA_OUTROS, sizeof(VersaoInventario));
+    PaginaInventario** paginas = mem_alocar_zerado(MEMORIA_OUTROS, (size_t)(numPaginas > 0 ? numPaginas : 1), sizeof(PaginaInventario*));
+    if (!versao || !paginas) {
+        mem_liberar(versao);
+        mem_liberar(paginas);
+        return NULL;
+    }
+    atomic_init(&versao->referencias, 1);
+    versao->numRegistros = 0;
+    versao->numPaginas = numPaginas;
+    versao->paginas = paginas;
+    return versao;
+}
+
+// Libera uma versão ainda não publicada, com a tabela possivelmente preenchida pela metade
+static void versao_descartar(VersaoInventario* versao) {
+    for (int p = 0; p < versao->numPaginas; p++) pagina_soltar(versao->paginas[p]);
+    mem_liberar(versao->paginas);
+    mem_liberar(versao);
+}
+
+VersaoInventario* versao_sincronizar(const VersaoInventario* base, const LinkedList* lista) {
+    int numPaginas = (lista->size + REGISTROS_POR_PAGINA - 1) / REGISTROS_POR_PAGINA;
+    VersaoInventario* versao = versao_nova(numPaginas);
+    if (!versao) return NULL;
+    versao->numRegistros = lista->size;
+
+    const Node* atual = lista->head;
+    for (int p = 0; p < numPaginas; p++) {
+        int quantidade = lista->size - p * REGISTROS_POR_PAGINA;
+        if (quantidade > REGISTROS_POR_PAGINA) quantidade = REGISTROS_POR_PAGINA;
+
+        // Página da base reaproveitada se todos os registros forem idênticos
+        PaginaInventario* antiga = (base != NULL && p < base->numPaginas) ? base->paginas[p] : NULL;
+        const Node* inicio = atual;
+        bool igual = antiga != NULL && antiga->quantidade == quantidade;
+        for (int i = 0; i < quantidade; i++, atual = atual->next) {
+            if (igual && memcmp(&antiga->registros[i], &atual->data, sizeof(Hardware)) != 0) igual = false;
+        }
+        if (igual) {
+            pagina_reter(antiga);
+            versao->paginas[p] = antiga;
+            continue;
+        }
+
+        PaginaInventario* pagina = pagina_nova();
+        if (!pagina) {
+            versao_descartar(versao);
+            return NULL;
+        }
+        for (const Node* no = inicio; pagina->quantidade < quantidade; no = no->next) {
+            pagina->registros[pagina->quantidade++] = no->data;
+        }
+        versao->paginas[p] = pagina;
+    }
+    return versao;
+}
+
+// Nova tabela com todas as páginas de base retidas, exceto a da posição trocada
+static VersaoInventario* versao_derivar(const VersaoInventario* base, int numPaginas, int paginaTrocada, PaginaInventario* nova) {
+    VersaoInventario* versao = versao_nova(numPaginas);
+    if (!versao) {
+        pagina_soltar(nova);
+        return NULL;
+    }
+    versao->numRegistros = base ? base->numRegistros : 0;
+    for (int p = 0; base != NULL && p < base->numPaginas; p++) {
+        if (p == paginaTrocada) continue;
+        pagina_reter(base->paginas[p]);
+        versao->paginas[p] = base->paginas[p];
+    }
+    versao->paginas[paginaTrocada] = nova;
+    return versao;
+}
+
+VersaoInventario* versao_substituir(const VersaoInventario* base, int posicao, const Hardware* hw) {
+    if (base == NULL || posicao < 0 || posicao >= base->numRegistros) return NULL;
+    int p = posicao / REGISTROS_POR_PAGINA;
+    PaginaInventario* pagina = pagina_copiar(base->paginas[p]);
+    if (!pagina) return NULL;
+    pagina->registros[posicao % REGISTROS_POR_PAGINA] = *hw;
+    return versao_derivar(base, base->numPaginas, p, pagina);
+}
+
+VersaoInventario* versao_anexar(const VersaoInventario* base, const Hardware* hw) {
+    int numRegistros = base ? base->numRegistros : 0;
+    int p = numRegistros / REGISTROS_POR_PAGINA;
+    int numPaginas = p + 1;
+
+    // A última página só é copiada se já existir; cheia, o registro abre uma página nova
+    PaginaInventario* pagina = numRegistros % REGISTROS_POR_PAGINA != 0 ? pagina_copiar(base->paginas[p]) : pagina_nova();
+    if (!pagina) return NULL;
+    pagina->registros[pagina->quantidade++] = *hw;
+
+    VersaoInventario* versao = versao_derivar(base, numPaginas, p, pagina);
+    if (versao) versao->numRegistros = numRegistros + 1;
+    return versao;
+}
+
+void versao_liberar(const VersaoInventario* versao) {
+    // A contagem de referências é a única parte mutável de uma versão publicada
+    VersaoInventario* mutavel = (VersaoInventario*)versao;
+    if (mutavel != NULL && atomic_fetch_sub_explicit(&mutavel->referencias, 1, memory_order_acq_rel) == 1) {
+        versao_descartar(mutavel);
+    }
+}
+
+const Hardware* versao_registro(const VersaoInventario* versao, int posicao) {
+    return &versao->paginas[posicao / REGISTROS_POR_PAGINA]->registros[posicao % REGISTROS_POR_PAGINA];
+}
+
+const Hardware** versao_coletar_itens(const VersaoInventario* versao) {
+    const Hardware** itens = mem_alocar(MEMORIA_TEMPORARIA, sizeof(Hardware*) * (versao->numRegistros > 0 ? versao->numRegistros : 1));
+    if (!itens) return NULL;
+
+    int i = 0;
+    for (int p = 0; p < versao->numPaginas; p++) {
+        const PaginaInventario* pagina = versao->paginas[p];
+        for (int j = 0; j < pagina->quantidade; j++) itens[i++] = &pagina->registros[j];
+    }
+    return itens;
+}
+
+void publicacao_init(PublicacaoVersao* publicacao) {
+    publicacao->atual = NULL;
+    pthread_mutex_init(&publicacao->trava, NULL);
+}
+
+void publicacao_destruir(PublicacaoVersao* publicacao) {
+    versao_liberar(publicacao->atual);
+    publicacao->atual = NULL;
+    pthread_mutex_destroy(&publicacao->trava);
+}
+
+void publicacao_trocar(PublicacaoVersao* publicacao, VersaoInventario* nova) {
+    pthread_mutex_lock(&publicacao->trava);
+    VersaoInventario* anterior = publicacao->atual;
+    publicacao->atual = nova;
+    pthread_mutex_unlock(&publicacao->trava);
+    versao_liberar(anterior);
+}
+
+const VersaoInventario* publicacao_obter(PublicacaoVersao* publicacao) {
+    pthread_mutex_lock(&publicacao->trava);
+    VersaoInventario* versao = publicacao->atual;
+    if (versao) atomic_fetch_add_explicit(&versao->referencias, 1, memory_order_relaxed);
+    pthread_mutex_unlock(&publicacao->trava);
+    return versao;
+}